@@ -22,6 +22,7 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <ghoul/glm.h>
@@ -50,6 +51,7 @@
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/resourcesynchronization.h>
 #include <openspace/util/task.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/scene/translation.h>
 #include <openspace/scene/rotation.h>
 #include <openspace/scene/scale.h>
@@ -63,7 +65,7 @@ namespace {
     const std::string _loggerCat = "TaskRunner Main";
 }
 
-void performTasks(const std::string& path) {
+void performTasks(const std::string& path, unsigned int nWorkers) {
     using namespace openspace;
 
     TaskLoader taskLoader;
@@ -77,17 +79,24 @@ void performTasks(const std::string& path) {
         LINFO(std::format("Task queue has {} items", tasks.size()));
     }
 
-    for (size_t i = 0; i < tasks.size(); i++) {
-        Task& task = *tasks[i].get();
-        LINFO(std::format(
-            "Performing task {} out of {}: {}", i + 1, tasks.size(), task.description()
-        ));
+    TaskScheduler::Result result;
+    try {
+        TaskScheduler scheduler = TaskScheduler(std::move(tasks));
         ProgressBar progressBar(100);
         auto onProgress = [&progressBar](float progress) {
             progressBar.print(static_cast<int>(progress * 100.f));
         };
-        task.perform(onProgress);
+        result = scheduler.run(nWorkers, onProgress);
     }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(std::format("Could not schedule tasks: {}", e.message));
+        return;
+    }
+
+    LINFO(std::format(
+        "Performed {} tasks, skipped {} up-to-date tasks, {} tasks failed",
+        result.nPerformed, result.nSkipped, result.nFailed
+    ));
     std::cout << "Done performing tasks" << std::endl;
 }
 
@@ -152,13 +161,27 @@ int main(int argc, char** argv) {
         )
     );
 
+    std::optional<int> nWorkers;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<int>>(
+            nWorkers,
+            "--workers",
+            "-w",
+            "The number of tasks that are performed concurrently. Tasks that depend on "
+            "each other are never performed at the same time. Defaults to 1"
+        )
+    );
+
     commandlineParser.setCommandLine({ argv, argv + argc });
     commandlineParser.execute();
 
     //FileSys.setCurrentDirectory(launchDirectory);
 
+    const unsigned int workers =
+        static_cast<unsigned int>(std::max(nWorkers.value_or(1), 1));
+
     if (tasksPath.has_value()) {
-        performTasks(*tasksPath);
+        performTasks(*tasksPath, workers);
         return 0;
     }
 
@@ -170,7 +193,7 @@ int main(int argc, char** argv) {
     std::cout << "TASK > ";
     std::string t;
     while (std::cin >> t) {
-        performTasks(t);
+        performTasks(t, workers);
         std::cout << "TASK > ";
     }
 
@@ -26,6 +26,7 @@
 #define __OPENSPACE_CORE___DATALOADER___H__
 
 #include <openspace/data/datamapping.h>
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/csvreader.h>
@@ -109,6 +110,68 @@ namespace data {
     Dataset loadFileWithCache(std::filesystem::path path,
         std::optional<DataMapping> specs = std::nullopt);
 
+    /**
+     * Returns the path to the cache file for the data file at \p path and the provided
+     * \p specs, which is the same file that is used by #loadFileWithCache. If the cache
+     * file does not exist yet, it is created, which requires the data file to be loaded
+     * in its entirety once.
+     *
+     * \param path The path to the data file
+     * \param specs The data mapping that is used to interpret the data file
+     * \return The path to the cache file for the data file
+     */
+    std::filesystem::path cachedFile(std::filesystem::path path,
+        std::optional<DataMapping> specs = std::nullopt);
+
+    /**
+     * Provides random access to the entries of a cache file that was written by
+     * #saveCachedFile without loading the entire file into memory. Only the entries that
+     * are requested are read from disk, which makes it possible to use datasets that are
+     * too large to be kept in memory as a whole. The comments of the entries are not
+     * read. All member functions can safely be called from multiple threads.
+     */
+    class CachedFileReader {
+    public:
+        /**
+         * Opens the cache file at \p path and reads all information except for the
+         * entries.
+         *
+         * \param path The path to the cache file
+         *
+         * \throw ghoul::RuntimeError If the file could not be opened, was written with
+         *        an incompatible version, or is truncated
+         */
+        explicit CachedFileReader(const std::filesystem::path& path);
+
+        /**
+         * Returns the contents of the cache file without any of its entries, that is
+         * the variables, textures, and indices of the dataset.
+         */
+        const Dataset& header() const;
+
+        /// Returns the total number of entries in the cache file
+        uint64_t nEntries() const;
+
+        /**
+         * Reads \p count consecutive entries starting with the entry at index \p first.
+         *
+         * \param first The index of the first entry that is read
+         * \param count The number of entries that are read
+         * \return The requested entries
+         *
+         * \pre `first + count` must be smaller or equal to #nEntries
+         */
+        std::vector<Dataset::Entry> readEntries(uint64_t first, uint64_t count) const;
+
+    private:
+        MemoryMappedFile _file;
+        Dataset _header;
+        uint64_t _nEntries = 0;
+        uint16_t _nValues = 0;
+        size_t _entriesOffset = 0;
+        size_t _valuesOffset = 0;
+    };
+
 } // namespace data
 
 namespace label {
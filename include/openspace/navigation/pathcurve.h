@@ -85,7 +85,8 @@ protected:
     /**
      * Compute curve parameter u that matches the input arc length s. Input s is a length
      * value in meters, in the range [0, _totalLength]. The returned curve parameter u is
-     * in range [0, 1].
+     * in range [0, 1]. The lookup is a binary search in the arc length map computed in
+     * #initializeParameterData, followed by a few Newton iterations on the arc length.
      */
     double curveParameter(double s) const;
 
@@ -105,6 +106,15 @@ protected:
         double s; // arc length parameter
     };
 
+    /**
+     * Recursively add samples between the \p lower and \p upper samples to the arc
+     * length map until a linear interpolation between neighboring samples is within the
+     * \p tolerance, in meters. The samples are added in increasing order, excluding
+     * \p lower and \p upper themselves.
+     */
+    void addRefinedSamples(const ParameterPair& lower, const ParameterPair& upper,
+        double tolerance, int depth);
+
     std::vector<ParameterPair> _parameterSamples;
 };
 
@@ -27,6 +27,8 @@
 
 #include <openspace/navigation/pathcurve.h>
 
+#include <unordered_map>
+
 namespace openspace { class SceneGraphNode; }
 
 namespace openspace::interaction {
@@ -41,6 +43,7 @@ private:
     void removeCollisions(int step = 0);
 
     std::vector<SceneGraphNode*> _relevantNodes;
+    std::unordered_map<SceneGraphNode*, size_t> _relevantNodeIndices;
 };
 
 } // namespace openspace::interaction
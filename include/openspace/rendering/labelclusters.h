@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___LABELCLUSTERS___H__
+#define __OPENSPACE_CORE___LABELCLUSTERS___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace openspace::labels {
+
+/**
+ * A flat spatial index over a list of labels that is used to cull labels in groups
+ * before they are culled individually. The labels are split at the median of the longest
+ * axis of their bounding box until each part is small enough to become a cluster, and the
+ * labels of each cluster are stored contiguously in #order.
+ */
+struct ClusterIndex {
+    struct Cluster {
+        /// The center of the bounding box of the labels in this cluster
+        glm::dvec3 center = glm::dvec3(0.0);
+        /// The distance from the #center to the farthest label position
+        double radius = 0.0;
+        /// The largest extent of any label in this cluster, in unscaled text units
+        float maxExtent = 0.f;
+
+        /// The first index into #order of the labels in this cluster
+        uint32_t first = 0;
+        /// The number of labels in this cluster
+        uint32_t count = 0;
+    };
+
+    std::vector<Cluster> clusters;
+
+    /// The indices of the original labels in the order in which they are stored in the
+    /// clusters
+    std::vector<uint32_t> order;
+};
+
+/**
+ * The information that is needed to decide whether a label is visible, derived from the
+ * modelViewProjection matrix and the size settings of the labels.
+ */
+struct CullingInfo {
+    /// The four side planes of the view frustum with normals of unit length that point
+    /// into the frustum. The near and far planes are not used as the far plane might be
+    /// at infinity
+    std::array<glm::dvec4, 4> planes;
+
+    /// The row of the modelViewProjection matrix that computes the clip-space depth
+    glm::dvec4 depthRow = glm::dvec4(0.0);
+    double depthRowLength = 0.0;
+
+    /// The factor with which the extent of a label, in text units, is multiplied to get
+    /// its extent in the model space of the labels
+    double scale = 1.0;
+
+    /// The height of a line of text in pixels at a clip-space depth of 1. The projected
+    /// height falls off with the inverse of the depth
+    double pixelsAtUnitDepth = 0.0;
+
+    /// The largest clip-space depth at which a label is at least as large as the minimum
+    /// size. Labels that are farther away are not visible
+    double maxDepth = 0.0;
+};
+
+/**
+ * Builds the ClusterIndex for the labels with the provided \p positions and
+ * \p extents. Labels are split until each cluster contains at most
+ * \p maxLabelsPerCluster labels.
+ *
+ * \param positions The positions of the labels in the model space of the labels
+ * \param extents The largest distance of any part of each label from its position, in
+ *        unscaled text units
+ * \param maxLabelsPerCluster The maximum number of labels in each cluster
+ * \return The index containing all labels
+ *
+ * \pre \p positions and \p extents must have the same size
+ */
+ClusterIndex buildClusterIndex(std::span<const glm::vec3> positions,
+    std::span<const float> extents, uint32_t maxLabelsPerCluster = 64);
+
+/**
+ * Creates the CullingInfo for labels that are rendered with the provided
+ * \p modelViewProjection matrix.
+ *
+ * \param modelViewProjection The matrix that transforms label positions into clip space
+ * \param scale The factor with which text units are multiplied to get model units
+ * \param lineHeight The height of a line of text in unscaled text units
+ * \param viewportHeight The height of the viewport in pixels
+ * \param minSize The minimum height of a label in pixels. Labels that would be smaller
+ *        are not visible. If this value is 0, labels are not culled by their size
+ */
+CullingInfo cullingInfo(const glm::dmat4& modelViewProjection, double scale,
+    double lineHeight, double viewportHeight, double minSize);
+
+/**
+ * Returns whether the label at the provided \p position, with the provided \p extent in
+ * unscaled text units, might be visible. A label is visible if its position is in front
+ * of the camera, it is not too small, and if a sphere with its extent around its position
+ * intersects the view frustum.
+ */
+bool isLabelVisible(const CullingInfo& info, const glm::dvec3& position, float extent);
+
+/**
+ * Selects all labels from the \p index that are visible according to #isLabelVisible.
+ * The result is the same as testing all labels individually, but entire clusters are
+ * rejected at once.
+ *
+ * \param index The index from which to select the labels
+ * \param positions The same label positions that were used to build the \p index
+ * \param extents The same label extents that were used to build the \p index
+ * \param info The culling information as returned by #cullingInfo
+ * \param result Receives the indices of the visible labels in the order of the clusters
+ */
+void selectLabels(const ClusterIndex& index, std::span<const glm::vec3> positions,
+    std::span<const float> extents, const CullingInfo& info,
+    std::vector<uint32_t>& result);
+
+} // namespace openspace::labels
+
+#endif // __OPENSPACE_CORE___LABELCLUSTERS___H__
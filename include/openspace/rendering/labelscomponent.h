@@ -33,9 +33,14 @@
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/ivec2property.h>
 #include <openspace/properties/vector/vec3property.h>
+#include <openspace/rendering/labelclusters.h>
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/glm.h>
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ghoul::fontrendering { class Font; }
 
@@ -79,6 +84,38 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /**
+     * A single glyph of a text. The position of its corners relative to the start of the
+     * text is given in unscaled text units and the texture coordinates refer to the
+     * atlas of the font.
+     */
+    struct GlyphQuad {
+        glm::vec2 topLeft = glm::vec2(0.f);
+        glm::vec2 bottomRight = glm::vec2(0.f);
+        glm::vec2 texCoordsTopLeft = glm::vec2(0.f);
+        glm::vec2 texCoordsBottomRight = glm::vec2(0.f);
+        glm::vec2 outlineTexCoordsTopLeft = glm::vec2(0.f);
+        glm::vec2 outlineTexCoordsBottomRight = glm::vec2(0.f);
+    };
+
+    /**
+     * The glyphs of a single text, which are stored contiguously in `_glyphQuads`.
+     */
+    struct TextLayout {
+        uint32_t firstQuad = 0;
+        uint32_t nQuads = 0;
+        /// The largest distance of any glyph corner from the start of the text
+        float extent = 0.f;
+    };
+
+    /**
+     * Returns the index of the layout for the provided \p text in `_textLayouts` and
+     * lays out the text with the current font if it has not been seen before.
+     */
+    uint32_t textLayout(const std::string& text);
+
+    void buildSpatialIndex();
+
     std::filesystem::path _labelFile;
     DistanceUnit _unit = DistanceUnit::Parsec;
     dataloader::Labelset _labelset;
@@ -91,6 +128,24 @@ private:
 
     bool _createdFromDataset = false;
 
+    // Labels often share the same text, so the glyphs of each distinct text are only
+    // laid out once per font
+    std::vector<GlyphQuad> _glyphQuads;
+    std::vector<TextLayout> _textLayouts;
+    std::unordered_map<std::string, uint32_t> _textLayoutIndices;
+
+    // The spatial index of the labels that is used to cull them before their glyphs are
+    // added to the vertex data. The positions are already transformed and scaled
+    std::vector<glm::vec3> _labelPositions;
+    std::vector<float> _labelExtents;
+    std::vector<uint32_t> _labelTextLayouts;
+    labels::ClusterIndex _clusterIndex;
+    bool _spatialIndexIsDirty = true;
+
+    // The glyphs of all visible labels are rendered with a single draw call
+    std::vector<uint32_t> _visibleLabels;
+    std::vector<float> _vertexData;
+
     properties::BoolProperty _enabled;
     properties::Vec3Property _color;
     properties::FloatProperty _size;
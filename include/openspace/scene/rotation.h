@@ -29,6 +29,7 @@
 
 #include <ghoul/glm.h>
 #include <ghoul/misc/managedmemoryuniqueptr.h>
+#include <span>
 
 namespace ghoul { class Dictionary; }
 
@@ -50,6 +51,21 @@ public:
 
     const glm::dmat3& matrix() const;
     virtual glm::dmat3 matrix(const UpdateData& time) const = 0;
+
+    /**
+     * Computes the rotation matrices at all \p times and writes them into \p result.
+     * The default implementation calls #matrix for each time individually, but
+     * subclasses override this function if a batch of matrices can be computed more
+     * efficiently.
+     *
+     * \param times The times in seconds past the J2000 epoch for which to compute the
+     *        rotation matrices
+     * \param result The output matrices, one for each entry in \p times
+     *
+     * \pre \p result must have the same size as \p times
+     */
+    virtual void matrices(std::span<const double> times,
+        std::span<glm::dmat3> result) const;
     virtual void update(const UpdateData& data);
 
     static documentation::Documentation Documentation();
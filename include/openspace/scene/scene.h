@@ -28,6 +28,7 @@
 #include <openspace/properties/propertyowner.h>
 
 #include <openspace/scene/profile.h>
+#include <openspace/scene/scenebvh.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scripting/scriptengine.h>
 #include <ghoul/lua/luastate.h>
@@ -153,6 +154,13 @@ public:
      */
     const std::unordered_map<std::string, SceneGraphNode*>& nodesByIdentifier() const;
 
+    /**
+     * Returns the bounding volume hierarchy over the world positions and bounding
+     * spheres of all scene graph nodes. The hierarchy is refit at the end of every call
+     * to #update.
+     */
+    const SceneBvh& boundingVolumeHierarchy() const;
+
     /**
      * Load a scene graph node from a dictionary and return it.
      */
@@ -331,6 +339,8 @@ private:
     std::vector<SceneGraphNode*> _circularNodes;
     std::unordered_map<std::string, SceneGraphNode*> _nodesByIdentifier;
     bool _dirtyNodeRegistry = false;
+    SceneBvh _bvh;
+    bool _dirtyBvh = true;
     SceneGraphNode _rootNode;
     std::unique_ptr<SceneInitializer> _initializer;
     std::string _profilePropertyName;
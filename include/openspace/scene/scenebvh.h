@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SCENEBVH___H__
+#define __OPENSPACE_CORE___SCENEBVH___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace openspace {
+
+class SceneGraphNode;
+
+/**
+ * A bounding volume hierarchy over the world positions and bounding spheres of a set of
+ * scene graph nodes. The hierarchy is built once whenever the set of nodes changes and
+ * is then refit every frame from the cached world positions of the nodes, which keeps
+ * the topology intact and only updates the bounds. If the nodes have moved so much that
+ * the refitted hierarchy has degraded, it is rebuilt from scratch.
+ *
+ * The bounding spheres are treated the same way as in the collision checks of the path
+ * navigation, that is, the radius is expressed in the model space of each node and is
+ * bounded in world space by the largest component of the node's world scale. All queries
+ * are conservative and return a superset of the nodes that actually intersect; the
+ * caller is expected to perform the exact test on the returned candidates.
+ */
+class SceneBvh {
+public:
+    using NodeFilter = std::function<bool(const SceneGraphNode*)>;
+
+    /**
+     * Rebuilds the hierarchy for the provided \p nodes, reading their current world
+     * positions and bounding spheres.
+     */
+    void build(const std::vector<SceneGraphNode*>& nodes);
+
+    /**
+     * Updates the bounds of the hierarchy from the current world positions and bounding
+     * spheres of the nodes without changing its topology. If the quality of the
+     * hierarchy has degraded too far compared to when it was built, the hierarchy is
+     * rebuilt instead.
+     */
+    void refit();
+
+    /**
+     * Removes all nodes from the hierarchy.
+     */
+    void clear();
+
+    /**
+     * Returns `true` if there are no nodes in the hierarchy.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Collects all nodes whose bounding sphere might intersect the line segment from
+     * \p p1 to \p p2. Each bounding sphere is first clamped to be at least
+     * \p minRadius and then scaled by \p radiusScale, which makes it possible to query
+     * for the spheres including an additional buffer. A segment with the same start and
+     * end point results in a point query.
+     *
+     * \param p1 The start point of the line segment in world coordinates
+     * \param p2 The end point of the line segment in world coordinates
+     * \param radiusScale The factor with which each bounding sphere is scaled
+     * \param minRadius The smallest bounding sphere used for any node
+     * \param result The vector into which the candidate nodes are appended
+     */
+    void querySegment(const glm::dvec3& p1, const glm::dvec3& p2, double radiusScale,
+        double minRadius, std::vector<SceneGraphNode*>& result) const;
+
+    /**
+     * Returns the node whose world position is closest to \p position out of all nodes
+     * that pass the \p filter, or `nullptr` if no such node exists.
+     *
+     * \param position The position in world coordinates
+     * \param filter An optional filter that a node has to pass to be considered
+     */
+    SceneGraphNode* nearestNode(const glm::dvec3& position,
+        const NodeFilter& filter = nullptr) const;
+
+    /**
+     * Returns the node whose world-space bounding sphere is hit first by the ray starting
+     * at \p origin in the \p direction out of all nodes that pass the \p filter, or
+     * `nullptr` if no node is hit. If \p distance is provided, the distance along the
+     * ray to the hit point is stored in it.
+     *
+     * \param origin The start of the ray in world coordinates
+     * \param direction The normalized direction of the ray
+     * \param filter An optional filter that a node has to pass to be considered
+     * \param distance An optional output for the distance to the intersection
+     */
+    SceneGraphNode* intersectRay(const glm::dvec3& origin, const glm::dvec3& direction,
+        const NodeFilter& filter = nullptr, double* distance = nullptr) const;
+
+private:
+    struct Leaf {
+        SceneGraphNode* node = nullptr;
+        glm::dvec3 center = glm::dvec3(0.0);
+        double radius = 0.0;
+        double scale = 1.0;
+    };
+
+    // The tree is stored in depth-first order, so the first child of an inner node is
+    // always located directly after it and only the index of the second child is stored
+    struct Node {
+        glm::dvec3 min = glm::dvec3(0.0);
+        glm::dvec3 max = glm::dvec3(0.0);
+        // The largest radius * scale and scale of any of the contained leaves
+        double maxRadius = 0.0;
+        double maxScale = 0.0;
+        uint32_t secondChild = 0;
+        uint32_t firstLeaf = 0;
+        uint32_t nLeaves = 0;
+    };
+
+    uint32_t buildRecursive(uint32_t begin, uint32_t end);
+    void updateLeaf(Leaf& leaf) const;
+    void fitNode(Node& node) const;
+    double totalSurfaceArea() const;
+
+    std::vector<Leaf> _leaves;
+    std::vector<Node> _nodes;
+    std::vector<SceneGraphNode*> _sceneNodes;
+    double _builtSurfaceArea = 0.0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SCENEBVH___H__
@@ -30,6 +30,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/misc/managedmemoryuniqueptr.h>
 #include <functional>
+#include <span>
 
 namespace ghoul { class Dictionary; }
 
@@ -53,6 +54,20 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Computes the positions at all \p times and writes them into \p result. The
+     * default implementation calls #position for each time individually, but subclasses
+     * override this function if a batch of positions can be computed more efficiently.
+     *
+     * \param times The times in seconds past the J2000 epoch for which to compute the
+     *        positions
+     * \param result The output positions, one for each entry in \p times
+     *
+     * \pre \p result must have the same size as \p times
+     */
+    virtual void positions(std::span<const double> times,
+        std::span<glm::dvec3> result) const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
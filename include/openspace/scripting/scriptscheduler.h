@@ -34,7 +34,9 @@
 #include <functional>
 #include <optional>
 #include <queue>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace ghoul { class Dictionary; }
@@ -46,7 +48,11 @@ struct LuaLibrary;
 
 /**
  * Maintains an ordered list of `ScheduledScript`s and provides a simple interface for
- * retrieveing scheduled scripts.
+ * retrieveing scheduled scripts. The scripts that have to be executed when passing a
+ * scheduled time in either direction are precomputed when loading the scripts and stored
+ * in time order for the forward direction and reverse time order for the backward
+ * direction, so that the scripts crossed by any change in time form a contiguous range
+ * that can be found with a binary search.
  */
 class ScriptScheduler : public properties::PropertyOwner {
 public:
@@ -96,9 +102,11 @@ public:
      *
      * \param newTime A j2000 time value specifying the new time stamp that the script
      *        scheduler should progress to.
-     * \return vector with the scheduled scripts that should be run from begining to end
+     * \return The scheduled scripts that should be run from begining to end. The
+     *         returned range refers to the scripts stored in the scheduler and is valid
+     *         until the next time scripts are loaded or cleared
      */
-    std::vector<std::string> progressTo(double newTime);
+    std::span<const std::string> progressTo(double newTime);
 
     /**
      * Returns the the j2000 time value that the script scheduler is currently at.
@@ -125,9 +133,24 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /**
+     * Recomputes the group indices and the current index after the scripts changed.
+     */
+    void updateIndices();
+
     properties::BoolProperty _enabled;
     properties::BoolProperty _shouldRunAllTimeJump;
+
+    // All scripts sorted by time
     std::vector<ScheduledScript> _scripts;
+    // The scripts to execute when passing each scheduled script forwards in time, in the
+    // same order as _scripts
+    std::vector<std::string> _forwardScripts;
+    // The scripts to execute when passing each scheduled script backwards in time, in the
+    // reverse order of _scripts
+    std::vector<std::string> _backwardScripts;
+    // The indices into _scripts for the scripts that belong to each group
+    std::unordered_map<int, std::vector<size_t>> _groups;
 
     int _currentIndex = 0;
     double _currentTime = 0;
@@ -0,0 +1,100 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+#define __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+
+#include <filesystem>
+#include <string_view>
+
+namespace openspace {
+
+/**
+ * A read-only view of the contents of a file that is mapped into the address space of
+ * the process. The contents are paged in by the operating system on first access, which
+ * makes it possible to parse large files in place and from multiple threads without
+ * copying them into an intermediate buffer first.
+ */
+class MemoryMappedFile {
+public:
+    /**
+     * Maps the entire contents of the provided \p file into memory.
+     *
+     * \param file The path to the file that should be mapped
+     *
+     * \throw ghoul::RuntimeError If the file could not be opened or mapped
+     */
+    explicit MemoryMappedFile(const std::filesystem::path& file);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+    MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+
+    /// Returns the first byte of the file, or `nullptr` if the file is empty
+    const char* data() const;
+
+    /// Returns the size of the file in bytes
+    size_t size() const;
+
+    /// Returns the entire contents of the file
+    std::string_view view() const;
+
+    /**
+     * Hints to the operating system that the provided byte range will be accessed soon,
+     * so that it can be read from disk asynchronously ahead of time. Ranges outside the
+     * file are clamped.
+     *
+     * \param offset The offset of the first byte of the range
+     * \param size The number of bytes in the range
+     */
+    void prefetch(size_t offset, size_t size) const;
+
+    /**
+     * Hints to the operating system that the provided byte range is not needed anymore,
+     * so that its pages can be dropped from the resident memory of the process. The
+     * contents are read from disk again the next time they are accessed. Ranges outside
+     * the file are clamped.
+     *
+     * \param offset The offset of the first byte of the range
+     * \param size The number of bytes in the range
+     */
+    void release(size_t offset, size_t size) const;
+
+private:
+    void unmap();
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif // WIN32
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
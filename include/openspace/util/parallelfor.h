@@ -0,0 +1,89 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PARALLELFOR___H__
+#define __OPENSPACE_CORE___PARALLELFOR___H__
+
+#include <cstddef>
+#include <functional>
+
+namespace openspace {
+
+/**
+ * Returns the number of ranges into which \p n items should be split so that each range
+ * contains at least \p minItemsPerRange items. The result is at least 1 and at most the
+ * number of threads that can work on the ranges at the same time, which is the number of
+ * helper threads plus the calling thread.
+ *
+ * \param n The total number of items
+ * \param minItemsPerRange The smallest number of items that makes it worthwhile to hand
+ *        a range to a different thread
+ * \return The number of ranges that should be passed to #parallelForRanges
+ */
+size_t parallelRangeCount(size_t n, size_t minItemsPerRange);
+
+/**
+ * Splits the items `[0, n)` into \p nRanges contiguous ranges of nearly equal size and
+ * calls \p func once for each of them. Range `r` covers the items
+ * `[n * r / nRanges, n * (r + 1) / nRanges)`. The ranges are processed by a process-wide
+ * pool of helper threads together with the calling thread, which claim the next
+ * unprocessed range whenever they are done with the previous one. This function returns
+ * once all ranges have been processed. Since the calling thread takes part in the work,
+ * it is safe to call this function from within \p func.
+ *
+ * Each range is processed by exactly one thread, so per-range state, such as a scratch
+ * buffer, can be indexed by the range index without further synchronization. If there
+ * are more ranges than threads, ranges are handed out dynamically, which balances
+ * ranges with uneven cost.
+ *
+ * If \p func throws for one or more ranges, the remaining ranges are still processed and
+ * the exception of the range with the lowest index is rethrown on the calling thread.
+ *
+ * \param n The total number of items. If it is 0, \p func is not called
+ * \param nRanges The number of ranges. Values larger than \p n are reduced to \p n
+ * \param func The function that is called with the index of the range and the first and
+ *        one-past-the-last item of that range
+ *
+ * \pre \p nRanges must be positive if \p n is positive
+ */
+void parallelForRanges(size_t n, size_t nRanges,
+    const std::function<void(size_t range, size_t begin, size_t end)>& func);
+
+/**
+ * Calls \p func for each item `i` in `[0, n)`, spreading the items over as many ranges as
+ * #parallelRangeCount returns for \p minItemsPerRange. See #parallelForRanges for the
+ * threading and exception guarantees.
+ *
+ * \param n The total number of items
+ * \param minItemsPerRange The smallest number of items that are processed on one thread
+ * \param func The function that is called with the index of each item
+ */
+template <typename Func>
+void parallelFor(size_t n, size_t minItemsPerRange, Func&& func);
+
+} // namespace openspace
+
+#include "parallelfor.inl"
+
+#endif // __OPENSPACE_CORE___PARALLELFOR___H__
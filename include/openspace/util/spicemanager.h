@@ -35,6 +35,7 @@
 #include <array>
 #include <filesystem>
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 #include <set>
@@ -676,6 +677,32 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the positions of a \p target body relative to an \p observer in a
+     * specific \p referenceFrame for all of the provided \p ephemerisTimes. The result is
+     * the same as calling #targetPosition for each time individually, but the NAIF IDs
+     * and coverage intervals of the \p target and \p observer are only resolved once for
+     * the entire batch.
+     *
+     * \param target The target body name or the target body's NAIF ID
+     * \param observer The observing body name or the observing body's NAIF ID
+     * \param referenceFrame The reference frame of the output position vectors
+     * \param aberrationCorrection The aberration correction used for the position
+     *        calculation
+     * \param ephemerisTimes The times at which the positions are to be queried
+     * \param positions The output positions, one for each of the \p ephemerisTimes
+     *
+     * \throw SpiceException If the position for any of the \p ephemerisTimes could not
+     *        be computed, see #targetPosition
+     * \pre \p target must not be empty
+     * \pre \p observer must not be empty
+     * \pre \p referenceFrame must not be empty
+     * \pre \p positions must have the same size as \p ephemerisTimes
+     */
+    void targetPositions(const std::string& target, const std::string& observer,
+        const std::string& referenceFrame, AberrationCorrection aberrationCorrection,
+        std::span<const double> ephemerisTimes, std::span<glm::dvec3> positions) const;
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
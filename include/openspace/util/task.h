@@ -25,8 +25,11 @@
 #ifndef __OPENSPACE_CORE___TASK___H__
 #define __OPENSPACE_CORE___TASK___H__
 
+#include <filesystem>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -38,15 +41,37 @@ class Task {
 public:
     using ProgressCallback = std::function<void(float)>;
 
+    /**
+     * Describes how a task relates to the other tasks that are performed with it. This
+     * is used to decide which tasks can be performed concurrently and which tasks can be
+     * skipped because their outputs are already up to date.
+     */
+    struct Scheduling {
+        /// The name by which other tasks can refer to this task
+        std::string name;
+        /// The files that are read by this task
+        std::vector<std::filesystem::path> inputs;
+        /// The files that are written by this task
+        std::vector<std::filesystem::path> outputs;
+        /// The names of the tasks that have to be finished before this task is performed
+        std::vector<std::string> dependencies;
+    };
+
     virtual ~Task() = default;
     virtual void perform(const ProgressCallback& onProgress) = 0;
     virtual std::string description() = 0;
 
+    const Scheduling& scheduling() const;
+    void setScheduling(Scheduling scheduling);
+
     static std::unique_ptr<Task> createFromDictionary(
         const ghoul::Dictionary& dictionary
     );
 
     static documentation::Documentation documentation();
+
+private:
+    Scheduling _scheduling;
 };
 
 } // namespace openspace
@@ -0,0 +1,96 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASKSCHEDULER___H__
+#define __OPENSPACE_CORE___TASKSCHEDULER___H__
+
+#include <openspace/util/task.h>
+
+#include <memory>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Performs a list of tasks on a number of worker threads. The order between the tasks is
+ * taken from their Task::Scheduling. A task is performed after all of the tasks that it
+ * explicitly depends on, and after all tasks that write one of the files it reads.
+ * Independent tasks are performed concurrently, preferring the order in which the tasks
+ * were provided. Tasks whose outputs are up to date are skipped, unless one of their
+ * dependencies was performed in the same run.
+ */
+class TaskScheduler {
+public:
+    struct Result {
+        int nPerformed = 0;
+        int nSkipped = 0;
+        int nFailed = 0;
+    };
+
+    /**
+     * Creates a scheduler for the provided \p tasks and resolves the dependencies
+     * between them. Empty entries in \p tasks are ignored.
+     *
+     * \param tasks The tasks that are performed by this scheduler
+     *
+     * \throw ghoul::RuntimeError If two tasks have the same name or write the same file,
+     *        if a task depends on a name that does not exist, or if the dependencies
+     *        between the tasks form a cycle
+     */
+    explicit TaskScheduler(std::vector<std::unique_ptr<Task>> tasks);
+
+    /**
+     * Performs all tasks and returns once all of them are finished. If a task fails by
+     * throwing an exception, the tasks that depend on it are not performed, but all
+     * other tasks are.
+     *
+     * \param nWorkers The maximum number of tasks that are performed at the same time.
+     *        With a single worker, all tasks are performed on the calling thread
+     * \param onProgress Called with the combined progress of all tasks between 0 and 1.
+     *        The calls are never concurrent
+     * \return The number of tasks that were performed, skipped, and failed
+     *
+     * \pre \p nWorkers must be positive
+     */
+    Result run(unsigned int nWorkers, const Task::ProgressCallback& onProgress = {});
+
+    /**
+     * Returns whether all outputs of the \p task exist and none of its inputs is newer
+     * than any of its outputs. Tasks that do not have any outputs are never up to date.
+     */
+    static bool isUpToDate(const Task& task);
+
+private:
+    std::vector<std::unique_ptr<Task>> _tasks;
+
+    /// The indices of the tasks that depend on each task
+    std::vector<std::vector<size_t>> _dependents;
+
+    /// The number of tasks that each task depends on
+    std::vector<size_t> _nDependencies;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TASKSCHEDULER___H__
@@ -26,8 +26,9 @@
 #define __OPENSPACE_CORE___TIMELINE___H__
 
 #include <algorithm>
-#include <deque>
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace openspace {
 
@@ -56,7 +57,12 @@ struct Keyframe : public KeyframeBase {
 };
 
 /**
- * Templated class for timelines.
+ * Templated class for timelines. The keyframes are stored contiguously and sorted by
+ * their timestamp. The timeline remembers the position of the last lookup, which makes
+ * queries for monotonically increasing or decreasing timestamps, as they happen during
+ * playback, amortized constant time. Lookups that are far away from the previous one
+ * fall back to a logarithmic search. As the lookup position is updated by the const
+ * query functions, a timeline must not be queried from multiple threads concurrently.
  */
 template <typename T>
 class Timeline {
@@ -65,6 +71,16 @@ public:
 
     void addKeyframe(double time, const T& data);
     void addKeyframe(double time, T&& data);
+
+    /**
+     * Adds all of the provided \p keyframes, which consist of a timestamp and the data,
+     * to the timeline. This is equivalent to calling #addKeyframe for each of them in
+     * order, but only requires a single allocation and merge with the existing
+     * keyframes. The batch is expected to be sorted by timestamp; if it is not, it will
+     * be sorted first.
+     */
+    void addKeyframes(std::vector<std::pair<double, T>> keyframes);
+
     void clearKeyframes();
     void removeKeyframe(size_t id);
     void removeKeyframesBefore(double timestamp, bool inclusive = false);
@@ -75,11 +91,21 @@ public:
     const Keyframe<T>* firstKeyframeAfter(double timestamp, bool inclusive = false) const;
     const Keyframe<T>* lastKeyframeBefore(double timestamp, bool inclusive = false) const;
 
-    const std::deque<Keyframe<T>>& keyframes() const;
+    const std::vector<Keyframe<T>>& keyframes() const;
 
 private:
+    /**
+     * Returns the index of the first keyframe that is not before the \p timestamp. If
+     * \p inclusive is `true`, keyframes at the \p timestamp are not considered to be
+     * before it, which corresponds to a `lower_bound`, otherwise they are, which
+     * corresponds to an `upper_bound`. The search starts at the result of the previous
+     * lookup and expands exponentially from there.
+     */
+    size_t partitionIndex(double timestamp, bool inclusive) const;
+
     size_t _nextKeyframeId = 1;
-    std::deque<Keyframe<T>> _keyframes;
+    std::vector<Keyframe<T>> _keyframes;
+    mutable size_t _cursor = 0;
 };
 
 /**
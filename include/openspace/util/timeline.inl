@@ -33,6 +33,12 @@ Keyframe<T>::Keyframe(size_t i, double t, T d)
 template <typename T>
 void Timeline<T>::addKeyframe(double timestamp, T&& data) {
     Keyframe<T> keyframe(++_nextKeyframeId, timestamp, std::move(data));
+    // Keyframes are most commonly added to the end of the timeline
+    if (_keyframes.empty() || _keyframes.back().timestamp <= timestamp) {
+        _keyframes.push_back(std::move(keyframe));
+        return;
+    }
+
     const auto iter = std::upper_bound(
         _keyframes.cbegin(),
         _keyframes.cend(),
@@ -44,109 +50,126 @@ void Timeline<T>::addKeyframe(double timestamp, T&& data) {
 
 template <typename T>
 void Timeline<T>::addKeyframe(double timestamp, const T& data) {
-    Keyframe<T> keyframe(++_nextKeyframeId, timestamp, data);
-    const auto iter = std::upper_bound(
-        _keyframes.cbegin(),
-        _keyframes.cend(),
-        keyframe,
-        &compareKeyframeTimes
-    );
-    _keyframes.insert(iter, std::move(keyframe));
+    addKeyframe(timestamp, T(data));
 }
 
 template <typename T>
-void Timeline<T>::removeKeyframesAfter(double timestamp, bool inclusive) {
-    typename std::deque<Keyframe<T>>::const_iterator iter;
-    if (inclusive) {
-        iter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
+void Timeline<T>::addKeyframes(std::vector<std::pair<double, T>> keyframes) {
+    if (keyframes.empty()) {
+        return;
     }
-    else {
-        iter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
+
+    auto compareTimes = [](const std::pair<double, T>& a, const std::pair<double, T>& b) {
+        return a.first < b.first;
+    };
+    if (!std::is_sorted(keyframes.begin(), keyframes.end(), compareTimes)) {
+        std::stable_sort(keyframes.begin(), keyframes.end(), compareTimes);
+    }
+
+    const size_t nExisting = _keyframes.size();
+    _keyframes.reserve(nExisting + keyframes.size());
+    for (std::pair<double, T>& kf : keyframes) {
+        _keyframes.emplace_back(++_nextKeyframeId, kf.first, std::move(kf.second));
     }
 
-    _keyframes.erase(iter, _keyframes.end());
+    // The merge is stable, so new keyframes end up after existing keyframes with the
+    // same timestamp, just as they would when adding them one by one
+    const bool needsMerge = nExisting > 0 &&
+        _keyframes[nExisting].timestamp < _keyframes[nExisting - 1].timestamp;
+    if (needsMerge) {
+        std::inplace_merge(
+            _keyframes.begin(),
+            _keyframes.begin() + nExisting,
+            _keyframes.end(),
+            &compareKeyframeTimes
+        );
+    }
 }
 
 template <typename T>
-void Timeline<T>::removeKeyframesBefore(double timestamp, bool inclusive) {
-    typename std::deque<Keyframe<T>>::const_iterator iter;
-    if (inclusive) {
-        iter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
+size_t Timeline<T>::partitionIndex(double timestamp, bool inclusive) const {
+    auto isBefore = [timestamp, inclusive](const Keyframe<T>& keyframe) {
+        return inclusive ?
+            keyframe.timestamp < timestamp :
+            keyframe.timestamp <= timestamp;
+    };
+
+    const size_t n = _keyframes.size();
+    const size_t cursor = std::min(_cursor, n);
+
+    // The result is in the range [lo, hi]
+    size_t lo = 0;
+    size_t hi = n;
+    if (cursor < n && isBefore(_keyframes[cursor])) {
+        // Search forwards with exponentially increasing steps
+        lo = cursor + 1;
+        hi = lo;
+        size_t step = 1;
+        while (hi < n && isBefore(_keyframes[hi])) {
+            lo = hi + 1;
+            hi = lo + step;
+            step *= 2;
+        }
+        hi = std::min(hi, n);
     }
     else {
-        iter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
+        // The result is at or before the cursor. Search backwards with exponentially
+        // increasing steps
+        hi = cursor;
+        size_t step = 1;
+        while (hi > 0) {
+            if (hi <= step) {
+                lo = 0;
+                break;
+            }
+            const size_t probe = hi - step;
+            if (isBefore(_keyframes[probe])) {
+                lo = probe + 1;
+                break;
+            }
+            hi = probe;
+            step *= 2;
+        }
     }
 
-    _keyframes.erase(_keyframes.begin(), iter);
+    const auto it = std::partition_point(
+        _keyframes.begin() + lo,
+        _keyframes.begin() + hi,
+        isBefore
+    );
+    _cursor = static_cast<size_t>(std::distance(_keyframes.begin(), it));
+    return _cursor;
+}
+
+template <typename T>
+void Timeline<T>::removeKeyframesAfter(double timestamp, bool inclusive) {
+    // Inclusive removal keeps all keyframes before the timestamp, exclusive removal
+    // also keeps the keyframes at the timestamp
+    const size_t index = partitionIndex(timestamp, inclusive);
+    _keyframes.erase(_keyframes.begin() + index, _keyframes.end());
+}
+
+template <typename T>
+void Timeline<T>::removeKeyframesBefore(double timestamp, bool inclusive) {
+    const size_t index = partitionIndex(timestamp, !inclusive);
+    _keyframes.erase(_keyframes.begin(), _keyframes.begin() + index);
+    _cursor = 0;
 }
 
 template <typename T>
 void Timeline<T>::removeKeyframesBetween(double begin, double end, bool inclusiveBegin,
                                          bool inclusiveEnd)
 {
-    typename std::deque<Keyframe<T>>::const_iterator beginIter;
-    if (inclusiveBegin) {
-        beginIter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            begin,
-            &compareKeyframeTimeWithTime
-        );
-    }
-    else {
-        beginIter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            begin,
-            &compareTimeWithKeyframeTime
-        );
-    }
-
-
-    typename std::deque<Keyframe<T>>::const_iterator endIter;
-    if (inclusiveEnd) {
-        endIter = std::upper_bound(
-            beginIter,
-            _keyframes.cend(),
-            end,
-            &compareTimeWithKeyframeTime
-        );
-    }
-    else {
-        endIter = std::lower_bound(
-            beginIter,
-            _keyframes.cend(),
-            end,
-            &compareKeyframeTimeWithTime
-        );
-    }
-
-    _keyframes.erase(beginIter, endIter);
+    const size_t beginIndex = partitionIndex(begin, inclusiveBegin);
+    const size_t endIndex = std::max(partitionIndex(end, !inclusiveEnd), beginIndex);
+    _keyframes.erase(_keyframes.begin() + beginIndex, _keyframes.begin() + endIndex);
+    _cursor = beginIndex;
 }
 
 template <typename T>
 void Timeline<T>::clearKeyframes() {
     _keyframes.clear();
+    _cursor = 0;
 }
 
 template <typename T>
@@ -169,60 +192,25 @@ size_t Timeline<T>::nKeyframes() const {
 template <typename T>
 const Keyframe<T>* Timeline<T>::firstKeyframeAfter(double timestamp, bool inclusive) const
 {
-    typename std::deque<Keyframe<T>>::const_iterator it;
-    if (inclusive) {
-        it = std::lower_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
-    }
-    else {
-        it = std::upper_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
-    }
-
-    if (it == _keyframes.end()) {
+    const size_t index = partitionIndex(timestamp, inclusive);
+    if (index == _keyframes.size()) {
         return nullptr;
     }
-    return &(*it);
+    return &_keyframes[index];
 }
 
 template <typename T>
 const Keyframe<T>* Timeline<T>::lastKeyframeBefore(double timestamp, bool inclusive) const
 {
-    typename std::deque<Keyframe<T>>::const_iterator it;
-    if (inclusive) {
-        it = std::upper_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
-    }
-    else {
-        it = std::lower_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
-    }
-
-    if (it == _keyframes.begin()) {
+    const size_t index = partitionIndex(timestamp, !inclusive);
+    if (index == 0) {
         return nullptr;
     }
-    it--;
-    return &(*it);
+    return &_keyframes[index - 1];
 }
 
 template <typename T>
-const std::deque<Keyframe<T>>& Timeline<T>::keyframes() const {
+const std::vector<Keyframe<T>>& Timeline<T>::keyframes() const {
     return _keyframes;
 }
 
@@ -111,6 +111,7 @@ public:
     void interpolatePreviousDeltaTimeStep(double durationSeconds);
 
     void addKeyframe(double timestamp, TimeKeyframeData time);
+    void addKeyframes(std::vector<std::pair<double, TimeKeyframeData>> keyframes);
     void removeKeyframesBefore(double timestamp, bool inclusive = false);
     void removeKeyframesAfter(double timestamp, bool inclusive = false);
 
@@ -35,6 +35,8 @@
 #include <ghoul/misc/interpolator.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <iterator>
 #include <optional>
 
 namespace {
@@ -151,6 +153,13 @@ namespace {
         };
         // Initial settings for the interpolation.
         std::optional<Interpolation> interpolation;
+
+        // If true, only the steps of the dataset that are needed for the current
+        // interpolation value are kept in memory, and the next step is loaded in the
+        // background while interpolating. This makes it possible to use datasets with
+        // more steps than fit into memory. The steps are read from the cache file of
+        // the dataset, which is created the first time the dataset is used
+        std::optional<bool> streamData;
     };
 
 #include "renderableinterpolatedpoints_codegen.cpp"
@@ -269,6 +278,11 @@ RenderableInterpolatedPoints::RenderableInterpolatedPoints(
     }
 
     _interpolation.value.onChange([this]() {
+        const float value = _interpolation.value;
+        if (value != _prevInterpolationValue) {
+            _interpolationDirection = value > _prevInterpolationValue ? 1 : -1;
+        }
+
         bool passedAKnot =
             glm::ceil(_interpolation.value) != glm::ceil(_prevInterpolationValue);
 
@@ -284,6 +298,7 @@ RenderableInterpolatedPoints::RenderableInterpolatedPoints(
     });
 
     _nObjectsInDataset = static_cast<unsigned int>(p.numberOfObjects);
+    _streamData = p.streamData.value_or(_streamData);
 
     if (_skipFirstDataPoint) {
         LWARNING(
@@ -299,7 +314,8 @@ void RenderableInterpolatedPoints::initialize() {
 
     // At this point, the dataset has been loaded and we know how many data points it
     // contains => we can compute the number of interpolation steps
-    if (_nDataPoints % _nObjectsInDataset != 0) {
+    const uint64_t nEntries = _reader ? _reader->nEntries() : _nDataPoints.value();
+    if (nEntries % _nObjectsInDataset != 0) {
         LERROR(std::format(
             "Mismatch between provided number of data entries and the specified number "
             "of points. Expected the number of entries in the data file '{}' to be "
@@ -308,7 +324,10 @@ void RenderableInterpolatedPoints::initialize() {
     }
 
     if (_nObjectsInDataset > 0) {
-        _interpolation.nSteps = _nDataPoints / _nObjectsInDataset;
+        _interpolation.nSteps = static_cast<unsigned int>(nEntries / _nObjectsInDataset);
+    }
+    if (!_reader) {
+        _nResidentSteps = _interpolation.nSteps;
     }
     _interpolation.value.setMaxValue(static_cast<float>(_interpolation.nSteps - 1));
 
@@ -317,6 +336,27 @@ void RenderableInterpolatedPoints::initialize() {
     _nDataPoints = _nObjectsInDataset;
 }
 
+void RenderableInterpolatedPoints::loadDataset() {
+    if (!_streamData) {
+        RenderablePointCloud::loadDataset();
+        return;
+    }
+
+    const std::filesystem::path cached =
+        dataloader::data::cachedFile(_dataFile, _dataMapping);
+    _reader = std::make_unique<dataloader::data::CachedFileReader>(cached);
+
+    // Only load the first step for now. The steps that are needed for the current
+    // interpolation value are loaded before the data is used for rendering
+    _dataset = _reader->header();
+    _dataset.entries = _reader->readEntries(
+        0,
+        std::min<uint64_t>(_nObjectsInDataset, _reader->nEntries())
+    );
+    _firstResidentStep = 0;
+    _nResidentSteps = 1;
+}
+
 void RenderableInterpolatedPoints::initializeShadersAndGlExtras() {
     _program = BaseModule::ProgramObjectManager.request(
         "RenderablePointCloud_Interpolated",
@@ -372,13 +412,15 @@ int RenderableInterpolatedPoints::nAttributesPerPoint() const {
         // Use one more orientation quaternion (wxyz)
         n += 4;
     }
-    // And potentially some more color and size data
-    n += hasColorData() ? 1 : 0;
-    n += hasSizeData() ? 1 : 0;
 
     return n;
 }
 
+int RenderableInterpolatedPoints::nColorAndSizeAttributesPerPoint() const {
+    // One color and size value for each of the two interpolated steps
+    return 2 * RenderablePointCloud::nColorAndSizeAttributesPerPoint();
+}
+
 bool RenderableInterpolatedPoints::useSplineInterpolation() const {
     return _interpolation.useSpline && _interpolation.nSteps > 1;
 }
@@ -390,8 +432,8 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
     using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
 
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
+    const Dataset::Entry& e0 = entry(firstIndex);
+    const Dataset::Entry& e1 = entry(secondIndex);
 
     glm::dvec3 position0 = transformedPosition(e0);
     glm::dvec3 position1 = transformedPosition(e1);
@@ -418,8 +460,8 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
             maxAllowedindex
         );
 
-        const Dataset::Entry& e00 = _dataset.entries[beforeIndex];
-        const Dataset::Entry& e11 = _dataset.entries[afterIndex];
+        const Dataset::Entry& e00 = entry(beforeIndex);
+        const Dataset::Entry& e11 = entry(afterIndex);
         glm::dvec3 positionBefore = transformedPosition(e00);
         glm::dvec3 positionAfter = transformedPosition(e11);
 
@@ -438,8 +480,8 @@ void RenderableInterpolatedPoints::addColorAndSizeDataForPoint(unsigned int inde
 {
     using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
+    const Dataset::Entry& e0 = entry(firstIndex);
+    const Dataset::Entry& e1 = entry(secondIndex);
 
     if (hasColorData()) {
         const int colorParamIndex = currentColorParameterIndex();
@@ -465,8 +507,8 @@ void RenderableInterpolatedPoints::addOrientationDataForPoint(unsigned int index
 {
     using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
+    const Dataset::Entry& e0 = entry(firstIndex);
+    const Dataset::Entry& e1 = entry(secondIndex);
 
     glm::quat q0 = orientationQuaternion(e0);
     glm::quat q1 = orientationQuaternion(e1);
@@ -491,6 +533,12 @@ void RenderableInterpolatedPoints::initializeBufferData() {
         glGenBuffers(1, &_vbo);
         LDEBUG(std::format("Generating Vertex Buffer Object id '{}'", _vbo));
     }
+    if (_colorAndSizeVbo == 0) {
+        glGenBuffers(1, &_colorAndSizeVbo);
+        LDEBUG(std::format(
+            "Generating Color and Size Vertex Buffer Object id '{}'", _colorAndSizeVbo
+        ));
+    }
 
     const int attibsPerPoint = nAttributesPerPoint();
     const unsigned int bufferSize = attibsPerPoint * _nDataPoints * sizeof(float);
@@ -510,16 +558,6 @@ void RenderableInterpolatedPoints::initializeBufferData() {
         offset = bufferVertexAttribute("in_position_after", 3, attibsPerPoint, offset);
     }
 
-    if (hasColorData()) {
-        offset = bufferVertexAttribute("in_colorParameter0", 1, attibsPerPoint, offset);
-        offset = bufferVertexAttribute("in_colorParameter1", 1, attibsPerPoint, offset);
-    }
-
-    if (hasSizeData()) {
-        offset = bufferVertexAttribute("in_scalingParameter0", 1, attibsPerPoint, offset);
-        offset = bufferVertexAttribute("in_scalingParameter1", 1, attibsPerPoint, offset);
-    }
-
     if (useOrientationData()) {
         offset = bufferVertexAttribute("in_orientation0", 4, attibsPerPoint, offset);
         offset = bufferVertexAttribute("in_orientation1", 4, attibsPerPoint, offset);
@@ -529,6 +567,27 @@ void RenderableInterpolatedPoints::initializeBufferData() {
         offset = bufferVertexAttribute("in_textureLayer", 1, attibsPerPoint, offset);
     }
 
+    const int nColorAndSize = nColorAndSizeAttributesPerPoint();
+    glBindBuffer(GL_ARRAY_BUFFER, _colorAndSizeVbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        nColorAndSize * _nDataPoints * sizeof(float),
+        nullptr,
+        GL_DYNAMIC_DRAW
+    );
+
+    offset = 0;
+
+    if (hasColorData()) {
+        offset = bufferVertexAttribute("in_colorParameter0", 1, nColorAndSize, offset);
+        offset = bufferVertexAttribute("in_colorParameter1", 1, nColorAndSize, offset);
+    }
+
+    if (hasSizeData()) {
+        offset = bufferVertexAttribute("in_scalingParameter0", 1, nColorAndSize, offset);
+        offset = bufferVertexAttribute("in_scalingParameter1", 1, nColorAndSize, offset);
+    }
+
     glBindVertexArray(0);
 }
 
@@ -541,16 +600,108 @@ void RenderableInterpolatedPoints::updateBufferData() {
     TracyGpuZone("Data dirty");
     LDEBUG("Regenerating data");
 
+    if (_streamData) {
+        updateResidentSteps();
+    }
+
     // Regenerate data and update buffer
-    std::vector<float> slice = createDataSlice();
+    createDataSlice();
 
     glBindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, slice.size() * sizeof(float), slice.data());
+    glBufferSubData(GL_ARRAY_BUFFER, 0, _slice.size() * sizeof(float), _slice.data());
+    glBindBuffer(GL_ARRAY_BUFFER, _colorAndSizeVbo);
+    glBufferSubData(
+        GL_ARRAY_BUFFER,
+        0,
+        _colorAndSizeSlice.size() * sizeof(float),
+        _colorAndSizeSlice.data()
+    );
 
     glBindVertexArray(0);
 
     _dataIsDirty = false;
+    _colorAndSizeDataIsDirty = false;
+}
+
+const dataloader::Dataset::Entry& RenderableInterpolatedPoints::entry(size_t index) const
+{
+    const size_t firstIndex =
+        static_cast<size_t>(_firstResidentStep) * _nObjectsInDataset;
+    ghoul_assert(
+        index >= firstIndex && index - firstIndex < _dataset.entries.size(),
+        "Step of the entry is not loaded"
+    );
+    return _dataset.entries[index - firstIndex];
+}
+
+void RenderableInterpolatedPoints::updateResidentSteps() {
+    ZoneScoped;
+
+    using Entry = dataloader::Dataset::Entry;
+
+    const unsigned int nObjects = _nObjectsInDataset;
+    const unsigned int nSteps = _interpolation.nSteps;
+    const unsigned int t0 = static_cast<unsigned int>(computeCurrentLowerValue());
+    const unsigned int t1 = static_cast<unsigned int>(computeCurrentUpperValue());
+
+    // The spline interpolation also needs the steps before and after the current ones
+    const bool useSpline = useSplineInterpolation();
+    const unsigned int first = (useSpline && t0 > 0) ? t0 - 1 : t0;
+    const unsigned int last = useSpline ? std::min(t1 + 1, nSteps - 1) : t1;
+
+    const unsigned int residentEnd = _firstResidentStep + _nResidentSteps;
+    if (first != _firstResidentStep || last + 1 != residentEnd) {
+        std::vector<Entry> entries;
+        entries.reserve(static_cast<size_t>(last - first + 1) * nObjects);
+        for (unsigned int step = first; step <= last; step++) {
+            if (step >= _firstResidentStep && step < residentEnd) {
+                // Steps that are already loaded can be reused
+                auto begin = _dataset.entries.begin() +
+                    static_cast<size_t>(step - _firstResidentStep) * nObjects;
+                std::move(begin, begin + nObjects, std::back_inserter(entries));
+            }
+            else if (_prefetchedStep.has_value() && _prefetchedStep->step == step) {
+                std::vector<Entry> e = _prefetchedStep->entries.get();
+                _prefetchedStep = std::nullopt;
+                std::move(e.begin(), e.end(), std::back_inserter(entries));
+            }
+            else {
+                std::vector<Entry> e = _reader->readEntries(
+                    static_cast<uint64_t>(step) * nObjects,
+                    nObjects
+                );
+                std::move(e.begin(), e.end(), std::back_inserter(entries));
+            }
+        }
+        _dataset.entries = std::move(entries);
+        _firstResidentStep = first;
+        _nResidentSteps = last - first + 1;
+    }
+
+    // Start loading the step that will be needed next if the interpolation continues in
+    // the same direction. A previous prefetch that was not used is discarded
+    const int next = _interpolationDirection > 0 ?
+        static_cast<int>(last) + 1 :
+        static_cast<int>(first) - 1;
+    if (next < 0 || next >= static_cast<int>(nSteps)) {
+        return;
+    }
+
+    const unsigned int step = static_cast<unsigned int>(next);
+    if (_prefetchedStep.has_value() && _prefetchedStep->step == step) {
+        return;
+    }
+    _prefetchedStep = PrefetchedStep {
+        .step = step,
+        .entries = std::async(
+            std::launch::async,
+            [reader = _reader.get(), step, nObjects]() {
+                const uint64_t firstEntry = static_cast<uint64_t>(step) * nObjects;
+                return reader->readEntries(firstEntry, nObjects);
+            }
+        )
+    };
 }
 
 bool RenderableInterpolatedPoints::isAtKnot() const {
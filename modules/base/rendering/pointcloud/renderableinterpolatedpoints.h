@@ -31,6 +31,9 @@
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/uintproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <future>
+#include <memory>
+#include <optional>
 
 namespace ghoul::opengl { class Texture; }
 
@@ -51,12 +54,14 @@ public:
 
 protected:
     void initialize() override;
+    void loadDataset() override;
     void initializeShadersAndGlExtras() override;
     void deinitializeShaders() override;
     void setExtraUniforms() override;
     void preUpdate() override;
 
     int nAttributesPerPoint() const override;
+    int nColorAndSizeAttributesPerPoint() const override;
 
     bool useSplineInterpolation() const;
 
@@ -89,6 +94,19 @@ protected:
     void updateBufferData() override;
 
 private:
+    /**
+     * Returns the entry with the provided \p index in the full dataset, where the
+     * entries of each step follow the entries of the previous step.
+     */
+    const dataloader::Dataset::Entry& entry(size_t index) const;
+
+    /**
+     * Loads the steps that are needed for the current interpolation value into
+     * `_dataset` if the data is streamed, and starts loading the step that will be
+     * needed next on a worker thread.
+     */
+    void updateResidentSteps();
+
     bool isAtKnot() const;
     float computeCurrentLowerValue() const;
     float computeCurrentUpperValue() const;
@@ -115,6 +133,26 @@ private:
     bool _shouldReinitializeBufferdata = false;
 
     unsigned int _nObjectsInDataset = 0;
+
+    /// If true, only the steps that are needed for the current interpolation are kept
+    /// in `_dataset` and the remaining steps are read from the cache file on demand
+    bool _streamData = false;
+    /// The direction in which the interpolation value changed most recently
+    int _interpolationDirection = 1;
+    std::unique_ptr<dataloader::data::CachedFileReader> _reader;
+
+    /// The first step that is stored in `_dataset`. If the data is not streamed, this
+    /// is always 0 and `_dataset` contains all of the steps
+    unsigned int _firstResidentStep = 0;
+    /// The number of steps that are stored in `_dataset`
+    unsigned int _nResidentSteps = 0;
+
+    /// The step that is currently being loaded on a worker thread
+    struct PrefetchedStep {
+        unsigned int step;
+        std::future<std::vector<dataloader::Dataset::Entry>> entries;
+    };
+    std::optional<PrefetchedStep> _prefetchedStep;
 };
 
 } // namespace openspace
@@ -28,6 +28,7 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/util/parallelfor.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/filesystem/file.h>
@@ -35,6 +36,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/crc32.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/misc/profiling.h>
@@ -46,12 +48,14 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/vector_angle.hpp>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <locale>
+#include <numeric>
 #include <optional>
 #include <string>
 
@@ -70,6 +74,10 @@ namespace {
         Bottom
     };
 
+    // Point clouds with fewer points than this per thread are processed on fewer
+    // threads, as the cost of handing work to another thread would outweigh the work
+    constexpr size_t MinPointsPerRange = 4096;
+
     constexpr openspace::properties::Property::PropertyInfo TextureEnabledInfo = {
         "Enabled",
         "Enabled",
@@ -732,9 +740,11 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
 
     if (_sizeSettings.sizeMapping != nullptr) {
         _sizeSettings.sizeMapping->parameterOption.onChange(
-            [this]() { _dataIsDirty = true; }
+            [this]() { _colorAndSizeDataIsDirty = true; }
+        );
+        _sizeSettings.sizeMapping->isRadius.onChange(
+            [this]() { _colorAndSizeDataIsDirty = true; }
         );
-        _sizeSettings.sizeMapping->isRadius.onChange([this]() { _dataIsDirty = true; });
         _hasDatavarSize = true;
     }
 
@@ -749,7 +759,7 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
         _hasColorMapFile = true;
 
         _colorSettings.colorMapping->dataColumn.onChange(
-            [this]() { _dataIsDirty = true; }
+            [this]() { _colorAndSizeDataIsDirty = true; }
         );
 
         _colorSettings.colorMapping->setRangeFromData.onChange([this]() {
@@ -760,7 +770,7 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
         });
 
         _colorSettings.colorMapping->colorMapFile.onChange([this]() {
-            _dataIsDirty = true;
+            _colorAndSizeDataIsDirty = true;
             _hasColorMapFile = std::filesystem::exists(
                 _colorSettings.colorMapping->colorMapFile.value()
             );
@@ -821,16 +831,7 @@ void RenderablePointCloud::initialize() {
     }
 
     if (_hasDataFile) {
-        if (_useCaching) {
-            _dataset = dataloader::data::loadFileWithCache(_dataFile, _dataMapping);
-        }
-        else {
-            _dataset = dataloader::data::loadFile(_dataFile, _dataMapping);
-        }
-
-        if (_skipFirstDataPoint) {
-            _dataset.entries.erase(_dataset.entries.begin());
-        }
+        loadDataset();
 
         _nDataPoints = static_cast<unsigned int>(_dataset.entries.size());
         _hasOrientationData = _dataset.orientationDataIndex >= 0;
@@ -860,6 +861,19 @@ void RenderablePointCloud::initialize() {
     }
 }
 
+void RenderablePointCloud::loadDataset() {
+    if (_useCaching) {
+        _dataset = dataloader::data::loadFileWithCache(_dataFile, _dataMapping);
+    }
+    else {
+        _dataset = dataloader::data::loadFile(_dataFile, _dataMapping);
+    }
+
+    if (_skipFirstDataPoint) {
+        _dataset.entries.erase(_dataset.entries.begin());
+    }
+}
+
 void RenderablePointCloud::initializeGL() {
     ZoneScoped;
 
@@ -887,6 +901,8 @@ void RenderablePointCloud::initializeGL() {
 void RenderablePointCloud::deinitializeGL() {
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
+    glDeleteBuffers(1, &_colorAndSizeVbo);
+    _colorAndSizeVbo = 0;
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
@@ -1381,6 +1397,9 @@ void RenderablePointCloud::update(const UpdateData&) {
     if (_dataIsDirty) {
         updateBufferData();
     }
+    else if (_colorAndSizeDataIsDirty) {
+        updateColorAndSizeBufferData();
+    }
 }
 
 glm::dvec3 RenderablePointCloud::transformedPosition(
@@ -1434,13 +1453,17 @@ glm::quat RenderablePointCloud::orientationQuaternion(
 
 int RenderablePointCloud::nAttributesPerPoint() const {
     int n = 3; // position
-    n += hasColorData() ? 1 : 0;
-    n += hasSizeData() ? 1 : 0;
     n += useOrientationData() ? 4 : 0;
     n += _hasSpriteTexture ? 1 : 0; // texture id
     return n;
 }
 
+int RenderablePointCloud::nColorAndSizeAttributesPerPoint() const {
+    int n = hasColorData() ? 1 : 0;
+    n += hasSizeData() ? 1 : 0;
+    return n;
+}
+
 int RenderablePointCloud::bufferVertexAttribute(const std::string& name, GLint nValues,
                                                 int nAttributesPerPoint, int offset) const
 {
@@ -1458,6 +1481,13 @@ int RenderablePointCloud::bufferVertexAttribute(const std::string& name, GLint n
     return offset + nValues;
 }
 
+void RenderablePointCloud::disableVertexAttribute(const std::string& name) const {
+    const GLint attrib = _program->attributeLocation(name);
+    if (attrib >= 0) {
+        glDisableVertexAttribArray(attrib);
+    }
+}
+
 void RenderablePointCloud::updateBufferData() {
     if (!_hasDataFile || _dataset.entries.empty()) {
         return;
@@ -1467,9 +1497,7 @@ void RenderablePointCloud::updateBufferData() {
     TracyGpuZone("Data dirty");
     LDEBUG("Regenerating data");
 
-    std::vector<float> slice = createDataSlice();
-
-    int size = static_cast<int>(slice.size());
+    createDataSlice();
 
     if (_vao == 0) {
         glGenVertexArrays(1, &_vao);
@@ -1479,24 +1507,27 @@ void RenderablePointCloud::updateBufferData() {
         glGenBuffers(1, &_vbo);
         LDEBUG(std::format("Generating Vertex Buffer Object id '{}'", _vbo));
     }
+    if (_colorAndSizeVbo == 0) {
+        glGenBuffers(1, &_colorAndSizeVbo);
+        LDEBUG(std::format(
+            "Generating Color and Size Vertex Buffer Object id '{}'", _colorAndSizeVbo
+        ));
+    }
 
     glBindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, size * sizeof(float), slice.data(), GL_STATIC_DRAW);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _slice.size() * sizeof(float),
+        _slice.data(),
+        GL_STATIC_DRAW
+    );
 
     const int attibsPerPoint = nAttributesPerPoint();
     int offset = 0;
 
     offset = bufferVertexAttribute("in_position", 3, attibsPerPoint, offset);
 
-    if (hasColorData()) {
-        offset = bufferVertexAttribute("in_colorParameter", 1, attibsPerPoint, offset);
-    }
-
-    if (hasSizeData()) {
-        offset = bufferVertexAttribute("in_scalingParameter", 1, attibsPerPoint, offset);
-    }
-
     if (useOrientationData()) {
         offset = bufferVertexAttribute("in_orientation", 4, attibsPerPoint, offset);
     }
@@ -1505,9 +1536,100 @@ void RenderablePointCloud::updateBufferData() {
         offset = bufferVertexAttribute("in_textureLayer", 1, attibsPerPoint, offset);
     }
 
+    // The color and size values are kept in a separate buffer, so that changing them
+    // does not require uploading the positions and orientations again
+    glBindBuffer(GL_ARRAY_BUFFER, _colorAndSizeVbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _colorAndSizeSlice.size() * sizeof(float),
+        _colorAndSizeSlice.data(),
+        GL_DYNAMIC_DRAW
+    );
+
+    const int colorAndSizeAttribsPerPoint = nColorAndSizeAttributesPerPoint();
+    offset = 0;
+
+    if (hasColorData()) {
+        offset = bufferVertexAttribute(
+            "in_colorParameter",
+            1,
+            colorAndSizeAttribsPerPoint,
+            offset
+        );
+    }
+    else {
+        disableVertexAttribute("in_colorParameter");
+    }
+
+    if (hasSizeData()) {
+        offset = bufferVertexAttribute(
+            "in_scalingParameter",
+            1,
+            colorAndSizeAttribsPerPoint,
+            offset
+        );
+    }
+    else {
+        disableVertexAttribute("in_scalingParameter");
+    }
+
     glBindVertexArray(0);
 
     _dataIsDirty = false;
+    _colorAndSizeDataIsDirty = false;
+}
+
+void RenderablePointCloud::updateColorAndSizeBufferData() {
+    if (!_hasDataFile || _dataset.entries.empty()) {
+        return;
+    }
+
+    const size_t nValues =
+        static_cast<size_t>(nColorAndSizeAttributesPerPoint()) * _sliceOrder.size();
+    const bool layoutChanged =
+        _colorAndSizeSlice.size() != nValues ||
+        _sliceLayout.hasColorData != hasColorData() ||
+        _sliceLayout.hasSizeData != hasSizeData();
+    if (layoutChanged) {
+        // Adding or removing attributes changes which vertex attributes are used
+        updateBufferData();
+        return;
+    }
+
+    ZoneScopedN("Color and size dirty");
+    TracyGpuZone("Color and size dirty");
+    LDEBUG("Regenerating color and size data");
+
+    const size_t nAttributes = nColorAndSizeAttributesPerPoint();
+    const size_t nPoints = _sliceOrder.size();
+    parallelForRanges(
+        nPoints,
+        parallelRangeCount(nPoints, MinPointsPerRange),
+        [&](size_t, size_t begin, size_t end) {
+            std::vector<float> values;
+            values.reserve(nAttributes);
+            for (size_t i = begin; i < end; i++) {
+                values.clear();
+                addColorAndSizeDataForPoint(_sliceOrder[i], values);
+                std::copy(
+                    values.begin(),
+                    values.end(),
+                    _colorAndSizeSlice.begin() + i * nAttributes
+                );
+            }
+        }
+    );
+
+    glBindBuffer(GL_ARRAY_BUFFER, _colorAndSizeVbo);
+    glBufferSubData(
+        GL_ARRAY_BUFFER,
+        0,
+        _colorAndSizeSlice.size() * sizeof(float),
+        _colorAndSizeSlice.data()
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _colorAndSizeDataIsDirty = false;
 }
 
 void RenderablePointCloud::updateSpriteTexture() {
@@ -1643,82 +1765,124 @@ void RenderablePointCloud::addOrientationDataForPoint(unsigned int index,
     result.push_back(q.w);
 }
 
-std::vector<float> RenderablePointCloud::createDataSlice() {
+void RenderablePointCloud::createDataSlice() {
     ZoneScoped;
 
-    if (_dataset.entries.empty()) {
-        return std::vector<float>();
-    }
-
-    double maxRadius = 0.0;
-
-    // One sub-array per texture array, since each of these will correspond to a separate
-    // draw call. We need at least one sub result array
-    std::vector<std::vector<float>> subResults = std::vector<std::vector<float>>(
-        !_textureArrays.empty() ? _textureArrays.size() : 1
-    );
+    _slice.clear();
+    _colorAndSizeSlice.clear();
+    _sliceOrder.clear();
 
-    // Reserve enough space for all points in each for now
-    for (std::vector<float>& subres : subResults) {
-        subres.reserve(nAttributesPerPoint() * _dataset.entries.size());
+    if (_dataset.entries.empty() || _nDataPoints == 0) {
+        return;
     }
 
-    for (unsigned int i = 0; i < _nDataPoints; i++) {
-        const dataloader::Dataset::Entry& e = _dataset.entries[i];
-
-        unsigned int subresultIndex = 0;
-        // Default texture layer for single texture is zero
-        float textureLayer = 0.f;
-
-        bool useMultiTexture = (_textureMode == TextureInputMode::Multi) &&
-            hasMultiTextureData();
-
+    const unsigned int nPoints = _nDataPoints;
+    const int nAttributes = nAttributesPerPoint();
+    const int nColorAndSizeAttributes = nColorAndSizeAttributesPerPoint();
+    const bool useOrientation = useOrientationData();
+    const bool useMultiTexture =
+        (_textureMode == TextureInputMode::Multi) && hasMultiTextureData();
+
+    // One range of points per texture array, since each of these will correspond to a
+    // separate draw call. We need at least one range
+    const size_t nTextureRanges = !_textureArrays.empty() ? _textureArrays.size() : 1;
+
+    // Find the texture array and layer of each point. This has to happen before the
+    // points are processed in parallel, as the lookup tables are modified on access
+    std::vector<unsigned int> arrayIndices(nPoints, 0);
+    // Default texture layer for single texture is zero
+    std::vector<float> textureLayers(nPoints, 0.f);
+    std::vector<size_t> nPointsPerRange(nTextureRanges, 0);
+    for (unsigned int i = 0; i < nPoints; i++) {
         if (useMultiTexture) {
-            int texId = static_cast<int>(e.data[_dataset.textureDataIndex]);
-            size_t texIndex = _indexInDataToTextureIndex[texId];
-            textureLayer = static_cast<float>(
+            const dataloader::Dataset::Entry& e = _dataset.entries[i];
+            const int texId = static_cast<int>(e.data[_dataset.textureDataIndex]);
+            const size_t texIndex = _indexInDataToTextureIndex[texId];
+            textureLayers[i] = static_cast<float>(
                 _textureIndexToArrayMap[texIndex].layer
             );
-            subresultIndex = _textureIndexToArrayMap[texIndex].arrayId;
+            arrayIndices[i] = _textureIndexToArrayMap[texIndex].arrayId;
         }
+        nPointsPerRange[arrayIndices[i]]++;
+    }
 
-        std::vector<float>& subArrayToUse = subResults[subresultIndex];
-
-        // Add position, color and size data (subclasses may compute these differently)
-        addPositionDataForPoint(i, subArrayToUse, maxRadius);
-        addColorAndSizeDataForPoint(i, subArrayToUse);
+    // Group the points by their texture array while keeping their relative order
+    std::vector<size_t> rangeOffsets(nTextureRanges, 0);
+    std::exclusive_scan(
+        nPointsPerRange.begin(),
+        nPointsPerRange.end(),
+        rangeOffsets.begin(),
+        size_t(0)
+    );
+    _sliceOrder.resize(nPoints);
+    std::vector<size_t> next = rangeOffsets;
+    for (unsigned int i = 0; i < nPoints; i++) {
+        _sliceOrder[next[arrayIndices[i]]++] = i;
+    }
 
-        if (useOrientationData()) {
-            addOrientationDataForPoint(i, subArrayToUse);
-        }
+    _sliceLayout = {
+        .hasColorData = hasColorData(),
+        .hasSizeData = hasSizeData()
+    };
 
-        // Texture layer
-        if (_hasSpriteTexture) {
-            subArrayToUse.push_back(static_cast<float>(textureLayer));
+    _slice.resize(static_cast<size_t>(nAttributes) * nPoints);
+    _colorAndSizeSlice.resize(static_cast<size_t>(nColorAndSizeAttributes) * nPoints);
+    const size_t nWorkRanges = parallelRangeCount(nPoints, MinPointsPerRange);
+    std::vector<double> maxRadii(nWorkRanges, 0.0);
+    parallelForRanges(
+        nPoints,
+        nWorkRanges,
+        [&](size_t range, size_t begin, size_t end) {
+            std::vector<float> v;
+            v.reserve(nAttributes);
+            std::vector<float> colorAndSize;
+            colorAndSize.reserve(nColorAndSizeAttributes);
+            for (size_t i = begin; i < end; i++) {
+                const unsigned int index = _sliceOrder[i];
+                v.clear();
+                colorAndSize.clear();
+
+                // Add position, color and size data (subclasses may compute these
+                // differently)
+                addPositionDataForPoint(index, v, maxRadii[range]);
+                addColorAndSizeDataForPoint(index, colorAndSize);
+
+                if (useOrientation) {
+                    addOrientationDataForPoint(index, v);
+                }
+
+                // Texture layer
+                if (_hasSpriteTexture) {
+                    v.push_back(textureLayers[index]);
+                }
+
+                ghoul_assert(
+                    v.size() == static_cast<size_t>(nAttributes),
+                    "Wrong number of attributes for point"
+                );
+                ghoul_assert(
+                    colorAndSize.size() == static_cast<size_t>(nColorAndSizeAttributes),
+                    "Wrong number of color and size attributes for point"
+                );
+                std::copy(v.begin(), v.end(), _slice.begin() + i * nAttributes);
+                std::copy(
+                    colorAndSize.begin(),
+                    colorAndSize.end(),
+                    _colorAndSizeSlice.begin() + i * nColorAndSizeAttributes
+                );
+            }
         }
-    }
-
-    for (std::vector<float>& subres : subResults) {
-        subres.shrink_to_fit();
-    }
+    );
 
-    // Combine subresults, which should be in same order as texture arrays
-    std::vector<float> result;
-    result.reserve(nAttributesPerPoint() * _dataset.entries.size());
-    size_t vertexCount = 0;
-    for (size_t i = 0; i < subResults.size(); ++i) {
-        result.insert(result.end(), subResults[i].begin(), subResults[i].end());
-        int nVertices = static_cast<int>(subResults[i].size()) / nAttributesPerPoint();
-        if (!_textureArrays.empty()) {
-            _textureArrays[i].nPoints = nVertices;
-            _textureArrays[i].startOffset = static_cast<GLint>(vertexCount);
+    // The texture ranges are in the same order as the texture arrays
+    if (!_textureArrays.empty()) {
+        for (size_t i = 0; i < _textureArrays.size(); i++) {
+            _textureArrays[i].nPoints = static_cast<int>(nPointsPerRange[i]);
+            _textureArrays[i].startOffset = static_cast<GLint>(rangeOffsets[i]);
         }
-        vertexCount += nVertices;
     }
-    result.shrink_to_fit();
 
-    setBoundingSphere(maxRadius);
-    return result;
+    setBoundingSphere(*std::max_element(maxRadii.begin(), maxRadii.end()));
 }
 
 
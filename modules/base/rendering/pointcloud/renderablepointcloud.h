@@ -92,6 +92,9 @@ protected:
         Other // For subclasses that need to handle their own texture
     };
 
+    /// Loads the contents of the data file into `_dataset`
+    virtual void loadDataset();
+
     virtual void initializeShadersAndGlExtras();
     virtual void deinitializeShaders();
     virtual void setExtraUniforms();
@@ -100,7 +103,10 @@ protected:
     glm::dvec3 transformedPosition(const dataloader::Dataset::Entry& e) const;
     glm::quat orientationQuaternion(const dataloader::Dataset::Entry& e) const;
 
+    /// The number of values per point in `_slice`, which excludes the color and size
     virtual int nAttributesPerPoint() const;
+    /// The number of values per point in `_colorAndSizeSlice`
+    virtual int nColorAndSizeAttributesPerPoint() const;
 
     /**
      * Helper function to buffer the vertex attribute with the given name and number
@@ -111,7 +117,20 @@ protected:
     int bufferVertexAttribute(const std::string& name, GLint nValues,
         int nAttributesPerPoint, int offset) const;
 
+    /// Disables the vertex attribute with the given name, if the program uses it
+    void disableVertexAttribute(const std::string& name) const;
+
     virtual void updateBufferData();
+
+    /**
+     * Recomputes only the color and size values of the previously created data slice
+     * and uploads them to their separate vertex buffer, which avoids recomputing and
+     * uploading the positions and orientations of all points if only the color or size
+     * parameters changed. If color or size values were added or removed as a result,
+     * all vertex data is regenerated instead.
+     */
+    void updateColorAndSizeBufferData();
+
     void updateSpriteTexture();
 
     /// Find the index of the currently chosen color parameter in the dataset
@@ -131,7 +150,14 @@ protected:
     virtual void addOrientationDataForPoint(unsigned int index,
         std::vector<float>& result) const;
 
-    std::vector<float> createDataSlice();
+    /**
+     * Creates the interleaved vertex data for all points and stores it in `_slice`,
+     * except for the color and size values, which are stored in `_colorAndSizeSlice`.
+     * The points are grouped by the texture array that they use and are processed in
+     * parallel, which requires the `add...DataForPoint` functions to be safe to call
+     * concurrently.
+     */
+    void createDataSlice();
 
     /**
      * A function that subclasses could override to initialize their own textures to
@@ -161,6 +187,7 @@ protected:
     ghoul::opengl::Texture::Format glFormat(bool useAlpha) const;
 
     bool _dataIsDirty = true;
+    bool _colorAndSizeDataIsDirty = false;
     bool _spriteTextureIsDirty = false;
     bool _cmapIsDirty = true;
 
@@ -254,6 +281,21 @@ protected:
 
     GLuint _vao = 0;
     GLuint _vbo = 0;
+    GLuint _colorAndSizeVbo = 0;
+
+    /// The interleaved vertex data that was created by the last call to createDataSlice
+    std::vector<float> _slice;
+    /// The interleaved color and size values, in the same point order as `_slice`
+    std::vector<float> _colorAndSizeSlice;
+    /// The index of the dataset entry that corresponds to each point in `_slice`
+    std::vector<unsigned int> _sliceOrder;
+
+    /// Which of the color and size values are stored in `_colorAndSizeSlice`
+    struct SliceLayout {
+        bool hasColorData = false;
+        bool hasSizeData = false;
+    };
+    SliceLayout _sliceLayout;
 
     // List of (unique) loaded textures. The other maps refer to the index in this vector
     std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
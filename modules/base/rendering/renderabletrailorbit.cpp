@@ -24,11 +24,13 @@
 
 #include <modules/base/rendering/renderabletrailorbit.h>
 
+#include <openspace/camera/camera.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/globals.h>
+#include <openspace/navigation/navigationhandler.h>
 #include <openspace/events/event.h>
 #include <openspace/events/eventengine.h>
 #include <openspace/rendering/renderengine.h>
@@ -36,7 +38,11 @@
 #include <openspace/scene/scene.h>
 
 #include <ghoul/opengl/programobject.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <numeric>
+#include <vector>
 #include <optional>
 
 // This class is using a VBO ring buffer + a constantly updated point as follows:
@@ -83,6 +89,13 @@
 // 10 11 12 13 14 15 00 01 02 03 04 05 06 07 08 09
 //
 //
+// If adaptive sampling is enabled, the fixed points are not equally spaced in time, but
+// the time stamp of each entry is stored in _pointTimes instead. As the trail covers
+// exactly one period, a fixed point that is removed from one end is replaced by a point
+// that is exactly one period away from it on the other end, which preserves the adaptive
+// placement without resampling the orbit. The ring buffer is manipulated the same way
+// as in the uniform case.
+//
 // NB: This method was implemented without a ring buffer before by manually shifting the
 // items in memory as was shown to be much slower than the current system.   ---abock
 
@@ -107,12 +120,160 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AdaptiveSamplingInfo = {
+        "AdaptiveSampling",
+        "Adaptive sampling",
+        "If this value is enabled, the samples along the orbit are not placed uniformly "
+        "in time, but such that the rendered trail deviates from the true path by less "
+        "than the sampling error. This places more samples in highly curved parts of "
+        "the orbit, for example close to the periapsis of an eccentric orbit, and fewer "
+        "samples elsewhere. In this case, the resolution is the maximum number of "
+        "samples that are used.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SamplingErrorInfo = {
+        "SamplingError",
+        "Sampling error (in degrees)",
+        "The maximum angle (in degrees) by which the trail is allowed to deviate from "
+        "the true path when seen from the camera if adaptive sampling is enabled. The "
+        "samples are recomputed if the distance between the camera and the trail "
+        "changes significantly.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    // The initial number of uniform segments that are refined by the adaptive sampling
+    constexpr int InitialSegments = 32;
+    // Segments that are shorter than this fraction of the period are never split
+    constexpr double MinSegmentFraction = 1e-9;
+    // For a camera that is inside the bounding sphere of the trail, the closest point of
+    // the trail can be arbitrarily close, so we limit the distance to a fraction of the
+    // bounding sphere to keep the number of samples reasonable
+    constexpr double MinDistanceFraction = 0.01;
+    // If the distance to the camera changes by more than this factor, the adaptive
+    // samples are recomputed
+    constexpr double ResampleDistanceFactor = 2.0;
+
+    struct Sample {
+        double time;
+        glm::dvec3 position;
+    };
+
+    double distanceToSegment(const glm::dvec3& p, const glm::dvec3& a,
+                             const glm::dvec3& b)
+    {
+        const glm::dvec3 ab = b - a;
+        const double length2 = glm::dot(ab, ab);
+        if (length2 == 0.0) {
+            return glm::distance(p, a);
+        }
+        const double t = std::clamp(glm::dot(p - a, ab) / length2, 0.0, 1.0);
+        return glm::distance(p, a + t * ab);
+    }
+
+    // Samples the path of the translation in [begin, end] with at most maxSamples
+    // samples, including both end points. Starting from a uniform sampling, every
+    // segment whose midpoint is further than tolerance away from the straight line
+    // between its end points is split in half. All midpoints of one refinement level are
+    // evaluated in a single batch. If the remaining budget does not suffice to split all
+    // segments, the segments with the largest errors are split first
+    std::vector<Sample> adaptiveSamples(const openspace::Translation& translation,
+                                        double begin, double end, double tolerance,
+                                        size_t maxSamples)
+    {
+        const size_t nInitial = std::clamp<size_t>(maxSamples - 1, 1, InitialSegments);
+        std::vector<double> times(nInitial + 1);
+        for (size_t i = 0; i <= nInitial; i++) {
+            times[i] = begin + (end - begin) * static_cast<double>(i) / nInitial;
+        }
+        std::vector<glm::dvec3> positions(times.size());
+        translation.positions(times, positions);
+
+        std::vector<Sample> samples(times.size());
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = { times[i], positions[i] };
+        }
+
+        // The segments that still have to be tested, identified by their first sample
+        std::vector<size_t> candidates(nInitial);
+        std::iota(candidates.begin(), candidates.end(), 0);
+        const double minDuration = (end - begin) * MinSegmentFraction;
+
+        std::vector<double> errors;
+        std::vector<size_t> splits;
+        std::vector<Sample> refined;
+        std::vector<size_t> nextCandidates;
+        while (!candidates.empty() && samples.size() < maxSamples) {
+            times.resize(candidates.size());
+            for (size_t i = 0; i < candidates.size(); i++) {
+                const size_t c = candidates[i];
+                times[i] = 0.5 * (samples[c].time + samples[c + 1].time);
+            }
+            positions.resize(candidates.size());
+            translation.positions(times, positions);
+
+            errors.resize(candidates.size());
+            splits.clear();
+            for (size_t i = 0; i < candidates.size(); i++) {
+                const Sample& a = samples[candidates[i]];
+                const Sample& b = samples[candidates[i] + 1];
+                errors[i] = distanceToSegment(positions[i], a.position, b.position);
+                if (errors[i] > tolerance && b.time - a.time > minDuration) {
+                    splits.push_back(i);
+                }
+            }
+            if (splits.empty()) {
+                break;
+            }
+
+            const size_t budget = maxSamples - samples.size();
+            if (splits.size() > budget) {
+                std::nth_element(
+                    splits.begin(),
+                    splits.begin() + budget,
+                    splits.end(),
+                    [&errors](size_t lhs, size_t rhs) {
+                        return errors[lhs] > errors[rhs];
+                    }
+                );
+                splits.resize(budget);
+                std::sort(splits.begin(), splits.end());
+            }
+
+            // Merge the midpoints into the samples; both halves of a split segment have
+            // to be tested again in the next level
+            refined.clear();
+            refined.reserve(samples.size() + splits.size());
+            nextCandidates.clear();
+            size_t s = 0;
+            for (size_t i = 0; i < samples.size(); i++) {
+                refined.push_back(samples[i]);
+                if (s < splits.size() && candidates[splits[s]] == i) {
+                    nextCandidates.push_back(refined.size() - 1);
+                    refined.push_back({ times[splits[s]], positions[splits[s]] });
+                    nextCandidates.push_back(refined.size() - 1);
+                    s++;
+                }
+            }
+            samples.swap(refined);
+            candidates.swap(nextCandidates);
+        }
+
+        return samples;
+    }
+
     struct [[codegen::Dictionary(RenderableTrailOrbit)]] Parameters {
         // [[codegen::verbatim(PeriodInfo.description)]]
         double period;
 
         // [[codegen::verbatim(ResolutionInfo.description)]]
         int resolution;
+
+        // [[codegen::verbatim(AdaptiveSamplingInfo.description)]]
+        std::optional<bool> adaptiveSampling;
+
+        // [[codegen::verbatim(SamplingErrorInfo.description)]]
+        std::optional<float> samplingError [[codegen::greater(0.f)]];
     };
 #include "renderabletrailorbit_codegen.cpp"
 } // namespace
@@ -130,6 +291,8 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     : RenderableTrail(dictionary)
     , _period(PeriodInfo, 0.0, 0.0, 250.0 * 365.25) // 250 years should be enough I guess
     , _resolution(ResolutionInfo, 10000, 1, 1000000)
+    , _adaptiveSampling(AdaptiveSamplingInfo, false)
+    , _samplingError(SamplingErrorInfo, 0.02f, 0.001f, 1.f)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -146,6 +309,19 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     _resolution.setExponent(3.5f);
     addProperty(_resolution);
 
+    _adaptiveSampling = p.adaptiveSampling.value_or(_adaptiveSampling);
+    _adaptiveSampling.onChange([&] { _needsFullSweep = true; _indexBufferDirty = true; });
+    addProperty(_adaptiveSampling);
+
+    _samplingError = p.samplingError.value_or(_samplingError);
+    _samplingError.onChange([&] {
+        if (_adaptiveSampling) {
+            _needsFullSweep = true;
+        }
+    });
+    _samplingError.setExponent(2.f);
+    addProperty(_samplingError);
+
     // We store the vertices with (excluding the wrapping) decending temporal order
     _primaryRenderInformation.sorting = RenderInformation::VertexSorting::NewestFirst;
 }
@@ -173,6 +349,22 @@ void RenderableTrailOrbit::update(const UpdateData& data) {
     // 3. Determine which parts of the array to upload and upload the data
 
     // 1
+    // When adaptive sampling is used, the samples depend on the distance to the camera
+    if (_adaptiveSampling) {
+        _cameraDistance = cameraDistance(data.modelTransform);
+        if (_samplingDistance > 0.0) {
+            const double ratio = _cameraDistance / _samplingDistance;
+            if (ratio > ResampleDistanceFactor || ratio < 1.0 / ResampleDistanceFactor) {
+                _needsFullSweep = true;
+            }
+        }
+        else if (_cameraDistance > 0.0) {
+            // The previous sweep had no usable distance, so it is redone as soon as the
+            // distance to the camera is known
+            _needsFullSweep = true;
+        }
+    }
+
     // Update the trails; the report contains whether any of the other values has been
     // touched and if so, how many
     const UpdateReport report = updateTrails(data);
@@ -326,6 +518,10 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
         return { false, false, 0 };
     }
 
+    if (_adaptiveSampling) {
+        return updateAdaptiveTrails(data.time.j2000Seconds());
+    }
+
     using namespace std::chrono;
     const double periodSeconds = _period * duration_cast<seconds>(hours(24)).count();
     const double secondsPerPoint = periodSeconds / (_resolution - 1);
@@ -431,37 +627,182 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
     }
 }
 
-void RenderableTrailOrbit::fullSweep(double time) {
-    // Reserve the space for the vertices
-    _vertexArray.clear();
-    _vertexArray.resize(_resolution);
+RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateAdaptiveTrails(
+                                                                              double time)
+{
+    using namespace std::chrono;
+    const double periodSeconds = _period * duration_cast<seconds>(hours(24)).count();
 
-    // The index buffer stays constant until we change the size of the array
-    if (_indexBufferDirty) {
-        // Create the index buffer and fill it with two ranges for [0, _resolution)
-        _indexArray.clear();
-        _indexArray.resize(_resolution * 2);
-        std::iota(_indexArray.begin(), _indexArray.begin() + _resolution, 0);
-        std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
+    int& first = _primaryRenderInformation.first;
+    const int count = _primaryRenderInformation.count;
+    int nNewPoints = 0;
+
+    if (time > _lastPointTime) {
+        // The oldest fixed point is replaced as soon as the point that is one period
+        // newer is no longer in the future
+        while (true) {
+            const int oldest = (first - 1 + count) % count;
+            const double t = _pointTimes[oldest] + periodSeconds;
+            if (t > time) {
+                break;
+            }
+
+            // If we would need to replace all fixed points, it is faster to regenerate
+            // the entire array
+            if (nNewPoints == count - 1) {
+                fullSweep(time);
+                return { false, true, UpdateReport::All };
+            }
+
+            // Write the new permanent point into the (previously) floating location and
+            // use the location of the oldest point as the new floating location
+            const glm::vec3 p = _translation->position({ {}, Time(t), Time(0.0) });
+            _vertexArray[first] = { p.x, p.y, p.z };
+            _pointTimes[first] = t;
+            first = oldest;
+            nNewPoints++;
+        }
+
+        if (nNewPoints == 0) {
+            return { true, false, 0 };
+        }
+
+        _lastPointTime = _pointTimes[(first + 1) % count];
+        _firstPointTime = _pointTimes[(first - 1 + count) % count];
+        return { false, true, nNewPoints };
+    }
+    else {
+        // The newest fixed point is replaced by the point that is one period older as
+        // long as it lies in the future
+        while (_lastPointTime > time) {
+            if (nNewPoints == count - 1) {
+                fullSweep(time);
+                return { false, true, UpdateReport::All };
+            }
+
+            const int newest = (first + 1) % count;
+            const double t = _pointTimes[newest] - periodSeconds;
+
+            // Write the new permanent point into the (previously) floating location and
+            // use the location of the newest point as the new floating location
+            const glm::vec3 p = _translation->position({ {}, Time(t), Time(0.0) });
+            _vertexArray[first] = { p.x, p.y, p.z };
+            _pointTimes[first] = t;
+            first = newest;
+            _lastPointTime = _pointTimes[(first + 1) % count];
+            nNewPoints++;
+        }
+
+        _firstPointTime = _pointTimes[(first - 1 + count) % count];
+        return { false, true, -nNewPoints };
+    }
+}
+
+double RenderableTrailOrbit::cameraDistance(const TransformData& transform) const {
+    const Camera* camera = global::navigationHandler->camera();
+    if (!camera) {
+        return _samplingDistance;
     }
 
-    _lastPointTime = time;
+    // Transform the camera into the coordinate system of the vertices
+    const glm::dvec3 position =
+        glm::inverse(transform.rotation) *
+        (camera->positionVec3() - transform.translation) / transform.scale;
+
+    const double radius = boundingSphere();
+    return std::max(glm::length(position) - radius, radius * MinDistanceFraction);
+}
+
+double RenderableTrailOrbit::orbitSize(double time) const {
+    const double radius = boundingSphere();
+    if (radius > 0.0) {
+        return radius;
+    }
 
+    const std::array<double, 1> times = { time };
+    std::array<glm::dvec3, 1> positions;
+    _translation->positions(times, positions);
+    return glm::length(positions[0]);
+}
+
+void RenderableTrailOrbit::fullSweep(double time) {
     using namespace std::chrono;
     const double periodSeconds = _period * duration_cast<seconds>(hours(24)).count();
-    const double secondsPerPoint = periodSeconds / (_resolution - 1);
-    // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; i++) {
-        const glm::vec3 p = _translation->position({ {}, Time(time), Time(0.0) });
-        _vertexArray[i] = { p.x, p.y, p.z };
 
-        time -= secondsPerPoint;
+    if (_adaptiveSampling) {
+        // Without a camera and before the first sweep the camera distance is 0, which
+        // would result in a tolerance of 0, so the size of the orbit is used instead
+        const double samplingDistance =
+            _cameraDistance > 0.0 ? _cameraDistance : orbitSize(time);
+        const double error = glm::radians(static_cast<double>(_samplingError));
+        const double tolerance = samplingDistance * std::tan(error);
+        const std::vector<Sample> samples = adaptiveSamples(
+            *_translation,
+            time - periodSeconds,
+            time,
+            tolerance,
+            std::max(_resolution.value(), 3)
+        );
+
+        // The oldest sample is exactly one period before the newest one and is thus not
+        // needed. Its place in the array is taken by the floating position instead
+        const int count = static_cast<int>(samples.size());
+        if (count != _primaryRenderInformation.count) {
+            _indexBufferDirty = true;
+        }
+        _vertexArray.resize(count);
+        _pointTimes.resize(count);
+        _pointTimes[0] = time;
+        for (int i = 1; i < count; i++) {
+            const Sample& sample = samples[count - i];
+            const glm::vec3 p = sample.position;
+            _vertexArray[i] = { p.x, p.y, p.z };
+            _pointTimes[i] = sample.time;
+        }
+
+        _primaryRenderInformation.first = 0;
+        _primaryRenderInformation.count = count;
+        _lastPointTime = time;
+        _firstPointTime = samples[1].time;
+        _samplingDistance = samplingDistance;
     }
+    else {
+        // Reserve the space for the vertices
+        _vertexArray.clear();
+        _vertexArray.resize(_resolution);
+        _pointTimes.clear();
+
+        _lastPointTime = time;
+
+        const double secondsPerPoint = periodSeconds / (_resolution - 1);
+        // starting at 1 because the first position is a floating current one
+        std::vector<double> times(_resolution - 1);
+        for (double& t : times) {
+            t = time;
+            time -= secondsPerPoint;
+        }
+        std::vector<glm::dvec3> positions(times.size());
+        _translation->positions(times, positions);
+        for (int i = 1; i < _resolution; i++) {
+            const glm::vec3 p = positions[i - 1];
+            _vertexArray[i] = { p.x, p.y, p.z };
+        }
 
-    _primaryRenderInformation.first = 0;
-    _primaryRenderInformation.count = _resolution;
+        _primaryRenderInformation.first = 0;
+        _primaryRenderInformation.count = _resolution;
 
-    _firstPointTime = time + secondsPerPoint;
+        _firstPointTime = time + secondsPerPoint;
+    }
+
+    // The index buffer stays constant until we change the size of the array
+    if (_indexBufferDirty) {
+        // Create the index buffer and fill it with two ranges for [0, count)
+        const int count = _primaryRenderInformation.count;
+        _indexArray.clear();
+        _indexArray.resize(count * 2);
+        std::iota(_indexArray.begin(), _indexArray.begin() + count, 0);
+        std::iota(_indexArray.begin() + count, _indexArray.end(), 0);
+    }
 
     // Updating bounding sphere
     glm::vec3 maxVertex(-std::numeric_limits<float>::max());
@@ -27,8 +27,11 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/doubleproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <vector>
 
 namespace openspace {
 
@@ -43,6 +46,12 @@ namespace documentation { struct Documentation; }
  * are rendered. Each of these fixed points are fixed time steps apart, where as the most
  * current point is floating and updated every frame. The _period determines the length of
  * the trail (the distance between the newest and oldest point being _period days).
+ *
+ * If adaptive sampling is enabled, the fixed points are instead placed such that the
+ * rendered line segments deviate from the true path by less than a tolerance derived from
+ * the distance to the camera, with _resolution acting as an upper bound. Since the path
+ * is periodic, the same placement is reused when time progresses: a point that falls out
+ * of the trail is replaced by a new point exactly one period later.
  */
 class RenderableTrailOrbit : public RenderableTrail {
 public:
@@ -92,10 +101,45 @@ private:
      */
     UpdateReport updateTrails(const UpdateData& data);
 
+    /**
+     * The adaptive version of #updateTrails, which is used if #_adaptiveSampling is
+     * enabled. Instead of fixed time steps, each fixed point is replaced by a point that
+     * is one period newer (or older) than the point that is dropped.
+     *
+     * \param time The current time
+     * \return The UpdateReport containing information which array parts were touched
+     */
+    UpdateReport updateAdaptiveTrails(double time);
+
+    /**
+     * Computes the distance between the camera and the closest part of the trail in the
+     * coordinate system of the trail vertices.
+     *
+     * \param transform The model transform of the scene graph node owning this trail
+     * \return The distance to the camera that is used to derive the sampling tolerance
+     */
+    double cameraDistance(const TransformData& transform) const;
+
+    /**
+     * Estimates the size of the orbit, which is used in place of the camera distance as
+     * long as the latter is unknown, for example before the first adaptive sweep if there
+     * is no camera.
+     *
+     * \param time The time at which the position is used if the bounding sphere of the
+     *        trail has not been computed yet
+     * \return The radius of the bounding sphere of the trail, or the distance of the
+     *         object to the origin of the trail if the bounding sphere is not yet known
+     */
+    double orbitSize(double time) const;
+
     /// The orbital period of the RenderableTrail in days
     properties::DoubleProperty _period;
     /// The number of points that should be sampled between _period and now
     properties::IntProperty _resolution;
+    /// Whether the fixed points are placed adaptively instead of uniformly in time
+    properties::BoolProperty _adaptiveSampling;
+    /// The maximum angular error (in degrees) of the adaptively sampled trail
+    properties::FloatProperty _samplingError;
 
     /// A dirty flag that determines whether a full sweep (recomputing of all values)
     /// is necessary
@@ -110,6 +154,13 @@ private:
     double _lastPointTime = 0.0;
     /// The time stamp of when the last valid trail was generated.
     double _previousTime = 0.0;
+
+    /// The time stamps of each entry in the _vertexArray if adaptive sampling is used
+    std::vector<double> _pointTimes;
+    /// The distance to the camera as computed in the most recent #update call
+    double _cameraDistance = 0.0;
+    /// The distance to the camera that was used in the most recent adaptive full sweep
+    double _samplingDistance = 0.0;
 };
 
 } // namespace openspace
@@ -31,6 +31,8 @@
 #include <openspace/util/timeconversion.h>
 #include <openspace/util/updatestructures.h>
 #include <optional>
+#include <span>
+#include <vector>
 
 // This class creates the entire trajectory at once and keeps it in memory the entire
 // time. This means that there is no need for updating the trail at runtime, but also that
@@ -304,14 +306,17 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
 
         // Calculate all vertex positions
         for (unsigned int i = startIndex; i < stopIndex; i++) {
-            const glm::dvec3 dp = _translation->position({
-                {},
-                Time(_start + i * _totalSampleInterval),
-                Time(0.0)
-            });
+            _timeVector[i] = _start + i * _totalSampleInterval;
+        }
+        std::vector<glm::dvec3> positions(stopIndex - startIndex);
+        _translation->positions(
+            std::span(_timeVector).subspan(startIndex, stopIndex - startIndex),
+            positions
+        );
+        for (unsigned int i = startIndex; i < stopIndex; i++) {
+            const glm::dvec3 dp = positions[i - startIndex];
             const glm::vec3 p(dp.x, dp.y, dp.z);
             _vertexArray[i] = { p.x, p.y, p.z };
-            _timeVector[i] = Time(_start + i * _totalSampleInterval).j2000Seconds();
             _dVertexArray[i] = {dp.x, dp.y, dp.z};
 
             // Set max and min vertex for bounding sphere calculations
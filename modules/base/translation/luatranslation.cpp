@@ -33,6 +33,8 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
 #include <chrono>
 
 namespace {
@@ -121,4 +123,50 @@ glm::dvec3 LuaTranslation::position(const UpdateData& data) const {
     return translation;
 }
 
+void LuaTranslation::positions(std::span<const double> times,
+                               std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    // The script only has to be executed once to define the function, which is then
+    // called for all times of the batch
+    ghoul::lua::runScriptFile(_state, _luaScriptFile.value());
+
+    using namespace std::chrono;
+    const auto now = high_resolution_clock::now();
+    const auto wallClock = duration_cast<milliseconds>(now.time_since_epoch()).count();
+
+    for (size_t i = 0; i < times.size(); i++) {
+        lua_getglobal(_state, "translation");
+        const bool isFunction = lua_isfunction(_state, -1);
+        if (!isFunction) {
+            LERRORC(
+                "LuaTranslation",
+                std::format(
+                    "Script '{}' does not have a function 'translation'",
+                    _luaScriptFile.value()
+                )
+            );
+            std::fill(result.begin() + i, result.end(), glm::dvec3(0.0));
+            return;
+        }
+
+        // The arguments are the same as for the single position, with the simulation
+        // time of the previous frame being undefined for a batch
+        ghoul::lua::push(_state, times[i]);
+        ghoul::lua::push(_state, 0.0);
+        ghoul::lua::push(_state, wallClock);
+
+        const int success = lua_pcall(_state, 3, 1, 0);
+        if (success != 0) {
+            LERRORC(
+                "LuaTranslation",
+                std::format("Error executing 'translation': {}", lua_tostring(_state, -1))
+            );
+        }
+
+        result[i] = ghoul::lua::value<glm::dvec3>(_state);
+    }
+}
+
 } // namespace openspace
@@ -28,7 +28,10 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/util/time.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
 #include <optional>
+#include <vector>
 
 namespace {
     constexpr openspace::properties::Property::PropertyInfo ShouldInterpolateInfo = {
@@ -77,14 +80,67 @@ TimelineTranslation::TimelineTranslation(const ghoul::Dictionary& dictionary)
 }
 
 glm::dvec3 TimelineTranslation::position(const UpdateData& data) const {
-    const double now = data.time.j2000Seconds();
+    const Blend b = blend(data.time.j2000Seconds());
+    if (!b.first) {
+        return glm::dvec3(0.0);
+    }
+    if (!b.second) {
+        return b.first->position(data);
+    }
+    return b.t * b.second->position(data) + (1.0 - b.t) * b.first->position(data);
+}
+
+void TimelineTranslation::positions(std::span<const double> times,
+                                    std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    std::vector<Blend> blends(times.size());
+    for (size_t i = 0; i < times.size(); i++) {
+        blends[i] = blend(times[i]);
+    }
+
+    // Consecutive times that are covered by the same keyframes are passed as a single
+    // batch to the translations of these keyframes
+    std::vector<glm::dvec3> secondPositions;
+    size_t begin = 0;
+    while (begin < times.size()) {
+        const Blend& b = blends[begin];
+        size_t end = begin + 1;
+        while (end < times.size() &&
+               blends[end].first == b.first && blends[end].second == b.second)
+        {
+            end++;
+        }
+
+        const std::span<const double> t = times.subspan(begin, end - begin);
+        const std::span<glm::dvec3> r = result.subspan(begin, end - begin);
+        if (!b.first) {
+            std::fill(r.begin(), r.end(), glm::dvec3(0.0));
+        }
+        else {
+            b.first->positions(t, r);
+            if (b.second) {
+                secondPositions.resize(t.size());
+                b.second->positions(t, secondPositions);
+                for (size_t i = 0; i < r.size(); i++) {
+                    const double w = blends[begin + i].t;
+                    r[i] = w * secondPositions[i] + (1.0 - w) * r[i];
+                }
+            }
+        }
+        begin = end;
+    }
+}
+
+TimelineTranslation::Blend TimelineTranslation::blend(double now) const {
     using KeyframePointer = const Keyframe<ghoul::mm_unique_ptr<Translation>>*;
 
     KeyframePointer prev = _timeline.lastKeyframeBefore(now, true);
     KeyframePointer next = _timeline.firstKeyframeAfter(now, true);
 
     if (!prev && !next) {
-        return glm::dvec3(0.0);
+        return Blend();
     }
     if (!prev) {
         prev = next;
@@ -96,21 +152,24 @@ glm::dvec3 TimelineTranslation::position(const UpdateData& data) const {
     const double nextTime = next->timestamp;
 
     if (_shouldInterpolate) {
+        if (prev == next) {
+            return { .first = prev->data.get() };
+        }
         double t = 0.0;
         if (nextTime - prevTime > 0.0) {
             t = (now - prevTime) / (nextTime - prevTime);
         }
-        return t * next->data->position(data) + (1.0 - t) * prev->data->position(data);
+        return { .first = prev->data.get(), .second = next->data.get(), .t = t };
     }
     else {
         if (prevTime <= now && now < nextTime) {
-            return prev->data->position(data);
+            return { .first = prev->data.get() };
         }
         else if (nextTime <= now) {
-            return next->data->position(data);
+            return { .first = next->data.get() };
         }
     }
-    return glm::dvec3(0.0);
+    return Blend();
 }
 
 } // namespace openspace
@@ -42,9 +42,21 @@ public:
     TimelineTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    void positions(std::span<const double> times,
+        std::span<glm::dvec3> result) const override;
     static documentation::Documentation Documentation();
 
 private:
+    /// The keyframe translations that contribute to the position at a specific time.
+    /// The result is `t * second + (1 - t) * first`, or just `first` if there is no
+    /// `second`, or the origin if there is neither
+    struct Blend {
+        const Translation* first = nullptr;
+        const Translation* second = nullptr;
+        double t = 0.0;
+    };
+    Blend blend(double now) const;
+
     Timeline<ghoul::mm_unique_ptr<Translation>> _timeline;
     properties::BoolProperty _shouldInterpolate;
 };
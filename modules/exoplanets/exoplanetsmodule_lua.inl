@@ -284,8 +284,10 @@ listOfExoplanetsDeprecated()
         ExoplanetsDataPreparationTask::readFirstDataRow(inputDataFile);
 
     const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
-    const std::filesystem::path
-        teffBvConversionPath = module->teffToBvConversionFilePath();
+    const ExoplanetsDataPreparationTask::TeffToBvTable teffToBv =
+        ExoplanetsDataPreparationTask::readTeffToBvTable(
+            module->teffToBvConversionFilePath()
+        );
 
     std::map<std::string, ExoplanetSystem> hostNameToSystemDataMap;
 
@@ -297,8 +299,8 @@ listOfExoplanetsDeprecated()
         PlanetData planetData = ExoplanetsDataPreparationTask::parseDataRow(
             row,
             columnNames,
-            "",
-            module->teffToBvConversionFilePath()
+            {},
+            teffToBv
         );
 
         if (!hasSufficientData(planetData.dataEntry)) {
@@ -28,12 +28,14 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/coordinateconversion.h>
+#include <openspace/util/parallelfor.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/stringhelper.h>
+#include <algorithm>
 #include <charconv>
 #include <filesystem>
 #include <fstream>
@@ -80,6 +82,12 @@ namespace {
         std::string teffToBvFile;
     };
 #include "exoplanetsdatapreparationtask_codegen.cpp"
+
+    // Rows are only parsed on multiple threads if there are at least this many per range
+    constexpr size_t MinRowsPerRange = 256;
+
+    // The progress is reported after every batch of this many rows
+    constexpr size_t RowsPerBatch = 16384;
 } // namespace
 
 namespace openspace::exoplanets {
@@ -144,33 +152,34 @@ void ExoplanetsDataPreparationTask::perform(
     // later access
     const std::vector<std::string> columnNames = readFirstDataRow(inputDataFile);
 
-    // Read total number of items
-    int total = 0;
+    std::vector<std::string> rows;
     std::string row;
     while (ghoul::getline(inputDataFile, row)) {
-        ++total;
+        rows.push_back(std::move(row));
     }
-    inputDataFile.clear();
-    inputDataFile.seekg(0);
-
-    // The reading is restarted, so we need to read past the first line,
-    // containing the data names, again
-    readFirstDataRow(inputDataFile);
 
-    LINFO(std::format("Loading {} exoplanets", total));
-
-    int exoplanetCount = 0;
-    while (ghoul::getline(inputDataFile, row)) {
-        ++exoplanetCount;
-        progressCallback(static_cast<float>(exoplanetCount) / static_cast<float>(total));
-
-        PlanetData planetData = parseDataRow(
-            row,
-            columnNames,
-            _inputSpeckPath,
-            _teffToBvFilePath
-        );
+    LINFO(std::format("Loading {} exoplanets", rows.size()));
+
+    // The star positions and the teff conversion are needed for every row, so they are
+    // read once up front rather than searching the files for each row
+    const StarPositions starPositions = readStarPositions(_inputSpeckPath);
+    const TeffToBvTable teffToBv = readTeffToBvTable(_teffToBvFilePath);
+
+    // The rows are independent of each other, so they are parsed in parallel and
+    // written in their original order afterwards. Parsing happens in batches so that the
+    // progress can be reported from the calling thread
+    std::vector<PlanetData> planets(rows.size());
+    const float total = static_cast<float>(rows.size());
+    for (size_t first = 0; first < rows.size(); first += RowsPerBatch) {
+        const size_t count = std::min(RowsPerBatch, rows.size() - first);
+        parallelFor(count, MinRowsPerRange, [&](size_t i) {
+            planets[first + i] =
+                parseDataRow(rows[first + i], columnNames, starPositions, teffToBv);
+        });
+        progressCallback(static_cast<float>(first + count) / total);
+    }
 
+    for (PlanetData& planetData : planets) {
         // Create look-up table
         const long pos = static_cast<long>(binFile.tellp());
         const std::string planetName = planetData.host + " " + planetData.component;
@@ -212,8 +221,8 @@ ExoplanetsDataPreparationTask::readFirstDataRow(std::ifstream& file)
 ExoplanetsDataPreparationTask::PlanetData
 ExoplanetsDataPreparationTask::parseDataRow(const std::string& row,
                                             const std::vector<std::string>& columnNames,
-                                          const std::filesystem::path& positionSourceFile,
-                                    const std::filesystem::path& bvFromTeffConversionFile)
+                                                    const StarPositions& starPositions,
+                                                         const TeffToBvTable& teffToBv)
 {
     auto readFloatData = [](const std::string& str) -> float {
 #ifdef WIN32
@@ -354,10 +363,12 @@ ExoplanetsDataPreparationTask::parseDataRow(const std::string& row,
         // Star - name and position
         else if (column == "hostname") {
             starName = readStringData(data);
-            glm::vec3 position = starPosition(starName, positionSourceFile);
-            p.positionX = position[0];
-            p.positionY = position[1];
-            p.positionZ = position[2];
+            const auto it = starPositions.find(starName);
+            if (it != starPositions.end()) {
+                p.positionX = it->second[0];
+                p.positionY = it->second[1];
+                p.positionZ = it->second[2];
+            }
         }
         else if (column == "ra") {
             ra = readFloatData(data);
@@ -382,7 +393,7 @@ ExoplanetsDataPreparationTask::parseDataRow(const std::string& row,
         // (B-V color index computed from star's effective temperature)
         else if (column == "st_teff") {
             p.teff = readFloatData(data);
-            p.bmv = bvFromTeff(p.teff, bvFromTeffConversionFile);
+            p.bmv = bvFromTeff(p.teff, teffToBv);
         }
         else if (column == "st_tefferr1") {
             p.teffUpper = readFloatData(data);
@@ -442,19 +453,20 @@ ExoplanetsDataPreparationTask::parseDataRow(const std::string& row,
     };
 }
 
-glm::vec3 ExoplanetsDataPreparationTask::starPosition(const std::string& starName,
-                                                  const std::filesystem::path& sourceFile)
+ExoplanetsDataPreparationTask::StarPositions
+ExoplanetsDataPreparationTask::readStarPositions(const std::filesystem::path& sourceFile)
 {
-    glm::vec3 position = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+    StarPositions positions;
 
     if (sourceFile.empty()) {
-        // No file specified => return NaN position
-        return position;
+        // No file specified => all positions are taken from the CSV file
+        return positions;
     }
 
     std::ifstream exoplanetsFile(sourceFile);
     if (!exoplanetsFile) {
         LERROR(std::format("Error opening file '{}'", sourceFile));
+        return positions;
     }
 
     std::string line;
@@ -475,42 +487,37 @@ glm::vec3 ExoplanetsDataPreparationTask::starPosition(const std::string& starNam
         ghoul::getline(linestream, name);
         name.erase(0, 1);
 
-        std::string coord;
-        if (name == starName) {
-            std::stringstream dataStream(data);
-            ghoul::getline(dataStream, coord, ' ');
-            position[0] = std::stof(coord, nullptr);
-            ghoul::getline(dataStream, coord, ' ');
-            position[1] = std::stof(coord, nullptr);
-            ghoul::getline(dataStream, coord, ' ');
-            position[2] = std::stof(coord, nullptr);
-            break;
+        if (positions.contains(name)) {
+            continue;
         }
+
+        glm::vec3 position;
+        std::string coord;
+        std::stringstream dataStream(data);
+        ghoul::getline(dataStream, coord, ' ');
+        position[0] = std::stof(coord, nullptr);
+        ghoul::getline(dataStream, coord, ' ');
+        position[1] = std::stof(coord, nullptr);
+        ghoul::getline(dataStream, coord, ' ');
+        position[2] = std::stof(coord, nullptr);
+        positions[name] = position;
     }
 
-    return position;
+    return positions;
 }
 
-float ExoplanetsDataPreparationTask::bvFromTeff(float teff,
+ExoplanetsDataPreparationTask::TeffToBvTable
+ExoplanetsDataPreparationTask::readTeffToBvTable(
                                               const std::filesystem::path& conversionFile)
 {
-    if (std::isnan(teff)) {
-        return std::numeric_limits<float>::quiet_NaN();
-    }
+    TeffToBvTable table;
 
     std::ifstream teffToBvFile(conversionFile);
     if (!teffToBvFile.good()) {
         LERROR(std::format("Failed to open file '{}'", conversionFile));
-        return std::numeric_limits<float>::quiet_NaN();
+        return table;
     }
 
-    // Find the line in the file that most closely corresponds to the specified teff,
-    // and finally interpolate the value
-    float bv = 0.f;
-    float bvUpper = 0.f;
-    float bvLower = 0.f;
-    float teffLower = 0.f;
-    float teffUpper = 0.f;
     std::string row;
     while (ghoul::getline(teffToBvFile, row)) {
         std::istringstream lineStream(row);
@@ -519,28 +526,53 @@ float ExoplanetsDataPreparationTask::bvFromTeff(float teff,
         std::string bvString;
         ghoul::getline(lineStream, bvString);
 
-        const float teffCurrent = std::stof(teffString, nullptr);
-        const float bvCurrent = std::stof(bvString, nullptr);
+        const float teff = std::stof(teffString, nullptr);
+        const float bv = std::stof(bvString, nullptr);
+        table.emplace_back(teff, bv);
+    }
 
-        if (teff > teffCurrent) {
-            teffLower = teffCurrent;
-            bvLower = bvCurrent;
+    // The conversion files are sorted already, but the lookup depends on it
+    std::stable_sort(
+        table.begin(),
+        table.end(),
+        [](const std::pair<float, float>& lhs, const std::pair<float, float>& rhs) {
+            return lhs.first < rhs.first;
         }
-        else {
-            teffUpper = teffCurrent;
-            bvUpper = bvCurrent;
-            if (bvLower == 0.f) {
-                bv = 2.f;
-            }
-            else {
-                const float bvDiff = (bvUpper - bvLower);
-                const float teffDiff = (teffUpper - teffLower);
-                bv = ((bvDiff * (teff - teffLower)) / teffDiff) + bvLower;
-            }
-            break;
+    );
+    return table;
+}
+
+float ExoplanetsDataPreparationTask::bvFromTeff(float teff,
+                                                const TeffToBvTable& teffToBv)
+{
+    if (std::isnan(teff) || teffToBv.empty()) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // Find the first entry whose teff is not smaller than the specified teff, and
+    // interpolate between it and the entry before it
+    const auto upper = std::lower_bound(
+        teffToBv.begin(),
+        teffToBv.end(),
+        teff,
+        [](const std::pair<float, float>& entry, float value) {
+            return entry.first < value;
         }
+    );
+    if (upper == teffToBv.end()) {
+        return 0.f;
+    }
+
+    const auto [teffUpper, bvUpper] = *upper;
+    const auto [teffLower, bvLower] =
+        upper != teffToBv.begin() ? *(upper - 1) : std::pair(0.f, 0.f);
+    if (bvLower == 0.f) {
+        return 2.f;
     }
-    return bv;
+
+    const float bvDiff = (bvUpper - bvLower);
+    const float teffDiff = (teffUpper - teffLower);
+    return ((bvDiff * (teff - teffLower)) / teffDiff) + bvLower;
 }
 
 } // namespace openspace::exoplanets
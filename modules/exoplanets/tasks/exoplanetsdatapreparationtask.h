@@ -31,6 +31,9 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <filesystem>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace openspace::exoplanets {
 
@@ -43,6 +46,12 @@ public:
         ExoplanetDataEntry dataEntry;
     };
 
+    /// The positions of stars in galactic XYZ, indexed by the name of the star
+    using StarPositions = std::unordered_map<std::string, glm::vec3>;
+
+    /// Pairs of effective temperature (teff) and B-V color index, sorted by the teff
+    using TeffToBvTable = std::vector<std::pair<float, float>>;
+
     ExoplanetsDataPreparationTask(const ghoul::Dictionary& dictionary);
     std::string description() override;
     void perform(const Task::ProgressCallback& progressCallback) override;
@@ -64,22 +73,39 @@ public:
      *
      * \param row The row to parse, given as a string
      * \param columnNames The list of column names in the file, from the CSV header
-     * \param positionSourceFile A SPECK file to use for getting the position of the star.
-     *        This is used to make sure the position of the star matches those of other
-     *        star datasets. If no file is provided, the position from the CSV data file
-     *        is read and used instead
-     * \param bvFromTeffConversionFile A text file containing a mapping between effective
-     *        temperature (teff) values and B-V color index values. Each line should
-     *        include two values separated by a comma: first the teff value and then the
-     *        B-V value
+     * \param starPositions The positions of stars, as read by readStarPositions. This
+     *        is used to make sure the position of the star matches those of other star
+     *        datasets. If the star is not found, the position from the CSV data file is
+     *        used instead
+     * \param teffToBv The mapping from effective temperature (teff) values to B-V
+     *        color index values, as read by readTeffToBvTable
      * \return An object containing the parsed information
      *
      * /sa https://exoplanetarchive.ipac.caltech.edu/
      */
     static PlanetData parseDataRow(const std::string& row,
-        const std::vector<std::string>& columnNames,
-        const std::filesystem::path& positionSourceFile,
-        const std::filesystem::path& bvFromTeffConversionFile);
+        const std::vector<std::string>& columnNames, const StarPositions& starPositions,
+        const TeffToBvTable& teffToBv);
+
+    /**
+     * Reads the positions of all stars in a SPECK file. The name of each star is given
+     * by the comment at the end of its line. If a name occurs multiple times, the first
+     * position is used.
+     *
+     * \param sourceFile The SPECK file to read. If this is empty, no positions are read
+     * \return The star positions, given in galactic XYZ
+     */
+    static StarPositions readStarPositions(const std::filesystem::path& sourceFile);
+
+    /**
+     * Reads a conversion file from effective temperature (teff) to B-V color index. Each
+     * line should include two values separated by a comma: first the teff value and then
+     * the B-V value.
+     *
+     * \param conversionFile The conversion file to read
+     * \return The conversion table, sorted by teff
+     */
+    static TeffToBvTable readTeffToBvTable(const std::filesystem::path& conversionFile);
 
 private:
     std::filesystem::path _inputDataPath;
@@ -88,19 +114,8 @@ private:
     std::filesystem::path _outputLutPath;
     std::filesystem::path _teffToBvFilePath;
 
-    /**
-     * Try to find the star position from an input speck file. If not found, the
-     * returned position will contain NaN values.
-     *
-     * \param starName The name of the star to look for in the file
-     * \param sourceFile The name of the file in which to look
-     * \return The resulting star position, given in galactix XYZ
-     */
-    static glm::vec3 starPosition(const std::string& starName,
-        const std::filesystem::path& sourceFile);
-
-    // Compute b-v color from teff value using a conversion file
-    static float bvFromTeff(float teff, const std::filesystem::path& conversionFile);
+    // Compute b-v color from teff value using a conversion table
+    static float bvFromTeff(float teff, const TeffToBvTable& teffToBv);
 };
 
 } // namespace openspace::exoplanets
@@ -27,10 +27,13 @@
 #include <modules/fieldlinessequence/rendering/renderablefieldlinessequence.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 namespace {
     constexpr std::string_view DefaultTransferfunctionSource =
@@ -44,6 +47,9 @@ mappingkey 0.5   255  140  0    255
 mappingkey 0.75  255  255  0    255
 mappingkey 1.0   255  255  255  255
 )";
+
+    // Loading states is mostly bound by disk access, so a few threads are sufficient
+    constexpr unsigned int MaxLoadingThreads = 4;
 } // namespace
 
 namespace openspace {
@@ -63,6 +69,19 @@ void FieldlinesSequenceModule::internalInitialize(const ghoul::Dictionary&) {
     ghoul_assert(factory, "No renderable factory existed");
 
     factory->registerClass<RenderableFieldlinesSequence>("RenderableFieldlinesSequence");
+
+    const unsigned int nThreads =
+        std::clamp(std::thread::hardware_concurrency() / 2, 1u, MaxLoadingThreads);
+    _stateLoadingPool = std::make_unique<ThreadPool>(nThreads);
+}
+
+void FieldlinesSequenceModule::internalDeinitialize() {
+    _stateLoadingPool = nullptr;
+}
+
+ThreadPool& FieldlinesSequenceModule::stateLoadingPool() {
+    ghoul_assert(_stateLoadingPool, "Module must be initialized");
+    return *_stateLoadingPool;
 }
 
 std::vector<documentation::Documentation> FieldlinesSequenceModule::documentations() const
@@ -28,9 +28,12 @@
 #include <openspace/util/openspacemodule.h>
 
 #include <filesystem>
+#include <memory>
 
 namespace openspace {
 
+class ThreadPool;
+
 class FieldlinesSequenceModule : public OpenSpaceModule {
 public:
     constexpr static const char* Name = "FieldlinesSequence";
@@ -41,8 +44,17 @@ public:
 
     static std::filesystem::path DefaultTransferFunctionFile;
 
+    /**
+     * Returns the thread pool that is shared between all fieldline sequences to load
+     * states from disk while the sequence is playing.
+     */
+    ThreadPool& stateLoadingPool();
+
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
+    void internalDeinitialize() override;
+
+    std::unique_ptr<ThreadPool> _stateLoadingPool;
 };
 
 } // namespace openspace
@@ -27,11 +27,13 @@
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
 #include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/navigation/navigationhandler.h>
 #include <openspace/navigation/orbitalnavigator.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
+#include <openspace/util/threadpool.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -40,6 +42,7 @@
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <map>
@@ -220,6 +223,10 @@ namespace {
         // Set to true if you are streaming data during runtime
         std::optional<bool> loadAtRuntime;
 
+        // The number of states that are loaded ahead of the current state in the
+        // direction of playback when streaming data during runtime. 3 is default
+        std::optional<int> numberOfPrefetchedStates [[codegen::greaterequal(0)]];
+
         // [[codegen::verbatim(ColorUniformInfo.description)]]
         std::optional<glm::vec4> color [[codegen::color()]];
 
@@ -473,6 +480,7 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
         LWARNING("Load at run time is only supported for osfls file type");
         _loadingStatesDynamically = false;
     }
+    _nPrefetchedStates = p.numberOfPrefetchedStates.value_or(_nPrefetchedStates);
 
     if (p.maskingRanges.has_value()) {
         _maskingRanges = *p.maskingRanges;
@@ -589,13 +597,17 @@ bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
         LERROR("The provided .osfls files seem to be corrupt");
         return false;
     }
-    _states.push_back(newState);
+    _states.push_back(std::move(newState));
     _nStates = _startTimes.size();
     if (_nStates == 1) {
         // loading dynamicaly is not nessesary if only having one set in the sequence
         _loadingStatesDynamically = false;
     }
     _activeStateIndex = 0;
+    _displayedStateIndex = 0;
+
+    // Room for the active state, the prefetched states ahead of it and the one behind
+    _streamedStates = std::vector<StreamedState>(_nPrefetchedStates + 2);
     return true;
 }
 
@@ -952,9 +964,9 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done
+    // Stall main thread until the threads that are loading states are done
     bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
+    while (_nPendingLoads > 0) {
         if (!printedWarning) {
             LWARNING("Trying to destroy class when an active thread is still using it");
             printedWarning = true;
@@ -1054,10 +1066,7 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
     if (_shaderProgram->isDirty()) {
         _shaderProgram->rebuildFromFile();
     }
-    // True if new 'runtime-state' must be loaded from disk.
-    // False => the previous frame's state should still be shown
-    bool mustLoadNewStateFromDisk = false;
-    // True if new 'in-RAM-state'  must be loaded.
+    // True if a new state must be shown.
     // False => the previous frame's state should still be shown
     bool needUpdate = false;
     const double currentTime = data.time.j2000Seconds();
@@ -1077,10 +1086,7 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         {
             updateActiveTriggerTimeIndex(currentTime);
 
-            if (_loadingStatesDynamically) {
-                mustLoadNewStateFromDisk = true;
-            }
-            else {
+            if (!_loadingStatesDynamically) {
                 needUpdate = true;
                 _activeStateIndex = _activeTriggerTimeIndex;
             }
@@ -1104,27 +1110,23 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
     else {
         // Not in interval => set everything to false
         _activeTriggerTimeIndex = -1;
-        mustLoadNewStateFromDisk = false;
         needUpdate = false;
     }
 
-    if (mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk = true;
-            mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)]() {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
+    if (_loadingStatesDynamically && _activeTriggerTimeIndex != -1) {
+        const double dt = currentTime - data.previousFrameTime.j2000Seconds();
+        if (dt != 0.0) {
+            _playbackDirection = dt > 0.0 ? 1 : -1;
         }
-    }
 
-    if (needUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+        // Until the active state has been loaded the previous state is still shown
+        if (_activeTriggerTimeIndex != _displayedStateIndex) {
+            needUpdate = showStreamedState(_activeTriggerTimeIndex);
         }
+        requestStreamedStates();
+    }
 
+    if (needUpdate) {
         updateVertexPositionBuffer();
 
         if (_states[_activeStateIndex].nExtraQuantities() > 0) {
@@ -1134,7 +1136,6 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
 
         // Everything is set and ready for rendering
         needUpdate = false;
-        _newStateIsReady = false;
     }
 
     if (_colorMethod == 1) { //By quantity
@@ -1171,13 +1172,101 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+// Moves the streamed state with the provided index into _states[0] if it has finished
+// loading. Returns false if the state is not available yet
+bool RenderableFieldlinesSequence::showStreamedState(int index) {
+    std::lock_guard lock(_streamedStatesMutex);
+    auto it = std::find_if(
+        _streamedStates.begin(),
+        _streamedStates.end(),
+        [index](const StreamedState& s) {
+            return s.index == index && s.isValid && !s.isLoading;
+        }
+    );
+    if (it == _streamedStates.end()) {
+        return false;
+    }
+
+    // Swapping hands the buffers of the previously displayed state to the slot, so
+    // that the next state loaded into it reuses their memory instead of reallocating
+    std::swap(it->state, _states[0]);
+    it->index = _displayedStateIndex;
+    _displayedStateIndex = index;
+    return true;
+}
+
+// Queues loads for the active state and the states surrounding it that are not already
+// loaded or loading. Slots holding the states farthest from the active one are reused
+void RenderableFieldlinesSequence::requestStreamedStates() {
+    const int nStates = static_cast<int>(_nStates);
+
+    // In priority order: the active state, the states ahead of it in the direction of
+    // playback and finally the state behind it for when the playback is reversed
+    std::vector<int> wanted;
+    wanted.reserve(_nPrefetchedStates + 2);
+    for (int i = 0; i <= _nPrefetchedStates; i++) {
+        const int index = _activeTriggerTimeIndex + i * _playbackDirection;
+        if (index >= 0 && index < nStates) {
+            wanted.push_back(index);
+        }
+    }
+    const int behind = _activeTriggerTimeIndex - _playbackDirection;
+    if (behind >= 0 && behind < nStates) {
+        wanted.push_back(behind);
+    }
+
+    ThreadPool& pool =
+        global::moduleEngine->module<FieldlinesSequenceModule>()->stateLoadingPool();
+
+    std::lock_guard lock(_streamedStatesMutex);
+    for (const int index : wanted) {
+        if (index == _displayedStateIndex) {
+            continue;
+        }
+        const bool isRequested = std::any_of(
+            _streamedStates.begin(),
+            _streamedStates.end(),
+            [index](const StreamedState& s) { return s.index == index; }
+        );
+        if (isRequested) {
+            continue;
+        }
+
+        StreamedState* slot = nullptr;
+        int farthest = -1;
+        for (StreamedState& s : _streamedStates) {
+            const bool isWanted =
+                std::find(wanted.begin(), wanted.end(), s.index) != wanted.end();
+            if (s.isLoading || isWanted) {
+                continue;
+            }
+            const int distance = s.index == -1 ?
+                nStates :
+                std::abs(s.index - _activeTriggerTimeIndex);
+            if (distance > farthest) {
+                slot = &s;
+                farthest = distance;
+            }
+        }
+        if (!slot) {
+            // All slots are busy or hold states that are more important
+            break;
+        }
+
+        slot->index = index;
+        slot->isLoading = true;
+        slot->isValid = false;
+        _nPendingLoads++;
+        pool.enqueue([this, slot, path = _sourceFiles[index]]() {
+            const bool success = slot->state.loadStateFromOsfls(path);
+            {
+                std::lock_guard l(_streamedStatesMutex);
+                slot->isLoading = false;
+                slot->isValid = success;
+            }
+            _nPendingLoads--;
+        });
     }
-    _isLoadingStateFromDisk = false;
 }
 
 // Unbind buffers and arrays
@@ -36,6 +36,7 @@
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
 #include <atomic>
+#include <mutex>
 
 namespace openspace {
 
@@ -65,7 +66,8 @@ private:
     void setupProperties();
     bool prepareForOsflsStreaming();
 
-    void readNewState(const std::string& filePath);
+    bool showStreamedState(int index);
+    void requestStreamedStates();
     void updateActiveTriggerTimeIndex(double currentTime);
     void updateVertexPositionBuffer();
     void updateVertexColorBuffer();
@@ -93,15 +95,30 @@ private:
     // optional except when using json input
     std::string _modelStr;
 
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
+    // Used for 'runtime-states'. One slot in the ring of states that are prefetched
+    // around the displayed state. A slot is only touched by the loading thread while
+    // isLoading is true
+    struct StreamedState {
+        // Index into _sourceFiles of the state in this slot, -1 if the slot is unused
+        int index = -1;
+        bool isLoading = false;
+        bool isValid = false;
+        FieldlinesState state;
+    };
+
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
+    // Used for 'runtime-states'. Number of states that are loaded ahead of the active
+    // state in the direction of playback
+    int _nPrefetchedStates = 3;
+    // Used for 'runtime-states'. Index into _sourceFiles of the state in _states[0]
+    int _displayedStateIndex = -1;
+    // Used for 'runtime-states'. 1 if time is moving forward, -1 if it moves backwards
+    int _playbackDirection = 1;
+    // Used for 'runtime-states'. Number of loads that are queued or in progress on the
+    // module's loading threads
+    std::atomic_int _nPendingLoads = 0;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -139,9 +156,6 @@ private:
     // OpenGL Vertex Buffer Object containing the vertex positions
     GLuint _vertexPositionBuffer = 0;
 
-    // The Lua-Modfile-Dictionary used during initialization
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -161,6 +175,11 @@ private:
     std::vector<double> _startTimes;
     // Stores the FieldlineStates
     std::vector<FieldlinesState> _states;
+    // Used for 'runtime-states'. Ring of prefetched states. Sized once so that the slots
+    // never move while they are being loaded into
+    std::vector<StreamedState> _streamedStates;
+    // Guards the index and flags of the slots in _streamedStates
+    std::mutex _streamedStatesMutex;
 
     // Group to hold the color properties
     properties::PropertyOwner _colorGroup;
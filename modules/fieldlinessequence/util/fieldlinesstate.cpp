@@ -384,7 +384,8 @@ void FieldlinesState::setTriggerTime(double t) {
 
 // Returns one of the extra quantity vectors, _extraQuantities[index].
 // If index is out of scope an empty vector is returned and the referenced bool is false.
-std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessful) const
+const std::vector<float>& FieldlinesState::extraQuantity(size_t index,
+                                                         bool& isSuccessful) const
 {
     if (index < _extraQuantities.size()) {
         isSuccessful = true;
@@ -393,7 +394,8 @@ std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessf
     else {
         isSuccessful = false;
         LERROR("Provided Index was out of scope");
-        return {};
+        static const std::vector<float> Empty;
+        return Empty;
     }
 }
 
@@ -24,11 +24,17 @@
 
 #include <modules/galaxy/tasks/milkywayconversiontask.h>
 
-#include <modules/volume/textureslicevolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/textureslicevolumereader.h>
 #include <modules/volume/volumesampler.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/util/parallelfor.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace {
     struct [[codegen::Dictionary(MilkywayConversionTask)]] Parameters {
@@ -40,6 +46,16 @@ namespace {
         glm::ivec3 outDimensions;
     };
 #include "milkywayconversiontask_codegen.cpp"
+
+    using Voxel = glm::tvec4<GLfloat>;
+    using SliceReader = openspace::volume::TextureSliceVolumeReader<Voxel>;
+
+    // The number of slices that are decoded ahead of the slab that is currently sampled,
+    // per prefetch thread
+    constexpr size_t PrefetchSlicesPerThread = 2;
+
+    // The smallest number of output rows that is worth sampling on a separate thread
+    constexpr size_t MinRowsPerRange = 4;
 } // namespace
 
 namespace openspace {
@@ -72,27 +88,68 @@ void MilkywayConversionTask::perform(const Task::ProgressCallback& onProgress) {
         );
     }
 
-    TextureSliceVolumeReader<glm::tvec4<GLfloat>> sliceReader(filenames, _inNSlices, 10);
-    sliceReader.initialize();
+    const glm::uvec3 outDimensions = glm::uvec3(_outDimensions);
+    // The slice reader decodes the input slices on its own prefetch threads, which run
+    // alongside the sampling of the current slab
+    const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
 
-    RawVolumeWriter<glm::tvec4<GLfloat>> rawWriter(_outFilename);
-    rawWriter.setDimensions(_outDimensions);
+    // Each output slice reads from about as many input slices as the resolution ratio
+    // along z, plus one for the interpolation. The cache has to hold those as well as
+    // the slices that are decoded ahead of time
+    const size_t prefetchDistance = nThreads * PrefetchSlicesPerThread;
+    const float zRatio = static_cast<float>(_inNSlices) / outDimensions.z;
+    const size_t slicesPerSlab = static_cast<size_t>(std::ceil(zRatio)) + 2;
+    SliceReader sliceReader(
+        filenames,
+        _inNSlices,
+        slicesPerSlab + prefetchDistance,
+        nThreads,
+        prefetchDistance
+    );
+    sliceReader.initialize();
 
     const glm::vec3 resolutionRatio = static_cast<glm::vec3>(sliceReader.dimensions()) /
-                                      static_cast<glm::vec3>(rawWriter.dimensions());
+                                      static_cast<glm::vec3>(outDimensions);
+    const VolumeSampler<SliceReader> readerSampler(&sliceReader, resolutionRatio);
 
-    const VolumeSampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> sampler(
-        &sliceReader,
-        resolutionRatio
-    );
-    auto sampleFunction = [resolutionRatio, sampler](const glm::ivec3& outCoord) {
-        const glm::vec3 inCoord =
-            ((glm::vec3(outCoord) + glm::vec3(0.5f)) * resolutionRatio) - glm::vec3(0.5f);
-        const glm::tvec4<GLfloat> value = sampler.sample(inCoord);
-        return value;
-    };
+    RawVolumeWriter<Voxel> writer(_outFilename);
+    writer.begin(outDimensions);
+
+    // The output is produced one z slice at a time. The input slices needed for it are
+    // pinned up front, so the rows of the slab can be sampled on the shared pool without
+    // touching the slice cache, while the prefetch threads decode the next input slices
+    std::vector<Voxel> slab(static_cast<size_t>(outDimensions.x) * outDimensions.y);
+    for (unsigned int z = 0; z < outDimensions.z; z++) {
+        const float inZ = (z + 0.5f) * resolutionRatio.z - 0.5f;
+        const glm::ivec2 range = readerSampler.sliceRange(inZ, inZ);
+        const SliceReader::SliceRange slices = sliceReader.slices(range.x, range.y);
+        const VolumeSampler<SliceReader::SliceRange> sampler(&slices, resolutionRatio);
 
-    rawWriter.write(sampleFunction, onProgress);
+        parallelForRanges(
+            outDimensions.y,
+            parallelRangeCount(outDimensions.y, MinRowsPerRange),
+            [&](size_t, size_t firstRow, size_t endRow) {
+                const glm::vec3 origin =
+                    (glm::vec3(0.f, firstRow, z) + glm::vec3(0.5f)) * resolutionRatio -
+                    glm::vec3(0.5f);
+                const glm::uvec3 count =
+                    glm::uvec3(outDimensions.x, endRow - firstRow, 1);
+                sampler.sample(
+                    origin,
+                    resolutionRatio,
+                    count,
+                    std::span(slab).subspan(
+                        firstRow * outDimensions.x,
+                        count.x * count.y
+                    )
+                );
+            }
+        );
+
+        writer.append(slab);
+        onProgress(static_cast<float>(z + 1) / outDimensions.z);
+    }
+    writer.finish();
 }
 
 } // namespace openspace
@@ -80,23 +80,19 @@ void DataProcessorKameleon::addDataValues(const std::string& path,
     }
 
     std::vector<float> sum(numOptions, 0.f);
-    std::vector<std::vector<float>> optionValues(numOptions, std::vector<float>());
     const std::vector<std::string>& options = dataOptions.options();
 
-    const int numValues = static_cast<int>(_dimensions.x * _dimensions.y * _dimensions.z);
+    const size_t numValues = _dimensions.x * _dimensions.y * _dimensions.z;
+    std::vector<std::vector<float>> optionValues(
+        numOptions,
+        std::vector<float>(numValues)
+    );
 
     for (int i = 0; i < numOptions; i++) {
         //0.5 to gather interesting values for the normalization/histograms.
-        float* values = _kw->uniformSliceValues(
-            options[i],
-            _dimensions,
-            0.5f
-        );
-
-        for (int j=0; j<numValues; j++) {
-            const float value = values[j];
+        _kw->uniformSliceValues(options[i], _dimensions, 0.5f, optionValues[i]);
 
-            optionValues[i].push_back(value);
+        for (const float value : optionValues[i]) {
             _min[i] = std::min(_min[i], value);
             _max[i] = std::max(_max[i], value);
             sum[i] += value;
@@ -134,10 +130,12 @@ std::vector<float*> DataProcessorKameleon::processData(const std::string& path,
 
     std::vector<float*> dataOptions(numOptions, nullptr);
     for (int option : selectedOptionsIndices) {
-        dataOptions[option] = _kw->uniformSliceValues(
+        dataOptions[option] = new float[numValues];
+        _kw->uniformSliceValues(
             options[option],
             dimensions,
-            _slice
+            _slice,
+            std::span<float>(dataOptions[option], numValues)
         );
 
         for (int i = 0; i < numValues; i++) {
@@ -29,6 +29,7 @@
 #include <glm/gtx/std_based_type.hpp>
 #include <array>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -85,14 +86,30 @@ public:
     bool open(const std::filesystem::path& filename);
     void close();
 
-    float* uniformSampledValues(const std::string& var,
-        const glm::size3_t& outDimensions) const;
-
-    float* uniformSliceValues(const std::string& var, const glm::size3_t& outDimensions,
-        float zSlice) const;
-
-    float* uniformSampledVectorValues(const std::string& xVar, const std::string& yVar,
-        const std::string& zVar, const glm::size3_t& outDimensions) const;
+    /**
+     * Samples \p var on a uniform grid of \p outDimensions and writes the values,
+     * normalized to [0, 1], into \p result, which must hold one float per sample with
+     * x as the fastest varying index. The grid is sampled on multiple threads.
+     */
+    void uniformSampledValues(const std::string& var, const glm::size3_t& outDimensions,
+        std::span<float> result) const;
+
+    /**
+     * Samples \p var on a uniform grid of \p outDimensions, where every dimension of
+     * size 1 is fixed at \p zSlice, and writes the values into \p result, which must
+     * hold one float per sample. Missing values are written as 0.
+     */
+    void uniformSliceValues(const std::string& var, const glm::size3_t& outDimensions,
+        float zSlice, std::span<float> result) const;
+
+    /**
+     * Samples the vector field made up of \p xVar, \p yVar, and \p zVar on a uniform
+     * grid of \p outDimensions and writes it as normalized RGBA values into \p result,
+     * which must hold four floats per sample.
+     */
+    void uniformSampledVectorValues(const std::string& xVar, const std::string& yVar,
+        const std::string& zVar, const glm::size3_t& outDimensions,
+        std::span<float> result) const;
 
     Fieldlines classifiedFieldLines(const std::string& xVar, const std::string& yVar,
         const std::string& zVar, const std::vector<glm::vec3>& seedPoints,
@@ -127,12 +144,19 @@ public:
 private:
     using TraceLine = std::vector<glm::vec3>;
 
-    TraceLine traceCartesianFieldline(const std::string& xVar, const std::string& yVar,
-        const std::string& zVar, const glm::vec3& seedPoint, float stepSize,
+    long int loadVariable(const std::string& var) const;
+    std::array<long int, 3> loadVectorVariables(const std::string& xVar,
+        const std::string& yVar, const std::string& zVar) const;
+
+    TraceLine traceCartesianFieldline(ccmc::Interpolator& interpolator,
+        const std::array<long int, 3>& ids, const glm::vec3& seedPoint, float stepSize,
         TraceDirection direction, FieldlineEnd& end) const;
 
-    TraceLine traceLorentzTrajectory(const glm::vec3& seedPoint, float stepsize,
-        float eCharge) const;
+    TraceLine traceLorentzTrajectory(ccmc::Interpolator& interpolator,
+        const std::array<long int, 3>& velocityIds,
+        const std::array<long int, 3>& magneticIds,
+        const std::array<long int, 3>& currentIds, const glm::vec3& seedPoint,
+        float stepsize, float eCharge) const;
 
     GridType gridType(const std::string& x, const std::string& y,
         const std::string& z) const;
@@ -24,6 +24,7 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 
+#include <openspace/util/parallelfor.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
@@ -31,7 +32,9 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/stringhelper.h>
+#include <algorithm>
 #include <filesystem>
+#include <memory>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -54,6 +57,40 @@
 namespace {
     constexpr std::string_view _loggerCat = "KameleonWrapper";
     constexpr float RE_TO_METER = 6371000;
+
+    // Fewer rows than this per range are not worth the cost of another interpolator
+    constexpr size_t MinRowsPerRange = 16;
+
+    // Calls `func` for all indices in [0, n), split into contiguous ranges that are
+    // processed on the shared thread pool. A Kameleon interpolator caches the last cell
+    // it visited and can thus not be shared between threads, so the first range uses the
+    // provided `interpolator` and every other range gets its own one created from the
+    // `model` up front. If any call throws, the exception for the lowest range is
+    // rethrown after all ranges have finished
+    template <typename Func>
+    void forEachWithInterpolator(ccmc::Model& model, ccmc::Interpolator& interpolator,
+                                 size_t n, size_t minItemsPerRange, Func&& func)
+    {
+        const size_t nRanges = openspace::parallelRangeCount(n, minItemsPerRange);
+
+        std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators;
+        interpolators.reserve(nRanges - 1);
+        for (size_t range = 1; range < nRanges; range++) {
+            interpolators.emplace_back(model.createNewInterpolator());
+        }
+
+        openspace::parallelForRanges(
+            n,
+            nRanges,
+            [&](size_t range, size_t begin, size_t end) {
+                ccmc::Interpolator& interp =
+                    range == 0 ? interpolator : *interpolators[range - 1];
+                for (size_t i = begin; i < end; i++) {
+                    func(interp, i);
+                }
+            }
+        );
+    }
 } // namespace
 
 namespace openspace {
@@ -166,21 +203,27 @@ void KameleonWrapper::close() {
     _gridType = GridType::Unknown;
 }
 
-// This method returns new'd memory,  turn into std::vector<float> instead?
-float* KameleonWrapper::uniformSampledValues(const std::string& var,
-                                             const glm::size3_t& outDimensions) const
+void KameleonWrapper::uniformSampledValues(const std::string& var,
+                                           const glm::size3_t& outDimensions,
+                                           std::span<float> result) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
+    ghoul_assert(
+        result.size() == outDimensions.x * outDimensions.y * outDimensions.z,
+        "Result must have one value per sample"
+    );
 
     LINFO(std::format(
         "Loading variable '{}' from CDF data with a uniform sampling", var
     ));
 
+    // Interpolating by name may load the variable into the model, which is not safe
+    // while other threads are interpolating, so the variable is resolved up front
+    const long int varId = loadVariable(var);
+
     const size_t size = outDimensions.x * outDimensions.y * outDimensions.z;
-    float* data = new float[size];
     std::vector<double> doubleData(size);
 
-
     const double varMin =
         _model->getVariableAttribute(var, "actual_min").getAttributeFloat();
     LDEBUG(std::format("{} Min: {}", var, varMin));
@@ -188,6 +231,85 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
         _model->getVariableAttribute(var, "actual_max").getAttributeFloat();
     LDEBUG(std::format("{} Max: {}", var, varMax));
 
+    auto sample = [&](ccmc::Interpolator& interpolator, size_t x, size_t y, size_t z) {
+        if (_gridType == GridType::Spherical) {
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * x / outDimensions.x - 1;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * z / outDimensions.z - 1;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model range to
+            // avoid gaps in the data Subtract a small term to avoid rounding errors when
+            // comparing to phiMax.
+            const double phiPh = _min.z + phiNorm /
+                glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
+
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
+                }
+                // Leave values at zero if outside domain
+                return 0.0;
+            }
+
+            // ENLIL CDF specific hacks!
+            // Convert from meters to AU for interpolator
+            const double localRPh = rPh / ccmc::constants::AU_in_meters;
+            // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
+            const double localThetaPh = -thetaPh * 180.f / glm::pi<double>() + 90.f;
+            // Convert from [0, 2pi] rad to [0, 360] degrees
+            const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+            // Sample
+            return static_cast<double>(interpolator.interpolate(
+                varId,
+                static_cast<float>(localRPh),
+                static_cast<float>(localThetaPh),
+                static_cast<float>(localPhiPh)
+            ));
+        }
+        else {
+            // Assume cartesian for fallback purpose
+            const double stepX = (_max.x - _min.x) / static_cast<double>(outDimensions.x);
+            const double stepY = (_max.y - _min.y) / static_cast<double>(outDimensions.y);
+            const double stepZ = (_max.z - _min.z) / static_cast<double>(outDimensions.z);
+
+            const double xPos = _min.x + stepX * x;
+            const double yPos = _min.y + stepY * y;
+            const double zPos = _min.z + stepZ * z;
+
+            // get interpolated data value for (xPos, yPos, zPos)
+            // swap yPos and zPos because model has Z as up
+            return static_cast<double>(interpolator.interpolate(
+                varId,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos)
+            ));
+        }
+    };
+
+    // Every row of constant y and z is contiguous in the output
+    const size_t nRows = outDimensions.y * outDimensions.z;
+    forEachWithInterpolator(*_model, *_interpolator, nRows, MinRowsPerRange,
+        [&](ccmc::Interpolator& interpolator, size_t row) {
+            const size_t y = row % outDimensions.y;
+            const size_t z = row / outDimensions.y;
+            for (size_t x = 0; x < outDimensions.x; x++) {
+                doubleData[row * outDimensions.x + x] = sample(interpolator, x, y, z);
+            }
+        }
+    );
+
     // HISTOGRAM
     constexpr int NBins = 200;
     std::vector<int> histogram(NBins, 0);
@@ -200,92 +322,8 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
 
         return glm::clamp(izerotoone, 0, NBins - 1);
     };
-
-    // ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Spherical) {
-                    // Put r in the [0..sqrt(3)] range
-                    const double rNorm = glm::root_three<double>() * x /
-                                         outDimensions.x - 1;
-
-                    // Put theta in the [0..PI] range
-                    const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
-
-                    // Put phi in the [0..2PI] range
-                    const double phiNorm = glm::two_pi<double>() * z /
-                                           outDimensions.z - 1;
-
-                    // Go to physical coordinates before sampling
-                    const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                    const double thetaPh = thetaNorm;
-                    // phi range needs to be mapped to the slightly different model
-                    // range to avoid gaps in the data Subtract a small term to
-                    // avoid rounding errors when comparing to phiMax.
-                    const double phiPh = _min.z + phiNorm /
-                                    glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
-
-                    double value = 0.0;
-                    // See if sample point is inside domain
-                    if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                        thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                    {
-                        if (phiPh > _max.z) {
-                            LWARNING("Warning: There might be a gap in the data");
-                        }
-                        // Leave values at zero if outside domain
-                    }
-                    else { // if inside
-                        // ENLIL CDF specific hacks!
-                        // Convert from meters to AU for interpolator
-                        const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                        // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
-                        const double localThetaPh = -thetaPh * 180.f /
-                                                    glm::pi<double>() + 90.f;
-                        // Convert from [0, 2pi] rad to [0, 360] degrees
-                        const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                        // Sample
-                        value = _interpolator->interpolate(
-                            var,
-                            static_cast<float>(localRPh),
-                            static_cast<float>(localThetaPh),
-                            static_cast<float>(localPhiPh)
-                        );
-                    }
-
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
-                }
-                else {
-                    // Assume cartesian for fallback purpose
-                    const double stepX = (_max.x - _min.x) /
-                                         (static_cast<double>(outDimensions.x));
-                    const double stepY = (_max.y - _min.y) /
-                                         (static_cast<double>(outDimensions.y));
-                    const double stepZ = (_max.z - _min.z) /
-                                         (static_cast<double>(outDimensions.z));
-
-                    const double xPos = _min.x + stepX * x;
-                    const double yPos = _min.y + stepY * y;
-                    const double zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    // swap yPos and zPos because model has Z as up
-                    double value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos)
-                    );
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
-                }
-            }
-        }
+    for (const double value : doubleData) {
+        histogram[mapToHistogram(value)]++;
     }
 
     int sum = 0;
@@ -305,35 +343,26 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
     const double varMaxNew = varMin + dist;
     for (size_t i = 0; i < size; i++) {
         const double normalizedVal = (doubleData[i] - varMin) / (varMaxNew - varMin);
-
-        data[i] = static_cast<float>(glm::clamp(normalizedVal, 0.0, 1.0));
-        if (data[i] < 0.f) {
-            LERROR(std::format("Datapoint {} less than 0", i));
-        }
-        if (data[i] > 1.f) {
-            LERROR(std::format("Datapoint {} more than 1", i));
-        }
+        result[i] = static_cast<float>(glm::clamp(normalizedVal, 0.0, 1.0));
     }
-
-    return data;
 }
 
-// This method returns new'd memory,  turn into std::vector<float> instead?
-float* KameleonWrapper::uniformSliceValues(const std::string& var,
-                                           const glm::size3_t& outDimensions,
-                                           float slice) const
+void KameleonWrapper::uniformSliceValues(const std::string& var,
+                                         const glm::size3_t& outDimensions, float slice,
+                                         std::span<float> result) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
+    ghoul_assert(
+        result.size() == outDimensions.x * outDimensions.y * outDimensions.z,
+        "Result must have one value per sample"
+    );
+
     LINFO(std::format(
         "Loading variable '{}' from CDF data with a uniform sampling",
         var
     ));
 
-    const size_t size = outDimensions.x * outDimensions.y * outDimensions.z;
-    float* data = new float[size];
-    std::vector<double> doubleData(size);
-
-    _model->loadVariable(var);
+    const long int varId = loadVariable(var);
 
     const double varMin =
         _model->getVariableAttribute(var, "actual_min").getAttributeFloat();
@@ -355,103 +384,92 @@ float* KameleonWrapper::uniformSliceValues(const std::string& var,
     LDEBUG(std::format("{} min: {}", var, varMin));
     LDEBUG(std::format("{} max: {}", var, varMax));
 
-    //double maxValue = 0.0;
-    //double minValue = std::numeric_limits<double>::max();
-
-    float missingValue = _model->getMissingValue();
-
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-
-                const float xi = (hasXSlice) ? slice : x;
-                const float yi = (hasYSlice) ? slice : y;
-                const float zi = (hasZSlice) ? slice : z;
-
-                double value = 0;
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-                if (_gridType == GridType::Spherical) {
-                        // int z = zSlice;
-                        // Put r in the [0..sqrt(3)] range
-                        const double rNorm = glm::root_three<double>() * xi / xDim;
-
-                        // Put theta in the [0..PI] range
-                        const double thetaNorm = glm::pi<double>() * yi / yDim;
-
-                        // Put phi in the [0..2PI] range
-                        const double phiNorm = glm::two_pi<double>() * zi / zDim;
-
-                        // Go to physical coordinates before sampling
-                        const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                        const double thetaPh = thetaNorm;
-                        // phi range needs to be mapped to the slightly different model
-                        // range to avoid gaps in the data Subtract a small term to
-                        // avoid rounding errors when comparing to phiMax.
-                        const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
-                                             (_max.z - _min.z - 0.000001);
-
-                        // See if sample point is inside domain
-                        if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                            thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                        {
-                            if (phiPh > _max.z) {
-                                LWARNING("Warning: There might be a gap in the data");
-                            }
-                            // Leave values at zero if outside domain
-                        }
-                        else {
-                            // if inside
-                            // ENLIL CDF specific hacks!
-                            // Convert from meters to AU for interpolator
-                            const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                            // Convert from colatitude [0, pi] rad to [-90, 90] deg
-                            const double localThetaPh = -thetaPh * 180.f /
-                                                        glm::pi<double>() + 90.f;
-                            // Convert from [0, 2pi] rad to [0, 360] degrees
-                            const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                            // Sample
-                            value = _interpolator->interpolate(
-                                var,
-                                static_cast<float>(localRPh),
-                                static_cast<float>(localPhiPh),
-                                static_cast<float>(localThetaPh)
-                            );
-                        }
-
-                }
-                else {
-                    const double xPos = _min.x + stepX * xi;
-                    const double yPos = _min.y + stepY * yi;
-                    const double zPos = _min.z + stepZ * zi;
-
-                    // std::cout << zPos << ", " << zpos << std::endl;
-                    // Should y and z be flipped?
-                    value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos));
-                }
-
-                if (value != missingValue) {
-                    doubleData[index] = value;
-                    data[index] = static_cast<float>(value);
-                }
-                else {
-                    doubleData[index] = 0;
+    const float missingValue = _model->getMissingValue();
+
+    auto sample = [&](ccmc::Interpolator& interpolator, size_t x, size_t y, size_t z) {
+        const float xi = (hasXSlice) ? slice : x;
+        const float yi = (hasYSlice) ? slice : y;
+        const float zi = (hasZSlice) ? slice : z;
+
+        if (_gridType == GridType::Spherical) {
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * xi / xDim;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * yi / yDim;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * zi / zDim;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model range to
+            // avoid gaps in the data Subtract a small term to avoid rounding errors when
+            // comparing to phiMax.
+            const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
+                (_max.z - _min.z - 0.000001);
+
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
                 }
+                // Leave values at zero if outside domain
+                return 0.f;
             }
+
+            // ENLIL CDF specific hacks!
+            // Convert from meters to AU for interpolator
+            const double localRPh = rPh / ccmc::constants::AU_in_meters;
+            // Convert from colatitude [0, pi] rad to [-90, 90] deg
+            const double localThetaPh = -thetaPh * 180.f / glm::pi<double>() + 90.f;
+            // Convert from [0, 2pi] rad to [0, 360] degrees
+            const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+            // Sample
+            return interpolator.interpolate(
+                varId,
+                static_cast<float>(localRPh),
+                static_cast<float>(localPhiPh),
+                static_cast<float>(localThetaPh)
+            );
         }
-    }
+        else {
+            const double xPos = _min.x + stepX * xi;
+            const double yPos = _min.y + stepY * yi;
+            const double zPos = _min.z + stepZ * zi;
+
+            // Should y and z be flipped?
+            return interpolator.interpolate(
+                varId,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos)
+            );
+        }
+    };
 
-    return data;
+    // Every row of constant y and z is contiguous in the output
+    const size_t nRows = outDimensions.y * outDimensions.z;
+    forEachWithInterpolator(*_model, *_interpolator, nRows, MinRowsPerRange,
+        [&](ccmc::Interpolator& interpolator, size_t row) {
+            const size_t y = row % outDimensions.y;
+            const size_t z = row / outDimensions.y;
+            for (size_t x = 0; x < outDimensions.x; x++) {
+                const float value = sample(interpolator, x, y, z);
+                result[row * outDimensions.x + x] = value != missingValue ? value : 0.f;
+            }
+        }
+    );
 }
 
-float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
-                                                   const std::string& yVar,
-                                                   const std::string& zVar,
-                                                  const glm::size3_t& outDimensions) const
+void KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
+                                                 const std::string& yVar,
+                                                 const std::string& zVar,
+                                                 const glm::size3_t& outDimensions,
+                                                 std::span<float> result) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
 
@@ -463,8 +481,20 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     ));
 
     constexpr int NumChannels = 4;
-    const size_t size = NumChannels * outDimensions.x * outDimensions.y * outDimensions.z;
-    float* data = new float[size];
+    ghoul_assert(
+        result.size() ==
+            NumChannels * outDimensions.x * outDimensions.y * outDimensions.z,
+        "Result must have four values per sample"
+    );
+
+    if (_gridType != GridType::Cartesian) {
+        LERROR(
+            "Only cartesian grid supported for uniformSampledVectorValues (for now)"
+        );
+        return;
+    }
+
+    const std::array<long int, 3> ids = loadVectorVariables(xVar, yVar, zVar);
 
     float varXMin = _model->getVariableAttribute(xVar, "actual_min").getAttributeFloat();
     float varXMax = _model->getVariableAttribute(xVar, "actual_max").getAttributeFloat();
@@ -477,50 +507,33 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     const float stepY = (_max.y - _min.y) / (static_cast<float>(outDimensions.y));
     const float stepZ = (_max.z - _min.z) / (static_cast<float>(outDimensions.z));
 
-    //LDEBUG(xVar << "Min: " << varXMin);
-    //LDEBUG(xVar << "Max: " << varXMax);
-    //LDEBUG(yVar << "Min: " << varYMin);
-    //LDEBUG(yVar << "Max: " << varYMax);
-    //LDEBUG(zVar << "Min: " << varZMin);
-    //LDEBUG(zVar << "Max: " << varZMax);
-
-    //ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        //pb.print(x);
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x * NumChannels + y * NumChannels * outDimensions.x +
-                                     z * NumChannels * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Cartesian) {
-                    const float xPos = _min.x + stepX * x;
-                    const float yPos = _min.y + stepY * y;
-                    const float zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    const float xVal = _interpolator->interpolate(xVar, xPos, yPos, zPos);
-                    const float yVal = _interpolator->interpolate(yVar, xPos, yPos, zPos);
-                    const float zVal = _interpolator->interpolate(zVar, xPos, yPos, zPos);
-
-                    // scale to [0,1]
-                    data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
-                    data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
-                    data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
-                    // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
-                    data[index + 3] = 1.f;
-                }
-                else {
-                    LERROR(
-                        "Only cartesian grid supported for "
-                        "uniformSampledVectorValues (for now)"
-                    );
-                    return data;
-                }
+    // Every row of constant y and z is contiguous in the output
+    const size_t nRows = outDimensions.y * outDimensions.z;
+    forEachWithInterpolator(*_model, *_interpolator, nRows, MinRowsPerRange,
+        [&](ccmc::Interpolator& interpolator, size_t row) {
+            const size_t y = row % outDimensions.y;
+            const size_t z = row / outDimensions.y;
+            for (size_t x = 0; x < outDimensions.x; x++) {
+                const size_t index = (row * outDimensions.x + x) * NumChannels;
+
+                const float xPos = _min.x + stepX * x;
+                const float yPos = _min.y + stepY * y;
+                const float zPos = _min.z + stepZ * z;
+
+                // get interpolated data value for (xPos, yPos, zPos)
+                const float xVal = interpolator.interpolate(ids[0], xPos, yPos, zPos);
+                const float yVal = interpolator.interpolate(ids[1], xPos, yPos, zPos);
+                const float zVal = interpolator.interpolate(ids[2], xPos, yPos, zPos);
+
+                // scale to [0,1]
+                result[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
+                result[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
+                result[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
+                // GL_RGB refuses to work. Workaround doing a GL_RGBA hardcoded alpha
+                result[index + 3] = 1.f;
             }
         }
-    }
-
-    return data;
+    );
 }
 
 KameleonWrapper::Fieldlines KameleonWrapper::classifiedFieldLines(const std::string& xVar,
@@ -535,27 +548,29 @@ KameleonWrapper::Fieldlines KameleonWrapper::classifiedFieldLines(const std::str
         seedPoints.size(), xVar, yVar, zVar
     ));
 
-    std::vector<std::vector<LinePoint> > fieldLines;
+    if (_type != Model::BATSRUS) {
+        LERROR("Fieldlines are only supported for BATSRUS model");
+        return Fieldlines();
+    }
 
-    if (_type == Model::BATSRUS) {
-        fieldLines.reserve(seedPoints.size());
-        for (const glm::vec3& seedPoint : seedPoints) {
+    const std::array<long int, 3> ids = loadVectorVariables(xVar, yVar, zVar);
+    Fieldlines fieldLines = Fieldlines(seedPoints.size());
+    forEachWithInterpolator(*_model, *_interpolator, seedPoints.size(), 1,
+        [&](ccmc::Interpolator& interpolator, size_t i) {
             FieldlineEnd forwardEnd;
             std::vector<glm::vec3> fLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
+                interpolator,
+                ids,
+                seedPoints[i],
                 stepSize,
                 TraceDirection::FORWARD,
                 forwardEnd
             );
             FieldlineEnd backEnd;
             std::vector<glm::vec3> bLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
+                interpolator,
+                ids,
+                seedPoints[i],
                 stepSize,
                 TraceDirection::BACK,
                 backEnd
@@ -565,20 +580,16 @@ KameleonWrapper::Fieldlines KameleonWrapper::classifiedFieldLines(const std::str
             bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
 
             // classify
-            glm::vec4 color = classifyFieldline(forwardEnd, backEnd);
+            const glm::vec4 color = classifyFieldline(forwardEnd, backEnd);
 
             // write colors and convert positions to meter
-            std::vector<LinePoint> line;
-            for (glm::vec3& position : bLine) {
-                line.push_back({ RE_TO_METER * std::move(position), color });
+            std::vector<LinePoint>& line = fieldLines[i];
+            line.reserve(bLine.size());
+            for (const glm::vec3& position : bLine) {
+                line.push_back({ RE_TO_METER * position, color });
             }
-
-            fieldLines.push_back(line);
         }
-    }
-    else {
-        LERROR("Fieldlines are only supported for BATSRUS model");
-    }
+    );
 
     return fieldLines;
 }
@@ -597,27 +608,29 @@ KameleonWrapper::Fieldlines KameleonWrapper::fieldLines(const std::string& xVar,
         seedPoints.size(), xVar, yVar, zVar
     ));
 
-    Fieldlines fieldLines;
+    if (_type != Model::BATSRUS) {
+        LERROR("Fieldlines are only supported for BATSRUS model");
+        return Fieldlines();
+    }
 
-    if (_type == Model::BATSRUS) {
-        fieldLines.reserve(seedPoints.size());
-        for (const glm::vec3& seedPoint : seedPoints) {
+    const std::array<long int, 3> ids = loadVectorVariables(xVar, yVar, zVar);
+    Fieldlines fieldLines = Fieldlines(seedPoints.size());
+    forEachWithInterpolator(*_model, *_interpolator, seedPoints.size(), 1,
+        [&](ccmc::Interpolator& interpolator, size_t i) {
             FieldlineEnd forwardEnd;
             std::vector<glm::vec3> fLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
+                interpolator,
+                ids,
+                seedPoints[i],
                 stepSize,
                 TraceDirection::FORWARD,
                 forwardEnd
             );
             FieldlineEnd backEnd;
             std::vector<glm::vec3> bLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
+                interpolator,
+                ids,
+                seedPoints[i],
                 stepSize,
                 TraceDirection::BACK,
                 backEnd
@@ -627,17 +640,13 @@ KameleonWrapper::Fieldlines KameleonWrapper::fieldLines(const std::string& xVar,
             bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
 
             // write colors and convert positions to meter
-            std::vector<LinePoint> line;
-            for (glm::vec3& position : bLine) {
-                line.push_back({ RE_TO_METER * std::move(position), color });
+            std::vector<LinePoint>& line = fieldLines[i];
+            line.reserve(bLine.size());
+            for (const glm::vec3& position : bLine) {
+                line.push_back({ RE_TO_METER * position, color });
             }
-
-            fieldLines.push_back(line);
         }
-    }
-    else {
-        LERROR("Fieldlines are only supported for BATSRUS model");
-    }
+    );
 
     return fieldLines;
 }
@@ -647,36 +656,61 @@ KameleonWrapper::Fieldlines KameleonWrapper::lorentzTrajectories(
                                                                const glm::vec4& /*color*/,
                                                                          float step) const
 {
-    LINFO(std::format("Creating {} Lorentz force trajectories", seedPoints.size()));
+    ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
 
-    Fieldlines trajectories;
+    LINFO(std::format("Creating {} Lorentz force trajectories", seedPoints.size()));
 
-    for (const glm::vec3& seedPoint : seedPoints) {
-        std::vector<glm::vec3> posTraj = traceLorentzTrajectory(seedPoint, step, 1.f);
-        std::vector<glm::vec3> negTraj = traceLorentzTrajectory(seedPoint, step, -1.f);
+    // Loading the variables modifies the model, so it has to happen before the
+    // trajectories are traced in parallel
+    const std::array<long int, 3> velocityIds = loadVectorVariables("ux", "uy", "uz");
+    const std::array<long int, 3> magneticIds = loadVectorVariables("bx", "by", "bz");
+    const std::array<long int, 3> currentIds = loadVectorVariables("jx", "jy", "jz");
+
+    Fieldlines trajectories = Fieldlines(seedPoints.size());
+    forEachWithInterpolator(*_model, *_interpolator, seedPoints.size(), 1,
+        [&](ccmc::Interpolator& interpolator, size_t i) {
+            std::vector<glm::vec3> posTraj = traceLorentzTrajectory(
+                interpolator,
+                velocityIds,
+                magneticIds,
+                currentIds,
+                seedPoints[i],
+                step,
+                1.f
+            );
+            std::vector<glm::vec3> negTraj = traceLorentzTrajectory(
+                interpolator,
+                velocityIds,
+                magneticIds,
+                currentIds,
+                seedPoints[i],
+                step,
+                -1.f
+            );
 
-        negTraj.insert(negTraj.begin(), posTraj.rbegin(), posTraj.rend());
+            negTraj.insert(negTraj.begin(), posTraj.rbegin(), posTraj.rend());
 
-        // write colors and convert positions to meter
-        std::vector<LinePoint> trajectory;
-        for (glm::vec3& position : negTraj) {
-            if (trajectory.size() < posTraj.size()) {
-                // set positive trajectory to pink
-                trajectory.push_back({
-                    RE_TO_METER * std::move(position),
-                    glm::vec4(1.f, 0.f, 1.f, 1.f)
-                });
-            }
-            else {
-                // set negative trajectory to cyan
-                trajectory.push_back({
-                    RE_TO_METER * std::move(position),
-                    glm::vec4(0.f, 1.f, 1.f, 1.f)
-                });
+            // write colors and convert positions to meter
+            std::vector<LinePoint>& trajectory = trajectories[i];
+            trajectory.reserve(negTraj.size());
+            for (const glm::vec3& position : negTraj) {
+                if (trajectory.size() < posTraj.size()) {
+                    // set positive trajectory to pink
+                    trajectory.push_back({
+                        RE_TO_METER * position,
+                        glm::vec4(1.f, 0.f, 1.f, 1.f)
+                    });
+                }
+                else {
+                    // set negative trajectory to cyan
+                    trajectory.push_back({
+                        RE_TO_METER * position,
+                        glm::vec4(0.f, 1.f, 1.f, 1.f)
+                    });
+                }
             }
         }
-        trajectories.push_back(trajectory);
-    }
+    );
 
     return trajectories;
 }
@@ -766,10 +800,21 @@ KameleonWrapper::GridType KameleonWrapper::gridType() const {
     return _gridType;
 }
 
+long int KameleonWrapper::loadVariable(const std::string& var) const {
+    _model->loadVariable(var);
+    return _model->getVariableID(var);
+}
+
+std::array<long int, 3> KameleonWrapper::loadVectorVariables(const std::string& xVar,
+                                                              const std::string& yVar,
+                                                        const std::string& zVar) const
+{
+    return { loadVariable(xVar), loadVariable(yVar), loadVariable(zVar) };
+}
+
 KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
-                                                                  const std::string& xVar,
-                                                                  const std::string& yVar,
-                                                                  const std::string& zVar,
+                                                         ccmc::Interpolator& interpolator,
+                                                      const std::array<long int, 3>& ids,
                                                                const glm::vec3& seedPoint,
                                                                            float stepSize,
                                                                  TraceDirection direction,
@@ -777,14 +822,9 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
 {
     constexpr int MaxSteps = 5000;
 
-    _model->loadVariable(xVar);
-    const long int xID = _model->getVariableID(xVar);
-
-    _model->loadVariable(yVar);
-    const long int yID = _model->getVariableID(yVar);
-
-    _model->loadVariable(zVar);
-    const long int zID = _model->getVariableID(zVar);
+    const long int xID = ids[0];
+    const long int yID = ids[1];
+    const long int zID = ids[2];
 
     glm::vec3 pos = seedPoint;
     int numSteps = 0;
@@ -804,9 +844,9 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
         float stepY;
         float stepZ;
         glm::vec3 k1 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, pos.x, pos.y, pos.z, stepX, stepY, stepZ),
-            _interpolator->interpolate(yID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(zID, pos.x, pos.y, pos.z)
+            interpolator.interpolate(xID, pos.x, pos.y, pos.z, stepX, stepY, stepZ),
+            interpolator.interpolate(yID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(zID, pos.x, pos.y, pos.z)
         ));
         k1 = (direction == TraceDirection::FORWARD) ? k1 : -1.f * k1;
 
@@ -814,25 +854,25 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
 
         glm::vec3 k1Pos = pos + step / 2.f * k1;
         glm::vec3 k2 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(yID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(zID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(xID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(yID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(zID, k1Pos.x, k1Pos.y, k1Pos.z)
         ));
         k2 = (direction == TraceDirection::FORWARD) ? k2 : -1.f * k2;
 
         glm::vec3 k2Pos = pos + step / 2.f * k2;
         glm::vec3 k3 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k2Pos.x, k2Pos.y, k2Pos.z),
-            _interpolator->interpolate(yID, k2Pos.x, k2Pos.y, k2Pos.z),
-            _interpolator->interpolate(zID, k2Pos.x, k2Pos.y, k2Pos.z)
+            interpolator.interpolate(xID, k2Pos.x, k2Pos.y, k2Pos.z),
+            interpolator.interpolate(yID, k2Pos.x, k2Pos.y, k2Pos.z),
+            interpolator.interpolate(zID, k2Pos.x, k2Pos.y, k2Pos.z)
         ));
         k3 = (direction == TraceDirection::FORWARD) ? k3 : -1.f * k3;
 
         glm::vec3 k3Pos = pos + step / 2.f * k3;
         glm::vec3 k4 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(yID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(zID, k3Pos.x, k3Pos.y, k3Pos.z)
+            interpolator.interpolate(xID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(yID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(zID, k3Pos.x, k3Pos.y, k3Pos.z)
         ));
         k4 = (direction == TraceDirection::FORWARD) ? k4 : -1.f * k4;
 
@@ -861,6 +901,10 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
 }
 
 KameleonWrapper::TraceLine KameleonWrapper::traceLorentzTrajectory(
+                                                         ccmc::Interpolator& interpolator,
+                                              const std::array<long int, 3>& velocityIds,
+                                              const std::array<long int, 3>& magneticIds,
+                                               const std::array<long int, 3>& currentIds,
                                                                const glm::vec3& seedPoint,
                                                                            float stepsize,
                                                                       float eCharge) const
@@ -869,19 +913,19 @@ KameleonWrapper::TraceLine KameleonWrapper::traceLorentzTrajectory(
 
     glm::vec3 step = glm::vec3(stepsize);
 
-    const long int bxID = _model->getVariableID("bx");
-    const long int byID = _model->getVariableID("by");
-    const long int bzID = _model->getVariableID("bz");
-    const long int jxID = _model->getVariableID("jx");
-    const long int jyID = _model->getVariableID("jy");
-    const long int jzID = _model->getVariableID("jz");
+    const long int bxID = magneticIds[0];
+    const long int byID = magneticIds[1];
+    const long int bzID = magneticIds[2];
+    const long int jxID = currentIds[0];
+    const long int jyID = currentIds[1];
+    const long int jzID = currentIds[2];
 
     TraceLine trajectory;
     glm::vec3 pos = seedPoint;
     glm::vec3 v0 = glm::normalize(glm::vec3(
-        _interpolator->interpolate("ux", pos.x, pos.y, pos.z),
-        _interpolator->interpolate("uy", pos.x, pos.y, pos.z),
-        _interpolator->interpolate("uz", pos.x, pos.y, pos.z)
+        interpolator.interpolate(velocityIds[0], pos.x, pos.y, pos.z),
+        interpolator.interpolate(velocityIds[1], pos.x, pos.y, pos.z),
+        interpolator.interpolate(velocityIds[2], pos.x, pos.y, pos.z)
     ));
 
     int numSteps = 0;
@@ -895,55 +939,55 @@ KameleonWrapper::TraceLine KameleonWrapper::traceLorentzTrajectory(
 
         // Calculate new position with Lorentz force quation and Runge-Kutta 4th order
         glm::vec3 B = glm::vec3(
-            _interpolator->interpolate(bxID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(byID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(bzID, pos.x, pos.y, pos.z)
+            interpolator.interpolate(bxID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(byID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(bzID, pos.x, pos.y, pos.z)
         );
 
         glm::vec3 E = glm::vec3(
-            _interpolator->interpolate(jxID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(jyID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(jzID, pos.x, pos.y, pos.z)
+            interpolator.interpolate(jxID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(jyID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(jzID, pos.x, pos.y, pos.z)
         );
         const glm::vec3 k1 = glm::normalize(eCharge * (E + glm::cross(v0, B)));
         const glm::vec3 k1Pos = pos + step / 2.f * v0 + step * step / 8.f * k1;
 
         B = glm::vec3(
-            _interpolator->interpolate(bxID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(byID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(bzID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(bxID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(byID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(bzID, k1Pos.x, k1Pos.y, k1Pos.z)
         );
         E = glm::vec3(
-            _interpolator->interpolate(jxID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(jyID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(jzID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(jxID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(jyID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(jzID, k1Pos.x, k1Pos.y, k1Pos.z)
         );
         const glm::vec3 v1 = v0 + step / 2.f * k1;
         const glm::vec3 k2 = glm::normalize(eCharge * (E + glm::cross(v1, B)));
 
         B = glm::vec3(
-            _interpolator->interpolate(bxID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(byID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(bzID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(bxID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(byID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(bzID, k1Pos.x, k1Pos.y, k1Pos.z)
         );
         E = glm::vec3(
-            _interpolator->interpolate(jxID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(jyID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(jzID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(jxID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(jyID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(jzID, k1Pos.x, k1Pos.y, k1Pos.z)
         );
         const glm::vec3 v2 = v0 + step / 2.f * k2;
         const glm::vec3 k3 = glm::normalize(eCharge * (E + glm::cross(v2, B)));
         const glm::vec3 k3Pos = pos + step * v0 + step * step / 2.f * k1;
 
         B = glm::vec3(
-            _interpolator->interpolate(bxID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(byID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(bzID, k3Pos.x, k3Pos.y, k3Pos.z)
+            interpolator.interpolate(bxID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(byID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(bzID, k3Pos.x, k3Pos.y, k3Pos.z)
         );
         E = glm::vec3(
-            _interpolator->interpolate(jxID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(jyID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(jzID, k3Pos.x, k3Pos.y, k3Pos.z)
+            interpolator.interpolate(jxID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(jyID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(jzID, k3Pos.x, k3Pos.y, k3Pos.z)
         );
         const glm::vec3 v3 = v0 + step * k3;
         const glm::vec3 k4 = glm::normalize(eCharge * (E + glm::cross(v3, B)));
@@ -26,11 +26,13 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/volume/rawvolume.h>
+#include <modules/volume/voxelevaluation.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
 #include <filesystem>
 
 #ifdef WIN32
@@ -89,11 +91,6 @@ KameleonVolumeReader::KameleonVolumeReader(std::filesystem::path path)
             "Failed to open file '{}' with Kameleon", _path
         ));
     }
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(
-        _kameleon->model->createNewInterpolator()
-    );
 }
 
 KameleonVolumeReader::~KameleonVolumeReader() {}
@@ -131,22 +128,36 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
     const glm::vec3 dims = volume->dimensions();
     const glm::vec3 diff = upperBound - lowerBound;
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
+    // Interpolators remember the cell of the previous lookup and can therefore not be
+    // shared between threads. The variable is loaded up front so that the interpolators
+    // do not try to load it concurrently
+    _kameleon->loadVariable(variable);
+    using Interpolator = std::unique_ptr<ccmc::Interpolator>;
+    auto createInterpolator = [this]() {
+        return Interpolator(_kameleon->model->createNewInterpolator());
     };
 
-    float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); index++) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
-
-        data[index] = interpolate(variable, volumeCoords);
+    auto interpolate = [&](Interpolator& interpolator, const glm::uvec3& cell) {
+        const glm::vec3 coordsZeroToOne = glm::vec3(cell) / dims;
+        const glm::vec3 coords = lowerBound + diff * coordsZeroToOne;
+        return interpolator->interpolate(variable, coords[0], coords[1], coords[2]);
+    };
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
-    }
+    float* data = volume->data();
+    auto write = [&](size_t first, std::span<const float> values) {
+        std::copy(values.begin(), values.end(), data + first);
+        for (const float value : values) {
+            minValue = glm::min(minValue, value);
+            maxValue = glm::max(maxValue, value);
+        }
+    };
 
+    volume::evaluateVoxels<float, Interpolator>(
+        dimensions,
+        createInterpolator,
+        interpolate,
+        write
+    );
     return volume;
 }
 
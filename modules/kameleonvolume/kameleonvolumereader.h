@@ -33,7 +33,6 @@
 
 namespace ccmc {
     class Attribute;
-    class Interpolator;
     class Kameleon;
 } // namespce ccmc
 
@@ -78,7 +77,6 @@ private:
 
     std::filesystem::path _path;
     std::unique_ptr<ccmc::Kameleon> _kameleon;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
 };
 
 } // namespace openspace::kameleonvolume
@@ -24,14 +24,21 @@
 
 #include <modules/multiresvolume/rendering/atlasmanager.h>
 
+#include <modules/multiresvolume/rendering/brickstreamer.h>
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/texture.h>
 #include <cstring>
 
 namespace openspace {
 
-AtlasManager::AtlasManager(TSP* tsp) : _tsp(tsp) {}
+AtlasManager::AtlasManager(TSP* tsp, size_t brickCacheSize)
+    : _tsp(tsp)
+    , _brickCacheSize(brickCacheSize)
+{}
+
+AtlasManager::~AtlasManager() = default;
 
 bool AtlasManager::initialize() {
     TSP::Header header = _tsp->header();
@@ -55,6 +62,19 @@ bool AtlasManager::initialize() {
         _freeAtlasCoords[i] = i;
     }
 
+    try {
+        _brickStreamer = std::make_unique<BrickStreamer>(
+            _tsp->filename(),
+            TSP::dataPosition(),
+            _nBrickVals,
+            _brickCacheSize / _brickSize
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC("AtlasManager", e.message);
+        return false;
+    }
+
     _textureAtlas = new ghoul::opengl::Texture(
         glm::size3_t(_atlasDim, _atlasDim, _atlasDim),
         GL_TEXTURE_3D,
@@ -101,10 +121,19 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
         }
     }
 
+    // Read all bricks that are not in the atlas yet in parallel. The ones that were
+    // prefetched during previous frames are already in the cache and return immediately
+    std::vector<int> missingBricks;
+    for (unsigned int brickIndex : _requiredBricks) {
+        if (!_brickMap.count(brickIndex)) {
+            missingBricks.push_back(brickIndex);
+        }
+    }
+
     // Stats
     _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
     _nStreamedBricks = 0;
-    _nDiskReads = 0;
+    _nDiskReads = _brickStreamer->request(missingBricks);
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
     glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
@@ -155,6 +184,16 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
+void AtlasManager::prefetchBricks(const std::vector<int>& brickIndices) {
+    std::vector<int> missingBricks;
+    for (int brickIndex : brickIndices) {
+        if (!_brickMap.count(brickIndex)) {
+            missingBricks.push_back(brickIndex);
+        }
+    }
+    _brickStreamer->request(missingBricks);
+}
+
 void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
                               float* mappedBuffer)
 {
@@ -168,16 +207,6 @@ void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
         return;
     }
 
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
-
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) *
-                       static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
-
     for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
         if (!_brickMap.count(brickIndex)) {
             unsigned int atlasCoords = _freeAtlasCoords.back();
@@ -189,15 +218,10 @@ void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
             unsigned int atlasData = (level << 28) + atlasCoords;
             _brickMap.emplace(brickIndex, atlasData);
             _nStreamedBricks++;
-            fillVolume(
-                &sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)],
-                mappedBuffer,
-                atlasCoords
-            );
+            BrickStreamer::Brick brick = _brickStreamer->brick(brickIndex);
+            fillVolume(brick->data(), mappedBuffer, atlasCoords);
         }
     }
-
-    delete[] sequenceBuffer;
 }
 
 void AtlasManager::removeFromAtlas(int brickIndex) {
@@ -207,7 +231,9 @@ void AtlasManager::removeFromAtlas(int brickIndex) {
     _freeAtlasCoords.push_back(atlasCoords);
 }
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
+void AtlasManager::fillVolume(const float* in, float* out,
+                              unsigned int linearAtlasCoords)
+{
     int x = linearAtlasCoords % _nBricksPerDim;
     int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
     int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
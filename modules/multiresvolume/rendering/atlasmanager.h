@@ -28,6 +28,7 @@
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -36,6 +37,7 @@ namespace ghoul::opengl { class Texture; }
 
 namespace openspace {
 
+class BrickStreamer;
 class TSP;
 
 class AtlasManager {
@@ -45,10 +47,16 @@ public:
         ODD = 1
     };
 
-    AtlasManager(TSP* tsp);
-    ~AtlasManager() = default;
+    AtlasManager(TSP* tsp, size_t brickCacheSize);
+    ~AtlasManager();
 
     void updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices);
+
+    /**
+     * Starts reading the provided bricks in the background, so that they are available
+     * without stalling once a later call to #updateAtlas needs them.
+     */
+    void prefetchBricks(const std::vector<int>& brickIndices);
     void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
     void removeFromAtlas(int brickIndex);
     bool initialize();
@@ -68,6 +76,8 @@ private:
     const unsigned int NotUsedIndex = std::numeric_limits<unsigned int>::max();
 
     TSP* _tsp;
+    size_t _brickCacheSize;
+    std::unique_ptr<BrickStreamer> _brickStreamer;
     unsigned int _pboHandle[2];
     unsigned int _atlasMapBuffer;
 
@@ -96,7 +106,7 @@ private:
     unsigned int _nBricksInMap;
     unsigned int _atlasDim;
 
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
+    void fillVolume(const float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
@@ -24,9 +24,11 @@
 
 #include <modules/multiresvolume/rendering/brickmanager.h>
 
+#include <modules/multiresvolume/rendering/brickstreamer.h>
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/texture.h>
 #include <glm/gtx/std_based_type.hpp>
 
@@ -104,6 +106,20 @@ bool BrickManager::readHeader() {
         return false;
     }
 
+    try {
+        // Enough cache space to hold one full frame worth of bricks
+        _brickStreamer = std::make_unique<BrickStreamer>(
+            _tsp->filename(),
+            TSP::dataPosition(),
+            _numBrickVals,
+            _numBricksFrame
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return false;
+    }
+
     _hasReadHeader = true;
 
     // Hold two brick lists
@@ -225,8 +241,8 @@ bool BrickManager::buildBrickList(BUFFER_INDEX bufferIndex,
     return true;
 }
 
-bool BrickManager::fillVolume(float* in, float* out, unsigned int x, unsigned int y,
-                              unsigned int z)
+bool BrickManager::fillVolume(const float* in, float* out, unsigned int x,
+                              unsigned int y, unsigned int z)
 {
 
     //timer_.start();
@@ -294,6 +310,15 @@ bool BrickManager::diskToPBO(BUFFER_INDEX pboIndex) {
         return false;
     }
 
+    // Start reading all bricks that are not in the PBO yet on the worker threads
+    std::vector<int> missingBricks;
+    for (unsigned int i = 0; i < _brickLists[pboIndex].size() / 3; i++) {
+        if (_brickLists[pboIndex][3 * i] != -1 && _bricksInPBO[pboIndex][i] == -1) {
+            missingBricks.push_back(static_cast<int>(i));
+        }
+    }
+    _brickStreamer->request(missingBricks);
+
     // Loop over brick request list
     unsigned int brickIndex = 0;
     while (brickIndex < _brickLists[pboIndex].size() / 3) {
@@ -325,53 +350,12 @@ bool BrickManager::diskToPBO(BUFFER_INDEX pboIndex) {
             }
             brickIndexProbe++;
         }
-        //INFO("Reading " << sequence << " bricks");
-
-        // Read the sequence into a buffer
-        float* seqBuffer = new float[sequence * _numBrickVals];
-        size_t bufSize = sequence * _numBrickVals * sizeof(float);
-        /*
-        std::ios::pos_type offset = dataPos_ +
-        static_cast<std::ios::pos_type>(brickIndex) *
-        static_cast<std::ios::pos_type>(_brickSize);
-        */
-
-        long long offset = TSP::dataPosition() +
-                           static_cast<long>(brickIndex) * static_cast<long>(_brickSize);
 
         // Skip reading if all bricks in sequence is already in PBO
         if (inPBO != sequence) {
-            //timer_.start();
-
-            /*
-            std::streamoff off = static_cast<std::streamoff>(offset);
-            in_.seekg(off);
-            if (in_.tellg() == -1) {
-            ERROR("Failed to get input stream position");
-            INFO("offset: " << offset);
-            INFO("streamoff max: " << std::numeric_limits<std::streamoff>::max());
-            INFO("size_t max: " << std::numeric_limits<size_t>::max());
-            return false;
-            }
-            INFO("in.tellg(): " << in_.tellg());
-            in_.read(reinterpret_cast<char*>(seqBuffer), _brickSize*sequence);
-            */
-
-            _tsp->file().seekg(offset);
-            _tsp->file().read(reinterpret_cast<char*>(seqBuffer), bufSize);
-
-
-            //timer_.stop();
-            //double time = timer_.elapsed().wall / 1.0e9;
-            //double mb = (_brickSize*sequence) / 1048576.0;
-            //INFO("Disk read "<<mb<<" MB in "<<time<<" s, "<< mb/time<<" MB/s");
-
-            // For each brick in the buffer, put it the correct buffer spot
+            // For each brick in the sequence, put it the correct buffer spot
             for (unsigned int i = 0; i < sequence; i++) {
                 // Only upload if needed
-                // Pointless if implementation only skips reading when ALL bricks in
-                // sequence are in PBO, but could be useful if other solutions that
-                // considers part of the buffer are implemented
                 if (_bricksInPBO[pboIndex][brickIndex + i] == -1) {
                     unsigned int x = static_cast<unsigned int>(
                         _brickLists[pboIndex][3 * (brickIndex + i) + 0]
@@ -386,9 +370,9 @@ bool BrickManager::diskToPBO(BUFFER_INDEX pboIndex) {
                     // Put each brick in the correct buffer place.
                     // This needs to be done because the values are in brick order, and
                     // the volume needs to be filled with one big float array.
-                    fillVolume(&seqBuffer[_numBrickVals*i], mappedBuffer, x, y, z);
+                    BrickStreamer::Brick brick = _brickStreamer->brick(brickIndex + i);
+                    fillVolume(brick->data(), mappedBuffer, x, y, z);
                     // Update the atlas list since the brick will be uploaded
-                    //INFO(brickIndex+i);
                     _bricksInPBO[pboIndex][brickIndex + i] = linearCoordinates(x, y, z);
                 }
             }
@@ -396,8 +380,6 @@ bool BrickManager::diskToPBO(BUFFER_INDEX pboIndex) {
 
         // Update the brick index
         brickIndex += sequence;
-
-        delete[] seqBuffer;
     }
 
     glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
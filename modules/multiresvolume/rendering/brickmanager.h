@@ -27,12 +27,15 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <memory>
 #include <vector>
 
 namespace ghoul::opengl { class Texture; }
 
 namespace openspace {
 
+class BrickStreamer;
+
 class BrickManager {
 public:
     enum BUFFER_INDEX { EVEN = 0, ODD = 1 };
@@ -46,7 +49,7 @@ public:
 
     bool buildBrickList(BUFFER_INDEX bufferIndex, std::vector<int>& brickRequest);
 
-    bool fillVolume(float* in, float* out, unsigned int x, unsigned int y,
+    bool fillVolume(const float* in, float* out, unsigned int x, unsigned int y,
         unsigned int z);
     bool diskToPBO(BUFFER_INDEX pboIndex);
     bool pboToAtlas(BUFFER_INDEX pboIndex);
@@ -61,6 +64,7 @@ private:
     void coordinatesFromLinear(int idx, int& x, int& y, int& z);
 
     TSP* _tsp = nullptr;
+    std::unique_ptr<BrickStreamer> _brickStreamer;
     TSP::Header _header;
 
     unsigned int _numBricks = 0;
@@ -0,0 +1,172 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+    // Upper limit for the number of consecutive bricks that are read by one task, so
+    // that a long run of bricks is still spread out across the worker threads
+    constexpr unsigned int MaxBricksPerRead = 32;
+} // namespace
+
+namespace openspace {
+
+BrickStreamer::BrickStreamer(const std::filesystem::path& path, size_t dataOffset,
+                             unsigned int nBrickValues, size_t cacheCapacity)
+    : _file(path)
+    , _dataOffset(dataOffset)
+    , _nBrickValues(nBrickValues)
+    , _brickSize(nBrickValues * sizeof(float))
+    , _cacheCapacity(std::max<size_t>(cacheCapacity, 1))
+{
+    if (_file.size() < _dataOffset) {
+        throw ghoul::RuntimeError(std::format(
+            "TSP file '{}' is too small to contain any bricks", path
+        ));
+    }
+    _nBricks = static_cast<unsigned int>((_file.size() - _dataOffset) / _brickSize);
+
+    const unsigned int nThreads = std::thread::hardware_concurrency() / 2;
+    _loadingPool = std::make_unique<ThreadPool>(std::clamp(nThreads, 1u, 4u));
+}
+
+BrickStreamer::~BrickStreamer() {
+    // Tasks that have not started yet are dropped, the running ones are joined
+    _loadingPool->clearTasks();
+    _loadingPool = nullptr;
+}
+
+unsigned int BrickStreamer::request(const std::vector<int>& brickIndices) {
+    std::set<unsigned int> missing;
+    {
+        std::lock_guard lock(_mutex);
+        for (int brickIndex : brickIndices) {
+            const unsigned int index = static_cast<unsigned int>(brickIndex);
+            if (brickIndex < 0 || index >= _nBricks) {
+                continue;
+            }
+            if (!_cache.contains(index) && !_pendingBricks.contains(index)) {
+                missing.insert(index);
+            }
+        }
+        _pendingBricks.insert(missing.begin(), missing.end());
+    }
+
+    // Coalesce the missing bricks into runs of consecutive bricks that are read as one
+    for (auto it = missing.begin(); it != missing.end();) {
+        const unsigned int first = *it;
+        unsigned int nBricks = 1;
+        for (it++;
+             it != missing.end() && *it == first + nBricks && nBricks < MaxBricksPerRead;
+             it++)
+        {
+            nBricks++;
+        }
+
+        _loadingPool->enqueue([this, first, nBricks]() { loadBricks(first, nBricks); });
+    }
+
+    return static_cast<unsigned int>(missing.size());
+}
+
+BrickStreamer::Brick BrickStreamer::brick(unsigned int brickIndex) {
+    ghoul_assert(brickIndex < _nBricks, "Brick index out of range");
+
+    {
+        std::unique_lock lock(_mutex);
+        _brickLoaded.wait(lock, [&]() { return !_pendingBricks.contains(brickIndex); });
+
+        auto it = _cache.find(brickIndex);
+        if (it != _cache.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second.lruPosition);
+            return it->second.data;
+        }
+    }
+
+    Brick data = readBrick(brickIndex);
+
+    std::lock_guard lock(_mutex);
+    insertIntoCache(brickIndex, data);
+    return data;
+}
+
+unsigned int BrickStreamer::numBricks() const {
+    return _nBricks;
+}
+
+void BrickStreamer::loadBricks(unsigned int firstBrickIndex, unsigned int nBricks) {
+    // Let the operating system read the whole run at once instead of faulting in the
+    // pages one at a time while copying
+    _file.prefetch(_dataOffset + firstBrickIndex * _brickSize, nBricks * _brickSize);
+
+    std::vector<Brick> staging;
+    staging.reserve(nBricks);
+    for (unsigned int i = 0; i < nBricks; i++) {
+        staging.push_back(readBrick(firstBrickIndex + i));
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        for (unsigned int i = 0; i < nBricks; i++) {
+            insertIntoCache(firstBrickIndex + i, std::move(staging[i]));
+            _pendingBricks.erase(firstBrickIndex + i);
+        }
+    }
+    _brickLoaded.notify_all();
+}
+
+BrickStreamer::Brick BrickStreamer::readBrick(unsigned int brickIndex) const {
+    auto data = std::make_shared<std::vector<float>>(_nBrickValues);
+    std::memcpy(
+        data->data(),
+        _file.data() + _dataOffset + brickIndex * _brickSize,
+        _brickSize
+    );
+    return data;
+}
+
+void BrickStreamer::insertIntoCache(unsigned int brickIndex, Brick data) {
+    auto it = _cache.find(brickIndex);
+    if (it != _cache.end()) {
+        _lru.splice(_lru.begin(), _lru, it->second.lruPosition);
+        return;
+    }
+
+    while (_cache.size() >= _cacheCapacity) {
+        _cache.erase(_lru.back());
+        _lru.pop_back();
+    }
+
+    _lru.push_front(brickIndex);
+    _cache.emplace(brickIndex, CacheEntry{ std::move(data), _lru.begin() });
+}
+
+} // namespace openspace
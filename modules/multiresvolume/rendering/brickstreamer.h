@@ -0,0 +1,115 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/threadpool.h>
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Provides the voxel data of the bricks stored in a TSP file. The file is memory mapped
+ * and bricks that are requested ahead of time are copied into staging buffers on a set
+ * of worker threads, with consecutive bricks being read together. Loaded bricks are
+ * kept in a cache that evicts the least recently used bricks once its capacity is
+ * reached, so that bricks that drop out of and come back into the selection do not
+ * have to be read from disk again.
+ */
+class BrickStreamer {
+public:
+    using Brick = std::shared_ptr<const std::vector<float>>;
+
+    /**
+     * Maps the TSP file at \p path for streaming.
+     *
+     * \param path The path to the TSP file
+     * \param dataOffset The offset in bytes of the first brick in the file
+     * \param nBrickValues The number of values in a single (padded) brick
+     * \param cacheCapacity The maximum number of bricks that are kept in the cache
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped
+     */
+    BrickStreamer(const std::filesystem::path& path, size_t dataOffset,
+        unsigned int nBrickValues, size_t cacheCapacity);
+    ~BrickStreamer();
+
+    /**
+     * Starts loading all of the provided bricks that are neither cached nor already
+     * being loaded on the worker threads. This function returns immediately.
+     *
+     * \return The number of bricks that have to be read from the file
+     */
+    unsigned int request(const std::vector<int>& brickIndices);
+
+    /**
+     * Returns the voxel data of the brick with the provided index. If the brick is
+     * currently being loaded, this function waits for it to finish. If it was never
+     * requested, it is read from the file on the calling thread.
+     */
+    Brick brick(unsigned int brickIndex);
+
+    /// Returns the number of bricks that are stored in the file
+    unsigned int numBricks() const;
+
+private:
+    struct CacheEntry {
+        Brick data;
+        std::list<unsigned int>::iterator lruPosition;
+    };
+
+    void loadBricks(unsigned int firstBrickIndex, unsigned int nBricks);
+    Brick readBrick(unsigned int brickIndex) const;
+    void insertIntoCache(unsigned int brickIndex, Brick data);
+
+    MemoryMappedFile _file;
+    const size_t _dataOffset;
+    const unsigned int _nBrickValues;
+    const size_t _brickSize;
+    const size_t _cacheCapacity;
+    unsigned int _nBricks = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _brickLoaded;
+    std::unordered_map<unsigned int, CacheEntry> _cache;
+    // Most recently used brick at the front
+    std::list<unsigned int> _lru;
+    std::set<unsigned int> _pendingBricks;
+
+    // Declared last so that the workers have finished before the cache is destroyed
+    std::unique_ptr<ThreadPool> _loadingPool;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
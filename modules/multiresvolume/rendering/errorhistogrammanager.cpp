@@ -25,9 +25,11 @@
 #include <modules/multiresvolume/rendering/errorhistogrammanager.h>
 
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/util/parallelfor.h>
 #include <openspace/util/progressbar.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/format.h>
+#include <mutex>
 
 namespace openspace {
 
@@ -36,8 +38,7 @@ ErrorHistogramManager::ErrorHistogramManager(TSP* tsp) : _tsp(tsp) {}
 bool ErrorHistogramManager::buildHistograms(int numBins) {
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
+    if (!_tsp->mapFile()) {
         return false;
     }
     _minBin = 0.f; // Should be calculated from tsp file
@@ -56,127 +57,98 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
         std::format("Build {} histograms with {} bins each", _numInnerNodes, numBins)
     );
 
-    // All TSP Leaves
-    int numOtNodes = _tsp->numOTNodes();
-    int otOffset = static_cast<int>((pow(8, numOtLevels - 1) - 1) / 7);
-
-    int numBstNodes = _tsp->numBSTNodes();
-    int bstOffset = numBstNodes / 2;
-
-    int numberOfLeaves = (numBstNodes - bstOffset) * (numOtNodes - otOffset);
-    ProgressBar pb(numberOfLeaves);
-    int processedLeaves = 0;
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromLeaf(bst, ot);
-            if (!success) {
-                return false;
-            }
-            pb.print(++processedLeaves);
+    // Every histogram only depends on the leaves below its own node, so they can be
+    // built independently of each other. Nodes close to the root cover many more leaves
+    // than the others, so every node is a range of its own
+    ProgressBar pb(_numInnerNodes);
+    std::mutex progressMutex;
+    int nProcessed = 0;
+    parallelForRanges(
+        _numInnerNodes,
+        _numInnerNodes,
+        [&](size_t innerNodeIndex, size_t, size_t) {
+            buildFromAncestor(static_cast<unsigned int>(innerNodeIndex));
+
+            std::lock_guard lock(progressMutex);
+            nProcessed++;
+            pb.print(nProcessed);
         }
-    }
+    );
 
-    return success;
+    return true;
 }
 
-bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
-                                          unsigned int octreeOffset)
-{
-    // Traverse all ancestors of leaf and add errors to their histograms
+void ErrorHistogramManager::buildFromAncestor(unsigned int innerNodeIndex) {
+    // Add the errors of all leaves that the ancestor covers to its histogram. The
+    // leaves are visited in increasing BST order and then increasing octree order
 
     unsigned int brickDim = _tsp->brickDim();
     unsigned int paddedBrickDim = _tsp->paddedBrickDim();
     unsigned int padding = (paddedBrickDim - brickDim) / 2;
 
-    int numOtNodes = _tsp->numOTNodes();
-    unsigned int leafIndex = bstOffset * numOtNodes + octreeOffset;
-    std::vector<float> leafValues = readValues(leafIndex);
-//    int numVoxels = leafValues.size();
-
-    int bstNode = bstOffset;
-    bool bstRightOnly = true;
-    unsigned int bstLevel = 0;
-
-    do {
-        glm::vec3 leafOffset(0.f); // Leaf offset in leaf sized voxels
-        unsigned int octreeLevel = 0;
-        unsigned int octreeNode = octreeOffset;
-        bool octreeLastOnly = true;
-        do {
-            // Visit ancestor
-            if (bstNode != static_cast<int>(bstOffset) || octreeNode != octreeOffset) {
-                // Is actually an ancestor
-
-                std::vector<float> ancestorVoxels;
-                unsigned int ancestorBrickIndex = bstNode * numOtNodes + octreeNode;
-                unsigned int innerNodeIndex = brickToInnerNodeIndex(ancestorBrickIndex);
-                auto it = _voxelCache.find(innerNodeIndex);
-                if (it == _voxelCache.end()) {
-                    // First visit
-                    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
-                    ancestorVoxels = readValues(ancestorBrickIndex);
-                    _voxelCache[innerNodeIndex] = ancestorVoxels;
-                }
-                else {
-                    ancestorVoxels = it->second;
-                }
+    const unsigned int numOtNodes = _tsp->numOTNodes();
+    const unsigned int ancestorBrickIndex = innerNodeToBrickIndex(innerNodeIndex);
+    const unsigned int ancestorOctreeNode = ancestorBrickIndex % numOtNodes;
+    const float* ancestorVoxels = _tsp->brickValues(ancestorBrickIndex);
+
+    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
+    Histogram& histogram = _histograms[innerNodeIndex];
+
+    const TSP::BrickRange bstLeaves = _tsp->coveredBSTLeafBricks(ancestorBrickIndex);
+    const TSP::BrickRange octreeLeaves = _tsp->coveredLeafBricks(ancestorBrickIndex);
+    for (unsigned int bst = 0; bst < bstLeaves.count; bst++) {
+        const unsigned int bstOffset = bstLeaves[bst] - ancestorOctreeNode;
+
+        for (unsigned int ot = 0; ot < octreeLeaves.count; ot++) {
+            const unsigned int octreeOffset = octreeLeaves[ot] % numOtNodes;
+            const float* leafValues = _tsp->brickValues(bstOffset + octreeOffset);
+
+            // Traverse the octree ancestors of the leaf up to the ancestor node
+            glm::vec3 leafOffset(0.f); // Leaf offset in leaf sized voxels
+            unsigned int octreeLevel = 0;
+            unsigned int octreeNode = octreeOffset;
+            while (octreeNode != ancestorOctreeNode) {
+                int octreeChild = (octreeNode - 1) % 8;
+                octreeNode = parentOffset(octreeNode, 8);
+
+                int childSize = static_cast<int>(pow(2, octreeLevel) * brickDim);
+                leafOffset.x += (octreeChild % 2) * childSize;
+                leafOffset.y += ((octreeChild / 2) % 2) * childSize;
+                leafOffset.z += (octreeChild / 4) * childSize;
+
+                octreeLevel++;
+            }
 
-                float voxelScale = static_cast<float>(pow(2.f, octreeLevel));
-                float invVoxelScale = 1.f / voxelScale;
+            float voxelScale = static_cast<float>(pow(2.f, octreeLevel));
+            float invVoxelScale = 1.f / voxelScale;
 
-                // Calculate leaf offset in ancestor sized voxels
-                glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) +
-                                           glm::vec3(padding - 0.5f);
+            // Calculate leaf offset in ancestor sized voxels
+            glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) +
+                                       glm::vec3(padding - 0.5f);
 
-                for (int z = 0; z < static_cast<int>(brickDim); z++) {
-                    for (int y = 0; y < static_cast<int>(brickDim); y++) {
-                        for (int x = 0; x < static_cast<int>(brickDim); x++) {
-                            glm::vec3 leafSamplePoint = glm::vec3(x, y, z) +
+            for (int z = 0; z < static_cast<int>(brickDim); z++) {
+                for (int y = 0; y < static_cast<int>(brickDim); y++) {
+                    for (int x = 0; x < static_cast<int>(brickDim); x++) {
+                        glm::vec3 leafSamplePoint = glm::vec3(x, y, z) +
                                                    glm::vec3(static_cast<float>(padding));
-                            glm::vec3 ancestorSamplePoint = ancestorOffset +
-                                (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
-                            float leafValue = leafValues[linearCoords(leafSamplePoint)];
-                            float ancestorValue = interpolate(
-                                ancestorSamplePoint,
-                                ancestorVoxels
-                            );
-
-                            _histograms[innerNodeIndex].addRectangle(
-                                leafValue,
-                                ancestorValue,
-                                std::abs(leafValue - ancestorValue)
-                            );
-                        }
+                        glm::vec3 ancestorSamplePoint = ancestorOffset +
+                            (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
+                        float leafValue = leafValues[linearCoords(leafSamplePoint)];
+                        float ancestorValue = interpolate(
+                            ancestorSamplePoint,
+                            ancestorVoxels
+                        );
+
+                        histogram.addRectangle(
+                            leafValue,
+                            ancestorValue,
+                            std::abs(leafValue - ancestorValue)
+                        );
                     }
                 }
-
-                if (bstRightOnly && octreeLastOnly) {
-                    _voxelCache.erase(innerNodeIndex);
-                }
             }
-
-            // Traverse to next octree ancestor
-            int octreeChild = (octreeNode - 1) % 8;
-            octreeLastOnly &= octreeChild == 7;
-            octreeNode = parentOffset(octreeNode, 8);
-
-            int childSize = static_cast<int>(pow(2, octreeLevel) * brickDim);
-            leafOffset.x += (octreeChild % 2) * childSize;
-            leafOffset.y += ((octreeChild / 2) % 2) * childSize;
-            leafOffset.z += (octreeChild / 4) * childSize;
-
-            octreeLevel++;
-        // @TODO(emiax):  This does not make sense? unsigned int check against -1
-        } while (octreeNode != -1);
-
-        bstRightOnly &= (bstNode % 2 == 0);
-        bstNode = parentOffset(bstNode, 2);
-
-        bstLevel++;
-    } while (bstNode != -1);
-
-    return true;
+        }
+    }
 }
 
 bool ErrorHistogramManager::loadFromFile(const std::filesystem::path& filename) {
@@ -251,7 +223,7 @@ unsigned int ErrorHistogramManager::linearCoords(const glm::ivec3& coords) const
 }
 
 float ErrorHistogramManager::interpolate(const glm::vec3& samplePoint,
-                                         const std::vector<float>& voxels) const
+                                         const float* voxels) const
 {
     const int lowX = static_cast<int>(samplePoint.x);
     const int lowY = static_cast<int>(samplePoint.y);
@@ -316,23 +288,6 @@ int ErrorHistogramManager::parentOffset(int offset, int base) const {
     return parentOffset;
 }
 
-std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) const {
-    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-    const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
-    std::vector<float> voxelValues(numBrickVals);
-
-    std::streampos offset = _tsp->dataPosition() +
-        static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(
-        reinterpret_cast<char*>(voxelValues.data()),
-        static_cast<size_t>(numBrickVals)*sizeof(float)
-    );
-
-    return voxelValues;
-}
-
 unsigned int ErrorHistogramManager::brickToInnerNodeIndex(unsigned int brickIndex) const {
     const unsigned int numOtNodes = _tsp->numOTNodes();
     const unsigned int numBstLevels = _tsp->numBSTLevels();
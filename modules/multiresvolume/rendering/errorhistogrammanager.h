@@ -29,7 +29,7 @@
 #include <ghoul/glm.h>
 #include <filesystem>
 #include <iosfwd>
-#include <map>
+#include <vector>
 
 namespace openspace {
 
@@ -48,7 +48,6 @@ public:
 
 private:
     TSP* _tsp;
-    std::ifstream* _file;
 
     std::vector<Histogram> _histograms;
     unsigned int _numInnerNodes;
@@ -56,10 +55,7 @@ private:
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
-
-    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset);
-    std::vector<float> readValues(unsigned int brickIndex) const;
+    void buildFromAncestor(unsigned int innerNodeIndex);
 
     int parentOffset(int offset, int base) const;
 
@@ -69,8 +65,7 @@ private:
     unsigned int linearCoords(int x, int y, int z) const;
     unsigned int linearCoords(const glm::ivec3& coords) const;
 
-    float interpolate(const glm::vec3& samplePoint,
-        const std::vector<float>& voxels) const;
+    float interpolate(const glm::vec3& samplePoint, const float* voxels) const;
 };
 
 } // namespace openspace
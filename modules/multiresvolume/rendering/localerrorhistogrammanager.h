@@ -29,7 +29,7 @@
 #include <ghoul/glm.h>
 #include <filesystem>
 #include <iosfwd>
-#include <map>
+#include <vector>
 
 namespace openspace {
 
@@ -48,7 +48,6 @@ public:
 
 private:
     TSP* _tsp = nullptr;
-    std::ifstream* _file;
 
     std::vector<Histogram> _spatialHistograms;
     std::vector<Histogram> _temporalHistograms;
@@ -57,14 +56,8 @@ private:
     float _maxBin = 0.f;
     int _numBins = 0;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
-
-    bool buildFromOctreeChild(unsigned int bstOffset, unsigned int octreeOffset);
-    bool buildFromBstChild(unsigned int bstOffset, unsigned int octreeOffset);
-
-    std::vector<float> readValues(unsigned int brickIndex) const;
-
-    int parentOffset(int offset, int base) const;
+    void buildFromOctreeChildren(unsigned int innerNodeIndex);
+    void buildFromBstChildren(unsigned int innerNodeIndex);
 
     unsigned int brickToInnerNodeIndex(unsigned int brickIndex) const;
     unsigned int innerNodeToBrickIndex(unsigned int innerNodeIndex) const;
@@ -72,7 +65,7 @@ private:
     unsigned int linearCoords(int x, int y, int z) const;
     unsigned int linearCoords(glm::ivec3 coords) const;
 
-    float interpolate(glm::vec3 samplePoint, const std::vector<float>& voxels) const;
+    float interpolate(glm::vec3 samplePoint, const float* voxels) const;
 };
 
 } // namespace openspace
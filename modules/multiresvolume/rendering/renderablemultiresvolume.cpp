@@ -168,6 +168,11 @@ namespace {
         std::filesystem::path transferFunction;
 
         std::optional<std::string> brickSelector;
+
+        // The amount of brick data, in megabytes, that is cached in memory after it has
+        // been read from the TSP file. Bricks that have been used least recently are
+        // released when the cache is full. 1024 is default
+        std::optional<float> brickCacheSize [[codegen::greater(0.0)]];
     };
 #include "renderablemultiresvolume_codegen.cpp"
 } // namespace
@@ -219,7 +224,9 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
     _transferFunction = std::make_shared<TransferFunction>(_transferFunctionPath);
 
     _tsp = std::make_shared<TSP>(_filename);
-    _atlasManager = std::make_shared<AtlasManager>(_tsp.get());
+    const size_t brickCacheSize =
+        static_cast<size_t>(p.brickCacheSize.value_or(1024.f) * 1024 * 1024);
+    _atlasManager = std::make_shared<AtlasManager>(_tsp.get(), brickCacheSize);
 
     _selectorName = p.brickSelector.value_or(_selectorName);
 
@@ -629,29 +636,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             selectionStart = std::chrono::system_clock::now();
         }
 
-        switch (_selector) {
-            case Selector::TF:
-                if (_tfBrickSelector) {
-                    _tfBrickSelector->setMemoryBudget(_memoryBudget);
-                    _tfBrickSelector->setStreamingBudget(_streamingBudget);
-                    _tfBrickSelector->selectBricks(currentTimestep, _brickIndices);
-                }
-                break;
-            case Selector::SIMPLE:
-                if (_simpleTfBrickSelector) {
-                    _simpleTfBrickSelector->setMemoryBudget(_memoryBudget);
-                    _simpleTfBrickSelector->setStreamingBudget(_streamingBudget);
-                    _simpleTfBrickSelector->selectBricks(currentTimestep, _brickIndices);
-                }
-                break;
-            case Selector::LOCAL:
-                if (_localTfBrickSelector) {
-                    _localTfBrickSelector->setMemoryBudget(_memoryBudget);
-                    _localTfBrickSelector->setStreamingBudget(_streamingBudget);
-                    _localTfBrickSelector->selectBricks(currentTimestep, _brickIndices);
-                }
-                break;
-        }
+        selectBricks(currentTimestep, _brickIndices);
 
         std::chrono::system_clock::time_point uploadStart;
         if (_gatheringStats) {
@@ -671,6 +656,25 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             _nUsedBricks = _atlasManager->numUsedBricks();
             _nStreamedBricks = _atlasManager->numStreamedBricks();
         }
+
+        // Select the bricks of the timestep that is shown next ahead of time, so that
+        // they are read in the background instead of stalling a later atlas update
+        if (currentTimestep != _previousTimestep) {
+            if (_previousTimestep != -1 && !_loop) {
+                _playbackDirection = currentTimestep > _previousTimestep ? 1 : -1;
+            }
+            _previousTimestep = currentTimestep;
+
+            int nextTimestep = currentTimestep + _playbackDirection;
+            if (_loop) {
+                nextTimestep = (nextTimestep + numTimesteps) % numTimesteps;
+            }
+            if (nextTimestep >= 0 && nextTimestep < numTimesteps) {
+                _prefetchBrickIndices.resize(_brickIndices.size(), 0);
+                selectBricks(nextTimestep, _prefetchBrickIndices);
+                _atlasManager->prefetchBricks(_prefetchBrickIndices);
+            }
+        }
     }
 
     if (_raycaster) {
@@ -695,6 +699,32 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
     }
 }
 
+void RenderableMultiresVolume::selectBricks(int timestep, std::vector<int>& bricks) {
+    switch (_selector) {
+        case Selector::TF:
+            if (_tfBrickSelector) {
+                _tfBrickSelector->setMemoryBudget(_memoryBudget);
+                _tfBrickSelector->setStreamingBudget(_streamingBudget);
+                _tfBrickSelector->selectBricks(timestep, bricks);
+            }
+            break;
+        case Selector::SIMPLE:
+            if (_simpleTfBrickSelector) {
+                _simpleTfBrickSelector->setMemoryBudget(_memoryBudget);
+                _simpleTfBrickSelector->setStreamingBudget(_streamingBudget);
+                _simpleTfBrickSelector->selectBricks(timestep, bricks);
+            }
+            break;
+        case Selector::LOCAL:
+            if (_localTfBrickSelector) {
+                _localTfBrickSelector->setMemoryBudget(_memoryBudget);
+                _localTfBrickSelector->setStreamingBudget(_streamingBudget);
+                _localTfBrickSelector->selectBricks(timestep, bricks);
+            }
+            break;
+    }
+}
+
 void RenderableMultiresVolume::render(const RenderData& data, RendererTasks& tasks) {
     RaycasterTask task { _raycaster.get(), data };
     tasks.raycasterTasks.push_back(task);
@@ -85,6 +85,8 @@ public:
     //virtual std::vector<unsigned int> getBuffers() override;
 
 private:
+    void selectBricks(int timestep, std::vector<int>& bricks);
+
     properties::BoolProperty _useGlobalTime;
     properties::BoolProperty _loop;
     // used to vary time, if not using global time nor looping
@@ -130,6 +132,11 @@ private:
     std::shared_ptr<TSP> _tsp;
     std::vector<int> _brickIndices;
 
+    // Brick selection for the timestep after the current one, which is read ahead
+    std::vector<int> _prefetchBrickIndices;
+    int _previousTimestep = -1;
+    int _playbackDirection = 1;
+
     std::shared_ptr<AtlasManager> _atlasManager;
 
     std::unique_ptr<MultiresVolumeRaycaster> _raycaster;
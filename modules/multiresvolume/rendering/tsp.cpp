@@ -24,15 +24,18 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <openspace/util/parallelfor.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
 #include <filesystem>
 #include <numeric>
-#include <queue>
 
 namespace {
     constexpr std::string_view _loggerCat = "TSP";
@@ -222,10 +225,51 @@ long long TSP::dataPosition() {
     return sizeof(Header);
 }
 
+const std::filesystem::path& TSP::filename() const {
+    return _filename;
+}
+
 std::ifstream& TSP::file() {
     return _file;
 }
 
+bool TSP::mapFile() {
+    if (_mappedFile.has_value()) {
+        return true;
+    }
+
+    try {
+        _mappedFile = MemoryMappedFile(_filename);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return false;
+    }
+
+    const size_t brickSize = static_cast<size_t>(_paddedBrickDim) * _paddedBrickDim *
+                             _paddedBrickDim * sizeof(float);
+    const size_t expectedSize = dataPosition() + _numTotalNodes * brickSize;
+    if (_mappedFile->size() < expectedSize) {
+        LERROR(std::format(
+            "File '{}' is too small to contain {} bricks", _filename, _numTotalNodes
+        ));
+        _mappedFile = std::nullopt;
+        return false;
+    }
+    return true;
+}
+
+const float* TSP::brickValues(unsigned int brickIndex) const {
+    ghoul_assert(_mappedFile.has_value(), "File must be mapped first");
+    ghoul_assert(brickIndex < _numTotalNodes, "Brick index out of range");
+
+    const size_t numBrickVals =
+        static_cast<size_t>(_paddedBrickDim) * _paddedBrickDim * _paddedBrickDim;
+    return reinterpret_cast<const float*>(
+        _mappedFile->data() + dataPosition()
+    ) + brickIndex * numBrickVals;
+}
+
 unsigned int TSP::numTotalNodes() const {
     return _numTotalNodes;
 }
@@ -269,91 +313,91 @@ GLuint TSP::ssbo() const {
 bool TSP::calculateSpatialError() {
     unsigned int numBrickVals = _paddedBrickDim*_paddedBrickDim*_paddedBrickDim;
 
-    if (!_file.is_open()) {
+    if (!mapFile()) {
         return false;
     }
 
-    std::vector<float> buffer(numBrickVals);
     std::vector<float> averages(_numTotalNodes);
     std::vector<float> stdDevs(_numTotalNodes);
 
     // First pass: Calculate average color for each brick
     LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
-        // Offset in file
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals) * sizeof(float)
-        );
-
-        double average = std::accumulate(
-            buffer.begin(),
-            buffer.end(),
-            0.0,
-            [](double a, float b) { return a + static_cast<double>(b); }
-        );
-        averages[brick] = static_cast<float>(average / static_cast<double>(numBrickVals));
-    }
-
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(_numTotalNodes);
+    parallelForRanges(
+        _numTotalNodes,
+        _numTotalNodes,
+        [&](size_t brickIndex, size_t, size_t) {
+            const unsigned int brick = static_cast<unsigned int>(brickIndex);
+            const float* values = brickValues(brick);
+            double average = std::accumulate(
+                values,
+                values + numBrickVals,
+                0.0,
+                [](double a, float b) { return a + static_cast<double>(b); }
+            );
+            averages[brick] = static_cast<float>(
+                average / static_cast<double>(numBrickVals)
+            );
+        }
+    );
 
     // Second pass: For each brick, compare the covered leaf voxels with
     // the brick average
     LDEBUG("Calculating spatial error, second pass");
-    for (unsigned int brick = 0; brick < _numTotalNodes; ++brick) {
-        // Fetch mean intensity
-        float brickAvg = averages[brick];
-
-        // Sum  for std dev computation
-        float stdDev = 0.f;
+    // Every brick is a range of its own as bricks close to the root cover many more
+    // leaves and take much longer than the others
+    parallelForRanges(
+        _numTotalNodes,
+        _numTotalNodes,
+        [&](size_t brickIndex, size_t, size_t) {
+            const unsigned int brick = static_cast<unsigned int>(brickIndex);
+            // Fetch mean intensity
+            float brickAvg = averages[brick];
+
+            // Sum  for std dev computation
+            float stdDev = 0.f;
+
+            // Get the leaf bricks that the current brick covers
+            const BrickRange leafBricksCovered = coveredLeafBricks(brick);
+
+            // If the brick is already a leaf, assign a negative error.
+            // Ad hoc "hack" to distinguish leafs from other nodes that happens
+            // to get a zero error due to rounding errors or other reasons.
+            if (leafBricksCovered.count == 1) {
+                stdDev = -0.1f;
+            }
+            else {
+                // Calculate "standard deviation" corresponding to leaves
+                for (unsigned int lb = 0; lb < leafBricksCovered.count; ++lb) {
+                    const float* values = brickValues(leafBricksCovered[lb]);
+
+                    // Add to sum
+                    for (unsigned int v = 0; v < numBrickVals; ++v) {
+                        stdDev += pow(values[v] - brickAvg, 2.f);
+                    }
+                }
 
-        // Get a list of leaf bricks that the current brick covers
-        std::list<unsigned int> leafBricksCovered = coveredLeafBricks(brick);
+                stdDev /= static_cast<float>(
+                    static_cast<size_t>(leafBricksCovered.count) * numBrickVals
+                );
+                stdDev = sqrt(stdDev);
+            } // if not leaf
 
-        // If the brick is already a leaf, assign a negative error.
-        // Ad hoc "hack" to distinguish leafs from other nodes that happens
-        // to get a zero error due to rounding errors or other reasons.
-        if (leafBricksCovered.size() == 1) {
-            stdDev = -0.1f;
+            stdDevs[brick] = stdDev;
         }
-        else {
-
-            // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = leafBricksCovered.begin(); lb != leafBricksCovered.end(); ++lb)
-            {
-                // Read brick
-                std::streampos offset = dataPosition() +
-                                 static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
-
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
-
-                // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
-                }
-            }
-
-            stdDev /= static_cast<float>(leafBricksCovered.size()*numBrickVals);
-            stdDev = sqrt(stdDev);
-        } // if not leaf
+    );
 
+    // Spatial SNR stats
+    float minError = 1e20f;
+    float maxError = 0.f;
+    std::vector<float> medianArray(_numTotalNodes);
+    for (unsigned int brick = 0; brick < _numTotalNodes; ++brick) {
+        const float stdDev = stdDevs[brick];
         if (stdDev < minError) {
             minError = stdDev;
         }
         else if (stdDev > maxError) {
             maxError = stdDev;
         }
-
-        stdDevs[brick] = stdDev;
         medianArray[brick] = stdDev;
     }
 
@@ -393,7 +437,7 @@ bool TSP::calculateSpatialError() {
 }
 
 bool TSP::calculateTemporalError() {
-    if (!_file.is_open()) {
+    if (!mapFile()) {
         return false;
     }
 
@@ -408,67 +452,58 @@ bool TSP::calculateTemporalError() {
     std::vector<float> errors(_numTotalNodes);
 
     // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
-        unsigned int numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
-
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(voxelAverages.data()),
-            static_cast<size_t>(numBrickVals)*sizeof(float)
-        );
-
-        // Build a list of the BST leaf bricks (within the same octree level) that
-        // this brick covers
-        std::list<unsigned int> coveredBricks = coveredBSTLeafBricks(brick);
-
-        // If the brick is at the lowest BST level, automatically set the error
-        // to -0.1 (enables using -1 as a marker for "no error accepted");
-        // Somewhat ad hoc to get around the fact that the error could be
-        // 0.0 higher up in the tree
-        if (coveredBricks.size() == 1) {
-            errors[brick] = -0.1f;
-        }
-        else {
-            // Calculate standard deviation per voxel, average over brick
-            float avgStdDev = 0.f;
-            for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
-                float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf)
-                {
+    parallelForRanges(
+        _numTotalNodes,
+        _numTotalNodes,
+        [&](size_t brickIndex, size_t, size_t) {
+            const unsigned int brick = static_cast<unsigned int>(brickIndex);
+            unsigned int numBrickVals =
+                _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
+
+            // The individual voxel's average over timesteps. Because the BSTs are built
+            // by averaging leaf nodes, we only need to sample the brick at the correct
+            // coordinate.
+            const float* voxelAverages = brickValues(brick);
+
+            // The BST leaf bricks (within the same octree level) that this brick covers
+            const BrickRange coveredBricks = coveredBSTLeafBricks(brick);
+
+            // If the brick is at the lowest BST level, automatically set the error
+            // to -0.1 (enables using -1 as a marker for "no error accepted");
+            // Somewhat ad hoc to get around the fact that the error could be
+            // 0.0 higher up in the tree
+            if (coveredBricks.count == 1) {
+                errors[brick] = -0.1f;
+            }
+            else {
+                // Sum up the squared differences per voxel. The leaves are visited one
+                // whole brick at a time, which adds to each voxel's sum in leaf order
+                std::vector<float> voxelStdDevs(numBrickVals, 0.f);
+                for (unsigned int leaf = 0; leaf < coveredBricks.count; ++leaf) {
                     // Sample the leaves at the corresponding voxel position
-                    _file.seekg(dataPosition() +
-                        static_cast<long long>(
-                            (*leaf * numBrickVals + voxel) * sizeof(float)
-                        )
-                    );
-
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
-
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+                    const float* samples = brickValues(coveredBricks[leaf]);
+                    for (unsigned int voxel = 0; voxel < numBrickVals; ++voxel) {
+                        const float diff = samples[voxel] - voxelAverages[voxel];
+                        voxelStdDevs[voxel] += pow(diff, 2.f);
+                    }
                 }
-                stdDev /= static_cast<float>(coveredBricks.size());
-                stdDev = sqrt(stdDev);
 
-                avgStdDev += stdDev;
-            } // for voxel
+                // Calculate standard deviation per voxel, average over brick
+                float avgStdDev = 0.f;
+                for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
+                    float stdDev = voxelStdDevs[voxel];
+                    stdDev /= static_cast<float>(coveredBricks.count);
+                    stdDev = sqrt(stdDev);
 
-            avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
-            errors[brick] = avgStdDev;
+                    avgStdDev += stdDev;
+                } // for voxel
+
+                avgStdDev /= static_cast<float>(numBrickVals);
+                meanArray[brick] = avgStdDev;
+                errors[brick] = avgStdDev;
+            }
         }
-    } // for all bricks
+    ); // for all bricks
 
     std::sort(meanArray.begin(), meanArray.end());
     //float medErr = meanArray[meanArray.size()/2];
@@ -621,79 +656,61 @@ bool TSP::isOctreeLeaf(unsigned int brickIndex) const {
     return depth == _numOTLevels - 1;
 }
 
-std::list<unsigned int> TSP::coveredLeafBricks(unsigned int brickIndex) const {
-    std::list<unsigned int> out;
-
+TSP::BrickRange TSP::coveredLeafBricks(unsigned int brickIndex) const {
     // Find what octree skeleton node the index belongs to
     const unsigned int OTNode = brickIndex % _numOTNodes;
-
-    // Find what BST node the index corresponds to using int division
-    const unsigned int BSTNode = brickIndex / _numOTNodes;
     // Calculate BST offset (to translate to root octree)
-    const unsigned int BSTOffset = BSTNode * _numOTNodes;
-
-    // Traverse root octree structure to leaves
-    // When visiting the leaves, translate back to correct BST level and save
-    std::queue<unsigned int> queue;
-    queue.push(OTNode);
-    do {
-        // Get front of queue and pop it
-        const unsigned int toVisit = queue.front();
-        queue.pop();
-
-        // See if the node has children
-        int child = _data[toVisit*NUM_DATA + CHILD_INDEX];
-        if (child == -1) {
-            // Translate back and save
-            out.push_back(toVisit + BSTOffset);
-        }
-        else {
-            // Queue the eight children
-            for (int i = 0; i<8; i++) {
-                queue.push(child + i);
-            }
-        }
-    } while (!queue.empty());
+    const unsigned int BSTOffset = brickIndex - OTNode;
+
+    // Find the octree level of the node and its position within that level
+    unsigned int level = 0;
+    unsigned int firstInLevel = 0;
+    unsigned int nodesInLevel = 1;
+    while (OTNode >= firstInLevel + nodesInLevel) {
+        firstInLevel += nodesInLevel;
+        nodesInLevel *= 8;
+        level++;
+    }
+    unsigned int offsetInLevel = OTNode - firstInLevel;
+
+    // The descendants of a node within one level are consecutive, as the children of
+    // the n:th node in a level are the nodes 8n to 8n+7 in the next level
+    unsigned int count = 1;
+    for (; level < _numOTLevels - 1; level++) {
+        firstInLevel += nodesInLevel;
+        nodesInLevel *= 8;
+        offsetInLevel *= 8;
+        count *= 8;
+    }
 
-    return out;
+    return { BSTOffset + firstInLevel + offsetInLevel, count, 1 };
 }
 
-std::list<unsigned int> TSP::coveredBSTLeafBricks(unsigned int brickIndex) const {
-    std::list<unsigned int> out;
-
-    // Traverse the BST children until we are at root
-    std::queue<unsigned int> queue;
-    queue.push(brickIndex);
-    do {
-        const unsigned int toVisit = queue.front();
-        queue.pop();
-
-        bool BSTRoot = toVisit < _numOTNodes;
-        if (BSTRoot) {
-            if (_numBSTLevels == 1) {
-                out.push_back(toVisit);
-            }
-            else {
-                queue.push(toVisit + _numOTNodes);
-                queue.push(toVisit + _numOTNodes * 2);
-            }
-        }
-        else {
-            int child = _data[toVisit*NUM_DATA + CHILD_INDEX];
-            if (child == -1) {
-                // Save leaf brick to list
-                out.push_back(toVisit);
-            }
-            else {
-                // Queue children
-                queue.push(child);
-                queue.push(child + _numOTNodes);
-            }
-        }
+TSP::BrickRange TSP::coveredBSTLeafBricks(unsigned int brickIndex) const {
+    const unsigned int OTNode = brickIndex % _numOTNodes;
+    const unsigned int BSTNode = brickIndex / _numOTNodes;
 
-    } while (!queue.empty());
+    // Find the BST level of the node and its position within that level
+    unsigned int level = 0;
+    unsigned int firstInLevel = 0;
+    unsigned int nodesInLevel = 1;
+    while (BSTNode >= firstInLevel + nodesInLevel) {
+        firstInLevel += nodesInLevel;
+        nodesInLevel *= 2;
+        level++;
+    }
+    unsigned int offsetInLevel = BSTNode - firstInLevel;
+
+    // Same as for the octree, but every BST node is a full octree of bricks apart
+    unsigned int count = 1;
+    for (; level < _numBSTLevels - 1; level++) {
+        firstInLevel += nodesInLevel;
+        nodesInLevel *= 2;
+        offsetInLevel *= 2;
+        count *= 2;
+    }
 
-    return out;
+    return { OTNode + (firstInLevel + offsetInLevel) * _numOTNodes, count, _numOTNodes };
 }
 
 } // namespace openspace
@@ -25,10 +25,11 @@
 #ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <filesystem>
 #include <fstream>
-#include <list>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -56,6 +57,15 @@ public:
         NUM_DATA
     };
 
+    /// A set of `count` brick indices that start at `first` and are `stride` apart
+    struct BrickRange {
+        unsigned int first;
+        unsigned int count;
+        unsigned int stride;
+
+        unsigned int operator[](unsigned int i) const { return first + i * stride; }
+    };
+
     TSP(const std::filesystem::path& filename);
     ~TSP();
 
@@ -71,7 +81,24 @@ public:
 
     const Header& header() const;
     static long long dataPosition();
+    const std::filesystem::path& filename() const;
     std::ifstream& file();
+
+    /**
+     * Maps the brick data of the TSP file into memory, which is required before calling
+     * #brickValues. Calling this function again after the file was mapped does nothing.
+     *
+     * \return `true` if the file is mapped
+     */
+    bool mapFile();
+
+    /**
+     * Returns the padded voxel values of the brick with the provided index. The file must
+     * have been mapped with #mapFile first. The returned values can be read from multiple
+     * threads at the same time.
+     */
+    const float* brickValues(unsigned int brickIndex) const;
+
     unsigned int numTotalNodes() const;
     unsigned int numValuesPerNode() const;
     unsigned int numBSTNodes() const;
@@ -96,27 +123,23 @@ public:
     bool isBstLeaf(unsigned int brickIndex) const;
     bool isOctreeLeaf(unsigned int brickIndex) const;
 
-private:
     /**
-     * Returns a list of the octree leaf nodes that a given input brick covers. If the
-     * input is already a leaf, the list will only contain that one index.
+     * Returns the octree leaf nodes that a given input brick covers, in increasing
+     * order. If the input is already a leaf, the range will only contain that one index.
      */
-    std::list<unsigned int> coveredLeafBricks(unsigned int brickIndex) const;
+    BrickRange coveredLeafBricks(unsigned int brickIndex) const;
 
     /**
-     * Returns a list of the BST leaf nodes that a given input brick covers (at the same
-     * spatial subdivision level).
+     * Returns the BST leaf nodes that a given input brick covers (at the same spatial
+     * subdivision level), in increasing order.
      */
-    std::list<unsigned int> coveredBSTLeafBricks(unsigned int brickIndex) const;
-
-    /**
-     * Return a list of eight children brick incices given a brick index.
-     */
-    std::list<unsigned int> childBricks(unsigned int brickIndex);
+    BrickRange coveredBSTLeafBricks(unsigned int brickIndex) const;
 
+private:
     std::filesystem::path _filename;
     std::ifstream _file;
     std::streampos _dataOffset;
+    std::optional<MemoryMappedFile> _mappedFile;
 
     // Holds the actual structure
     std::vector<int> _data;
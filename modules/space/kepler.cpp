@@ -24,18 +24,28 @@
 
 #include <modules/space/kepler.h>
 
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/parallelfor.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/stringhelper.h>
+#include <glm/gtx/transform.hpp>
 #include <scn/scan.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <optional>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
 
 namespace {
     constexpr std::string_view _loggerCat = "Kepler";
-    constexpr int8_t CurrentCacheVersion = 1;
+    constexpr int8_t CurrentCacheVersion = 2;
 
     // The list of leap years only goes until 2056 as we need to touch this file then
     // again anyway ;)
@@ -392,22 +402,155 @@ namespace {
         return
             nSecondsSince2000 + totalSeconds + nLeapSecondsOffset - offset + date.seconds;
     }
-} // namespace
 
-namespace openspace::kepler {
+    // Solves Kepler's equation for all mean anomalies in `anomalies` in place, using the
+    // same solvers and number of iterations as the KeplerTranslation. The regime is
+    // chosen once for the entire block and each iteration runs over all values, so that
+    // the inner loops have no dependencies between their iterations
+    template <size_t N>
+    void solveEccentricAnomalies(double e, std::array<double, N>& anomalies,
+                                 size_t count)
+    {
+        std::array<double, N> x;
+        if (e == 0.0) {
+            // In a circular orbit, the eccentric anomaly = mean anomaly
+            return;
+        }
+        else if (e < 0.2) {
+            // For low eccentricity, using a first order solver sufficient
+            std::copy_n(anomalies.begin(), count, x.begin());
+            for (int it = 0; it < 5; it++) {
+                for (size_t i = 0; i < count; i++) {
+                    x[i] = anomalies[i] + e * std::sin(x[i]);
+                }
+            }
+        }
+        else if (e < 0.9) {
+            std::copy_n(anomalies.begin(), count, x.begin());
+            for (int it = 0; it < 6; it++) {
+                for (size_t i = 0; i < count; i++) {
+                    x[i] = x[i] + (anomalies[i] + e * std::sin(x[i]) - x[i]) /
+                        (1.0 - e * std::cos(x[i]));
+                }
+            }
+        }
+        else if (e < 1.0) {
+            auto sign = [](double val) -> double {
+                return val > 0.0 ? 1.0 : ((val < 0.0) ? -1.0 : 0.0);
+            };
 
-std::vector<Parameters> readTleFile(const std::filesystem::path& file) {
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+            for (size_t i = 0; i < count; i++) {
+                x[i] = anomalies[i] + 0.85 * e * sign(std::sin(anomalies[i]));
+            }
+            for (int it = 0; it < 8; it++) {
+                for (size_t i = 0; i < count; i++) {
+                    const double s = e * std::sin(x[i]);
+                    const double c = e * std::cos(x[i]);
+                    const double f = x[i] - s - anomalies[i];
+                    const double f1 = 1 - c;
+                    const double f2 = s;
+                    x[i] = x[i] + (-5 * f / (f1 + sign(f1) *
+                        std::sqrt(std::abs(16 * f1 * f1 - 20 * f * f2))));
+                }
+            }
+        }
+        else {
+            LERRORC("Kepler", "Eccentricity must not be >= 1.0");
+            std::fill_n(x.begin(), count, 0.0);
+        }
+        std::copy_n(x.begin(), count, anomalies.begin());
+    }
+
+    // Computes the positions of the orbit with index `orbit` for the times returned by
+    // `timeSinceEpoch(i)` for every index of `positions`. The eccentric anomalies are
+    // solved in blocks so that the solver loops can be vectorized
+    template <typename Func>
+    void computeOrbitPositions(const openspace::kepler::OrbitElements& orbits,
+                               size_t orbit, const Func& timeSinceEpoch,
+                               std::span<glm::dvec3> positions)
+    {
+        const size_t n = positions.size();
+        const double e = orbits.eccentricity[orbit];
+        const double a = orbits.semiMajorAxis[orbit];
+        const double b = orbits.semiMinorAxis[orbit];
+        const double meanAnomalyAtEpoch = orbits.meanAnomalyAtEpoch[orbit];
+        const double meanMotion = orbits.meanMotion[orbit];
+        const glm::dmat3& rotation = orbits.orbitPlaneRotation[orbit];
+
+        constexpr size_t BlockSize = 64;
+        std::array<double, BlockSize> anomalies;
+        for (size_t begin = 0; begin < n; begin += BlockSize) {
+            const size_t count = std::min(BlockSize, n - begin);
+            for (size_t i = 0; i < count; i++) {
+                const double t = timeSinceEpoch(begin + i);
+                anomalies[i] = meanAnomalyAtEpoch + t * meanMotion;
+            }
+
+            solveEccentricAnomalies(e, anomalies, count);
+
+            for (size_t i = 0; i < count; i++) {
+                const double ea = anomalies[i];
+                positions[begin + i] =
+                    rotation * glm::dvec3(a * (std::cos(ea) - e), b * std::sin(ea), 0.0);
+            }
+        }
+    }
 
-    std::vector<Parameters> result;
+    // Files with fewer entries than this per thread are parsed on fewer threads, as the
+    // cost of handing work to another thread would outweigh the parsing itself
+    constexpr size_t MinItemsPerRange = 512;
+
+    // Splits the contents of a file into its lines without copying them. A trailing
+    // carriage return is removed from each line so that files with Windows line endings
+    // are handled in the same way as by ghoul::getline
+    std::vector<std::string_view> splitLines(std::string_view content) {
+        std::vector<std::string_view> lines;
+        lines.reserve(std::count(content.begin(), content.end(), '\n') + 1);
+        size_t begin = 0;
+        while (begin < content.size()) {
+            size_t end = content.find('\n', begin);
+            if (end == std::string_view::npos) {
+                end = content.size();
+            }
+            std::string_view line = content.substr(begin, end - begin);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            lines.push_back(line);
+            begin = end + 1;
+        }
+        return lines;
+    }
 
-    std::ifstream f;
-    f.open(file);
+    std::string_view trimmed(std::string_view str) {
+        constexpr std::string_view Whitespace = " \t\n\r\f\v";
+        const size_t begin = str.find_first_not_of(Whitespace);
+        if (begin == std::string_view::npos) {
+            return std::string_view();
+        }
+        const size_t end = str.find_last_not_of(Whitespace);
+        return str.substr(begin, end - begin + 1);
+    }
 
-    int lineNum = 1;
+    // Parses a single fixed-width TLE field. The fields are short enough to fit into the
+    // small string buffer, so the conversion does not allocate
+    template <typename T>
+    T parseTleField(std::string_view field) {
+        if constexpr (std::is_same_v<T, float>) {
+            return std::stof(std::string(field));
+        }
+        else {
+            return std::stod(std::string(field));
+        }
+    }
 
-    std::string header;
-    while (ghoul::getline(f, header)) {
+    openspace::kepler::Parameters parseTleRecord(std::string_view header,
+                                                 std::string_view firstLine,
+                                                 std::string_view secondLine,
+                                                 const std::filesystem::path& file,
+                                                 size_t lineNum)
+    {
+        using namespace openspace::kepler;
         Parameters p;
 
         // Header
@@ -429,9 +572,7 @@ std::vector<Parameters> readTleFile(const std::filesystem::path& file) {
         //    12   63-63   The "Ephemeris type"
         //    13   65-68   Element set  number.Incremented when a new TLE is generated
         //    14   69-69   Checksum (modulo 10)
-        std::string firstLine;
-        ghoul::getline(f, firstLine);
-        if (f.bad() || firstLine[0] != '1') {
+        if (firstLine.empty() || firstLine[0] != '1') {
             throw ghoul::RuntimeError(std::format(
                 "Malformed TLE file '{}' at line {}", file, lineNum + 1
             ));
@@ -439,14 +580,12 @@ std::vector<Parameters> readTleFile(const std::filesystem::path& file) {
         // The id only contains the last two digits of the launch year, so we have to
         // patch it to the full year
         {
-            const std::string id = firstLine.substr(9, 6);
-            const std::string prefix = [y = id.substr(0, 2)]() {
-                const int year = std::atoi(y.c_str());
-                return year >= 57 ? "19" : "20";
-            }();
+            const std::string_view id = firstLine.substr(9, 6);
+            const int year = std::atoi(std::string(id.substr(0, 2)).c_str());
+            const std::string_view prefix = year >= 57 ? "19" : "20";
             p.id = std::format("{}{}-{}", prefix, id.substr(0, 2), id.substr(3));
         }
-        p.epoch = epochFromSubstring(firstLine.substr(18, 14)); // should be 13?
+        p.epoch = epochFromSubstring(std::string(firstLine.substr(18, 14)));
 
 
         // Second line
@@ -461,174 +600,116 @@ std::vector<Parameters> readTleFile(const std::filesystem::path& file) {
         //     8      53-63   Mean Motion (revolutions per day)
         //     9      64-68   Revolution number at epoch (revolutions)
         //    10      69-69   Checksum (modulo 10)
-        std::string secondLine;
-        ghoul::getline(f, secondLine);
-        if (f.bad() || secondLine[0] != '2') {
+        if (secondLine.empty() || secondLine[0] != '2') {
             throw ghoul::RuntimeError(std::format(
-                "Malformed TLE file '{}' at line {}", file, lineNum + 1
+                "Malformed TLE file '{}' at line {}", file, lineNum + 2
             ));
         }
 
-        std::stringstream stream;
-        stream.exceptions(std::ios::failbit);
-
-        // Get inclination
-        stream.str(secondLine.substr(8, 8));
-        stream >> p.inclination;
-        stream.clear();
-
-        // Get Right ascension of the ascending node
-        stream.str(secondLine.substr(17, 8));
-        stream >> p.ascendingNode;
-        stream.clear();
-
-        // Get Eccentricity
-        stream.str("0." + secondLine.substr(26, 7));
-        stream >> p.eccentricity;
-        stream.clear();
-
-        // Get argument of periapsis
-        stream.str(secondLine.substr(34, 8));
-        stream >> p.argumentOfPeriapsis;
-        stream.clear();
-
-        // Get mean anomaly
-        stream.str(secondLine.substr(43, 8));
-        stream >> p.meanAnomaly;
-        stream.clear();
-
-        // Get mean motion
-        stream.str(secondLine.substr(52, 11));
-        float meanMotion = 0.f;
-        stream >> meanMotion;
-
-        p.semiMajorAxis = calculateSemiMajorAxis(meanMotion);
-        p.period = std::chrono::seconds(std::chrono::hours(24)).count() / meanMotion;
-
-        result.push_back(p);
-
-        lineNum = lineNum + 3;
-    }
-
-    return result;
-}
-
-std::vector<Parameters> readOmmFile(const std::filesystem::path& file) {
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
-
-    std::vector<Parameters> result;
-
-    std::ifstream f;
-    f.open(file);
-
-    int lineNum = 1;
-    std::optional<Parameters> current = std::nullopt;
-    std::string line;
-    while (ghoul::getline(f, line)) {
-        if (line.empty() || line == "\r") {
-            continue;
-        }
+        try {
+            p.inclination = parseTleField<double>(secondLine.substr(8, 8));
+            p.ascendingNode = parseTleField<double>(secondLine.substr(17, 8));
+            p.eccentricity = parseTleField<double>(
+                std::format("0.{}", secondLine.substr(26, 7))
+            );
+            p.argumentOfPeriapsis = parseTleField<double>(secondLine.substr(34, 8));
+            p.meanAnomaly = parseTleField<double>(secondLine.substr(43, 8));
 
-        // Tokenize the line
-        std::vector<std::string> parts = ghoul::tokenizeString(line, '=');
-        for (std::string& p : parts) {
-            ghoul::trimWhitespace(p);
+            const float meanMotion = parseTleField<float>(secondLine.substr(52, 11));
+            p.semiMajorAxis = calculateSemiMajorAxis(meanMotion);
+            p.period = std::chrono::seconds(std::chrono::hours(24)).count() / meanMotion;
         }
-
-        if (parts.size() != 2) {
+        catch (const std::logic_error&) {
+            // Thrown both by std::stod for invalid numbers and by substr for lines that
+            // are too short
             throw ghoul::RuntimeError(std::format(
-                "Malformed line '{}' at {}", line, lineNum
+                "Malformed TLE file '{}' at line {}", file, lineNum + 2
             ));
         }
 
-        if (parts[0] == "CCSDS_OMM_VERS") {
-            if (parts[1] != "2.0") {
-                LWARNINGC(
-                    "OMM",
-                    std::format(
-                        "Only version 2.0 is currently supported but found {}. "
-                        "Parsing might fail",
-                        parts[1]
-                    )
-                );
-            }
+        return p;
+    }
 
-            // We start a new value so we need to store the last one...
-            if (current.has_value()) {
-                result.push_back(*current);
+    // Parses all lines of a single OMM record, the first of which is the line containing
+    // the CCSDS_OMM_VERS key
+    openspace::kepler::Parameters parseOmmRecord(std::span<const std::string_view> lines,
+                                                 size_t lineNum)
+    {
+        using namespace openspace::kepler;
+        Parameters current;
+
+        for (std::string_view l : lines) {
+            lineNum++;
+            if (l.empty()) {
+                continue;
             }
 
-            // ... and start a new one
-            current = Parameters();
-        }
-
-        ghoul_assert(current.has_value(), "No current element");
+            // Tokenize the line
+            const std::string line = std::string(l);
+            std::vector<std::string> parts = ghoul::tokenizeString(line, '=');
+            for (std::string& p : parts) {
+                ghoul::trimWhitespace(p);
+            }
 
-        if (parts[0] == "OBJECT_NAME") {
-            current->name = parts[1];
-        }
-        else if (parts[0] == "OBJECT_ID") {
-            current->id = parts[1];
-        }
-        else if (parts[0] == "EPOCH") {
-            current->epoch = epochFromOmmString(parts[1]);
-        }
-        else if (parts[0] == "MEAN_MOTION") {
-            const float mm = std::stof(parts[1]);
-            current->semiMajorAxis = calculateSemiMajorAxis(mm);
-            current->period = std::chrono::seconds(std::chrono::hours(24)).count() / mm;
-        }
-        else if (parts[0] == "SEMI_MAJOR_AXIS") {
+            if (parts.size() != 2) {
+                throw ghoul::RuntimeError(std::format(
+                    "Malformed line '{}' at {}", line, lineNum
+                ));
+            }
 
+            if (parts[0] == "CCSDS_OMM_VERS") {
+                if (parts[1] != "2.0") {
+                    LWARNINGC(
+                        "OMM",
+                        std::format(
+                            "Only version 2.0 is currently supported but found {}. "
+                            "Parsing might fail",
+                            parts[1]
+                        )
+                    );
+                }
+            }
+            else if (parts[0] == "OBJECT_NAME") {
+                current.name = parts[1];
+            }
+            else if (parts[0] == "OBJECT_ID") {
+                current.id = parts[1];
+            }
+            else if (parts[0] == "EPOCH") {
+                current.epoch = epochFromOmmString(parts[1]);
+            }
+            else if (parts[0] == "MEAN_MOTION") {
+                const float mm = std::stof(parts[1]);
+                current.semiMajorAxis = calculateSemiMajorAxis(mm);
+                current.period =
+                    std::chrono::seconds(std::chrono::hours(24)).count() / mm;
+            }
+            else if (parts[0] == "ECCENTRICITY") {
+                current.eccentricity = std::stof(parts[1]);
+            }
+            else if (parts[0] == "INCLINATION") {
+                current.inclination = std::stof(parts[1]);
+            }
+            else if (parts[0] == "RA_OF_ASC_NODE") {
+                current.ascendingNode = std::stof(parts[1]);
+            }
+            else if (parts[0] == "ARG_OF_PERICENTER") {
+                current.argumentOfPeriapsis = std::stof(parts[1]);
+            }
+            else if (parts[0] == "MEAN_ANOMALY") {
+                current.meanAnomaly = std::stof(parts[1]);
+            }
         }
-        else if (parts[0] == "ECCENTRICITY") {
-            current->eccentricity = std::stof(parts[1]);
-        }
-        else if (parts[0] == "INCLINATION") {
-            current->inclination = std::stof(parts[1]);
-        }
-        else if (parts[0] == "RA_OF_ASC_NODE") {
-            current->ascendingNode = std::stof(parts[1]);
-        }
-        else if (parts[0] == "ARG_OF_PERICENTER") {
-            current->argumentOfPeriapsis = std::stof(parts[1]);
-        }
-        else if (parts[0] == "MEAN_ANOMALY") {
-            current->meanAnomaly = std::stof(parts[1]);
-        }
-    }
-
-    if (current.has_value()) {
-        result.push_back(*current);
-    }
-
-    return result;
-}
-
-std::vector<Parameters> readSbdbFile(const std::filesystem::path& file) {
-    constexpr int NDataFields = 9;
-    constexpr std::string_view ExpectedHeader = "full_name,epoch_cal,e,a,i,om,w,ma,per";
-
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
-
-    std::ifstream f;
-    f.open(file);
 
-    std::string line;
-    ghoul::getline(f, line);
-    // Newer versions downloaded from the JPL SBDB website have " around variables
-    line.erase(remove(line.begin(), line.end(), '\"'), line.end());
-    if (line != ExpectedHeader) {
-        throw ghoul::RuntimeError(std::format(
-            "Expected JPL SBDB file to start with '{}' but found '{}' instead",
-            ExpectedHeader, line.substr(0, 100)
-        ));
+        return current;
     }
 
-    std::vector<Parameters> result;
-    while (ghoul::getline(f, line)) {
+    openspace::kepler::Parameters parseSbdbLine(std::string_view l) {
+        using namespace openspace::kepler;
+        constexpr int NDataFields = 9;
         constexpr double AuToKm = 1.496e8;
 
+        const std::string line = std::string(l);
         std::vector<std::string> parts = ghoul::tokenizeString(line, ',');
         if (parts.size() != NDataFields) {
             throw ghoul::RuntimeError(std::format(
@@ -664,80 +745,245 @@ std::vector<Parameters> readSbdbFile(const std::filesystem::path& file) {
         p.period =
             std::stod(parts[8]) * std::chrono::seconds(std::chrono::hours(24)).count();
 
-        result.push_back(std::move(p));
+        return p;
+    }
+
+    // The layout of the cache file. All parts are stored back to back and the header and
+    // records are multiples of 8 bytes in size, so that every record is properly aligned
+    // when the file is mapped into memory:
+    //   CacheHeader
+    //   CacheRecord[nRecords]
+    //   char[stringsSize]       names and ids of all records
+    // The version is the first byte, just as in the first version of the cache, so that
+    // old cache files are detected and recreated
+    struct CacheHeader {
+        int8_t version = CurrentCacheVersion;
+        std::array<uint8_t, 7> padding = {};
+        uint64_t nRecords = 0;
+        uint64_t stringsSize = 0;
+    };
+    static_assert(sizeof(CacheHeader) == 24);
+
+    struct CacheRecord {
+        double inclination = 0.0;
+        double semiMajorAxis = 0.0;
+        double ascendingNode = 0.0;
+        double eccentricity = 0.0;
+        double argumentOfPeriapsis = 0.0;
+        double meanAnomaly = 0.0;
+        double epoch = 0.0;
+        double period = 0.0;
+        // The name is stored at `stringsOffset` and the id follows directly after it
+        uint64_t stringsOffset = 0;
+        uint32_t nameLength = 0;
+        uint32_t idLength = 0;
+    };
+    static_assert(sizeof(CacheRecord) == 80);
+    static_assert(std::is_trivially_copyable_v<CacheRecord>);
+} // namespace
+
+namespace openspace::kepler {
+
+std::vector<Parameters> readTleFile(const std::filesystem::path& file) {
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    const MemoryMappedFile content = MemoryMappedFile(file);
+    std::vector<std::string_view> lines = splitLines(content.view());
+    // Ignore empty lines at the end of the file
+    while (!lines.empty() && trimmed(lines.back()).empty()) {
+        lines.pop_back();
     }
+
+    // Each record consists of a header line followed by the two element lines, so the
+    // records can be parsed independently of each other
+    const size_t nRecords = (lines.size() + 2) / 3;
+    std::vector<Parameters> result(nRecords);
+    parallelFor(nRecords, MinItemsPerRange, [&](size_t i) {
+        const size_t lineNum = i * 3 + 1;
+        if (i * 3 + 2 >= lines.size()) {
+            throw ghoul::RuntimeError(std::format(
+                "Malformed TLE file '{}' at line {}", file, lines.size() + 1
+            ));
+        }
+        result[i] = parseTleRecord(
+            lines[i * 3],
+            lines[i * 3 + 1],
+            lines[i * 3 + 2],
+            file,
+            lineNum
+        );
+    });
     return result;
 }
 
-void saveCache(const std::vector<Parameters>& params, const std::filesystem::path& file) {
-    std::ofstream stream(file, std::ofstream::binary);
+std::vector<Parameters> readOmmFile(const std::filesystem::path& file) {
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
 
-    stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    const MemoryMappedFile content = MemoryMappedFile(file);
+    const std::vector<std::string_view> lines = splitLines(content.view());
 
-    uint32_t size = static_cast<uint32_t>(params.size());
-    stream.write(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
-    for (const Parameters& param : params) {
-        uint32_t nameLength = static_cast<uint32_t>(param.name.size());
-        stream.write(reinterpret_cast<const char*>(&nameLength), sizeof(uint32_t));
-        stream.write(param.name.data(), nameLength * sizeof(char));
-
-        uint32_t idLength = static_cast<uint32_t>(param.id.size());
-        stream.write(reinterpret_cast<const char*>(&idLength), sizeof(uint32_t));
-        stream.write(param.id.data(), idLength * sizeof(char));
-
-        stream.write(reinterpret_cast<const char*>(&param.inclination), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.semiMajorAxis), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.ascendingNode), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.eccentricity), sizeof(double));
-        stream.write(
-            reinterpret_cast<const char*>(&param.argumentOfPeriapsis),
-            sizeof(double)
+    // Find the beginning of each record first, which only requires looking at the keys,
+    // so that the records themselves can then be parsed in parallel
+    std::vector<size_t> recordStarts;
+    for (size_t i = 0; i < lines.size(); i++) {
+        const std::string_view key = trimmed(lines[i].substr(0, lines[i].find('=')));
+        if (key == "CCSDS_OMM_VERS") {
+            recordStarts.push_back(i);
+        }
+        else if (recordStarts.empty() && !key.empty()) {
+            throw ghoul::RuntimeError(std::format(
+                "Malformed OMM file '{}'. Expected 'CCSDS_OMM_VERS' at line {}",
+                file, i + 1
+            ));
+        }
+    }
+    recordStarts.push_back(lines.size());
+
+    const size_t nRecords = recordStarts.size() - 1;
+    std::vector<Parameters> result(nRecords);
+    parallelFor(nRecords, MinItemsPerRange, [&](size_t i) {
+        const size_t begin = recordStarts[i];
+        const size_t end = recordStarts[i + 1];
+        result[i] = parseOmmRecord(
+            std::span<const std::string_view>(lines.data() + begin, end - begin),
+            begin
         );
-        stream.write(reinterpret_cast<const char*>(&param.meanAnomaly), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.epoch), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.period), sizeof(double));
+    });
+    return result;
+}
+
+std::vector<Parameters> readSbdbFile(const std::filesystem::path& file) {
+    constexpr std::string_view ExpectedHeader = "full_name,epoch_cal,e,a,i,om,w,ma,per";
+
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    const MemoryMappedFile content = MemoryMappedFile(file);
+    const std::vector<std::string_view> lines = splitLines(content.view());
+
+    std::string header = lines.empty() ? std::string() : std::string(lines.front());
+    // Newer versions downloaded from the JPL SBDB website have " around variables
+    header.erase(std::remove(header.begin(), header.end(), '\"'), header.end());
+    if (header != ExpectedHeader) {
+        throw ghoul::RuntimeError(std::format(
+            "Expected JPL SBDB file to start with '{}' but found '{}' instead",
+            ExpectedHeader, header.substr(0, 100)
+        ));
+    }
+
+    const size_t nRecords = lines.size() - 1;
+    std::vector<Parameters> result(nRecords);
+    parallelFor(nRecords, MinItemsPerRange, [&](size_t i) {
+        result[i] = parseSbdbLine(lines[i + 1]);
+    });
+    return result;
+}
+
+void saveCache(const std::vector<Parameters>& params, const std::filesystem::path& file) {
+    std::vector<CacheRecord> records;
+    records.reserve(params.size());
+    std::string strings;
+    for (const Parameters& param : params) {
+        records.push_back({
+            .inclination = param.inclination,
+            .semiMajorAxis = param.semiMajorAxis,
+            .ascendingNode = param.ascendingNode,
+            .eccentricity = param.eccentricity,
+            .argumentOfPeriapsis = param.argumentOfPeriapsis,
+            .meanAnomaly = param.meanAnomaly,
+            .epoch = param.epoch,
+            .period = param.period,
+            .stringsOffset = strings.size(),
+            .nameLength = static_cast<uint32_t>(param.name.size()),
+            .idLength = static_cast<uint32_t>(param.id.size())
+        });
+        strings += param.name;
+        strings += param.id;
     }
+
+    const CacheHeader header = {
+        .nRecords = records.size(),
+        .stringsSize = strings.size()
+    };
+
+    std::ofstream stream(file, std::ofstream::binary);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+    stream.write(
+        reinterpret_cast<const char*>(records.data()),
+        records.size() * sizeof(CacheRecord)
+    );
+    stream.write(strings.data(), strings.size());
 }
 
 std::optional<std::vector<Parameters>> loadCache(const std::filesystem::path& file) {
-    std::ifstream stream(file, std::ifstream::binary);
+    std::optional<MemoryMappedFile> content;
+    try {
+        content.emplace(file);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LWARNING(std::format("Error loading cache file '{}': {}", file, e.message));
+        return std::nullopt;
+    }
 
-    int8_t version = 0;
-    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-    if (version != CurrentCacheVersion) {
+    CacheHeader header;
+    if (content->size() < sizeof(CacheHeader)) {
+        LINFO("The format of the cached file has changed");
+        return std::nullopt;
+    }
+    std::memcpy(&header, content->data(), sizeof(CacheHeader));
+    if (header.version != CurrentCacheVersion) {
         LINFO("The format of the cached file has changed");
         return std::nullopt;
     }
 
-    uint32_t size = 0;
-    stream.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
-    std::vector<Parameters> res;
-    res.reserve(size);
-    for (uint32_t i = 0; i < size; i++) {
-        Parameters param;
+    // The sizes are checked against the remaining file size one after the other, since
+    // the sum of the values of a corrupted header could overflow
+    const size_t remainingSize = content->size() - sizeof(CacheHeader);
+    if (header.nRecords > remainingSize / sizeof(CacheRecord) ||
+        header.stringsSize != remainingSize - header.nRecords * sizeof(CacheRecord))
+    {
+        LWARNING(std::format("Cache file '{}' is truncated", file));
+        return std::nullopt;
+    }
 
-        uint32_t nameLength = 0;
-        stream.read(reinterpret_cast<char*>(&nameLength), sizeof(uint32_t));
-        param.name.resize(nameLength);
-        stream.read(param.name.data(), nameLength * sizeof(char));
+    const char* records = content->data() + sizeof(CacheHeader);
+    const std::string_view strings = std::string_view(
+        records + header.nRecords * sizeof(CacheRecord),
+        header.stringsSize
+    );
+
+    std::vector<Parameters> res(header.nRecords);
+    std::atomic_bool isValid = true;
+    parallelFor(res.size(), MinItemsPerRange, [&](size_t i) {
+        CacheRecord record;
+        std::memcpy(&record, records + i * sizeof(CacheRecord), sizeof(CacheRecord));
+        const uint64_t length = uint64_t(record.nameLength) + record.idLength;
+        if (record.stringsOffset > strings.size() ||
+            length > strings.size() - record.stringsOffset)
+        {
+            isValid = false;
+            return;
+        }
 
-        uint32_t idLength = 0;
-        stream.read(reinterpret_cast<char*>(&idLength), sizeof(uint32_t));
-        param.id.resize(idLength);
-        stream.read(param.id.data(), idLength * sizeof(char));
-
-        stream.read(reinterpret_cast<char*>(&param.inclination), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.semiMajorAxis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.ascendingNode), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.eccentricity), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.argumentOfPeriapsis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.meanAnomaly), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.epoch), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.period), sizeof(double));
-
-        res.push_back(std::move(param));
+        Parameters& param = res[i];
+        param.name = strings.substr(record.stringsOffset, record.nameLength);
+        param.id = strings.substr(
+            record.stringsOffset + record.nameLength,
+            record.idLength
+        );
+        param.inclination = record.inclination;
+        param.semiMajorAxis = record.semiMajorAxis;
+        param.ascendingNode = record.ascendingNode;
+        param.eccentricity = record.eccentricity;
+        param.argumentOfPeriapsis = record.argumentOfPeriapsis;
+        param.meanAnomaly = record.meanAnomaly;
+        param.epoch = record.epoch;
+        param.period = record.period;
+    });
+
+    if (!isValid) {
+        LWARNING(std::format("Cache file '{}' is corrupted", file));
+        return std::nullopt;
     }
-
     return res;
 }
 
@@ -774,4 +1020,74 @@ std::vector<Parameters> readFile(std::filesystem::path file, Format format) {
     return res;
 }
 
+OrbitElements::OrbitElements(std::span<const Parameters> parameters) {
+    const size_t n = parameters.size();
+    eccentricity.resize(n);
+    semiMajorAxis.resize(n);
+    semiMinorAxis.resize(n);
+    meanAnomalyAtEpoch.resize(n);
+    meanMotion.resize(n);
+    period.resize(n);
+    epoch.resize(n);
+    orbitPlaneRotation.resize(n);
+
+    for (size_t i = 0; i < n; i++) {
+        const Parameters& p = parameters[i];
+        const double e = p.eccentricity;
+        eccentricity[i] = e;
+        semiMajorAxis[i] = p.semiMajorAxis * 1000.0;
+        semiMinorAxis[i] = p.semiMajorAxis * 1000.0 * std::sqrt(1.0 - e * e);
+        meanAnomalyAtEpoch[i] = glm::radians(p.meanAnomaly);
+        meanMotion[i] = glm::two_pi<double>() / p.period;
+        period[i] = p.period;
+        epoch[i] = p.epoch;
+
+        // Same rotations as in KeplerTranslation::computeOrbitPlane
+        const double asc = glm::radians(p.ascendingNode);
+        const double inc = glm::radians(p.inclination);
+        const double per = glm::radians(p.argumentOfPeriapsis);
+        orbitPlaneRotation[i] = glm::dmat3(
+            glm::rotate(asc, glm::dvec3(0.0, 0.0, 1.0)) *
+            glm::rotate(inc, glm::dvec3(1.0, 0.0, 0.0)) *
+            glm::rotate(per, glm::dvec3(0.0, 0.0, 1.0))
+        );
+    }
+}
+
+size_t OrbitElements::size() const {
+    return eccentricity.size();
+}
+
+void orbitPositions(const OrbitElements& orbits, size_t orbit,
+                    std::span<glm::dvec3> positions)
+{
+    ghoul_assert(orbit < orbits.size(), "Orbit index out of range");
+
+    const size_t n = positions.size();
+    const double period = orbits.period[orbit];
+    const double denominator = n > 1 ? static_cast<double>(n - 1) : 1.0;
+    computeOrbitPositions(
+        orbits,
+        orbit,
+        [period, denominator](size_t i) {
+            return period * static_cast<double>(i) / denominator;
+        },
+        positions
+    );
+}
+
+void orbitPositions(const OrbitElements& orbits, size_t orbit, double startTime,
+                    double timeStep, std::span<glm::dvec3> positions)
+{
+    ghoul_assert(orbit < orbits.size(), "Orbit index out of range");
+
+    const double t0 = startTime - orbits.epoch[orbit];
+    computeOrbitPositions(
+        orbits,
+        orbit,
+        [t0, timeStep](size_t i) { return t0 + static_cast<double>(i) * timeStep; },
+        positions
+    );
+}
+
 } // namespace openspace::kepler
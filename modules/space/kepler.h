@@ -25,7 +25,9 @@
 #ifndef __OPENSPACE_MODULE_SPACE___KEPLER___H__
 #define __OPENSPACE_MODULE_SPACE___KEPLER___H__
 
+#include <ghoul/glm.h>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -105,6 +107,67 @@ enum class Format {
  */
 std::vector<Parameters> readFile(std::filesystem::path file, Format format);
 
+/**
+ * The orbital elements of a list of objects stored as a structure of arrays. All values
+ * that do not depend on the time are precomputed, so that the positions along an orbit
+ * can be computed without touching the original Parameters.
+ */
+struct OrbitElements {
+    OrbitElements() = default;
+    explicit OrbitElements(std::span<const Parameters> parameters);
+
+    size_t size() const;
+
+    std::vector<double> eccentricity;
+    /// In meters
+    std::vector<double> semiMajorAxis;
+    /// In meters
+    std::vector<double> semiMinorAxis;
+    /// In radians
+    std::vector<double> meanAnomalyAtEpoch;
+    /// In radians per second
+    std::vector<double> meanMotion;
+    /// In seconds
+    std::vector<double> period;
+    /// In seconds past the J2000 epoch
+    std::vector<double> epoch;
+    /// Rotation from the orbital plane into the reference frame of the elements
+    std::vector<glm::dmat3> orbitPlaneRotation;
+};
+
+/**
+ * Computes points along the orbit with the index \p orbit in \p orbits that are evenly
+ * distributed in time over one full period, starting at the epoch. The first and the
+ * last point are therefore at the same location. The results are the same as evaluating
+ * a KeplerTranslation for the same elements, but the eccentric anomalies are solved for
+ * blocks of points at a time, which lets the compiler vectorize the solver.
+ *
+ * \param orbits The orbital elements of all orbits
+ * \param orbit The index of the orbit for which to compute the points
+ * \param positions The output positions in meters. The number of points that are
+ *        computed is determined by the size of this span
+ *
+ * \pre \p orbit must be smaller than the number of orbits in \p orbits
+ */
+void orbitPositions(const OrbitElements& orbits, size_t orbit,
+    std::span<glm::dvec3> positions);
+
+/**
+ * Computes the positions of the orbit with the index \p orbit in \p orbits at the times
+ * `startTime + i * timeStep` for every index `i` of \p positions. The results are the
+ * same as evaluating a KeplerTranslation for the same elements at these times.
+ *
+ * \param orbits The orbital elements of all orbits
+ * \param orbit The index of the orbit for which to compute the positions
+ * \param startTime The time of the first position in seconds past the J2000 epoch
+ * \param timeStep The time between two consecutive positions in seconds
+ * \param positions The output positions in meters
+ *
+ * \pre \p orbit must be smaller than the number of orbits in \p orbits
+ */
+void orbitPositions(const OrbitElements& orbits, size_t orbit, double startTime,
+    double timeStep, std::span<glm::dvec3> positions);
+
 } // namespace openspace::kepler
 
 #endif // __OPENSPACE_MODULE_SPACE___KEPLER___H__
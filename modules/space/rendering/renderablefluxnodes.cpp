@@ -40,6 +40,8 @@
 #include <ghoul/misc/stringhelper.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <optional>
@@ -60,6 +62,11 @@ namespace {
         "usingGaussianPulse"
     };
 
+    // The positions file starts with the number of nodes per time step and the number of
+    // time steps, followed by the positions of all time steps back to back. The flux and
+    // radius files only contain the values of all time steps back to back
+    constexpr size_t PositionsHeaderSize = 2 * sizeof(uint32_t);
+
     constexpr openspace::properties::Property::PropertyInfo GoesEnergyBinsInfo = {
         "GoesEnergy",
         "GOES Energy",
@@ -284,6 +291,15 @@ namespace {
 
         // [[codegen::verbatim(colorTableRangeInfo.description)]]
         std::optional<glm::vec2> colorTableRange;
+
+        // The number of time steps that are read from disk ahead of the current time
+        // step in the direction of playback. 2 is default
+        std::optional<int> numberOfPrefetchedStates [[codegen::greaterequal(0)]];
+
+        // The amount of node data, in megabytes, that is kept in memory. Time steps that
+        // have been used least recently are released when the budget is exceeded, but
+        // the current and prefetched time steps are always kept. 1024 is default
+        std::optional<float> memoryBudget [[codegen::greater(0.0)]];
     };
 #include "renderablefluxnodes_codegen.cpp"
 
@@ -342,6 +358,8 @@ RenderableFluxNodes::RenderableFluxNodes(const ghoul::Dictionary& dictionary)
     _colorTablePath = p.colorTablePath;
     _transferFunction = std::make_unique<TransferFunction>(_colorTablePath.value());
     _colorTableRange = p.colorTableRange.value_or(_colorTableRange);
+    _nPrefetchedStates = p.numberOfPrefetchedStates.value_or(_nPrefetchedStates);
+    _memoryBudget = static_cast<size_t>(p.memoryBudget.value_or(1024.f) * 1024 * 1024);
 
     _binarySourceFolderPath = p.sourceFolder;
     if (std::filesystem::is_directory(_binarySourceFolderPath)) {
@@ -434,7 +452,7 @@ void RenderableFluxNodes::definePropertyCallbackFunctions() {
 }
 
 void RenderableFluxNodes::loadNodeData(int energybinOption) {
-    LDEBUG("Loading in binary files directly from sync folder");
+    LDEBUG("Mapping binary files directly from sync folder");
 
     std::string energybin;
     switch (energybinOption) {
@@ -456,20 +474,37 @@ void RenderableFluxNodes::loadNodeData(int energybinOption) {
         "{}/radiuses{}", _binarySourceFolderPath, energybin
     );
 
-    std::ifstream fileStream = std::ifstream(file, std::ifstream::binary);
-    std::ifstream fileStream2 = std::ifstream(file2, std::ifstream::binary);
-    std::ifstream fileStream3 = std::ifstream(file3, std::ifstream::binary);
+    // The previous energy bin is unmapped even if the new one turns out to be invalid
+    _positionsFile = std::nullopt;
+    _fluxesFile = std::nullopt;
+    _radiusesFile = std::nullopt;
+    _residentStates.clear();
+    _uploadedStateIndex = -1;
+    _nNodesPerTimestep = 0;
+
+    std::optional<MemoryMappedFile> positions;
+    std::optional<MemoryMappedFile> fluxes;
+    std::optional<MemoryMappedFile> radiuses;
+    try {
+        positions.emplace(file);
+        fluxes.emplace(file2);
+        radiuses.emplace(file3);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return;
+    }
 
-    if (!fileStream.good()) {
+    if (positions->size() < PositionsHeaderSize) {
         LERROR(std::format("Could not read file '{}'", file));
         return;
     }
 
     uint32_t nNodesPerTimestep = 0;
-    fileStream.read(reinterpret_cast<char*>(&nNodesPerTimestep), sizeof(uint32_t));
+    std::memcpy(&nNodesPerTimestep, positions->data(), sizeof(uint32_t));
 
     uint32_t nTimeSteps = 0;
-    fileStream.read(reinterpret_cast<char*>(&nTimeSteps), sizeof(uint32_t));
+    std::memcpy(&nTimeSteps, positions->data() + sizeof(uint32_t), sizeof(uint32_t));
     _nStates = nTimeSteps;
 
     if (_nStates != _startTimes.size()) {
@@ -480,36 +515,57 @@ void RenderableFluxNodes::loadNodeData(int energybinOption) {
         return;
     }
 
-    _statesColor.clear();
-    _statesPos.clear();
-    _statesRadius.clear();
+    const size_t nValues = static_cast<size_t>(nNodesPerTimestep) * _nStates;
+    if (positions->size() < PositionsHeaderSize + nValues * sizeof(glm::vec3)) {
+        LERROR(std::format("File '{}' is too small for {} states", file, _nStates));
+        return;
+    }
+    if (fluxes->size() < nValues * sizeof(float)) {
+        LERROR(std::format("File '{}' is too small for {} states", file2, _nStates));
+        return;
+    }
+    if (radiuses->size() < nValues * sizeof(float)) {
+        LERROR(std::format("File '{}' is too small for {} states", file3, _nStates));
+        return;
+    }
+
+    _positionsFile = std::move(positions);
+    _fluxesFile = std::move(fluxes);
+    _radiusesFile = std::move(radiuses);
+    _nNodesPerTimestep = nNodesPerTimestep;
+}
 
-    for (unsigned int i = 0; i < _nStates; i++) {
-        _vertexPositions.resize(nNodesPerTimestep);
-        fileStream.read(reinterpret_cast<char*>(
-            _vertexPositions.data()), nNodesPerTimestep * sizeof(glm::vec3)
-        );
+void RenderableFluxNodes::makeStateResident(int state) {
+    const size_t nNodes = _nNodesPerTimestep;
+    const size_t positionsSize = nNodes * sizeof(glm::vec3);
+    const size_t valuesSize = nNodes * sizeof(float);
 
-        _statesPos.push_back(_vertexPositions);
-        _vertexPositions.clear();
+    auto it = std::find(_residentStates.begin(), _residentStates.end(), state);
+    if (it != _residentStates.end()) {
+        _residentStates.erase(it);
     }
-    for (unsigned int i = 0; i < _nStates; i++) {
-        _vertexColor.resize(nNodesPerTimestep);
-        fileStream2.read(reinterpret_cast<char*>(
-            _vertexColor.data()), nNodesPerTimestep * sizeof(float)
-        );
-
-        _statesColor.push_back(_vertexColor);
-        _vertexColor.clear();
+    else {
+        // Reading the pages happens asynchronously in the operating system, so by the
+        // time the state becomes active it is hopefully already in memory
+        const size_t offset = PositionsHeaderSize + state * positionsSize;
+        _positionsFile->prefetch(offset, positionsSize);
+        _fluxesFile->prefetch(state * valuesSize, valuesSize);
+        _radiusesFile->prefetch(state * valuesSize, valuesSize);
     }
-    for (unsigned int i = 0; i < _nStates; i++) {
-        _vertexRadius.resize(nNodesPerTimestep);
-        fileStream3.read(reinterpret_cast<char*>(
-            _vertexRadius.data()), nNodesPerTimestep * sizeof(float)
-        );
+    _residentStates.push_back(state);
 
-        _statesRadius.push_back(_vertexRadius);
-        _vertexRadius.clear();
+    // The active state and the prefetched states are always kept, regardless of budget
+    const size_t stateSize = positionsSize + 2 * valuesSize;
+    const size_t nResident = std::max(
+        _memoryBudget / std::max<size_t>(stateSize, 1),
+        static_cast<size_t>(_nPrefetchedStates) + 1
+    );
+    while (_residentStates.size() > nResident) {
+        const int s = _residentStates.front();
+        _positionsFile->release(PositionsHeaderSize + s * positionsSize, positionsSize);
+        _fluxesFile->release(s * valuesSize, valuesSize);
+        _radiusesFile->release(s * valuesSize, valuesSize);
+        _residentStates.pop_front();
     }
 }
 
@@ -761,11 +817,9 @@ void RenderableFluxNodes::render(const RenderData& data, RendererTasks&) {
 
     glBindVertexArray(_vertexArrayObject);
 
-    glDrawArrays(
-        GL_POINTS,
-        0,
-        static_cast<GLsizei>(_vertexPositions.size())
-    );
+    if (_uploadedStateIndex != -1) {
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_nNodesPerTimestep));
+    }
 
     glBindVertexArray(0);
     _shaderProgram->deactivate();
@@ -819,13 +873,24 @@ void RenderableFluxNodes::update(const UpdateData& data) {
         needsUpdate = false;
     }
 
-    if (needsUpdate && !_statesPos[_activeTriggerTimeIndex].empty()) {
-        _vertexPositions = _statesPos[_activeTriggerTimeIndex];
-        _vertexColor = _statesColor[_activeTriggerTimeIndex];
-        _vertexRadius = _statesRadius[_activeTriggerTimeIndex];
+    // The buffers only need to be uploaded when the active state has changed
+    const bool isUploaded = _activeTriggerTimeIndex == _uploadedStateIndex;
+    if (needsUpdate && !isUploaded && _nNodesPerTimestep > 0) {
+        makeStateResident(_activeTriggerTimeIndex);
         updatePositionBuffer();
         updateVertexColorBuffer();
         updateVertexFilteringBuffer();
+        _uploadedStateIndex = _activeTriggerTimeIndex;
+
+        const double dt = currentTime - data.previousFrameTime.j2000Seconds();
+        const int direction = dt < 0.0 ? -1 : 1;
+        for (int i = 1; i <= _nPrefetchedStates; i++) {
+            const int state = _activeTriggerTimeIndex + i * direction;
+            if (state < 0 || state >= static_cast<int>(_nStates)) {
+                break;
+            }
+            makeStateResident(state);
+        }
     }
 
     if (_shaderProgram->isDirty()) {
@@ -842,10 +907,12 @@ void RenderableFluxNodes::updatePositionBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
 
+    // The nodes are uploaded straight from the mapped file without an intermediate copy
+    const size_t size = _nNodesPerTimestep * sizeof(glm::vec3);
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexPositions.size() * sizeof(glm::vec3),
-        _vertexPositions.data(),
+        size,
+        _positionsFile->data() + PositionsHeaderSize + _activeTriggerTimeIndex * size,
         GL_STATIC_DRAW
     );
 
@@ -861,10 +928,11 @@ void RenderableFluxNodes::updateVertexColorBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
+    const size_t size = _nNodesPerTimestep * sizeof(float);
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexColor.size() * sizeof(float),
-        _vertexColor.data(),
+        size,
+        _fluxesFile->data() + _activeTriggerTimeIndex * size,
         GL_STATIC_DRAW
     );
 
@@ -879,10 +947,11 @@ void RenderableFluxNodes::updateVertexFilteringBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexFilteringBuffer);
 
+    const size_t size = _nNodesPerTimestep * sizeof(float);
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexRadius.size() * sizeof(float),
-        _vertexRadius.data(),
+        size,
+        _radiusesFile->data() + _activeTriggerTimeIndex * size,
         GL_STATIC_DRAW
     );
 
@@ -34,9 +34,11 @@
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/opengl/uniformcache.h>
-#include <atomic>
+#include <deque>
 #include <filesystem>
+#include <optional>
 
 namespace openspace {
 
@@ -63,12 +65,11 @@ private:
     void updateActiveTriggerTimeIndex(double currentTime);
 
     void loadNodeData(int energybinOption);
+    void makeStateResident(int state);
     void updatePositionBuffer();
     void updateVertexColorBuffer();
     void updateVertexFilteringBuffer();
 
-    std::vector<GLsizei> _lineCount;
-    std::vector<GLint> _lineStart;
     // Used to determine if lines should be colored UNIFORMLY or by Flux Value
     enum class ColorMethod {
         ByFluxValue = 0,
@@ -112,6 +113,15 @@ private:
     int _activeTriggerTimeIndex = -1;
     // Number of states in the sequence
     uint32_t _nStates = 0;
+    // Number of nodes in each of the states
+    uint32_t _nNodesPerTimestep = 0;
+    // The state whose nodes are currently in the vertex buffers, -1 if none
+    int _uploadedStateIndex = -1;
+    // Number of states that are read ahead of the active state in the direction of
+    // playback
+    int _nPrefetchedStates = 2;
+    // The number of bytes of node data that is kept resident in memory
+    size_t _memoryBudget = 0;
 
     // Estimated end of sequence.
     double _sequenceEndTime;
@@ -133,18 +143,14 @@ private:
     std::vector<std::filesystem::path> _binarySourceFiles;
     // Contains the _triggerTimes for all streams in the sequence
     std::vector<double> _startTimes;
-    // Contains vertexPositions
-    std::vector<glm::vec3> _vertexPositions;
-    // Contains vertex flux values for color
-    std::vector<float> _vertexColor;
-    // Contains radius of vertices
-    std::vector<float> _vertexRadius;
-    // Stores the states position
-    std::vector<std::vector<glm::vec3>> _statesPos;
-    // Stores the states color
-    std::vector<std::vector<float>> _statesColor;
-    // Stores the states radius
-    std::vector<std::vector<float>> _statesRadius;
+    // Memory mapped files with the node positions, flux values for color and radius of
+    // all states for the selected energy bin. The states are stored back to back
+    std::optional<MemoryMappedFile> _positionsFile;
+    std::optional<MemoryMappedFile> _fluxesFile;
+    std::optional<MemoryMappedFile> _radiusesFile;
+    // The states that have been accessed most recently, with the latest one at the back.
+    // States are released from memory from the front when exceeding the memory budget
+    std::deque<int> _residentStates;
 
     // Group to hold properties regarding distance to earth
     properties::PropertyOwner _earthdistGroup;
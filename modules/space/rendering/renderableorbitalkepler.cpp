@@ -24,13 +24,13 @@
 
 #include <modules/space/rendering/renderableorbitalkepler.h>
 
-#include <modules/space/translation/keplertranslation.h>
 #include <modules/space/spacemodule.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/engine/globals.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/parallelfor.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -334,7 +334,10 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     addPropertySubOwner(_appearance);
 
     _path = p.path.string();
-    _path.onChange([this]() { updateBuffers(); });
+    _path.onChange([this]() {
+        _parametersAreDirty = true;
+        updateBuffers();
+    });
     addProperty(_path);
 
     _format = codegen::map<kepler::Format>(p.format);
@@ -345,6 +348,7 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
             if ((_numObjects - _startRenderIdx) < _sizeRender) {
                 _sizeRender = static_cast<unsigned int>(_numObjects - _startRenderIdx);
             }
+            _parametersAreDirty = true;
             _updateDataBuffersAtNextRender = true;
         }
     });
@@ -357,12 +361,16 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
                 _startRenderIdx = static_cast<unsigned int>(_numObjects - _sizeRender);
             }
         }
+        _parametersAreDirty = true;
         _updateDataBuffersAtNextRender = true;
     });
     addProperty(_sizeRender);
 
     _contiguousMode = p.contiguousMode.value_or(false);
-    _contiguousMode.onChange([this]() { _updateDataBuffersAtNextRender = true; });
+    _contiguousMode.onChange([this]() {
+        _parametersAreDirty = true;
+        _updateDataBuffersAtNextRender = true;
+    });
     addProperty(_contiguousMode);
 }
 
@@ -591,7 +599,7 @@ void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
     }
 }
 
-void RenderableOrbitalKepler::updateBuffers() {
+void RenderableOrbitalKepler::loadParameters() {
     std::vector<kepler::Parameters> parameters = kepler::readFile(
        _path.value(),
         _format
@@ -647,63 +655,72 @@ void RenderableOrbitalKepler::updateBuffers() {
         );
     }
 
+    _orbitElements = kepler::OrbitElements(parameters);
+
+    double maxSemiMajorAxis = 0.0;
+    for (const kepler::Parameters& kp : parameters) {
+        if (kp.semiMajorAxis > maxSemiMajorAxis) {
+            maxSemiMajorAxis = kp.semiMajorAxis;
+        }
+    }
+    setBoundingSphere(maxSemiMajorAxis * 1000);
+
+    _parametersAreDirty = false;
+}
+
+void RenderableOrbitalKepler::updateBuffers() {
+    // Changing the segment quality only requires the vertices to be recomputed, so the
+    // file is only read again if the selection of objects has changed
+    if (_parametersAreDirty) {
+        loadParameters();
+    }
+
+    const size_t numOrbits = _orbitElements.size();
+
     _segmentSize.clear();
     _startIndex.clear();
     _startIndex.push_back(0);
-    for (size_t i = 0; i < parameters.size(); i++) {
+    for (size_t i = 0; i < numOrbits; i++) {
         const double scale = static_cast<double>(_segmentQuality) * 10.0;
-        const kepler::Parameters& p = parameters[i];
+        const double eccentricity = _orbitElements.eccentricity[i];
         _segmentSize.push_back(
-            static_cast<int>(scale + (scale / pow(1.0 - p.eccentricity, 1.2)))
+            static_cast<int>(scale + (scale / pow(1.0 - eccentricity, 1.2)))
         );
         _startIndex.push_back(_startIndex[i] + static_cast<GLint>(_segmentSize[i]));
     }
+    const size_t nVerticesTotal = _startIndex.back();
     _startIndex.pop_back();
 
-    size_t nVerticesTotal = 0;
-
-    const int numOrbits = static_cast<int>(parameters.size());
-    for (int i = 0; i < numOrbits; i++) {
-        nVerticesTotal += _segmentSize[i];
-    }
     _vertexBufferData.resize(nVerticesTotal);
 
-    size_t vertexBufIdx = 0;
-    KeplerTranslation keplerTranslator;
-    for (int orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
-        const kepler::Parameters& orbit = parameters[orbitIdx];
-
-        keplerTranslator.setKeplerElements(
-            orbit.eccentricity,
-            orbit.semiMajorAxis,
-            orbit.inclination,
-            orbit.ascendingNode,
-            orbit.argumentOfPeriapsis,
-            orbit.meanAnomaly,
-            orbit.period,
-            orbit.epoch
-        );
-
-        for (GLint j = 0 ; j < (_segmentSize[orbitIdx]); j++) {
-            const double timeOffset = orbit.period *
-                static_cast<double>(j) / static_cast<double>(_segmentSize[orbitIdx] - 1);
-
-            const glm::dvec3 position = keplerTranslator.position({
-                {},
-                Time(timeOffset + orbit.epoch),
-                Time(0.0)
-            });
-
-            _vertexBufferData[vertexBufIdx].x = static_cast<float>(position.x);
-            _vertexBufferData[vertexBufIdx].y = static_cast<float>(position.y);
-            _vertexBufferData[vertexBufIdx].z = static_cast<float>(position.z);
-            _vertexBufferData[vertexBufIdx].time = static_cast<float>(timeOffset);
-            _vertexBufferData[vertexBufIdx].epoch = orbit.epoch;
-            _vertexBufferData[vertexBufIdx].period = orbit.period;
-
-            vertexBufIdx++;
+    // The orbits are handed out to the threads in small batches as the number of
+    // vertices per orbit varies with the eccentricity
+    constexpr size_t OrbitsPerBatch = 256;
+    const size_t nBatches = (numOrbits + OrbitsPerBatch - 1) / OrbitsPerBatch;
+    auto computeVertices = [this](size_t, size_t begin, size_t end) {
+        std::vector<glm::dvec3> positions;
+        for (size_t orbitIdx = begin; orbitIdx < end; orbitIdx++) {
+            const size_t nSegments = _segmentSize[orbitIdx];
+            positions.resize(nSegments);
+            kepler::orbitPositions(_orbitElements, orbitIdx, positions);
+
+            const double period = _orbitElements.period[orbitIdx];
+            const double epoch = _orbitElements.epoch[orbitIdx];
+            TrailVBOLayout* vertices = &_vertexBufferData[_startIndex[orbitIdx]];
+            for (size_t j = 0; j < nSegments; j++) {
+                const double timeOffset = period *
+                    static_cast<double>(j) / static_cast<double>(nSegments - 1);
+
+                vertices[j].x = static_cast<float>(positions[j].x);
+                vertices[j].y = static_cast<float>(positions[j].y);
+                vertices[j].z = static_cast<float>(positions[j].z);
+                vertices[j].time = static_cast<float>(timeOffset);
+                vertices[j].epoch = epoch;
+                vertices[j].period = period;
+            }
         }
-    }
+    };
+    parallelForRanges(numOrbits, nBatches, computeVertices);
 
     glBindVertexArray(_vertexArray);
 
@@ -729,14 +746,6 @@ void RenderableOrbitalKepler::updateBuffers() {
     );
 
     glBindVertexArray(0);
-
-    double maxSemiMajorAxis = 0.0;
-    for (const kepler::Parameters& kp : parameters) {
-        if (kp.semiMajorAxis > maxSemiMajorAxis) {
-            maxSemiMajorAxis = kp.semiMajorAxis;
-        }
-    }
-    setBoundingSphere(maxSemiMajorAxis * 1000);
 }
 
 } // namespace openspace
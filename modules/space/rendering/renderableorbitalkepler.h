@@ -29,7 +29,6 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 #include <modules/space/kepler.h>
-#include <modules/space/translation/keplertranslation.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/uintproperty.h>
 #include <ghoul/glm.h>
@@ -78,9 +77,12 @@ private:
         properties::FloatProperty outlineWidth;
     };
 
+    void loadParameters();
     void updateBuffers();
 
     bool _updateDataBuffersAtNextRender = false;
+    bool _parametersAreDirty = true;
+    kepler::OrbitElements _orbitElements;
     std::streamoff _numObjects;
     std::vector<GLint> _segmentSize;
     std::vector<GLint> _startIndex;
@@ -31,6 +31,7 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/templatefactory.h>
@@ -39,6 +40,8 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <filesystem>
@@ -315,6 +318,25 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo EnableLevelOfDetailInfo = {
+        "EnableLevelOfDetail",
+        "Enable Level of Detail",
+        "If enabled, the stars are organized in a spatial hierarchy when they are "
+        "loaded and only the stars that are inside the view frustum and brighter than "
+        "the magnitude limit, as seen from the camera, are rendered. This requires the "
+        "absolute magnitude data mapping to be set.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MagnitudeLimitInfo = {
+        "MagnitudeLimit",
+        "Magnitude Limit",
+        "The apparent magnitude of the dimmest stars that are rendered if the level of "
+        "detail is enabled. Stars that appear dimmer than this from the current camera "
+        "position are not rendered.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(RenderableStars)]] Parameters {
         // [[codegen::verbatim(SpeckFileInfo.description)]]
         std::filesystem::path speckFile [[codegen::key("File")]];
@@ -408,6 +430,12 @@ namespace {
 
         // [[codegen::verbatim(EnableFadeInInfo.description)]]
         std::optional<bool> enableFadeIn;
+
+        // [[codegen::verbatim(EnableLevelOfDetailInfo.description)]]
+        std::optional<bool> enableLevelOfDetail;
+
+        // [[codegen::verbatim(MagnitudeLimitInfo.description)]]
+        std::optional<float> magnitudeLimit;
     };
 #include "renderablestars_codegen.cpp"
 }  // namespace
@@ -481,6 +509,8 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
         glm::vec2(100.f)
     )
     , _enableFadeInDistance(EnableFadeInInfo, false)
+    , _enableLevelOfDetail(EnableLevelOfDetailInfo, false)
+    , _magnitudeLimit(MagnitudeLimitInfo, 12.f, -10.f, 30.f)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -516,7 +546,10 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
 
     _dataMapping.absoluteMagnitude =
         p.dataMapping.absoluteMagnitude.value_or(_dataMapping.absoluteMagnitude);
-    _dataMapping.absoluteMagnitude.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.absoluteMagnitude.onChange([this]() {
+        _dataIsDirty = true;
+        _hierarchyIsDirty = true;
+    });
     _dataMapping.container.addProperty(_dataMapping.absoluteMagnitude);
 
     _dataMapping.vx = p.dataMapping.vx.value_or(_dataMapping.vx);
@@ -649,6 +682,13 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
         addProperty(_enableFadeInDistance);
     }
 
+    _enableLevelOfDetail = p.enableLevelOfDetail.value_or(_enableLevelOfDetail);
+    _enableLevelOfDetail.onChange([this]() { _dataIsDirty = true; });
+    addProperty(_enableLevelOfDetail);
+
+    _magnitudeLimit = p.magnitudeLimit.value_or(_magnitudeLimit);
+    addProperty(_magnitudeLimit);
+
     _queuedOtherData = p.otherData.value_or(_queuedOtherData);
     _staticFilterValue = p.staticFilter;
     _staticFilterReplacementValue =
@@ -841,8 +881,12 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     _program->setUniform(_uniformCache.filterOutOfRange, _filterOutOfRange);
 
 
+    if (_isUsingHierarchy) {
+        streamVisibleStars(modelMatrix, viewProjectionMatrix, eyePosition);
+    }
+
     glBindVertexArray(_vao);
-    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_dataset.entries.size()));
+    glDrawArrays(GL_POINTS, 0, _nRenderedStars);
     glBindVertexArray(0);
     _program->deactivate();
 
@@ -867,23 +911,49 @@ void RenderableStars::update(const UpdateData&) {
         LDEBUG("Regenerating data");
 
         std::vector<float> slice = createDataSlice(ColorOption(value));
+        const size_t nStars = _dataset.entries.size();
+        const size_t nValues = slice.size() / nStars;
+
+        if (_enableLevelOfDetail && _hierarchyIsDirty) {
+            loadHierarchy();
+            _hierarchyIsDirty = false;
+        }
+        _isUsingHierarchy = _enableLevelOfDetail && !_hierarchy.nodes.empty();
 
         glBindVertexArray(_vao);
         glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            slice.size() * sizeof(GLfloat),
-            slice.data(),
-            GL_STATIC_DRAW
-        );
+        if (_isUsingHierarchy) {
+            // Store the stars in the order of the hierarchy so that the visible stars
+            // can be copied as contiguous ranges. The buffer is filled during rendering
+            _nValuesPerStar = nValues;
+            _hierarchySlice.resize(slice.size());
+            for (size_t i = 0; i < _hierarchy.order.size(); i++) {
+                std::copy_n(
+                    slice.begin() + _hierarchy.order[i] * nValues,
+                    nValues,
+                    _hierarchySlice.begin() + i * nValues
+                );
+            }
+            _uploadedStars.clear();
+            _nRenderedStars = 0;
+            glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+        }
+        else {
+            _hierarchySlice.clear();
+            _hierarchySlice.shrink_to_fit();
+            _nRenderedStars = static_cast<GLsizei>(nStars);
+            glBufferData(
+                GL_ARRAY_BUFFER,
+                slice.size() * sizeof(GLfloat),
+                slice.data(),
+                GL_STATIC_DRAW
+            );
+        }
 
         const GLint positionAttrib = _program->attributeLocation("in_position");
         // in_bvLumAbsMag = bv color, luminosity, abs magnitude
         const GLint bvLumAbsMagAttrib = _program->attributeLocation("in_bvLumAbsMag");
 
-        const size_t nStars = _dataset.entries.size();
-        const size_t nValues = slice.size() / nStars;
-
         const GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
 
         glEnableVertexAttribArray(positionAttrib);
@@ -1033,6 +1103,7 @@ void RenderableStars::loadData() {
     }
 
     _dataset = dataloader::data::loadFileWithCache(file);
+    _hierarchyIsDirty = true;
     if (_dataset.entries.empty()) {
         return;
     }
@@ -1050,6 +1121,92 @@ void RenderableStars::loadData() {
     }
 }
 
+void RenderableStars::loadHierarchy() {
+    _hierarchy = stars::Hierarchy();
+
+    const int absMagIdx = _dataset.index(_dataMapping.absoluteMagnitude);
+    if (absMagIdx == -1) {
+        LWARNING(std::format(
+            "Could not find absolute magnitude column '{}'. Level of detail is disabled",
+            _dataMapping.absoluteMagnitude.value()
+        ));
+        return;
+    }
+
+    const std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+        absPath(_speckFile),
+        std::format("hierarchy-{}", _dataMapping.absoluteMagnitude.value())
+    );
+    if (std::filesystem::is_regular_file(cached)) {
+        std::optional<stars::Hierarchy> hierarchy =
+            stars::loadCache(cached, _dataset.entries.size());
+        if (hierarchy.has_value()) {
+            LDEBUG(std::format("Loaded star hierarchy from cache '{}'", cached));
+            _hierarchy = std::move(*hierarchy);
+            return;
+        }
+        FileSys.cacheManager()->removeCacheFile(cached);
+    }
+
+    LDEBUG("Building star hierarchy");
+    std::vector<glm::vec3> positions;
+    positions.reserve(_dataset.entries.size());
+    std::vector<float> absoluteMagnitudes;
+    absoluteMagnitudes.reserve(_dataset.entries.size());
+    for (const dataloader::Dataset::Entry& e : _dataset.entries) {
+        positions.push_back(e.position);
+        absoluteMagnitudes.push_back(e.data[absMagIdx]);
+    }
+    _hierarchy = stars::buildHierarchy(positions, absoluteMagnitudes);
+    stars::saveCache(_hierarchy, cached);
+}
+
+void RenderableStars::streamVisibleStars(const glm::dmat4& modelMatrix,
+                                         const glm::dmat4& viewProjectionMatrix,
+                                         const glm::dvec3& eyePosition)
+{
+    // The hierarchy is built from the positions in the dataset, which are in parsec
+    const glm::dmat4 parsecToWorld =
+        modelMatrix * glm::scale(glm::dvec3(distanceconstants::Parsec));
+    const glm::dvec3 cameraPosition =
+        glm::dvec3(glm::inverse(parsecToWorld) * glm::dvec4(eyePosition, 1.0));
+    const std::array<glm::dvec4, 4> planes =
+        stars::frustumPlanes(viewProjectionMatrix * parsecToWorld);
+
+    stars::selectStars(
+        _hierarchy,
+        cameraPosition,
+        planes,
+        _magnitudeLimit,
+        _visibleStars
+    );
+    if (_visibleStars == _uploadedStars) {
+        return;
+    }
+
+    _streamBuffer.clear();
+    for (const stars::Range& range : _visibleStars) {
+        const auto begin = _hierarchySlice.begin() + range.first * _nValuesPerStar;
+        _streamBuffer.insert(
+            _streamBuffer.end(),
+            begin,
+            begin + range.count * _nValuesPerStar
+        );
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _streamBuffer.size() * sizeof(GLfloat),
+        _streamBuffer.data(),
+        GL_STREAM_DRAW
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _nRenderedStars = static_cast<GLsizei>(_streamBuffer.size() / _nValuesPerStar);
+    std::swap(_uploadedStars, _visibleStars);
+}
+
 std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
     const int bvIdx = std::max(_dataset.index(_dataMapping.bvColor), 0);
     const int lumIdx = std::max(_dataset.index(_dataMapping.luminance), 0);
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/space/starhierarchy.h>
 #include <openspace/data/dataloader.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
@@ -75,7 +76,10 @@ private:
 
     void loadPSFTexture();
     void loadData();
+    void loadHierarchy();
     std::vector<float> createDataSlice(ColorOption option);
+    void streamVisibleStars(const glm::dmat4& modelMatrix,
+        const glm::dmat4& viewProjectionMatrix, const glm::dvec3& eyePosition);
 
     properties::StringProperty _speckFile;
 
@@ -128,6 +132,8 @@ private:
     properties::FloatProperty _magnitudeExponent;
     properties::Vec2Property _fadeInDistances;
     properties::BoolProperty _enableFadeInDistance;
+    properties::BoolProperty _enableLevelOfDetail;
+    properties::FloatProperty _magnitudeLimit;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
     UniformCache(
@@ -143,9 +149,21 @@ private:
     bool _colorTextureIsDirty = true;
     bool _dataIsDirty = true;
     bool _otherDataColorMapIsDirty = true;
+    bool _hierarchyIsDirty = true;
 
     dataloader::Dataset _dataset;
 
+    // The level of detail data. If the hierarchy is used, the VBO only contains the
+    // currently visible stars, which are streamed from `_hierarchySlice` when needed
+    stars::Hierarchy _hierarchy;
+    bool _isUsingHierarchy = false;
+    std::vector<float> _hierarchySlice;
+    size_t _nValuesPerStar = 0;
+    std::vector<stars::Range> _visibleStars;
+    std::vector<stars::Range> _uploadedStars;
+    std::vector<float> _streamBuffer;
+    GLsizei _nRenderedStars = 0;
+
     std::string _queuedOtherData;
 
     std::optional<float> _staticFilterValue;
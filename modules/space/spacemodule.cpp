@@ -33,6 +33,7 @@
 #include <modules/space/rendering/renderablerings.h>
 #include <modules/space/rendering/renderablestars.h>
 #include <modules/space/rendering/renderabletravelspeed.h>
+#include <modules/space/tasks/generatedebrisvolumetask.h>
 #include <modules/space/translation/keplertranslation.h>
 #include <modules/space/translation/spicetranslation.h>
 #include <modules/space/translation/gptranslation.h>
@@ -45,6 +46,7 @@
 #include <openspace/util/coordinateconversion.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
@@ -120,6 +122,10 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary& dictionary) {
 
     fRotation->registerClass<SpiceRotation>("SpiceRotation");
 
+    ghoul::TemplateFactory<Task>* fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<volume::GenerateDebrisVolumeTask>("GenerateDebrisVolumeTask");
+
     const Parameters p = codegen::bake<Parameters>(dictionary);
     _showSpiceExceptions = p.showExceptions.value_or(_showSpiceExceptions);
 }
@@ -130,6 +136,7 @@ void SpaceModule::internalDeinitializeGL() {
 
 std::vector<documentation::Documentation> SpaceModule::documentations() const {
     return {
+        volume::GenerateDebrisVolumeTask::Documentation(),
         HorizonsTranslation::Documentation(),
         KeplerTranslation::Documentation(),
         RenderableConstellationBounds::Documentation(),
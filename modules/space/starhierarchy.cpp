@@ -0,0 +1,381 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/starhierarchy.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace {
+    constexpr int8_t CurrentCacheVersion = 1;
+
+    // Nodes are not subdivided further than this, even if they contain more stars than
+    // requested, to guard against pathological distributions such as duplicate positions
+    constexpr int MaxDepth = 21;
+
+    using Hierarchy = openspace::stars::Hierarchy;
+
+    struct Builder {
+        std::span<const glm::vec3> positions;
+        std::span<const float> magnitudes;
+        uint32_t maxStarsPerNode = 0;
+        Hierarchy& hierarchy;
+    };
+
+    void buildNode(Builder& b, size_t nodeIndex, uint32_t begin, uint32_t end,
+                   int depth)
+    {
+        std::vector<uint32_t>& order = b.hierarchy.order;
+
+        Hierarchy::Node node;
+        node.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        node.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+        node.minAbsoluteMagnitude = std::numeric_limits<float>::max();
+        for (uint32_t i = begin; i < end; i++) {
+            const glm::vec3& p = b.positions[order[i]];
+            node.boundsMin = glm::min(node.boundsMin, p);
+            node.boundsMax = glm::max(node.boundsMax, p);
+            node.minAbsoluteMagnitude =
+                std::min(node.minAbsoluteMagnitude, b.magnitudes[order[i]]);
+        }
+
+        const bool isLeaf = (end - begin) <= b.maxStarsPerNode || depth >= MaxDepth ||
+            node.boundsMin == node.boundsMax;
+        if (isLeaf) {
+            // Sort the stars from the brightest to the dimmest, so that the stars that
+            // are visible from any distance are always a prefix of the leaf
+            std::sort(
+                order.begin() + begin,
+                order.begin() + end,
+                [&b](uint32_t lhs, uint32_t rhs) {
+                    return b.magnitudes[lhs] < b.magnitudes[rhs];
+                }
+            );
+            node.first = begin;
+            node.count = end - begin;
+            b.hierarchy.nodes[nodeIndex] = node;
+            return;
+        }
+
+        // Partition the stars into the eight octants around the center of the bounding
+        // box by splitting along the x, y, and z axes in turn
+        const glm::vec3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+        auto partition = [&b, &order, &center](uint32_t first, uint32_t last, int axis) {
+            auto it = std::partition(
+                order.begin() + first,
+                order.begin() + last,
+                [&b, &center, axis](uint32_t i) {
+                    return b.positions[i][axis] < center[axis];
+                }
+            );
+            return static_cast<uint32_t>(std::distance(order.begin(), it));
+        };
+        std::array<uint32_t, 9> splits;
+        splits[0] = begin;
+        splits[8] = end;
+        splits[4] = partition(splits[0], splits[8], 0);
+        splits[2] = partition(splits[0], splits[4], 1);
+        splits[6] = partition(splits[4], splits[8], 1);
+        for (int i = 0; i < 8; i += 2) {
+            splits[i + 1] = partition(splits[i], splits[i + 2], 2);
+        }
+
+        node.firstChild = static_cast<uint32_t>(b.hierarchy.nodes.size());
+        for (int i = 0; i < 8; i++) {
+            if (splits[i] != splits[i + 1]) {
+                node.nChildren++;
+            }
+        }
+        // The children are allocated before recursing so that they are contiguous
+        b.hierarchy.nodes.resize(b.hierarchy.nodes.size() + node.nChildren);
+        b.hierarchy.nodes[nodeIndex] = node;
+
+        size_t child = node.firstChild;
+        for (int i = 0; i < 8; i++) {
+            if (splits[i] != splits[i + 1]) {
+                buildNode(b, child, splits[i], splits[i + 1], depth + 1);
+                child++;
+            }
+        }
+    }
+
+    bool isOutside(const Hierarchy::Node& node, const std::array<glm::dvec4, 4>& planes) {
+        for (const glm::dvec4& plane : planes) {
+            // The corner of the box that lies the farthest along the plane normal
+            const glm::dvec3 corner = glm::dvec3(
+                plane.x >= 0.0 ? node.boundsMax.x : node.boundsMin.x,
+                plane.y >= 0.0 ? node.boundsMax.y : node.boundsMin.y,
+                plane.z >= 0.0 ? node.boundsMax.z : node.boundsMin.z
+            );
+            if (glm::dot(glm::dvec3(plane), corner) + plane.w < 0.0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    double distanceToNode(const Hierarchy::Node& node, const glm::dvec3& position) {
+        const glm::dvec3 d = glm::max(
+            glm::max(glm::dvec3(node.boundsMin) - position, glm::dvec3(0.0)),
+            position - glm::dvec3(node.boundsMax)
+        );
+        return glm::length(d);
+    }
+} // namespace
+
+namespace openspace::stars {
+
+Hierarchy buildHierarchy(std::span<const glm::vec3> positions,
+                         std::span<const float> absoluteMagnitudes,
+                         uint32_t maxStarsPerNode)
+{
+    ghoul_assert(
+        positions.size() == absoluteMagnitudes.size(),
+        "Positions and magnitudes must have the same size"
+    );
+    ghoul_assert(maxStarsPerNode > 0, "Nodes must contain at least one star");
+
+    Hierarchy hierarchy;
+    if (positions.empty()) {
+        return hierarchy;
+    }
+
+    // Stars without a valid magnitude are treated as being infinitely bright so that
+    // they are never culled because of their brightness
+    std::vector<float> magnitudes = std::vector<float>(
+        absoluteMagnitudes.begin(),
+        absoluteMagnitudes.end()
+    );
+    for (float& m : magnitudes) {
+        if (std::isnan(m)) {
+            m = -std::numeric_limits<float>::max();
+        }
+    }
+
+    hierarchy.order.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        hierarchy.order[i] = static_cast<uint32_t>(i);
+    }
+    hierarchy.nodes.resize(1);
+
+    Builder builder = {
+        .positions = positions,
+        .magnitudes = magnitudes,
+        .maxStarsPerNode = maxStarsPerNode,
+        .hierarchy = hierarchy
+    };
+    buildNode(builder, 0, 0, static_cast<uint32_t>(positions.size()), 0);
+
+    hierarchy.absoluteMagnitudes.resize(positions.size());
+    for (size_t i = 0; i < hierarchy.order.size(); i++) {
+        hierarchy.absoluteMagnitudes[i] = magnitudes[hierarchy.order[i]];
+    }
+    return hierarchy;
+}
+
+std::array<glm::dvec4, 4> frustumPlanes(const glm::dmat4& viewProjection) {
+    auto row = [&viewProjection](int i) {
+        return glm::dvec4(
+            viewProjection[0][i],
+            viewProjection[1][i],
+            viewProjection[2][i],
+            viewProjection[3][i]
+        );
+    };
+
+    std::array<glm::dvec4, 4> planes = {
+        row(3) + row(0), // left
+        row(3) - row(0), // right
+        row(3) + row(1), // bottom
+        row(3) - row(1)  // top
+    };
+    for (glm::dvec4& plane : planes) {
+        plane /= glm::length(glm::dvec3(plane));
+    }
+    return planes;
+}
+
+void selectStars(const Hierarchy& hierarchy, const glm::dvec3& cameraPosition,
+                 const std::array<glm::dvec4, 4>& planes, float magnitudeLimit,
+                 std::vector<Range>& result)
+{
+    result.clear();
+    if (hierarchy.nodes.empty()) {
+        return;
+    }
+
+    // Every level of the depth-first traversal adds at most 8 nodes to the stack
+    std::array<uint32_t, 8 * (MaxDepth + 1)> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Hierarchy::Node& node = hierarchy.nodes[stack[--stackSize]];
+        if (isOutside(node, planes)) {
+            continue;
+        }
+
+        // The apparent magnitude of the brightest star in the node if it were located
+        // at the point of the node that is closest to the camera
+        const double distance = distanceToNode(node, cameraPosition);
+        const double distanceModulus =
+            distance > 0.0 ?
+            5.0 * std::log10(distance) - 5.0 :
+            -std::numeric_limits<double>::infinity();
+        if (node.minAbsoluteMagnitude + distanceModulus > magnitudeLimit) {
+            continue;
+        }
+
+        if (node.nChildren == 0) {
+            // The stars in a leaf are sorted by brightness, so the visible ones are the
+            // prefix of stars whose absolute magnitude is below the threshold
+            const auto begin = hierarchy.absoluteMagnitudes.begin() + node.first;
+            const auto end = begin + node.count;
+            const double threshold = magnitudeLimit - distanceModulus;
+            const auto it = std::upper_bound(
+                begin,
+                end,
+                threshold,
+                [](double value, float magnitude) { return value < magnitude; }
+            );
+            const uint32_t count = static_cast<uint32_t>(std::distance(begin, it));
+            if (count == 0) {
+                continue;
+            }
+
+            const bool isAdjacent = !result.empty() &&
+                result.back().first + result.back().count == node.first;
+            if (isAdjacent) {
+                result.back().count += count;
+            }
+            else {
+                result.push_back({ .first = node.first, .count = count });
+            }
+        }
+        else {
+            // Push the children in reverse order so that the leaves are visited, and
+            // the ranges are created, in increasing order
+            for (uint32_t i = node.nChildren; i > 0; i--) {
+                stack[stackSize++] = node.firstChild + i - 1;
+            }
+        }
+    }
+}
+
+void saveCache(const Hierarchy& hierarchy, const std::filesystem::path& file) {
+    std::ofstream stream = std::ofstream(file, std::ofstream::binary);
+
+    stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+
+    const uint64_t nStars = hierarchy.order.size();
+    stream.write(reinterpret_cast<const char*>(&nStars), sizeof(uint64_t));
+    const uint64_t nNodes = hierarchy.nodes.size();
+    stream.write(reinterpret_cast<const char*>(&nNodes), sizeof(uint64_t));
+
+    stream.write(
+        reinterpret_cast<const char*>(hierarchy.nodes.data()),
+        nNodes * sizeof(Hierarchy::Node)
+    );
+    stream.write(
+        reinterpret_cast<const char*>(hierarchy.order.data()),
+        nStars * sizeof(uint32_t)
+    );
+    stream.write(
+        reinterpret_cast<const char*>(hierarchy.absoluteMagnitudes.data()),
+        nStars * sizeof(float)
+    );
+}
+
+std::optional<Hierarchy> loadCache(const std::filesystem::path& file, size_t nStars) {
+    std::ifstream stream = std::ifstream(file, std::ifstream::binary);
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    int8_t version = 0;
+    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        return std::nullopt;
+    }
+
+    uint64_t nCachedStars = 0;
+    stream.read(reinterpret_cast<char*>(&nCachedStars), sizeof(uint64_t));
+    uint64_t nNodes = 0;
+    stream.read(reinterpret_cast<char*>(&nNodes), sizeof(uint64_t));
+    const uint64_t maxNodes = (MaxDepth + 1) * nStars + 1;
+    if (!stream.good() || nCachedStars != nStars || nNodes > maxNodes) {
+        return std::nullopt;
+    }
+
+    Hierarchy hierarchy;
+    hierarchy.nodes.resize(nNodes);
+    stream.read(
+        reinterpret_cast<char*>(hierarchy.nodes.data()),
+        nNodes * sizeof(Hierarchy::Node)
+    );
+    hierarchy.order.resize(nStars);
+    stream.read(
+        reinterpret_cast<char*>(hierarchy.order.data()),
+        nStars * sizeof(uint32_t)
+    );
+    hierarchy.absoluteMagnitudes.resize(nStars);
+    stream.read(
+        reinterpret_cast<char*>(hierarchy.absoluteMagnitudes.data()),
+        nStars * sizeof(float)
+    );
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    // Make sure that a corrupted file cannot lead to out-of-bounds accesses or an
+    // overflow of the traversal stack in selectStars later. Children are always stored
+    // after their parent, so the depth of all nodes can be computed in a single pass
+    std::vector<int> depths = std::vector<int>(nNodes, 0);
+    for (uint64_t i = 0; i < nNodes; i++) {
+        const Hierarchy::Node& node = hierarchy.nodes[i];
+        const bool isValid =
+            node.nChildren <= 8 &&
+            (node.nChildren == 0 || node.firstChild > i) &&
+            node.firstChild + static_cast<uint64_t>(node.nChildren) <= nNodes &&
+            node.first + static_cast<uint64_t>(node.count) <= nStars &&
+            depths[i] <= MaxDepth;
+        if (!isValid) {
+            return std::nullopt;
+        }
+        for (uint32_t c = 0; c < node.nChildren; c++) {
+            depths[node.firstChild + c] = depths[i] + 1;
+        }
+    }
+    for (uint32_t index : hierarchy.order) {
+        if (index >= nStars) {
+            return std::nullopt;
+        }
+    }
+
+    return hierarchy;
+}
+
+} // namespace openspace::stars
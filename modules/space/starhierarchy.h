@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___STARHIERARCHY___H__
+#define __OPENSPACE_MODULE_SPACE___STARHIERARCHY___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace openspace::stars {
+
+/**
+ * A spatial octree over a list of stars that is used to only select the stars that are
+ * bright enough to be visible from the current camera position. All stars are stored in
+ * the leaves of the tree and the stars of each leaf are contiguous in #order, sorted
+ * from the brightest to the dimmest star. Every node stores a summary of the brightest
+ * star in its subtree, so that entire subtrees can be rejected at once.
+ */
+struct Hierarchy {
+    struct Node {
+        /// The tight bounding box of all stars in this subtree, in parsec
+        glm::vec3 boundsMin = glm::vec3(0.f);
+        glm::vec3 boundsMax = glm::vec3(0.f);
+
+        /// The smallest, and thus brightest, absolute magnitude in this subtree
+        float minAbsoluteMagnitude = 0.f;
+
+        /// The index of the first child in #nodes. All children are stored contiguously
+        uint32_t firstChild = 0;
+        /// The number of children, which is 0 for leaf nodes
+        uint32_t nChildren = 0;
+
+        /// The first index into #order of the stars in this leaf
+        uint32_t first = 0;
+        /// The number of stars in this leaf
+        uint32_t count = 0;
+    };
+
+    /// All nodes of the tree, the first of which is the root node
+    std::vector<Node> nodes;
+
+    /// The indices of the original stars in the order in which they are stored in the
+    /// leaves of the tree
+    std::vector<uint32_t> order;
+
+    /// The absolute magnitudes of the stars in the same order as #order
+    std::vector<float> absoluteMagnitudes;
+};
+
+/**
+ * A contiguous range of stars in the order of Hierarchy::order.
+ */
+struct Range {
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    bool operator==(const Range&) const = default;
+};
+
+/**
+ * Builds the Hierarchy for the stars with the provided \p positions and
+ * \p absoluteMagnitudes. Nodes are subdivided until they contain at most
+ * \p maxStarsPerNode stars.
+ *
+ * \param positions The positions of the stars in parsec
+ * \param absoluteMagnitudes The absolute magnitude for each of the stars
+ * \param maxStarsPerNode The maximum number of stars in a leaf node
+ * \return The hierarchy containing all stars
+ *
+ * \pre \p positions and \p absoluteMagnitudes must have the same size
+ */
+Hierarchy buildHierarchy(std::span<const glm::vec3> positions,
+    std::span<const float> absoluteMagnitudes, uint32_t maxStarsPerNode = 1024);
+
+/**
+ * Extracts the four side planes of the view frustum described by the provided
+ * \p viewProjection matrix. The planes are returned in the coordinate system in which
+ * the matrix expects its input positions and their normals point into the frustum. The
+ * near and far planes are not used as the far plane might be at infinity.
+ */
+std::array<glm::dvec4, 4> frustumPlanes(const glm::dmat4& viewProjection);
+
+/**
+ * Selects all stars from the \p hierarchy that are inside the frustum and whose apparent
+ * magnitude, as seen from the \p cameraPosition, is at most \p magnitudeLimit. The
+ * selection is conservative as the distance of each node to the camera is used for all
+ * of its stars, which means that some stars that are slightly too dim are included.
+ *
+ * \param hierarchy The hierarchy from which to select the stars
+ * \param cameraPosition The position of the camera in parsec
+ * \param planes The frustum planes as returned by #frustumPlanes
+ * \param magnitudeLimit The largest apparent magnitude that is still selected
+ * \param result Receives the ranges of selected stars, in increasing order
+ */
+void selectStars(const Hierarchy& hierarchy, const glm::dvec3& cameraPosition,
+    const std::array<glm::dvec4, 4>& planes, float magnitudeLimit,
+    std::vector<Range>& result);
+
+/**
+ * Stores the \p hierarchy in the provided binary \p file.
+ */
+void saveCache(const Hierarchy& hierarchy, const std::filesystem::path& file);
+
+/**
+ * Loads a hierarchy that was previously stored using #saveCache from the provided
+ * \p file. Returns `std::nullopt` if the file could not be read, was written by a
+ * different version, or does not contain exactly \p nStars stars.
+ */
+std::optional<Hierarchy> loadCache(const std::filesystem::path& file, size_t nStars);
+
+} // namespace openspace::stars
+
+#endif // __OPENSPACE_MODULE_SPACE___STARHIERARCHY___H__
@@ -27,13 +27,11 @@
 
 #include <openspace/util/task.h>
 
-
-#include <modules/space/rendering/renderableorbitalkepler.h>
-#include <modules/space/translation/keplertranslation.h>
-#include <openspace/util/time.h>
+#include <modules/space/kepler.h>
+#include <modules/volume/volumegridtype.h>
 #include <ghoul/glm.h>
+#include <filesystem>
 #include <string>
-#include <vector>
 
 namespace openspace::volume {
 
@@ -42,25 +40,21 @@ public:
     GenerateDebrisVolumeTask(const ghoul::Dictionary& dictionary);
     std::string description() override;
     void perform(const Task::ProgressCallback& progressCallback) override;
-    static documentation::Documentation documentation();
-
-    std::string _gridType;
+    static documentation::Documentation Documentation();
 
 private:
-    std::string _rawVolumeOutputPath;
-    std::string _dictionaryOutputPath;
+    std::filesystem::path _rawVolumeOutputPath;
+    std::filesystem::path _dictionaryOutputPath;
     std::string _startTime;
-    std::string _timeStep;
     std::string _endTime;
-    std::string _inputPath;
-
-    glm::uvec3 _dimensions;
-    glm::vec3 _lowerDomainBound;
-    glm::vec3 _upperDomainBound;
-
-    std::vector<KeplerParameters> _TLEDataVector;
-
-    float _maxApogee;
+    double _timeStep = 0.0;
+    std::filesystem::path _inputPath;
+    kepler::Format _format = kepler::Format::TLE;
+    VolumeGridType _gridType = VolumeGridType::Cartesian;
+
+    glm::uvec3 _dimensions = glm::uvec3(0);
+    glm::vec3 _lowerDomainBound = glm::vec3(0.f);
+    glm::vec3 _upperDomainBound = glm::vec3(0.f);
 };
 
 } // namespace openspace::volume
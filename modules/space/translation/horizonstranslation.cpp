@@ -31,6 +31,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
 #include <filesystem>
@@ -112,17 +113,43 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
 }
 
 glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
-    glm::dvec3 interpolatedPos = glm::dvec3(0.0);
+    return interpolatedPosition(data.time.j2000Seconds());
+}
+
+void HorizonsTranslation::positions(std::span<const double> times,
+                                    std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    // The timeline keeps track of the last queried keyframe, so a sweep over sorted
+    // times only has to step to the neighboring keyframe for each entry
+    for (size_t i = 0; i < times.size(); i++) {
+        result[i] = interpolatedPosition(times[i]);
+    }
+}
 
-    const Keyframe<glm::dvec3>* lastBefore =
-        _timeline.lastKeyframeBefore(data.time.j2000Seconds(), true);
-    const Keyframe<glm::dvec3>* firstAfter =
-        _timeline.firstKeyframeAfter(data.time.j2000Seconds(), false);
+glm::dvec3 HorizonsTranslation::interpolatedPosition(double time) const {
+    const std::vector<Keyframe<glm::dvec3>>& keyframes = _timeline.keyframes();
+    if (keyframes.empty()) {
+        return glm::dvec3(0.0);
+    }
+
+    // The keyframes are stored contiguously, so the last keyframe before (or at) the
+    // requested time is the one preceding the first keyframe after it
+    const Keyframe<glm::dvec3>* firstAfter = _timeline.firstKeyframeAfter(time, false);
+    const Keyframe<glm::dvec3>* lastBefore = nullptr;
+    if (!firstAfter) {
+        lastBefore = &keyframes.back();
+    }
+    else if (firstAfter != keyframes.data()) {
+        lastBefore = firstAfter - 1;
+    }
 
+    glm::dvec3 interpolatedPos = glm::dvec3(0.0);
     if (lastBefore && firstAfter) {
         // We're inbetween first and last value.
         const double timelineDiff = firstAfter->timestamp - lastBefore->timestamp;
-        const double timeDiff = data.time.j2000Seconds() - lastBefore->timestamp;
+        const double timeDiff = time - lastBefore->timestamp;
         const double diff = (timelineDiff > DBL_EPSILON) ? timeDiff / timelineDiff : 0.0;
 
         const glm::dvec3 dir = firstAfter->data - lastBefore->data;
@@ -187,21 +214,22 @@ bool HorizonsTranslation::readHorizonsTextFile(HorizonsFile& horizonsFile) {
         return false;
     }
 
+    std::vector<std::pair<double, glm::dvec3>> newKeyframes;
+    newKeyframes.reserve(result.data.size());
     for (HorizonsKeyframe& keyframe : result.data) {
-        // Search if the keyframe already exist in the timeline
-        auto it = std::find_if(
-            _timeline.keyframes().begin(),
-            _timeline.keyframes().end(),
-            [keyframe](const Keyframe<glm::dvec3>& kf) {
-                return kf.timestamp == keyframe.time;
-            }
-        );
+        // Search if the keyframe already exist in the timeline or the new keyframes
+        const Keyframe<glm::dvec3>* kf =
+            _timeline.firstKeyframeAfter(keyframe.time, true);
+        const bool isInTimeline = kf && kf->timestamp == keyframe.time;
+        const bool isInBatch =
+            !newKeyframes.empty() && newKeyframes.back().first == keyframe.time;
 
         // If it doesn't exist in the timeline then add it, prevent duplicates
-        if (it == _timeline.keyframes().end()) {
-            _timeline.addKeyframe(keyframe.time, std::move(keyframe.position));
+        if (!isInTimeline && !isInBatch) {
+            newKeyframes.emplace_back(keyframe.time, std::move(keyframe.position));
         }
     }
+    _timeline.addKeyframes(std::move(newKeyframes));
     return true;
 }
 
@@ -276,7 +304,7 @@ void HorizonsTranslation::saveCachedFile(const std::filesystem::path& file) cons
     fileStream.write(reinterpret_cast<const char*>(&nKeyframes), sizeof(int32_t));
 
     // Transfer all data to a cache key frame vector, write it all in one go
-    std::deque<Keyframe<glm::dvec3>> keyframes = _timeline.keyframes();
+    const std::vector<Keyframe<glm::dvec3>>& keyframes = _timeline.keyframes();
     std::vector<CacheKeyframe> cachKeyframes;
     cachKeyframes.reserve(nKeyframes);
     for (int i = 0; i < nKeyframes; i++) {
@@ -73,10 +73,14 @@ public:
     HorizonsTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    void positions(std::span<const double> times,
+        std::span<glm::dvec3> result) const override;
 
     static documentation::Documentation Documentation();
 
 private:
+    glm::dvec3 interpolatedPosition(double time) const;
+
     struct CacheKeyframe {
         double timestamp;
         std::array<double, 3> position;
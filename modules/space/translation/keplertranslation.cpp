@@ -28,6 +28,7 @@
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <glm/gtx/transform.hpp>
 
 namespace {
@@ -276,6 +277,31 @@ glm::dvec3 KeplerTranslation::position(const UpdateData& data) const {
     return _orbitPlaneRotation * p;
 }
 
+void KeplerTranslation::positions(std::span<const double> times,
+                                  std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    if (_orbitPlaneDirty) {
+        computeOrbitPlane();
+        _orbitPlaneDirty = false;
+    }
+
+    const double meanMotion = glm::two_pi<double>() / _period;
+    const double meanAnomalyAtEpoch = glm::radians(_meanAnomalyAtEpoch.value());
+    const double ecc = _eccentricity;
+    const double a = _semiMajorAxis * 1000.0;
+    const double b = a * sqrt(1.0 - ecc * ecc);
+    const double epoch = _epoch;
+    const glm::dmat3& rotation = _orbitPlaneRotation;
+
+    for (size_t i = 0; i < times.size(); i++) {
+        const double meanAnomaly = meanAnomalyAtEpoch + (times[i] - epoch) * meanMotion;
+        const double e = eccentricAnomaly(meanAnomaly);
+        result[i] = rotation * glm::dvec3(a * (cos(e) - ecc), b * sin(e), 0.0);
+    }
+}
+
 void KeplerTranslation::computeOrbitPlane() const {
     // We assume the following coordinate system:
     // z = axis of rotation
@@ -70,6 +70,16 @@ public:
     */
     glm::dvec3 position(const UpdateData& data) const override;
 
+    /**
+     * Computes the translation vectors for all \p times. The orbit plane and all
+     * time-independent terms are only computed once for the entire batch.
+     *
+     * \param times The times in seconds past the J2000 epoch
+     * \param result The output positions, one for each entry in \p times
+     */
+    void positions(std::span<const double> times,
+        std::span<glm::dvec3> result) const override;
+
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictionary
      * that can be passed to the constructor.
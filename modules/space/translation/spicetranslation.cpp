@@ -32,7 +32,9 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 #include <variant>
@@ -171,4 +173,30 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     ) * 1000.0;
 }
 
+void SpiceTranslation::positions(std::span<const double> times,
+                                 std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    if (_fixedEphemerisTime.has_value()) {
+        const glm::dvec3 p = position({ {}, Time(*_fixedEphemerisTime), Time(0.0) });
+        std::fill(result.begin(), result.end(), p);
+        return;
+    }
+
+    SpiceManager::ref().targetPositions(
+        _cachedTarget,
+        _cachedObserver,
+        _cachedFrame,
+        {},
+        times,
+        result
+    );
+
+    // Spice handles positions in KM, but we use meters in OpenSpace
+    for (glm::dvec3& p : result) {
+        p *= 1000.0;
+    }
+}
+
 } // namespace openspace
@@ -37,6 +37,8 @@ public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    void positions(std::span<const double> times,
+        std::span<glm::dvec3> result) const override;
 
     static documentation::Documentation Documentation();
 
@@ -25,12 +25,17 @@
 #ifndef __OPENSPACE_MODULE_VOLUME___LINEARLRUCACHE___H__
 #define __OPENSPACE_MODULE_VOLUME___LINEARLRUCACHE___H__
 
-#include <ghoul/glm.h>
-#include <list>
-#include <iterator>
+#include <cstddef>
+#include <limits>
+#include <vector>
 
 namespace openspace::volume {
 
+/**
+ * A least recently used cache for the keys [0, nIndices). The order in which the keys
+ * were used is tracked through an intrusive linked list in the storage for all keys, so
+ * no memory is allocated after construction.
+ */
 template <typename ValueType>
 class LinearLruCache {
 public:
@@ -44,12 +49,27 @@ public:
 
     void evict();
     size_t capacity() const;
+    size_t size() const;
 
 private:
-    void insert(size_t key, const ValueType& value);
+    static constexpr size_t NoKey = std::numeric_limits<size_t>::max();
 
-    std::list<size_t> _tracker;
-    std::vector<std::pair<ValueType, typename std::list<size_t>::iterator>> _cache;
+    struct Entry {
+        ValueType value = ValueType();
+        size_t previous = NoKey;
+        size_t next = NoKey;
+        bool isCached = false;
+    };
+
+    void insert(size_t key, ValueType value);
+    void unlink(size_t key);
+    void pushBack(size_t key);
+
+    std::vector<Entry> _entries;
+    // The least and the most recently used key
+    size_t _front = NoKey;
+    size_t _back = NoKey;
+    size_t _size = 0;
     size_t _capacity;
 };
 
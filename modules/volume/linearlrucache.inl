@@ -22,50 +22,59 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <ghoul/misc/assert.h>
+#include <utility>
+
 namespace openspace::volume {
 
 template <typename ValueType>
 LinearLruCache<ValueType>::LinearLruCache(size_t capacity, size_t nIndices)
-    : _tracker()
-    , _cache(nIndices, { nullptr, _tracker.end() })
+    : _entries(nIndices)
     , _capacity(capacity)
-{}
+{
+    ghoul_assert(_capacity > 0, "Capacity must be positive");
+}
 
 template <typename ValueType>
 bool LinearLruCache<ValueType>::has(size_t key) const {
-    return _cache[key].first != nullptr;
+    return _entries[key].isCached;
 }
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::set(size_t key, ValueType value) {
-    auto prev = _cache[key];
-    if (prev.first != nullptr) {
-        prev.first = value;
-        const std::list<size_t>::iterator trackerIter = prev.second;
-        _tracker.splice(_tracker.end(), _tracker, trackerIter);
+    Entry& entry = _entries[key];
+    if (entry.isCached) {
+        entry.value = std::move(value);
+        unlink(key);
+        pushBack(key);
     }
     else {
-        insert(key, value);
+        insert(key, std::move(value));
     }
 }
 
 template <typename ValueType>
 ValueType& LinearLruCache<ValueType>::use(size_t key) {
-    const auto& pair = _cache[key];
-    const std::list<size_t>::iterator trackerIter = pair.second;
-    _tracker.splice(_tracker.end(), _tracker, trackerIter);
-    return pair.first;
+    ghoul_assert(has(key), "Key must be cached");
+    unlink(key);
+    pushBack(key);
+    return _entries[key].value;
 }
 
 template <typename ValueType>
 ValueType& LinearLruCache<ValueType>::get(size_t key) {
-    return _cache[key].first;
+    return _entries[key].value;
 }
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::evict() {
-    _cache[_tracker.front()] = make_pair(nullptr, _tracker.end());
-    _tracker.pop_front();
+    ghoul_assert(_front != NoKey, "Cache must not be empty");
+    const size_t key = _front;
+    unlink(key);
+    Entry& entry = _entries[key];
+    entry.value = ValueType();
+    entry.isCached = false;
+    _size--;
 }
 
 template <typename ValueType>
@@ -74,12 +83,53 @@ size_t LinearLruCache<ValueType>::capacity() const {
 }
 
 template <typename ValueType>
-void LinearLruCache<ValueType>::insert(size_t key, const ValueType& value) {
-    if (_tracker.size() == _capacity) {
+size_t LinearLruCache<ValueType>::size() const {
+    return _size;
+}
+
+template <typename ValueType>
+void LinearLruCache<ValueType>::insert(size_t key, ValueType value) {
+    if (_size == _capacity) {
         evict();
     }
-    auto iter = _tracker.insert(_tracker.end(), key);
-    _cache[key] = { value, iter };
+    Entry& entry = _entries[key];
+    entry.value = std::move(value);
+    entry.isCached = true;
+    pushBack(key);
+    _size++;
+}
+
+template <typename ValueType>
+void LinearLruCache<ValueType>::unlink(size_t key) {
+    Entry& entry = _entries[key];
+    if (entry.previous != NoKey) {
+        _entries[entry.previous].next = entry.next;
+    }
+    else {
+        _front = entry.next;
+    }
+    if (entry.next != NoKey) {
+        _entries[entry.next].previous = entry.previous;
+    }
+    else {
+        _back = entry.previous;
+    }
+    entry.previous = NoKey;
+    entry.next = NoKey;
+}
+
+template <typename ValueType>
+void LinearLruCache<ValueType>::pushBack(size_t key) {
+    Entry& entry = _entries[key];
+    entry.previous = _back;
+    entry.next = NoKey;
+    if (_back != NoKey) {
+        _entries[_back].next = key;
+    }
+    else {
+        _front = key;
+    }
+    _back = key;
 }
 
 } // namespace openspace::volume
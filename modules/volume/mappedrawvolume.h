@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+#define __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <filesystem>
+
+namespace openspace::volume {
+
+/**
+ * A read-only view of a `.rawvolume` file that is mapped into memory. In contrast to a
+ * RawVolume, the voxels are not copied into memory up front but paged in by the
+ * operating system as they are accessed, so this can be used for volumes that are
+ * larger than the available RAM.
+ */
+template <typename Type>
+class MappedRawVolume {
+public:
+    using VoxelType = Type;
+
+    /**
+     * Maps the volume at \\p path, which has to contain at least the number of voxels
+     * specified by \\p dimensions.
+     *
+     * \\throw ghoul::RuntimeError If the file could not be mapped or is too small
+     */
+    MappedRawVolume(const std::filesystem::path& path, const glm::uvec3& dimensions);
+
+    glm::uvec3 dimensions() const;
+    size_t nCells() const;
+    VoxelType get(const glm::uvec3& coordinates) const;
+    VoxelType get(size_t index) const;
+    const VoxelType* data() const;
+    size_t coordsToIndex(const glm::uvec3& cartesian) const;
+    glm::uvec3 indexToCoords(size_t linear) const;
+
+    /// Hints that the voxels with z coordinate in [\\p zBegin, \\p zEnd) are needed soon
+    void prefetchSlices(unsigned int zBegin, unsigned int zEnd) const;
+
+private:
+    glm::uvec3 _dimensions = glm::uvec3(0);
+    MemoryMappedFile _file;
+};
+
+} // namespace openspace::volume
+
+#include "mappedrawvolume.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
@@ -0,0 +1,90 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/volumeutils.h>
+#include <ghoul/format.h>
+#include <ghoul/misc/exception.h>
+
+namespace openspace::volume {
+
+template <typename VoxelType>
+MappedRawVolume<VoxelType>::MappedRawVolume(const std::filesystem::path& path,
+                                             const glm::uvec3& dimensions)
+    : _dimensions(dimensions)
+    , _file(path)
+{
+    if (_file.size() < nCells() * sizeof(VoxelType)) {
+        throw ghoul::RuntimeError(std::format(
+            "Volume file '{}' is too small for dimensions ({}, {}, {})",
+            path, dimensions.x, dimensions.y, dimensions.z
+        ));
+    }
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::dimensions() const {
+    return _dimensions;
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::nCells() const {
+    return static_cast<size_t>(_dimensions.x) * static_cast<size_t>(_dimensions.y) *
+        static_cast<size_t>(_dimensions.z);
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(const glm::uvec3& coordinates) const {
+    return get(coordsToIndex(coordinates));
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(size_t index) const {
+    return data()[index];
+}
+
+template <typename VoxelType>
+const VoxelType* MappedRawVolume<VoxelType>::data() const {
+    return reinterpret_cast<const VoxelType*>(_file.data());
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
+    return volume::coordsToIndex(cartesian, _dimensions);
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::indexToCoords(size_t linear) const {
+    return volume::indexToCoords(linear, _dimensions);
+}
+
+template <typename VoxelType>
+void MappedRawVolume<VoxelType>::prefetchSlices(unsigned int zBegin,
+                                                unsigned int zEnd) const
+{
+    const size_t sliceSize =
+        static_cast<size_t>(_dimensions.x) * _dimensions.y * sizeof(VoxelType);
+    _file.prefetch(zBegin * sliceSize, (zEnd - zBegin) * sliceSize);
+}
+
+} // namespace openspace::volume
@@ -27,10 +27,13 @@
 
 #include <ghoul/glm.h>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace openspace::volume {
 
+template <typename T> class MappedRawVolume;
 template <typename T> class RawVolume;
 
 template <typename Type>
@@ -39,20 +42,72 @@ public:
     using VoxelType = Type;
 
     RawVolumeReader(const std::filesystem::path& path, const glm::uvec3& dimensions);
+    ~RawVolumeReader() = default;
 
     glm::uvec3 dimensions() const;
     std::filesystem::path path() const;
     void setPath(std::filesystem::path path);
     void setDimensions(const glm::uvec3& dimensions);
-    //VoxelType get(const glm::ivec3& coordinates) const; // TODO: Implement this
-    //VoxelType get(const size_t index) const; // TODO: Implement this
+
+    /**
+     * Returns the voxel at the provided \p coordinates or linear \p index without
+     * reading the rest of the file. This function can be called from multiple threads at
+     * the same time.
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped or is too small
+     */
+    VoxelType get(const glm::uvec3& coordinates) const;
+    VoxelType get(size_t index) const;
+
+    /**
+     * Reads the entire volume into memory. If \p invertZ is `true`, the order of the
+     * slices along the z-axis is reversed.
+     *
+     * \throw ghoul::FileNotFoundError If the file does not exist
+     * \throw ghoul::RuntimeError If the file is too small
+     */
     std::unique_ptr<RawVolume<VoxelType>> read(bool invertZ = false);
 
+    /**
+     * Reads the box of voxels that starts at \p offset and has the provided \p size.
+     * Only every \p stride:th voxel along each axis is read, so the returned volume has
+     * the dimensions `ceil(size / stride)`. Only the parts of the file that are covered
+     * by the box are read from disk.
+     *
+     * \throw ghoul::RuntimeError If the box is outside the volume, the stride is 0, or
+     *        the file could not be mapped
+     */
+    std::unique_ptr<RawVolume<VoxelType>> readBox(const glm::uvec3& offset,
+        const glm::uvec3& size, const glm::uvec3& stride = glm::uvec3(1)) const;
+
+    /// Reads the slice with the z coordinate \p z as a volume with depth 1
+    std::unique_ptr<RawVolume<VoxelType>> readSlice(unsigned int z) const;
+
+    /// Reads every \p stride:th voxel along each axis of the entire volume
+    std::unique_ptr<RawVolume<VoxelType>> readDownsampled(const glm::uvec3& stride) const;
+
+    /**
+     * Maps the volume into memory without reading it. The returned volume stays valid
+     * after the reader is destroyed.
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped or is too small
+     */
+    std::unique_ptr<MappedRawVolume<VoxelType>> map() const;
+
 private:
+    const MappedRawVolume<VoxelType>& mappedVolume() const;
+
     size_t coordsToIndex(const glm::uvec3& cartesian) const;
     glm::uvec3 indexToCoords(size_t linear) const;
     glm::uvec3 _dimensions;
     std::filesystem::path _path;
+    // Created on the first random access into the file, which might happen on multiple
+    // threads at the same time. Replaced as a whole when the path or dimensions change
+    struct LazyMapping {
+        std::once_flag isMapped;
+        std::unique_ptr<MappedRawVolume<VoxelType>> volume;
+    };
+    std::unique_ptr<LazyMapping> _mapping = std::make_unique<LazyMapping>();
 };
 
 } // namespace openspace::volume
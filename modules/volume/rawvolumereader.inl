@@ -22,8 +22,13 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <modules/volume/mappedrawvolume.h>
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumeutils.h>
+#include <ghoul/format.h>
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/profiling.h>
+#include <cstring>
 #include <fstream>
 
 namespace openspace::volume {
@@ -43,6 +48,7 @@ glm::uvec3 RawVolumeReader<VoxelType>::dimensions() const {
 template <typename VoxelType>
 void RawVolumeReader<VoxelType>::setDimensions(const glm::uvec3& dimensions) {
     _dimensions = dimensions;
+    _mapping = std::make_unique<LazyMapping>();
 }
 
 template <typename VoxelType>
@@ -53,29 +59,39 @@ std::filesystem::path RawVolumeReader<VoxelType>::path() const {
 template <typename VoxelType>
 void RawVolumeReader<VoxelType>::setPath(std::filesystem::path path) {
     _path = std::move(path);
+    _mapping = std::make_unique<LazyMapping>();
 }
 
-/*
-TODO: Implement these methods for random access in raw volume file
 template <typename VoxelType>
-VoxelType RawVolumeReader<VoxelType>::get(const glm::ivec3& coordinates) const {
-    return get(coordsToIndex(coordinates, dimensions()));
+VoxelType RawVolumeReader<VoxelType>::get(const glm::uvec3& coordinates) const {
+    return get(coordsToIndex(coordinates));
 }
 
 template <typename VoxelType>
 VoxelType RawVolumeReader<VoxelType>::get(size_t index) const {
-    // TODO: read from specific position.
-    return VoxelType();
-}*/
+    return mappedVolume().get(index);
+}
 
 template <typename VoxelType>
 size_t RawVolumeReader<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
-    return coordsToIndex(cartesian, dimensions());
+    return volume::coordsToIndex(cartesian, dimensions());
 }
 
 template <typename VoxelType>
 glm::uvec3 RawVolumeReader<VoxelType>::indexToCoords(size_t linear) const {
-    return indexToCoords(linear, dimensions());
+    return volume::indexToCoords(linear, dimensions());
+}
+
+template <typename VoxelType>
+const MappedRawVolume<VoxelType>& RawVolumeReader<VoxelType>::mappedVolume() const {
+    // If the mapping fails, the exception is passed on and the next call tries again
+    std::call_once(_mapping->isMapped, [this]() { _mapping->volume = map(); });
+    return *_mapping->volume;
+}
+
+template <typename VoxelType>
+std::unique_ptr<MappedRawVolume<VoxelType>> RawVolumeReader<VoxelType>::map() const {
+    return std::make_unique<MappedRawVolume<VoxelType>>(_path, _dimensions);
 }
 
 template <typename VoxelType>
@@ -91,36 +107,94 @@ std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::read(bool inve
     auto volume = std::make_unique<RawVolume<VoxelType>>(dims);
 
     char* buffer = reinterpret_cast<char*>(volume->data());
-    size_t length = glm::compMul(dims) * sizeof(VoxelType);
     {
         ZoneScopedN("read");
-        file.read(buffer, length);
+        if (invertZ) {
+            // Reading the slices into their mirrored position directly avoids having to
+            // reorder the voxels in a second volume afterwards
+            const size_t sliceLength =
+                static_cast<size_t>(dims.x) * dims.y * sizeof(VoxelType);
+            for (unsigned int z = 0; z < dims.z; z++) {
+                file.read(buffer + (dims.z - z - 1) * sliceLength, sliceLength);
+            }
+        }
+        else {
+            file.read(buffer, volume->nCells() * sizeof(VoxelType));
+        }
     }
 
     if (file.fail()) {
         throw ghoul::RuntimeError("Error reading volume file");
     }
+    return volume;
+}
 
-    if (invertZ) {
-        std::unique_ptr<RawVolume<VoxelType>> newVolume =
-            std::make_unique<RawVolume<VoxelType>>(dims);
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::readBox(
+                                                              const glm::uvec3& offset,
+                                                                const glm::uvec3& size,
+                                                        const glm::uvec3& stride) const
+{
+    ZoneScoped;
 
-        for (size_t i = 0; i < volume->nCells(); i++) {
-            const glm::uvec3& coords = volume->indexToCoords(i);
-            glm::uvec3 newcoords = glm::uvec3(coords.x, coords.y, dims.z - coords.z - 1);
+    const glm::uvec3 end = offset + size;
+    if (glm::any(glm::greaterThan(end, _dimensions)) ||
+        glm::any(glm::lessThan(end, offset)))
+    {
+        throw ghoul::RuntimeError(std::format(
+            "Box ({}, {}, {}) + ({}, {}, {}) is outside of volume '{}'",
+            offset.x, offset.y, offset.z, size.x, size.y, size.z, _path
+        ));
+    }
+    if (glm::any(glm::equal(stride, glm::uvec3(0)))) {
+        throw ghoul::RuntimeError("Stride must be at least 1 along every axis");
+    }
 
-            // @TODO (emmbr, 2022-02-10) Not sure why they are here, but commented them
-            // out for now as they aren't used
-            //size_t newIndex = volume->coordsToIndex(newcoords);
-            //size_t oldIndex = volume->coordsToIndex(coords);
+    const MappedRawVolume<VoxelType>& mapped = mappedVolume();
+    const glm::uvec3 dims = (size + stride - glm::uvec3(1)) / stride;
+    auto volume = std::make_unique<RawVolume<VoxelType>>(dims);
+    if (volume->nCells() == 0) {
+        return volume;
+    }
 
-            newVolume->set(newcoords, volume->get(coords));
+    // Only the slices covered by the box are paged in
+    mapped.prefetchSlices(offset.z, end.z);
+
+    const VoxelType* source = mapped.data();
+    VoxelType* destination = volume->data();
+    for (unsigned int z = 0; z < dims.z; z++) {
+        for (unsigned int y = 0; y < dims.y; y++) {
+            const glm::uvec3 rowStart = offset + glm::uvec3(0, y, z) * stride;
+            const VoxelType* row = source + mapped.coordsToIndex(rowStart);
+            if (stride.x == 1) {
+                std::memcpy(destination, row, dims.x * sizeof(VoxelType));
+            }
+            else {
+                for (unsigned int x = 0; x < dims.x; x++) {
+                    destination[x] = row[static_cast<size_t>(x) * stride.x];
+                }
+            }
+            destination += dims.x;
         }
-        return newVolume;
-    }
-    else {
-        return volume;
     }
+    return volume;
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::readSlice(
+                                                                   unsigned int z) const
+{
+    return readBox(
+        glm::uvec3(0, 0, z),
+        glm::uvec3(_dimensions.x, _dimensions.y, 1)
+    );
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::readDownsampled(
+                                                          const glm::uvec3& stride) const
+{
+    return readBox(glm::uvec3(0), _dimensions, stride);
 }
 
 } // namespace openspace::volume
@@ -25,8 +25,11 @@
 #ifndef __OPENSPACE_MODULE_VOLUME___RAWVOLUMEWRITER___H__
 #define __OPENSPACE_MODULE_VOLUME___RAWVOLUMEWRITER___H__
 
+#include <ghoul/glm.h>
 #include <filesystem>
+#include <fstream>
 #include <functional>
+#include <span>
 #include <string>
 
 namespace openspace::volume {
@@ -45,6 +48,31 @@ public:
                const std::function<void(float)>& onProgress = [](float) {});
     void write(const RawVolume<VoxelType>& volume);
 
+    /**
+     * Starts writing a volume with the provided \p dimensions piece by piece, which
+     * does not require the entire volume to be in memory at once. The voxels are then
+     * passed in file order to #append and the file is completed with #finish.
+     *
+     * \throw ghoul::RuntimeError If the file could not be created
+     */
+    void begin(glm::uvec3 dimensions);
+
+    /**
+     * Writes the next \p voxels of the volume that was started with #begin.
+     *
+     * \throw ghoul::RuntimeError If the voxels exceed the dimensions of the volume or
+     *        could not be written
+     */
+    void append(std::span<const VoxelType> voxels);
+
+    /**
+     * Completes the volume that was started with #begin and closes the file.
+     *
+     * \throw ghoul::RuntimeError If fewer voxels than the volume contains were written
+     *        or the file could not be written
+     */
+    void finish();
+
     size_t coordsToIndex(const glm::uvec3& coords) const;
     glm::ivec3 indexToCoords(size_t linear) const;
 
@@ -52,6 +80,9 @@ private:
     glm::ivec3 _dimensions = glm::ivec3(0);
     std::filesystem::path _path;
     size_t _bufferSize = 0;
+
+    std::ofstream _stream;
+    size_t _nWrittenVoxels = 0;
 };
 
 } // namespace openspace::volume
@@ -27,6 +27,7 @@
 #include <ghoul/format.h>
 #include <ghoul/misc/exception.h>
 #include <fstream>
+#include <vector>
 
 namespace openspace::volume {
 
@@ -107,4 +108,54 @@ void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     file.close();
 }
 
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::begin(glm::uvec3 dimensions) {
+    setDimensions(std::move(dimensions));
+    _nWrittenVoxels = 0;
+
+    _stream = std::ofstream(_path, std::ios::binary);
+    if (!_stream.good()) {
+        throw ghoul::RuntimeError(std::format("Could not create file '{}'", _path));
+    }
+}
+
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::append(std::span<const VoxelType> voxels) {
+    const glm::uvec3 dims = dimensions();
+    const size_t nVoxels = static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) *
+        static_cast<size_t>(dims.z);
+    if (voxels.size() > nVoxels - _nWrittenVoxels) {
+        throw ghoul::RuntimeError(std::format(
+            "Writing {} voxels exceeds the size of volume '{}'", voxels.size(), _path
+        ));
+    }
+
+    _stream.write(
+        reinterpret_cast<const char*>(voxels.data()),
+        voxels.size() * sizeof(VoxelType)
+    );
+    if (!_stream.good()) {
+        throw ghoul::RuntimeError(std::format("Error writing file '{}'", _path));
+    }
+    _nWrittenVoxels += voxels.size();
+}
+
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::finish() {
+    const glm::uvec3 dims = dimensions();
+    const size_t nVoxels = static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) *
+        static_cast<size_t>(dims.z);
+
+    _stream.close();
+    if (_stream.fail()) {
+        throw ghoul::RuntimeError(std::format("Error writing file '{}'", _path));
+    }
+    if (_nWrittenVoxels != nVoxels) {
+        throw ghoul::RuntimeError(std::format(
+            "Volume '{}' is incomplete. Expected {} voxels but got {}",
+            _path, nVoxels, _nWrittenVoxels
+        ));
+    }
+}
+
 } // namespace openspace::volume
@@ -44,6 +44,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 
@@ -157,6 +158,16 @@ namespace {
 
         // @TODO Missing documentation
         std::optional<ghoul::Dictionary> clipPlanes;
+
+        // The number of timesteps that are read ahead of the current timestep in the
+        // direction of playback. 2 is default
+        std::optional<int> numberOfPrefetchedTimesteps [[codegen::greaterequal(0)]];
+
+        // The amount of volume textures, in megabytes, that is kept on the GPU. The
+        // timesteps that have been used least recently are unloaded when the budget is
+        // exceeded, but the current and prefetched timesteps are always kept. The data
+        // is only kept in RAM until it has been uploaded. 1024 is default
+        std::optional<float> memoryBudget [[codegen::greater(0.0)]];
     };
 #include "renderabletimevaryingvolume_codegen.cpp"
 } // namespace
@@ -193,6 +204,10 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     );
 
     _invertDataAtZ = p.invertDataAtZ.value_or(_invertDataAtZ);
+    _nPrefetchedTimesteps = p.numberOfPrefetchedTimesteps.value_or(
+        _nPrefetchedTimesteps
+    );
+    _memoryBudget = static_cast<size_t>(p.memoryBudget.value_or(1024.f) * 1024 * 1024);
 
     _gridType.addOptions({
         { static_cast<int>(volume::VolumeGridType::Cartesian), "Cartesian" },
@@ -237,44 +252,7 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        const std::string path = std::format(
-            "{}/{}.rawvolume", _sourceDirectory.value(), t.baseName
-        );
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read(_invertDataAtZ);
-
-        const float min = t.metadata.minValue;
-        const float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
-            t.histogram->add(data[i]);
-        }
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            GL_TEXTURE_3D,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
-    }
+    // The volumes are read on demand when their timestep is getting close
 
     _clipPlanes->initialize();
 
@@ -353,6 +331,169 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::filesystem::pa
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
 
+// Runs on a worker thread
+void RenderableTimeVaryingVolume::readTimestep(Timestep& t,
+                                               const std::filesystem::path& path) const
+{
+    RawVolumeReader<float> reader(path, t.metadata.dimensions);
+    t.rawVolume = reader.read(_invertDataAtZ);
+
+    const float min = t.metadata.minValue;
+    const float diff = t.metadata.maxValue - t.metadata.minValue;
+    float* data = t.rawVolume->data();
+    for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
+        data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+    }
+
+    t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
+    for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
+        t.histogram->add(data[i]);
+    }
+    // TODO: handle normalization properly for different timesteps + transfer function
+}
+
+void RenderableTimeVaryingVolume::requestTimestep(Timestep& t) {
+    if (t.inRam || t.onGpu || t.hasFailed || t.loading.valid()) {
+        return;
+    }
+
+    std::filesystem::path path = std::format(
+        "{}/{}.rawvolume", _sourceDirectory.value(), t.baseName
+    );
+    t.loading = std::async(
+        std::launch::async,
+        [this, &t, p = std::move(path)]() { readTimestep(t, p); }
+    );
+    _loadingTimesteps.push_back(&t);
+}
+
+// Returns true if the timestep has finished loading, or if it was not loading at all
+bool RenderableTimeVaryingVolume::finishLoading(Timestep& t) {
+    if (!t.loading.valid()) {
+        return true;
+    }
+    if (t.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+
+    try {
+        t.loading.get();
+        t.inRam = true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        t.rawVolume = nullptr;
+        t.hasFailed = true;
+    }
+    std::erase(_loadingTimesteps, &t);
+    return true;
+}
+
+void RenderableTimeVaryingVolume::uploadTimestep(Timestep& t) {
+    t.texture = std::make_shared<ghoul::opengl::Texture>(
+        t.metadata.dimensions,
+        GL_TEXTURE_3D,
+        ghoul::opengl::Texture::Format::Red,
+        GL_RED,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp
+    );
+
+    t.texture->setPixelData(
+        reinterpret_cast<void*>(t.rawVolume->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->uploadTexture();
+
+    // The texture lives on the GPU from here on, so the RAM copy is no longer needed
+    t.texture->purgeFromRAM();
+    t.rawVolume = nullptr;
+    t.inRam = false;
+    t.onGpu = true;
+    _residentTimesteps.push_back(&t);
+}
+
+void RenderableTimeVaryingVolume::updateResidentTimesteps(const Timestep& current,
+                                                          int direction)
+{
+    // The current timestep first, then the ones ahead of it in the direction of playback
+    // and finally the one behind it
+    using Iterator = std::map<double, Timestep>::iterator;
+    auto neighbor = [this](Iterator i, int dir) {
+        if (dir > 0) {
+            return std::next(i);
+        }
+        return i == _volumeTimesteps.begin() ? _volumeTimesteps.end() : std::prev(i);
+    };
+
+    std::vector<Timestep*> window;
+    const Iterator it = _volumeTimesteps.find(current.metadata.time);
+    window.push_back(&it->second);
+    Iterator ahead = neighbor(it, direction);
+    for (int i = 0; i < _nPrefetchedTimesteps && ahead != _volumeTimesteps.end(); i++) {
+        window.push_back(&ahead->second);
+        ahead = neighbor(ahead, direction);
+    }
+    const Iterator behind = neighbor(it, -direction);
+    if (behind != _volumeTimesteps.end()) {
+        window.push_back(&behind->second);
+    }
+    auto isInWindow = [&window](const Timestep* t) {
+        return std::find(window.begin(), window.end(), t) != window.end();
+    };
+    auto textureSize = [](const Timestep* t) {
+        return static_cast<size_t>(t->metadata.dimensions.x) *
+            t->metadata.dimensions.y * t->metadata.dimensions.z * sizeof(float);
+    };
+
+    // Volumes that were requested earlier but are no longer needed are dropped as soon as
+    // they are done, so that only the timesteps around the current one occupy RAM
+    std::vector<Timestep*> loading = _loadingTimesteps;
+    for (Timestep* t : loading) {
+        if (finishLoading(*t) && !isInWindow(t)) {
+            t->rawVolume = nullptr;
+            t->inRam = false;
+        }
+    }
+
+    // Uploading is the only step that has to happen on this thread. The current timestep
+    // is first in the window, so it is uploaded as soon as it is ready, but the other
+    // timesteps are limited to one per frame to avoid stalling
+    bool hasUploaded = false;
+    for (Timestep* t : window) {
+        if (t->inRam && !hasUploaded) {
+            uploadTimestep(*t);
+            hasUploaded = true;
+        }
+        else {
+            requestTimestep(*t);
+        }
+
+        if (t->onGpu) {
+            std::erase(_residentTimesteps, t);
+            _residentTimesteps.push_back(t);
+        }
+    }
+
+    size_t textureMemory = 0;
+    for (const Timestep* t : _residentTimesteps) {
+        textureMemory += textureSize(t);
+    }
+    auto evict = _residentTimesteps.begin();
+    while (textureMemory > _memoryBudget && evict != _residentTimesteps.end()) {
+        Timestep* t = *evict;
+        if (isInWindow(t) || t == _displayedTimestep) {
+            evict++;
+            continue;
+        }
+        textureMemory -= textureSize(t);
+        t->texture = nullptr;
+        t->onGpu = false;
+        evict = _residentTimesteps.erase(evict);
+    }
+}
+
 RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimestep() {
     if (_volumeTimesteps.empty()) {
         return nullptr;
@@ -422,11 +563,23 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     }
 }
 
-void RenderableTimeVaryingVolume::update(const UpdateData&) {
+void RenderableTimeVaryingVolume::update(const UpdateData& data) {
     _transferFunction->update();
 
     if (_raycaster) {
-        Timestep* t = currentTimestep();
+        Timestep* current = currentTimestep();
+        if (current) {
+            const double dt =
+                data.time.j2000Seconds() - data.previousFrameTime.j2000Seconds();
+            updateResidentTimesteps(*current, dt < 0.0 ? -1 : 1);
+            if (current->onGpu) {
+                _displayedTimestep = current;
+            }
+        }
+        else {
+            _displayedTimestep = nullptr;
+        }
+        Timestep* t = _displayedTimestep;
 
         // Set scale and translation matrices:
         // The original data cube is a unit cube centered in 0
@@ -480,6 +633,19 @@ void RenderableTimeVaryingVolume::deinitializeGL() {
         global::raycasterManager->detachRaycaster(*_raycaster);
         _raycaster = nullptr;
     }
+
+    // The worker threads write into the timesteps, so they have to finish first
+    for (Timestep* t : _loadingTimesteps) {
+        t->loading.wait();
+    }
+    _loadingTimesteps.clear();
+
+    for (Timestep* t : _residentTimesteps) {
+        t->texture = nullptr;
+        t->onGpu = false;
+    }
+    _residentTimesteps.clear();
+    _displayedTimestep = nullptr;
 }
 
 } // namespace openspace::volume
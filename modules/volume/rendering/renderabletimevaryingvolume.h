@@ -34,6 +34,8 @@
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
 #include <openspace/rendering/transferfunction.h>
+#include <deque>
+#include <future>
 
 namespace openspace {
     class Histogram;
@@ -62,14 +64,27 @@ public:
 private:
     struct Timestep {
         std::filesystem::path baseName;
-        bool inRam;
-        bool onGpu;
+        // True if the normalized volume is in rawVolume, waiting to be uploaded
+        bool inRam = false;
+        // True if the volume has been uploaded to texture
+        bool onGpu = false;
+        // True if reading the volume failed, in which case it is not attempted again
+        bool hasFailed = false;
         RawVolumeMetadata metadata;
         std::shared_ptr<RawVolume<float>> rawVolume;
         std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<Histogram> histogram;
+        // Valid while the volume is being read on a worker thread. The worker thread is
+        // the only one that touches rawVolume and histogram until it has finished
+        std::future<void> loading;
     };
 
+    void readTimestep(Timestep& t, const std::filesystem::path& path) const;
+    void requestTimestep(Timestep& t);
+    bool finishLoading(Timestep& t);
+    void uploadTimestep(Timestep& t);
+    void updateResidentTimesteps(const Timestep& current, int direction);
+
     Timestep* currentTimestep();
     int timestepIndex(const Timestep* t) const;
     Timestep* timestepFromIndex(int target);
@@ -93,6 +108,18 @@ private:
     properties::IntProperty _jumpToTimestep;
 
     std::map<double, Timestep> _volumeTimesteps;
+    // The timesteps that are currently being read on worker threads
+    std::vector<Timestep*> _loadingTimesteps;
+    // The timesteps that have a texture, with the most recently used one at the back
+    std::deque<Timestep*> _residentTimesteps;
+    // The timestep whose texture is passed to the raycaster. This is the previous
+    // timestep until the current one has finished loading
+    Timestep* _displayedTimestep = nullptr;
+    // Number of timesteps that are loaded ahead of the current one in the direction of
+    // playback
+    int _nPrefetchedTimesteps = 2;
+    // Number of bytes of textures that are kept on the GPU
+    size_t _memoryBudget = 0;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
     bool _invertDataAtZ;
 
@@ -24,9 +24,9 @@
 
 #include <modules/volume/tasks/generaterawvolumetask.h>
 
-#include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumemetadata.h>
 #include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/voxelevaluation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/time.h>
 #include <openspace/util/spicemanager.h>
@@ -38,10 +38,17 @@
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
 #include <ghoul/misc/defer.h>
+#include <ghoul/misc/exception.h>
 #include <filesystem>
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace {
+    constexpr std::string_view _loggerCat = "GenerateRawVolumeTask";
+
     struct [[codegen::Dictionary(GenerateRawVolumeTask)]] Parameters {
         // The Lua function used to compute the cell values
         std::string valueFunction [[codegen::annotation("A Lua expression that returns a "
@@ -67,6 +74,16 @@ namespace {
         glm::dvec3 upperDomainBound;
     };
 #include "generaterawvolumetask_codegen.cpp"
+
+    // Lua states cannot be shared between threads, so every thread evaluating the value
+    // function gets its own copy of it. The value range only covers the cells for which
+    // the function could be evaluated
+    struct ValueFunction {
+        ghoul::lua::LuaState state;
+        int reference = LUA_NOREF;
+        float minValue = std::numeric_limits<float>::max();
+        float maxValue = std::numeric_limits<float>::lowest();
+    };
 } // namespace
 
 namespace openspace::volume {
@@ -111,36 +128,43 @@ void GenerateRawVolumeTask::perform(const Task::ProgressCallback& progressCallba
         SpiceManager::ref().unloadKernel(kernel);
     };
 
-    volume::RawVolume<float> rawVolume(_dimensions);
-    progressCallback(0.1f);
-
-    ghoul::lua::LuaState state;
-    ghoul::lua::runScript(state, _valueFunctionLua);
+    const std::filesystem::path directory = _rawVolumeOutputPath.parent_path();
+    if (!std::filesystem::is_directory(directory)) {
+        std::filesystem::create_directories(directory);
+    }
 
-#if (defined(NDEBUG) || defined(DEBUG))
-    ghoul::lua::verifyStackSize(state, 1);
-#endif
+    RawVolumeWriter<float> writer = RawVolumeWriter<float>(_rawVolumeOutputPath);
+    writer.begin(_dimensions);
+    progressCallback(0.1f);
 
-    int functionReference = luaL_ref(state, LUA_REGISTRYINDEX);
+    // The functions are owned here rather than by evaluateVoxels so that their value
+    // ranges can be combined once all cells have been evaluated
+    using Function = ValueFunction*;
+    std::vector<std::unique_ptr<ValueFunction>> functions;
+    auto createFunction = [this, &functions]() {
+        Function function = functions.emplace_back(
+            std::make_unique<ValueFunction>()
+        ).get();
+        ghoul::lua::runScript(function->state, _valueFunctionLua);
 
 #if (defined(NDEBUG) || defined(DEBUG))
-    ghoul::lua::verifyStackSize(state, 0);
+        ghoul::lua::verifyStackSize(function->state, 1);
 #endif
 
-    glm::vec3 domainSize = _upperDomainBound - _lowerDomainBound;
-
-
-    float minVal = std::numeric_limits<float>::max();
-    float maxVal = std::numeric_limits<float>::min();
+        function->reference = luaL_ref(function->state, LUA_REGISTRYINDEX);
+        return function;
+    };
 
-    rawVolume.forEachVoxel([&](const glm::uvec3& cell, float) {
+    const glm::vec3 domainSize = _upperDomainBound - _lowerDomainBound;
+    auto evaluate = [this, domainSize](Function& function, const glm::uvec3& cell) {
         const glm::vec3 coord = _lowerDomainBound +
             glm::vec3(cell) / glm::vec3(_dimensions) * domainSize;
 
+        lua_State* state = function->state;
 #if (defined(NDEBUG) || defined(DEBUG))
         ghoul::lua::verifyStackSize(state, 0);
 #endif
-        lua_rawgeti(state, LUA_REGISTRYINDEX, functionReference);
+        lua_rawgeti(state, LUA_REGISTRYINDEX, function->reference);
 
         lua_pushnumber(state, coord.x);
         lua_pushnumber(state, coord.y);
@@ -150,29 +174,40 @@ void GenerateRawVolumeTask::perform(const Task::ProgressCallback& progressCallba
         ghoul::lua::verifyStackSize(state, 4);
 #endif
 
-        if (lua_pcall(state, 3, 1, 0) != LUA_OK) {
-            return;
+        if (lua_pcall(state, 3, 1, 0) != LUA_OK || !lua_isnumber(state, -1)) {
+            // Remove the error message or invalid result; the cell keeps the value 0 and
+            // does not count towards the value range
+            lua_pop(state, 1);
+            return 0.f;
         }
 
-        const float value = static_cast<float>(luaL_checknumber(state, 1));
+        const float value = static_cast<float>(lua_tonumber(state, -1));
         lua_pop(state, 1);
-        rawVolume.set(cell, value);
-
-        minVal = std::min(minVal, value);
-        maxVal = std::max(maxVal, value);
-    });
+        function->minValue = std::min(function->minValue, value);
+        function->maxValue = std::max(function->maxValue, value);
+        return value;
+    };
 
-    luaL_unref(state, LUA_REGISTRYINDEX, functionReference);
+    evaluateVoxels<float, Function>(
+        _dimensions,
+        createFunction,
+        evaluate,
+        [&writer](size_t, std::span<const float> values) { writer.append(values); },
+        [&progressCallback](float progress) { progressCallback(0.1f + 0.8f * progress); }
+    );
+    writer.finish();
 
-    const std::filesystem::path directory = _rawVolumeOutputPath.parent_path();
-    if (!std::filesystem::is_directory(directory)) {
-        std::filesystem::create_directories(directory);
+    float minVal = std::numeric_limits<float>::max();
+    float maxVal = std::numeric_limits<float>::lowest();
+    for (const std::unique_ptr<ValueFunction>& function : functions) {
+        minVal = std::min(minVal, function->minValue);
+        maxVal = std::max(maxVal, function->maxValue);
+    }
+    if (minVal > maxVal) {
+        LWARNING("The value function could not be evaluated for any cell");
+        minVal = 0.f;
+        maxVal = 0.f;
     }
-
-    volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath);
-    writer.write(rawVolume);
-
-    progressCallback(0.9f);
 
     RawVolumeMetadata metadata;
     metadata.time = Time::convertTime(_time);
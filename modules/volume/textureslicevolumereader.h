@@ -27,20 +27,61 @@
 
 #include <modules/volume/linearlrucache.h>
 #include <ghoul/glm.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace ghoul::opengl { class Texture; }
 
 namespace openspace::volume {
 
+/**
+ * Reads a volume from a set of image files, one file per slice along the z axis. The
+ * slices are loaded on demand and kept in a cache. If prefetching is enabled, a number of
+ * worker threads decode the slices following the most recently requested ones, so that
+ * the slices are already available when the volume is read in the order of increasing z
+ * coordinates. All functions can be called from multiple threads at the same time.
+ */
 template <typename Type>
 class TextureSliceVolumeReader {
 public:
     using VoxelType = Type;
 
-    TextureSliceVolumeReader(std::vector<std::string> paths, size_t sliceCacheMaxItems,
-        size_t sliceCacheSize);
+    /**
+     * A range of consecutive slices that stay in memory for as long as the range exists,
+     * even if they are evicted from the slice cache of the reader. Reading from a range
+     * does not require any synchronization, and it provides the same interface as the
+     * reader, so it can be sampled by a VolumeSampler. Only voxels inside the slices of
+     * the range can be read.
+     */
+    class SliceRange {
+    public:
+        using VoxelType = Type;
+
+        VoxelType get(const glm::ivec3& coordinates) const;
+        glm::ivec3 dimensions() const;
+
+    private:
+        friend class TextureSliceVolumeReader;
+
+        std::vector<std::shared_ptr<ghoul::opengl::Texture>> _slices;
+        glm::ivec3 _dimensions = glm::ivec3(0);
+        int _firstSlice = 0;
+    };
+
+    /**
+     * Creates a reader for the slices in \p paths. The slice cache holds at most
+     * \p sliceCacheCapacity slices. If \p nPrefetchThreads is bigger than 0, that many
+     * threads decode up to \p prefetchDistance slices following the requested ones ahead
+     * of time. The cache should be able to hold the prefetched slices in addition to the
+     * slices that are in use, or the prefetched slices are evicted before they are used.
+     */
+    TextureSliceVolumeReader(std::vector<std::string> paths, size_t sliceCacheNIndices,
+        size_t sliceCacheCapacity, unsigned int nPrefetchThreads = 0,
+        size_t prefetchDistance = 0);
     virtual ~TextureSliceVolumeReader();
 
     void initialize();
@@ -49,12 +90,37 @@ public:
     virtual glm::ivec3 dimensions() const;
     void setPaths(std::vector<std::string> paths);
 
+    /**
+     * Returns the slices from \p firstSlice to \p lastSlice, both inclusive, and
+     * schedules the slices following them to be prefetched. This blocks until all of the
+     * slices are loaded.
+     */
+    SliceRange slices(int firstSlice, int lastSlice) const;
+
 private:
-    ghoul::opengl::Texture& getSlice(int sliceIndex) const;
+    std::shared_ptr<ghoul::opengl::Texture> acquireSlice(
+        std::unique_lock<std::mutex>& lock, int sliceIndex) const;
+    std::shared_ptr<ghoul::opengl::Texture> loadSlice(int sliceIndex) const;
+    void schedulePrefetch(int firstSlice, int lastSlice) const;
+    void prefetch();
+
     std::vector<std::string> _paths;
-    mutable LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>> _cache;
     glm::ivec2 _sliceDimensions = glm::ivec2(0);
     bool _isInitialized = false;
+
+    unsigned int _nPrefetchThreads = 0;
+    size_t _prefetchDistance = 0;
+    std::vector<std::thread> _prefetchThreads;
+
+    // Guards all of the members below
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _condition;
+    mutable LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>> _cache;
+    mutable std::vector<bool> _isLoading;
+    // The range of slices that are yet to be considered by the prefetch threads
+    mutable size_t _nextPrefetch = 0;
+    mutable size_t _prefetchEnd = 0;
+    bool _shouldStop = false;
 };
 
 } // namespace openspace::volume
@@ -23,39 +23,85 @@
  ****************************************************************************************/
 
 #include <ghoul/io/texture/texturereader.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 
 namespace openspace::volume {
 
+template <typename VoxelType>
+VoxelType TextureSliceVolumeReader<VoxelType>::SliceRange::get(
+                                                     const glm::ivec3& coordinates) const
+{
+    ghoul_assert(
+        coordinates.z >= _firstSlice &&
+        coordinates.z < _firstSlice + static_cast<int>(_slices.size()),
+        "Coordinates must be inside the slice range"
+    );
+
+    ghoul::opengl::Texture& slice = *_slices[coordinates.z - _firstSlice];
+    return slice.texel<VoxelType>(glm::uvec2(coordinates.x, coordinates.y));
+}
+
+template <typename VoxelType>
+glm::ivec3 TextureSliceVolumeReader<VoxelType>::SliceRange::dimensions() const {
+    return _dimensions;
+}
+
 template <typename VoxelType>
 TextureSliceVolumeReader<VoxelType>::TextureSliceVolumeReader(
                                                            std::vector<std::string> paths,
-                                                           size_t sliceCacheNIndices,
-                                                           size_t sliceCacheCapacity)
+                                                                size_t sliceCacheNIndices,
+                                                                size_t sliceCacheCapacity,
+                                                            unsigned int nPrefetchThreads,
+                                                                  size_t prefetchDistance)
     : _paths(std::move(paths))
+    , _nPrefetchThreads(nPrefetchThreads)
+    , _prefetchDistance(prefetchDistance)
     , _cache(sliceCacheCapacity, sliceCacheNIndices)
 {}
 
 template <typename VoxelType>
-TextureSliceVolumeReader<VoxelType>::~TextureSliceVolumeReader() {}
+TextureSliceVolumeReader<VoxelType>::~TextureSliceVolumeReader() {
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_all();
+    for (std::thread& thread : _prefetchThreads) {
+        thread.join();
+    }
+}
 
 template <typename VoxelType>
 void TextureSliceVolumeReader<VoxelType>::initialize() {
     ghoul_assert(_paths.size() > 0, "No paths to read slices from");
+    ghoul_assert(!_isInitialized, "Volume is already initialized");
 
     std::shared_ptr<ghoul::opengl::Texture> firstSlice =
         ghoul::io::TextureReader::ref().loadTexture(_paths[0], 2);
 
     glm::uvec3 dimensions = firstSlice->dimensions();
     _sliceDimensions = glm::uvec2(dimensions.x, dimensions.y);
+    _isLoading.assign(_paths.size(), false);
     _isInitialized = true;
     _cache.set(0, firstSlice);
+
+    _prefetchThreads.reserve(_nPrefetchThreads);
+    for (unsigned int i = 0; i < _nPrefetchThreads; i++) {
+        _prefetchThreads.emplace_back(&TextureSliceVolumeReader::prefetch, this);
+    }
 }
 
 template <typename VoxelType>
 VoxelType TextureSliceVolumeReader<VoxelType>::get(const glm::ivec3& coordinates) const {
-    ghoul::opengl::Texture& slice = getSlice(coordinates.z);
-    return slice.texel<VoxelType>(glm::uvec2(coordinates.x, coordinates.y));
+    std::shared_ptr<ghoul::opengl::Texture> slice;
+    {
+        std::unique_lock lock(_mutex);
+        schedulePrefetch(coordinates.z, coordinates.z);
+        slice = acquireSlice(lock, coordinates.z);
+    }
+    return slice->texel<VoxelType>(glm::uvec2(coordinates.x, coordinates.y));
 }
 
 template <typename VoxelType>
@@ -65,12 +111,34 @@ glm::ivec3 TextureSliceVolumeReader<VoxelType>::dimensions() const {
 
 template <typename VoxelType>
 void TextureSliceVolumeReader<VoxelType>::setPaths(std::vector<std::string> paths) {
+    ghoul_assert(!_isInitialized, "Paths can only be changed before initialization");
     _paths = std::move(paths);
 }
 
 template <typename VoxelType>
-ghoul::opengl::Texture&
-TextureSliceVolumeReader<VoxelType>::getSlice(int sliceIndex) const
+typename TextureSliceVolumeReader<VoxelType>::SliceRange
+TextureSliceVolumeReader<VoxelType>::slices(int firstSlice, int lastSlice) const {
+    ghoul_assert(firstSlice <= lastSlice, "First slice must not be after the last");
+
+    SliceRange range;
+    range._dimensions = dimensions();
+    range._firstSlice = firstSlice;
+    range._slices.reserve(lastSlice - firstSlice + 1);
+
+    std::unique_lock lock(_mutex);
+    // Schedule the requested slices as well, so that the prefetch threads help with
+    // loading the ones that are missing
+    schedulePrefetch(firstSlice, lastSlice);
+    for (int i = firstSlice; i <= lastSlice; i++) {
+        range._slices.push_back(acquireSlice(lock, i));
+    }
+    return range;
+}
+
+template <typename VoxelType>
+std::shared_ptr<ghoul::opengl::Texture>
+TextureSliceVolumeReader<VoxelType>::acquireSlice(std::unique_lock<std::mutex>& lock,
+                                                  int sliceIndex) const
 {
     ghoul_assert(_isInitialized, "Volume is not initialized");
     ghoul_assert(
@@ -78,17 +146,98 @@ TextureSliceVolumeReader<VoxelType>::getSlice(int sliceIndex) const
         "Slice index " + std::to_string(sliceIndex) + "is outside the range"
     );
 
-    if (!_cache.has(sliceIndex)) {
-        std::shared_ptr<ghoul::opengl::Texture> texture =
-            ghoul::io::TextureReader::ref().loadTexture(_paths[sliceIndex], 2);
+    // Wait for the slice if a prefetch thread is already loading it
+    while (!_cache.has(sliceIndex) && _isLoading[sliceIndex]) {
+        _condition.wait(lock);
+    }
+    if (_cache.has(sliceIndex)) {
+        return _cache.use(sliceIndex);
+    }
+
+    _isLoading[sliceIndex] = true;
+    lock.unlock();
+    std::shared_ptr<ghoul::opengl::Texture> texture;
+    try {
+        texture = loadSlice(sliceIndex);
+    }
+    catch (...) {
+        lock.lock();
+        _isLoading[sliceIndex] = false;
+        _condition.notify_all();
+        throw;
+    }
+    lock.lock();
+    _isLoading[sliceIndex] = false;
+    _cache.set(sliceIndex, texture);
+    _condition.notify_all();
+    return texture;
+}
+
+template <typename VoxelType>
+std::shared_ptr<ghoul::opengl::Texture>
+TextureSliceVolumeReader<VoxelType>::loadSlice(int sliceIndex) const {
+    std::shared_ptr<ghoul::opengl::Texture> texture =
+        ghoul::io::TextureReader::ref().loadTexture(_paths[sliceIndex], 2);
+
+    ghoul_assert(
+        glm::ivec2(texture->dimensions()) == _sliceDimensions,
+        "Slice dimensions do not agree"
+    );
+    return texture;
+}
+
+template <typename VoxelType>
+void TextureSliceVolumeReader<VoxelType>::schedulePrefetch(int firstSlice,
+                                                           int lastSlice) const
+{
+    if (_prefetchThreads.empty()) {
+        return;
+    }
+
+    const size_t end = std::min(lastSlice + 1 + _prefetchDistance, _paths.size());
+    if (end == _prefetchEnd) {
+        // The same range was already scheduled, which is the common case when reading
+        // individual voxels
+        return;
+    }
+    _nextPrefetch = firstSlice;
+    _prefetchEnd = end;
+    _condition.notify_all();
+}
+
+template <typename VoxelType>
+void TextureSliceVolumeReader<VoxelType>::prefetch() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this]() {
+            return _shouldStop || _nextPrefetch < _prefetchEnd;
+        });
+        if (_shouldStop) {
+            return;
+        }
+
+        const size_t sliceIndex = _nextPrefetch++;
+        if (_cache.has(sliceIndex) || _isLoading[sliceIndex]) {
+            continue;
+        }
 
-        ghoul_assert(
-            glm::ivec2(texture->dimensions()) == _sliceDimensions,
-            "Slice dimensions do not agree"
-        );
-        _cache.set(sliceIndex, std::move(texture));
+        _isLoading[sliceIndex] = true;
+        lock.unlock();
+        std::shared_ptr<ghoul::opengl::Texture> texture;
+        try {
+            texture = loadSlice(static_cast<int>(sliceIndex));
+        }
+        catch (...) {
+            // The slice is loaded again when it is requested, which then reports the
+            // error to the caller
+        }
+        lock.lock();
+        _isLoading[sliceIndex] = false;
+        if (texture) {
+            _cache.set(sliceIndex, std::move(texture));
+        }
+        _condition.notify_all();
     }
-    return *_cache.get(sliceIndex).get();
 }
 
 } // namespace openspace::volume
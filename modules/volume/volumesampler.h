@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_VOLUME___VOLUMESAMPLER___H__
 
 #include <ghoul/glm.h>
+#include <span>
 
 namespace openspace::volume {
 
@@ -37,6 +38,21 @@ public:
     VolumeSampler(const VolumeType* volume, const glm::vec3& filterSize);
     typename VolumeType::VoxelType sample(const glm::vec3& position) const;
 
+    /**
+     * Samples the volume on a regular grid of \p count positions that starts at
+     * \p origin and has a distance of \p spacing between neighboring positions. The
+     * values are written into \p result with x as the fastest varying index.
+     */
+    void sample(const glm::vec3& origin, const glm::vec3& spacing,
+        const glm::uvec3& count,
+        std::span<typename VolumeType::VoxelType> result) const;
+
+    /**
+     * Returns the first and last z coordinate, both inclusive, of the voxels that are
+     * read when sampling positions with z coordinates between \p minZ and \p maxZ.
+     */
+    glm::ivec2 sliceRange(float minZ, float maxZ) const;
+
 private:
     glm::ivec3 _filterSize = glm::ivec3(0);
     const VolumeType* _volume;
@@ -22,6 +22,10 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+
 namespace openspace::volume {
 
 template <typename VolumeType>
@@ -50,7 +54,7 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
     const glm::ivec3 maxCoords = minCoords + _filterSize;
     const glm::ivec3 clampCeiling = _volume->dimensions() - glm::ivec3(1);
 
-    typename VolumeType::VoxelType value;
+    typename VolumeType::VoxelType value = typename VolumeType::VoxelType(0);
     for (int z = minCoords.z; z <= maxCoords.z; z++) {
         for (int y = minCoords.y; y <= maxCoords.y; y++) {
             for (int x = minCoords.x; x <= maxCoords.x; x++) {
@@ -90,4 +94,35 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
     return value;
 }
 
+template <typename VolumeType>
+void VolumeSampler<VolumeType>::sample(const glm::vec3& origin, const glm::vec3& spacing,
+                                       const glm::uvec3& count,
+                                std::span<typename VolumeType::VoxelType> result) const
+{
+    ghoul_assert(
+        result.size() == static_cast<size_t>(count.x) * count.y * count.z,
+        "Result must have one value per position"
+    );
+
+    size_t i = 0;
+    for (unsigned int z = 0; z < count.z; z++) {
+        for (unsigned int y = 0; y < count.y; y++) {
+            for (unsigned int x = 0; x < count.x; x++) {
+                result[i] = sample(origin + spacing * glm::vec3(x, y, z));
+                i++;
+            }
+        }
+    }
+}
+
+template <typename VolumeType>
+glm::ivec2 VolumeSampler<VolumeType>::sliceRange(float minZ, float maxZ) const {
+    // Same footprint as in the sampling above, including the interpolation
+    const int first = static_cast<int>(std::floor(minZ)) - _filterSize.z / 2;
+    const int last = static_cast<int>(std::floor(maxZ)) - _filterSize.z / 2 +
+        _filterSize.z;
+    const int ceiling = _volume->dimensions().z - 1;
+    return glm::ivec2(std::clamp(first, 0, ceiling), std::clamp(last, 0, ceiling));
+}
+
 } // namespace openspace::volume
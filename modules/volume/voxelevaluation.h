@@ -0,0 +1,70 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___VOXELEVALUATION___H__
+#define __OPENSPACE_MODULE_VOLUME___VOXELEVALUATION___H__
+
+#include <ghoul/glm.h>
+#include <functional>
+#include <span>
+
+namespace openspace::volume {
+
+/**
+ * Evaluates a function for every voxel of a volume with the provided \p dimensions on
+ * the shared thread pool. The voxels are evaluated in batches of consecutive voxels in
+ * file order, and each batch is passed to \p write on the calling thread in the same
+ * order as the voxels are laid out in a `.rawvolume` file. Only one batch is held in
+ * memory at any time, so the result can be streamed to disk without holding the entire
+ * volume in memory.
+ *
+ * \param dimensions The number of voxels along each axis
+ * \param createThreadState Called on the calling thread once for each range into which
+ *        the batches are split, before any voxels are evaluated. The returned state is
+ *        passed to \p evaluate and is only ever used by a single thread at a time, so
+ *        this is where resources such as Lua states or interpolators that are not
+ *        thread-safe should be created
+ * \param evaluate Computes the value of the voxel at the provided coordinates
+ * \param write Receives the index of the first voxel of a batch and the values of the
+ *        batch. It is called on the calling thread with the batches in order
+ * \param onProgress Called on the calling thread with the fraction of voxels written
+ * \param nThreads The number of ranges, and thus states, that each batch is split into.
+ *        If this is 0, one range per thread of the shared thread pool is used
+ *
+ * \throw Any exception thrown by \p evaluate is rethrown on the calling thread once
+ *        the batch in which it occurred has been processed
+ */
+template <typename VoxelType, typename ThreadState>
+void evaluateVoxels(const glm::uvec3& dimensions,
+    const std::function<ThreadState()>& createThreadState,
+    const std::function<VoxelType(ThreadState&, const glm::uvec3&)>& evaluate,
+    const std::function<void(size_t, std::span<const VoxelType>)>& write,
+    const std::function<void(float)>& onProgress = [](float) {},
+    unsigned int nThreads = 0);
+
+} // namespace openspace::volume
+
+#include "voxelevaluation.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___VOXELEVALUATION___H__
@@ -0,0 +1,94 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/volumeutils.h>
+#include <openspace/util/parallelfor.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <vector>
+
+namespace openspace::volume {
+
+namespace voxelevaluation {
+    // Ranges are large enough to amortize handing them to another thread, but small
+    // enough that a batch of ranges does not take up too much memory
+    constexpr size_t MinVoxelsPerRange = 1 << 14;
+    constexpr size_t MaxVoxelsPerRange = 1 << 18;
+} // namespace voxelevaluation
+
+template <typename VoxelType, typename ThreadState>
+void evaluateVoxels(const glm::uvec3& dimensions,
+                                    const std::function<ThreadState()>& createThreadState,
+                const std::function<VoxelType(ThreadState&, const glm::uvec3&)>& evaluate,
+                     const std::function<void(size_t, std::span<const VoxelType>)>& write,
+                                             const std::function<void(float)>& onProgress,
+                                                                    unsigned int nThreads)
+{
+    using namespace voxelevaluation;
+    ZoneScoped;
+
+    const size_t nVoxels = static_cast<size_t>(dimensions.x) *
+        static_cast<size_t>(dimensions.y) * static_cast<size_t>(dimensions.z);
+    if (nVoxels == 0) {
+        onProgress(1.f);
+        return;
+    }
+
+    // Each range of a batch is evaluated by exactly one thread, so every range gets its
+    // own state
+    const size_t nRanges = nThreads == 0 ?
+        parallelRangeCount(nVoxels, MinVoxelsPerRange) :
+        std::min<size_t>(nThreads, nVoxels);
+    std::vector<ThreadState> states;
+    states.reserve(nRanges);
+    for (size_t i = 0; i < nRanges; i++) {
+        states.push_back(createThreadState());
+    }
+
+    const size_t rangeSize = std::clamp<size_t>(
+        (nVoxels + nRanges - 1) / nRanges,
+        1,
+        MaxVoxelsPerRange
+    );
+    const size_t batchSize = std::min(rangeSize * nRanges, nVoxels);
+    std::vector<VoxelType> batch(batchSize);
+    for (size_t first = 0; first < nVoxels; first += batchSize) {
+        const size_t count = std::min(batchSize, nVoxels - first);
+        parallelForRanges(
+            count,
+            nRanges,
+            [&](size_t range, size_t begin, size_t end) {
+                ThreadState& state = states[range];
+                for (size_t i = begin; i < end; i++) {
+                    batch[i] = evaluate(state, indexToCoords(first + i, dimensions));
+                }
+            }
+        );
+
+        write(first, std::span<const VoxelType>(batch.data(), count));
+        onProgress(static_cast<float>(first + count) / nVoxels);
+    }
+}
+
+} // namespace openspace::volume
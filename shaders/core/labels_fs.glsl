@@ -0,0 +1,58 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "fragment.glsl"
+
+in float depth;
+in vec2 texCoords;
+in vec2 outlineTexCoords;
+
+uniform sampler2D tex;
+uniform vec4 color;
+uniform vec4 outlineColor;
+uniform bool hasOutline;
+
+Fragment getFragment() {
+  Fragment frag;
+
+  // The font atlas only stores the coverage of each glyph in its red channel
+  float inside = texture(tex, texCoords).r;
+  if (hasOutline) {
+    float outline = texture(tex, outlineTexCoords).r;
+    frag.color = vec4(
+      mix(outlineColor.rgb, color.rgb, inside),
+      max(inside, outline) * color.a
+    );
+  }
+  else {
+    frag.color = vec4(color.rgb, inside * color.a);
+  }
+
+  if (frag.color.a == 0.0) {
+    discard;
+  }
+
+  frag.depth = depth;
+  return frag;
+}
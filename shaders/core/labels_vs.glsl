@@ -0,0 +1,63 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec2 in_offset;
+layout(location = 2) in vec2 in_texCoords;
+layout(location = 3) in vec2 in_outlineTexCoords;
+
+out float depth;
+out vec2 texCoords;
+out vec2 outlineTexCoords;
+
+uniform dmat4 modelViewProjection;
+uniform int renderType;
+uniform vec3 orthoRight;
+uniform vec3 orthoUp;
+uniform dvec3 cameraPosition;
+uniform vec3 cameraLookUp;
+
+const int RenderTypePositionNormal = 1;
+
+void main() {
+  texCoords = in_texCoords;
+  outlineTexCoords = in_outlineTexCoords;
+
+  // The offset of the glyph corner from the label position is already scaled into the
+  // model space of the labels and only has to be oriented
+  vec3 right = orthoRight;
+  vec3 up = orthoUp;
+  if (renderType == RenderTypePositionNormal) {
+    vec3 normal = vec3(normalize(cameraPosition - dvec3(in_position)));
+    right = normalize(cross(cameraLookUp, normal));
+    up = cross(normal, right);
+  }
+  dvec3 offset = dvec3(right * in_offset.x + up * in_offset.y);
+
+  vec4 p = vec4(modelViewProjection * dvec4(dvec3(in_position) + offset, 1.0));
+  gl_Position = p;
+  depth = p.w;
+}
@@ -35,6 +35,7 @@
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/stringhelper.h>
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <string_view>
@@ -51,6 +52,44 @@ namespace {
         }
     }
 
+    // Each entry in a data cache file consists of its position and the comment length
+    constexpr size_t CachedEntrySize = 3 * sizeof(float) + sizeof(uint16_t);
+
+    // Reads consecutive values out of a memory mapped file and throws an exception if the
+    // file is too short to contain them
+    class FileCursor {
+    public:
+        explicit FileCursor(std::string_view content) : _content(content) {}
+
+        template <typename T>
+        T read() {
+            T value;
+            std::memcpy(&value, advance(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        std::string readString(size_t length) {
+            return std::string(advance(length), length);
+        }
+
+        const char* advance(size_t nBytes) {
+            if (nBytes > _content.size() - _position) {
+                throw ghoul::RuntimeError("Unexpected end of cache file");
+            }
+            const char* result = _content.data() + _position;
+            _position += nBytes;
+            return result;
+        }
+
+        size_t position() const {
+            return _position;
+        }
+
+    private:
+        std::string_view _content;
+        size_t _position = 0;
+    };
+
     template <typename T>
     using LoadCacheFunc = std::function<std::optional<T>(std::filesystem::path)>;
 
@@ -416,6 +455,118 @@ Dataset loadFileWithCache(std::filesystem::path path, std::optional<DataMapping>
     );
 }
 
+std::filesystem::path cachedFile(std::filesystem::path path,
+                                 std::optional<DataMapping> specs)
+{
+    ZoneScoped;
+
+    std::string info;
+    if (specs.has_value()) {
+        info = generateHashString(*specs);
+    }
+    std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(path, info);
+
+    if (std::filesystem::exists(cached)) {
+        int8_t fileVersion = 0;
+        {
+            std::ifstream file = std::ifstream(cached, std::ios::binary);
+            file.read(reinterpret_cast<char*>(&fileVersion), sizeof(int8_t));
+        }
+        if (fileVersion == DataCacheFileVersion) {
+            return cached;
+        }
+        FileSys.cacheManager()->removeCacheFile(cached);
+    }
+
+    LINFOC("DataLoader", std::format("Loading file '{}'", path));
+    const Dataset dataset = loadFile(path, std::move(specs));
+    if (dataset.entries.empty()) {
+        throw ghoul::RuntimeError(std::format("Data file '{}' has no entries", path));
+    }
+
+    LINFOC("DataLoader", "Saving cache");
+    saveCachedFile(dataset, cached);
+    return cached;
+}
+
+CachedFileReader::CachedFileReader(const std::filesystem::path& path)
+    : _file(path)
+{
+    ZoneScoped;
+
+    // This has to match the layout that is written in saveCachedFile
+    FileCursor cursor = FileCursor(_file.view());
+    if (cursor.read<int8_t>() != DataCacheFileVersion) {
+        throw ghoul::RuntimeError(std::format(
+            "Cache file '{}' was written with an incompatible version", path
+        ));
+    }
+
+    const uint16_t nVariables = cursor.read<uint16_t>();
+    _header.variables.resize(nVariables);
+    for (Dataset::Variable& var : _header.variables) {
+        var.index = cursor.read<int16_t>();
+        var.name = cursor.readString(cursor.read<uint16_t>());
+    }
+
+    const uint16_t nTextures = cursor.read<uint16_t>();
+    _header.textures.resize(nTextures);
+    for (Dataset::Texture& tex : _header.textures) {
+        tex.index = cursor.read<int16_t>();
+        tex.file = cursor.readString(cursor.read<uint16_t>());
+    }
+
+    _header.textureDataIndex = cursor.read<int16_t>();
+    _header.orientationDataIndex = cursor.read<int16_t>();
+
+    _nEntries = cursor.read<uint64_t>();
+    if (_nEntries > _file.size() / CachedEntrySize) {
+        throw ghoul::RuntimeError(std::format("Cache file '{}' is truncated", path));
+    }
+    _entriesOffset = cursor.position();
+    cursor.advance(_nEntries * CachedEntrySize);
+
+    _nValues = cursor.read<uint16_t>();
+    _valuesOffset = cursor.position();
+    if (_nValues > 0 && _nEntries > _file.size() / (_nValues * sizeof(float))) {
+        throw ghoul::RuntimeError(std::format("Cache file '{}' is truncated", path));
+    }
+    cursor.advance(_nEntries * _nValues * sizeof(float));
+
+    const uint64_t totalCommentLength = cursor.read<uint64_t>();
+    cursor.advance(totalCommentLength);
+    _header.maxPositionComponent = cursor.read<float>();
+}
+
+const Dataset& CachedFileReader::header() const {
+    return _header;
+}
+
+uint64_t CachedFileReader::nEntries() const {
+    return _nEntries;
+}
+
+std::vector<Dataset::Entry> CachedFileReader::readEntries(uint64_t first,
+                                                          uint64_t count) const
+{
+    ZoneScoped;
+
+    ghoul_assert(first + count <= _nEntries, "Entries out of range");
+
+    std::vector<Dataset::Entry> result(count);
+    const char* entries = _file.data() + _entriesOffset + first * CachedEntrySize;
+    const char* values = _file.data() + _valuesOffset + first * _nValues * sizeof(float);
+    for (Dataset::Entry& e : result) {
+        std::memcpy(&e.position.x, entries, 3 * sizeof(float));
+        entries += CachedEntrySize;
+
+        e.data.resize(_nValues);
+        std::memcpy(e.data.data(), values, _nValues * sizeof(float));
+        values += _nValues * sizeof(float);
+    }
+    return result;
+}
+
 } // namespace data
 
 namespace label {
@@ -1094,9 +1094,9 @@ void OpenSpaceEngine::preSynchronization() {
 
         global::timeManager->preSynchronization(dt);
 
-        const std::vector<std::string> schedScripts = global::scriptScheduler->progressTo(
-            global::timeManager->time().j2000Seconds()
-        );
+        const double simulationTime = global::timeManager->time().j2000Seconds();
+        const std::span<const std::string> schedScripts =
+            global::scriptScheduler->progressTo(simulationTime);
         for (const std::string& script : schedScripts) {
             if (script.empty()) {
                 continue;
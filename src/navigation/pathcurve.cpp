@@ -36,6 +36,27 @@
 
 namespace {
     constexpr double LengthEpsilon = 100.0 * std::numeric_limits<double>::epsilon();
+
+    // Number of evenly spaced samples per segment in the arc length map
+    constexpr int SamplesPerSegment = 100;
+
+    // The arc length error in meters that we tolerate when mapping an arc length to a
+    // curve parameter
+    constexpr double ArcLengthTolerance = 0.5;
+
+    // The arc length error of the precomputed arc length map, relative to the length of
+    // a segment. Refining the map down to the absolute tolerance would take far too many
+    // samples on interplanetary segments, so the remaining error is instead removed with
+    // a few Newton iterations when a curve parameter is looked up
+    constexpr double RelativeArcLengthTolerance = 1e-6;
+
+    // The maximum number of times that the interval between two evenly spaced samples is
+    // halved to reach the tolerated error
+    constexpr int MaxRefinementDepth = 6;
+
+    // The maximum number of Newton iterations used to improve a curve parameter that was
+    // interpolated from the arc length map
+    constexpr int MaxNewtonIterations = 4;
 } // namespace
 
 namespace openspace::interaction {
@@ -71,22 +92,34 @@ void PathCurve::initializeParameterData() {
     _lengthSums.clear();
     _parameterSamples.clear();
 
-    const double max = static_cast<double>(_nSegments);
-
     // Evenly space out parameter intervals
     _curveParameterSteps.reserve(_nSegments + 1);
     for (unsigned int i = 0; i <= _nSegments; i++) {
         _curveParameterSteps.push_back(static_cast<double>(i));
     }
 
-    // Arc lengths
+    // Compute the arc lengths of evenly spaced parameter intervals in each segment. Each
+    // sample only integrates over its own interval and the lengths are accumulated, which
+    // keeps the cost of each integration constant regardless of the segment length
+    const double uStep = 1.0 / static_cast<double>(SamplesPerSegment);
+    std::vector<ParameterPair> uniformSamples;
+    uniformSamples.reserve(SamplesPerSegment * _nSegments + 1);
+    uniformSamples.push_back({ 0.0, 0.0 });
+
     _lengthSums.reserve(_nSegments + 1);
     _lengthSums.push_back(0.0);
-    for (unsigned int i = 1; i <= _nSegments; i++) {
-        const double u = _curveParameterSteps[i];
-        const double uPrev = _curveParameterSteps[i - 1];
-        const double length = arcLength(uPrev, u);
-        _lengthSums.push_back(_lengthSums[i - 1] + length);
+    for (unsigned int i = 0; i < _nSegments; i++) {
+        const double uStart = _curveParameterSteps[i];
+        for (int j = 1; j <= SamplesPerSegment; j++) {
+            const double uPrev = uniformSamples.back().u;
+            // Use the exact segment end to not accumulate any rounding errors
+            const double u = (j == SamplesPerSegment) ?
+                _curveParameterSteps[i + 1] :
+                uStart + j * uStep;
+            const double s = uniformSamples.back().s + arcLength(uPrev, u);
+            uniformSamples.push_back({ u, s });
+        }
+        _lengthSums.push_back(uniformSamples.back().s);
     }
     _totalLength = _lengthSums.back();
 
@@ -94,42 +127,72 @@ void PathCurve::initializeParameterData() {
         throw TooShortPathError("Path too short");
     }
 
-    // Compute a map of arc lengths s and curve parameters u, for reparameterization
-    constexpr int Steps = 100;
-    const double uStep = 1.0 / static_cast<double>(Steps);
-    _parameterSamples.reserve(Steps * _nSegments + 1);
+    // Refine the map of arc lengths s and curve parameters u used for the
+    // reparameterization wherever a linear interpolation between two neighboring samples
+    // would deviate more than the tolerated error from the actual arc length. The
+    // tolerance scales with the length of each segment to bound the number of samples
+    _parameterSamples.reserve(uniformSamples.size());
+    _parameterSamples.push_back(uniformSamples.front());
+    for (size_t i = 1; i < uniformSamples.size(); i++) {
+        const ParameterPair& prev = uniformSamples[i - 1];
+        const ParameterPair& next = uniformSamples[i];
+        const bool isSegmentEnd = (i % SamplesPerSegment == 0);
+        const size_t segment = (i - 1) / SamplesPerSegment;
+        const double segmentLength = _lengthSums[segment + 1] - _lengthSums[segment];
+
+        // Identify samples that are indistinguishable due to precision limitations
+        if (!isSegmentEnd && std::abs(next.s - prev.s) < LengthEpsilon) {
+            throw InsufficientPrecisionError("Insufficient precision due to path length");
+        }
 
-    for (unsigned int i = 0; i < _nSegments; i++) {
-        const double uStart = _curveParameterSteps[i];
-        const double sStart = _lengthSums[i];
-        _parameterSamples.push_back({ uStart, sStart });
-        // Intermediate sampels
-        for (int j = 1; j < Steps; j++) {
-            const double u = uStart + j * uStep;
-            const double s = sStart + arcLength(uStart, u);
-            // Identify samples that are indistinguishable due to precision limitations
-            if (std::abs(s - _parameterSamples.back().s) < LengthEpsilon) {
-                throw InsufficientPrecisionError(
-                    "Insufficient precision due to path length"
-                );
-            }
-            _parameterSamples.push_back({ u, s });
+        const double tolerance =
+            std::max(ArcLengthTolerance, RelativeArcLengthTolerance * segmentLength);
+        addRefinedSamples(prev, next, tolerance, 0);
+        _parameterSamples.push_back(next);
+    }
+
+    // Remove the second to last sample if it is indistinguishable from the final one
+    const size_t nSamples = _parameterSamples.size();
+    if (nSamples > 2) {
+        const double diff =
+            std::abs(_totalLength - _parameterSamples[nSamples - 2].s);
+        if (diff < LengthEpsilon) {
+            _parameterSamples.erase(_parameterSamples.end() - 2);
         }
     }
+    _parameterSamples.shrink_to_fit();
+}
 
-    // Remove the very last sample if indistinguishable from the final one
-    const double diff = std::abs(_totalLength - _parameterSamples.back().s);
-    if (diff < LengthEpsilon) {
-        _parameterSamples.pop_back();
+void PathCurve::addRefinedSamples(const ParameterPair& lower, const ParameterPair& upper,
+                                  double tolerance, int depth)
+{
+    if (depth >= MaxRefinementDepth) {
+        return;
     }
 
-    _parameterSamples.push_back({ max, _totalLength });
-    _parameterSamples.shrink_to_fit();
+    const double uMid = 0.5 * (lower.u + upper.u);
+    const double sMid = lower.s + arcLength(lower.u, uMid);
+    if (sMid <= lower.s || sMid >= upper.s) {
+        // Keep the map strictly increasing even if the integration is not exact
+        return;
+    }
+
+    // The error of a linear interpolation is the largest in the middle of the interval
+    const double error = std::abs(sMid - 0.5 * (lower.s + upper.s));
+    if (error <= tolerance) {
+        return;
+    }
+
+    const ParameterPair mid = { uMid, sMid };
+    addRefinedSamples(lower, mid, tolerance, depth + 1);
+    _parameterSamples.push_back(mid);
+    addRefinedSamples(mid, upper, tolerance, depth + 1);
 }
 
-// Compute the curve parameter from an arc length value, using a combination of
-// Newton's method and bisection. Source:
-// https://www.geometrictools.com/Documentation/MovingAlongCurveSpecifiedSpeed.pdf
+// Compute the curve parameter from an arc length value, using a binary search in the
+// precomputed, monotonically increasing map of arc lengths and curve parameters. The
+// value interpolated between two samples is then improved with a bounded number of
+// Newton iterations until the arc length is within the tolerated error.
 // Input s is a length value, in the range [0, _totalLength]
 // Returns curve parameter in range [0, _nSegments]
 double PathCurve::curveParameter(double s) const {
@@ -140,81 +203,45 @@ double PathCurve::curveParameter(double s) const {
         return _curveParameterSteps.back();
     }
 
-    unsigned int segmentIndex = 1;
-    while (s > _lengthSums[segmentIndex]) {
-        segmentIndex++;
-    }
-
-    const double segmentS = s - _lengthSums[segmentIndex - 1];
-    const double uMin = _curveParameterSteps[segmentIndex - 1];
-    const double uMax = _curveParameterSteps[segmentIndex];
-
-    // Find sample indices corresponding to the selected sample
-    auto findIndexOfFirstEqualOrLarger_u = [&samples = _parameterSamples](double value) {
-        auto it = std::lower_bound(
-            samples.begin(),
-            samples.end(),
-            ParameterPair{ value, 0.0 }, // 0.0 is a dummy value for s
-            [](const ParameterPair& lhs, const ParameterPair& rhs) {
-                return lhs.u < rhs.u;
-            }
-        );
-        return std::distance(samples.begin(), it);
-    };
-
-    const size_t startIndex = findIndexOfFirstEqualOrLarger_u(uMin);
-    const size_t endIndex = findIndexOfFirstEqualOrLarger_u(uMax);
-
-    // Use samples to find an initial guess for Newton's method
-    // Find first sample with s larger than input s
+    // Find first sample with s larger than input s. As the first sample has s = 0 and the
+    // last one _totalLength, the iterator is never the first or past the end
     auto sampleIterator = std::upper_bound(
-        _parameterSamples.begin() + startIndex,
-        _parameterSamples.begin() + endIndex,
-        ParameterPair{ 0.0 , s }, // 0.0 is a dummy value for u
-        [](const ParameterPair& lhs, const ParameterPair& rhs) {
-            return lhs.s < rhs.s;
-        }
+        _parameterSamples.begin(),
+        _parameterSamples.end(),
+        s,
+        [](double value, const ParameterPair& sample) { return value < sample.s; }
+    );
+    ghoul_assert(
+        sampleIterator != _parameterSamples.begin() &&
+        sampleIterator != _parameterSamples.end(),
+        "Arc length out of range"
     );
 
     const ParameterPair& sample = *sampleIterator;
     const ParameterPair& prevSample = *(sampleIterator - 1);
-    const double uPrev = prevSample.u;
-    const double sPrev = prevSample.s;
-    const double slope = (sample.u - uPrev) / (sample.s - sPrev);
-    double u = uPrev + slope * (s - sPrev);
-
-    constexpr int maxIterations = 50;
-
-    // Initialize root bounding limits for bisection
-    double lower = uMin;
-    double upper = uMax;
-
-    for (int i = 0; i < maxIterations; i++) {
-        const double F = arcLength(uMin, u) - segmentS;
-
-        // The error we tolerate, in meters. Note that distances are very large
-        constexpr double tolerance = 0.5;
-        if (std::abs(F) <= tolerance) {
-            return u;
+    const double t = (s - prevSample.s) / (sample.s - prevSample.s);
+    double u = prevSample.u + t * (sample.u - prevSample.u);
+
+    // The solution is always between the two samples, so fall back to bisecting that
+    // interval whenever a Newton step would leave it
+    double lower = prevSample.u;
+    double upper = sample.u;
+    for (int i = 0; i < MaxNewtonIterations; i++) {
+        const double error = prevSample.s + arcLength(prevSample.u, u) - s;
+        if (std::abs(error) <= ArcLengthTolerance) {
+            break;
         }
 
-        // Generate a candidate for Newton's method
-        const double dfdu = approximatedDerivative(u); // > 0
-        const double uCandidate = u - F / dfdu;
-
-        // Update root-bounding interval and test candidate
-        if (F > 0) {  // => candidate < u <= upper
+        if (error > 0.0) {
             upper = u;
-            u = (uCandidate <= lower) ? (upper + lower) / 2.0 : uCandidate;
         }
-        else { // F < 0 => lower <= u < candidate
+        else {
             lower = u;
-            u = (uCandidate >= upper) ? (upper + lower) / 2.0 : uCandidate;
         }
-    }
 
-    // No root was found based on the number of iterations and tolerance. However, it is
-    // safe to report the last computed u value, since it is within the segment interval
+        const double next = u - error / approximatedDerivative(u);
+        u = (next > lower && next < upper) ? next : 0.5 * (lower + upper);
+    }
     return u;
 }
 
@@ -30,6 +30,8 @@
 #include <openspace/navigation/pathnavigator.h>
 #include <openspace/navigation/waypoint.h>
 #include <openspace/query/query.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/scene/scene.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/collisionhelper.h>
 #include <ghoul/logging/logmanager.h>
@@ -123,6 +125,13 @@ AvoidCollisionCurve::AvoidCollisionCurve(const Waypoint& start, const Waypoint&
     _points.push_back(end.position());
     _points.push_back(end.position());
 
+    // Remember the order of the relevant nodes, so that the candidates returned from the
+    // scene's bounding volume hierarchy are handled in the same order as before
+    _relevantNodeIndices.reserve(_relevantNodes.size());
+    for (size_t i = 0; i < _relevantNodes.size(); i++) {
+        _relevantNodeIndices[_relevantNodes[i]] = i;
+    }
+
     // Create extra points to avoid collision
     removeCollisions();
 
@@ -137,6 +146,13 @@ void AvoidCollisionCurve::removeCollisions(int step) {
         return;
     }
 
+    // Sphere to check for collision. Make sure it does not have radius zero.
+    const double minValidBoundingSphere =
+        global::navigationHandler->pathNavigator().minValidBoundingSphere();
+
+    const SceneBvh& bvh = global::renderEngine->scene()->boundingVolumeHierarchy();
+    std::vector<SceneGraphNode*> candidates;
+
     const int nSegments = static_cast<int>(_points.size() - 3);
     for (int i = 0; i < nSegments; i++) {
         const glm::dvec3 lineStart = _points[i + 1];
@@ -146,7 +162,34 @@ void AvoidCollisionCurve::removeCollisions(int step) {
             continue; // Start and end position are the same. Go to next segment
         }
 
-        for (SceneGraphNode* node : _relevantNodes) {
+        // Only nodes whose bounding sphere, including the buffer, is close to the line
+        // segment can collide with it
+        candidates.clear();
+        if (bvh.isEmpty()) {
+            candidates = _relevantNodes;
+        }
+        else {
+            bvh.querySegment(
+                lineStart,
+                lineEnd,
+                1.0 + CollisionBufferSizeRadiusMultiplier,
+                minValidBoundingSphere,
+                candidates
+            );
+            std::erase_if(
+                candidates,
+                [this](SceneGraphNode* n) { return !_relevantNodeIndices.contains(n); }
+            );
+            std::sort(
+                candidates.begin(),
+                candidates.end(),
+                [this](SceneGraphNode* lhs, SceneGraphNode* rhs) {
+                    return _relevantNodeIndices.at(lhs) < _relevantNodeIndices.at(rhs);
+                }
+            );
+        }
+
+        for (SceneGraphNode* node : candidates) {
             using namespace collision;
 
             // Do collision check in relative coordinates, to avoid huge numbers
@@ -156,10 +199,6 @@ void AvoidCollisionCurve::removeCollisions(int step) {
             const glm::dvec3 p2 =
                 glm::inverse(modelTransform) * glm::dvec4(lineEnd, 1.0);
 
-            // Sphere to check for collision. Make sure it does not have radius zero.
-            const double minValidBoundingSphere =
-                global::navigationHandler->pathNavigator().minValidBoundingSphere();
-
             double radius = std::max(node->boundingSphere(), minValidBoundingSphere);
             constexpr glm::dvec3 Center = glm::dvec3(0.0, 0.0, 0.0);
 
@@ -527,10 +527,33 @@ void PathNavigator::findRelevantNodes() {
 
 SceneGraphNode* PathNavigator::findNodeNearTarget(const SceneGraphNode* node) {
     constexpr float LengthEpsilon = 1e-5f;
+    constexpr float proximityRadiusFactor = 3.f;
+
     const std::vector<SceneGraphNode*>& relNodes =
         global::navigationHandler->pathNavigator().relevantNodes();
 
+    // Use the scene's bounding volume hierarchy to only consider the nodes that are
+    // close enough to the target to possibly pass the proximity check below
+    const SceneBvh& bvh = global::renderEngine->scene()->boundingVolumeHierarchy();
+    std::vector<SceneGraphNode*> candidates;
+    if (!bvh.isEmpty()) {
+        bvh.querySegment(
+            node->worldPosition(),
+            node->worldPosition(),
+            proximityRadiusFactor,
+            0.0,
+            candidates
+        );
+        std::sort(candidates.begin(), candidates.end());
+    }
+
     for (SceneGraphNode* n : relNodes) {
+        const bool isCandidate = bvh.isEmpty() ||
+            std::binary_search(candidates.begin(), candidates.end(), n);
+        if (!isCandidate) {
+            continue;
+        }
+
         bool isSame = (n->identifier() == node->identifier());
         // If the nodes are in the very same position, they are probably representing
         // the same object
@@ -541,8 +564,6 @@ SceneGraphNode* PathNavigator::findNodeNearTarget(const SceneGraphNode* node) {
             continue;
         }
 
-        constexpr float proximityRadiusFactor = 3.f;
-
         const float bs = static_cast<float>(n->boundingSphere());
         const float proximityRadius = proximityRadiusFactor * bs;
         const glm::dvec3 posInModelCoords =
@@ -387,6 +387,8 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
                 global::timeManager->removeKeyframesAfter(convertedTimestamp, true);
             }
 
+            std::vector<std::pair<double, TimeManager::TimeKeyframeData>> keyframes;
+            keyframes.reserve(keyframesMessage.size());
             for (const datamessagestructures::TimeKeyframe& kfMessage : keyframesMessage)
             {
                 TimeManager::TimeKeyframeData timeKeyframeData;
@@ -401,12 +403,14 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
                 // so we can remove any other previous ones
                 if (kfTimestamp < now) {
                     global::timeManager->removeKeyframesBefore(kfTimestamp, true);
+                    std::erase_if(
+                        keyframes,
+                        [kfTimestamp](const auto& kf) { return kf.first <= kfTimestamp; }
+                    );
                 }
-                global::timeManager->addKeyframe(
-                    kfTimestamp,
-                    timeKeyframeData
-                );
+                keyframes.emplace_back(kfTimestamp, std::move(timeKeyframeData));
             }
+            global::timeManager->addKeyframes(std::move(keyframes));
             break;
         }
         case datamessagestructures::Type::ScriptData: {
@@ -760,7 +764,8 @@ void ParallelPeer::sendTimeTimeline() {
     // Create a keyframe with current position and orientation of camera
     const Timeline<TimeManager::TimeKeyframeData>& timeline =
         global::timeManager->timeline();
-    std::deque<Keyframe<TimeManager::TimeKeyframeData>> keyframes = timeline.keyframes();
+    const std::vector<Keyframe<TimeManager::TimeKeyframeData>>& keyframes =
+        timeline.keyframes();
 
     datamessagestructures::TimeTimeline timelineMessage;
     timelineMessage._clear = true;
@@ -0,0 +1,186 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/labelclusters.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace openspace::labels {
+
+ClusterIndex buildClusterIndex(std::span<const glm::vec3> positions,
+                               std::span<const float> extents,
+                               uint32_t maxLabelsPerCluster)
+{
+    ghoul_assert(positions.size() == extents.size(), "Sizes must agree");
+    ghoul_assert(maxLabelsPerCluster > 0, "Clusters must be allowed to contain labels");
+
+    ClusterIndex index;
+    index.order.resize(positions.size());
+    std::iota(index.order.begin(), index.order.end(), 0);
+
+    // Recursively split the labels at the median of the longest axis of their bounding
+    // box until each part is small enough to become a cluster
+    std::vector<std::pair<uint32_t, uint32_t>> parts = {
+        { 0, static_cast<uint32_t>(positions.size()) }
+    };
+    while (!parts.empty()) {
+        const auto [begin, end] = parts.back();
+        parts.pop_back();
+        if (begin == end) {
+            continue;
+        }
+
+        glm::vec3 minimum = positions[index.order[begin]];
+        glm::vec3 maximum = minimum;
+        for (uint32_t i = begin; i < end; i++) {
+            minimum = glm::min(minimum, positions[index.order[i]]);
+            maximum = glm::max(maximum, positions[index.order[i]]);
+        }
+
+        if (end - begin <= maxLabelsPerCluster) {
+            ClusterIndex::Cluster cluster;
+            cluster.center = (glm::dvec3(minimum) + glm::dvec3(maximum)) / 2.0;
+            cluster.first = begin;
+            cluster.count = end - begin;
+            for (uint32_t i = begin; i < end; i++) {
+                const uint32_t label = index.order[i];
+                cluster.radius = std::max(
+                    cluster.radius,
+                    glm::distance(cluster.center, glm::dvec3(positions[label]))
+                );
+                cluster.maxExtent = std::max(cluster.maxExtent, extents[label]);
+            }
+            index.clusters.push_back(cluster);
+            continue;
+        }
+
+        const glm::vec3 size = maximum - minimum;
+        const int axis = (size.x >= size.y && size.x >= size.z) ? 0 :
+                         (size.y >= size.z) ? 1 : 2;
+        const uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(
+            index.order.begin() + begin,
+            index.order.begin() + middle,
+            index.order.begin() + end,
+            [&positions, axis](uint32_t lhs, uint32_t rhs) {
+                return positions[lhs][axis] < positions[rhs][axis];
+            }
+        );
+        parts.emplace_back(middle, end);
+        parts.emplace_back(begin, middle);
+    }
+
+    return index;
+}
+
+CullingInfo cullingInfo(const glm::dmat4& modelViewProjection, double scale,
+                        double lineHeight, double viewportHeight, double minSize)
+{
+    const glm::dmat4& mvp = modelViewProjection;
+    auto row = [&mvp](int i) {
+        return glm::dvec4(mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i]);
+    };
+
+    CullingInfo info;
+    info.planes = {
+        row(3) + row(0), // left
+        row(3) - row(0), // right
+        row(3) + row(1), // bottom
+        row(3) - row(1)  // top
+    };
+    for (glm::dvec4& plane : info.planes) {
+        plane /= glm::length(glm::dvec3(plane));
+    }
+    info.depthRow = row(3);
+    info.depthRowLength = glm::length(glm::dvec3(info.depthRow));
+    info.scale = scale;
+
+    info.pixelsAtUnitDepth =
+        lineHeight * scale * glm::length(glm::dvec3(row(1))) * viewportHeight / 2.0;
+    info.maxDepth =
+        minSize > 0.0 ?
+        info.pixelsAtUnitDepth / minSize :
+        std::numeric_limits<double>::infinity();
+    return info;
+}
+
+bool isLabelVisible(const CullingInfo& info, const glm::dvec3& position, float extent) {
+    const double depth = glm::dot(glm::dvec3(info.depthRow), position) + info.depthRow.w;
+    if (depth <= 0.0 || depth > info.maxDepth) {
+        return false;
+    }
+
+    const double e = extent * info.scale;
+    for (const glm::dvec4& plane : info.planes) {
+        if (glm::dot(glm::dvec3(plane), position) + plane.w < -e) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void selectLabels(const ClusterIndex& index, std::span<const glm::vec3> positions,
+                  std::span<const float> extents, const CullingInfo& info,
+                  std::vector<uint32_t>& result)
+{
+    ghoul_assert(positions.size() == index.order.size(), "Index must match positions");
+    ghoul_assert(extents.size() == index.order.size(), "Index must match extents");
+
+    result.clear();
+    for (const ClusterIndex::Cluster& cluster : index.clusters) {
+        // The depth of every label in the cluster differs from the depth of the center
+        // by at most the radius times the length of the depth row
+        const double depth =
+            glm::dot(glm::dvec3(info.depthRow), cluster.center) + info.depthRow.w;
+        const double depthRange = cluster.radius * info.depthRowLength;
+        if (depth + depthRange <= 0.0 || depth - depthRange > info.maxDepth) {
+            continue;
+        }
+
+        const double e = cluster.radius + cluster.maxExtent * info.scale;
+        bool isCulled = false;
+        for (const glm::dvec4& plane : info.planes) {
+            if (glm::dot(glm::dvec3(plane), cluster.center) + plane.w < -e) {
+                isCulled = true;
+                break;
+            }
+        }
+        if (isCulled) {
+            continue;
+        }
+
+        for (uint32_t i = cluster.first; i < cluster.first + cluster.count; i++) {
+            const uint32_t label = index.order[i];
+            if (isLabelVisible(info, glm::dvec3(positions[label]), extents[label])) {
+                result.push_back(label);
+            }
+        }
+    }
+}
+
+} // namespace openspace::labels
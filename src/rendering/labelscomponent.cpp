@@ -27,10 +27,20 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/rendering/renderengine.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
-#include <ghoul/font/fontrenderer.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/openglstatecache.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/texture.h>
+#include <ghoul/opengl/textureatlas.h>
+#include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <optional>
 
 namespace {
@@ -39,6 +49,80 @@ namespace {
     constexpr int RenderOptionFaceCamera = 0;
     constexpr int RenderOptionPositionNormal = 1;
 
+    // The maximum number of labels that are culled together as a single cluster
+    constexpr uint32_t MaxLabelsPerCluster = 64;
+
+    // Each glyph vertex consists of the label position (3), the offset of the corner
+    // from the label position (2), and the texture coordinates of the glyph (2) and of
+    // its outline (2)
+    constexpr int FloatsPerVertex = 9;
+
+    // The program and the buffers are shared between all label components, since the
+    // vertex data is recreated every frame anyway. The first component that renders
+    // creates them and, like the program for the debug spheres of the scene graph nodes,
+    // they are never freed as they are needed for the lifetime of the application
+    struct {
+        ghoul::opengl::ProgramObject* program = nullptr;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ibo = 0;
+        GLsizei nQuadsInIndexBuffer = 0;
+    } SharedRenderData;
+
+    void initializeSharedRenderData() {
+        std::unique_ptr<ghoul::opengl::ProgramObject> program =
+            openspace::global::renderEngine->buildRenderProgram(
+                "LabelsComponent",
+                absPath("${SHADERS}/core/labels_vs.glsl"),
+                absPath("${SHADERS}/core/labels_fs.glsl")
+            );
+        SharedRenderData.program = program.release();
+        SharedRenderData.program->setIgnoreUniformLocationError(
+            ghoul::opengl::ProgramObject::IgnoreError::Yes
+        );
+
+        glGenVertexArrays(1, &SharedRenderData.vao);
+        glGenBuffers(1, &SharedRenderData.vbo);
+        glGenBuffers(1, &SharedRenderData.ibo);
+
+        glBindVertexArray(SharedRenderData.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, SharedRenderData.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, SharedRenderData.ibo);
+
+        constexpr GLsizei Stride = FloatsPerVertex * sizeof(float);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, Stride, nullptr);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(
+            1,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            Stride,
+            reinterpret_cast<void*>(3 * sizeof(float))
+        );
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(
+            2,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            Stride,
+            reinterpret_cast<void*>(5 * sizeof(float))
+        );
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(
+            3,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            Stride,
+            reinterpret_cast<void*>(7 * sizeof(float))
+        );
+
+        glBindVertexArray(0);
+    }
+
     constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
         "Enabled",
         "Enabled",
@@ -237,6 +321,8 @@ void LabelsComponent::initialize() {
         ghoul::fontrendering::FontManager::Outline::Yes,
         ghoul::fontrendering::FontManager::LoadGlyphs::No
     );
+    // The text layouts depend on the font
+    _spatialIndexIsDirty = true;
 
     loadLabels();
 }
@@ -257,6 +343,7 @@ void LabelsComponent::loadLabelsFromDataset(const dataloader::Dataset& dataset,
     _labelset = dataloader::label::loadFromDataset(dataset);
 
     _createdFromDataset = true;
+    _spatialIndexIsDirty = true;
 }
 
 void LabelsComponent::loadLabels() {
@@ -275,6 +362,103 @@ void LabelsComponent::loadLabels() {
     else {
         _labelset = dataloader::label::loadFile(_labelFile);
     }
+    _spatialIndexIsDirty = true;
+}
+
+uint32_t LabelsComponent::textLayout(const std::string& text) {
+    const auto it = _textLayoutIndices.find(text);
+    if (it != _textLayoutIndices.end()) {
+        return it->second;
+    }
+
+    TextLayout layout;
+    layout.firstQuad = static_cast<uint32_t>(_glyphQuads.size());
+
+    glm::vec2 pen = glm::vec2(0.f);
+    wchar_t previous = 0;
+    for (const char c : text) {
+        if (c == '\n') {
+            pen = glm::vec2(0.f, pen.y - _font->height());
+            previous = 0;
+            continue;
+        }
+
+        const wchar_t character = static_cast<wchar_t>(static_cast<unsigned char>(c));
+        const ghoul::fontrendering::Font::Glyph* glyph = _font->glyph(character);
+        if (!glyph) {
+            continue;
+        }
+        if (previous != 0) {
+            pen.x += glyph->kerning(previous);
+        }
+
+        // Glyphs without an area, such as spaces, only move the pen
+        if (glyph->width > 0.f && glyph->height > 0.f) {
+            GlyphQuad quad;
+            quad.topLeft = pen + glm::vec2(glyph->leftBearing, glyph->topBearing);
+            quad.bottomRight = quad.topLeft + glm::vec2(glyph->width, -glyph->height);
+            quad.texCoordsTopLeft = glyph->topLeft;
+            quad.texCoordsBottomRight = glyph->bottomRight;
+            quad.outlineTexCoordsTopLeft = glyph->outlineTopLeft;
+            quad.outlineTexCoordsBottomRight = glyph->outlineBottomRight;
+            _glyphQuads.push_back(quad);
+
+            layout.extent = std::max({
+                layout.extent,
+                glm::length(quad.topLeft),
+                glm::length(quad.bottomRight),
+                glm::length(glm::vec2(quad.topLeft.x, quad.bottomRight.y)),
+                glm::length(glm::vec2(quad.bottomRight.x, quad.topLeft.y))
+            });
+        }
+
+        pen.x += glyph->horizontalAdvance;
+        previous = character;
+    }
+    layout.nQuads = static_cast<uint32_t>(_glyphQuads.size()) - layout.firstQuad;
+
+    const uint32_t index = static_cast<uint32_t>(_textLayouts.size());
+    _textLayouts.push_back(layout);
+    _textLayoutIndices[text] = index;
+    return index;
+}
+
+void LabelsComponent::buildSpatialIndex() {
+    ZoneScoped;
+
+    // The glyphs are laid out again as the font might have changed
+    _glyphQuads.clear();
+    _textLayouts.clear();
+    _textLayoutIndices.clear();
+
+    const float scale = static_cast<float>(toMeter(_unit));
+
+    const std::vector<dataloader::Labelset::Entry>& entries = _labelset.entries;
+    _labelPositions.clear();
+    _labelPositions.reserve(entries.size());
+    _labelExtents.clear();
+    _labelExtents.reserve(entries.size());
+    _labelTextLayouts.clear();
+    _labelTextLayouts.reserve(entries.size());
+    for (const dataloader::Labelset::Entry& e : entries) {
+        // Transform and scale the labels
+        const glm::vec3 transformedPos = glm::vec3(
+            _transformationMatrix * glm::dvec4(e.position, 1.0)
+        );
+        _labelPositions.push_back(glm::vec3(transformedPos * scale));
+
+        const uint32_t layout = textLayout(e.text);
+        _labelTextLayouts.push_back(layout);
+        _labelExtents.push_back(_textLayouts[layout].extent);
+    }
+
+    _clusterIndex = labels::buildClusterIndex(
+        _labelPositions,
+        _labelExtents,
+        MaxLabelsPerCluster
+    );
+
+    _spatialIndexIsDirty = false;
 }
 
 bool LabelsComponent::isReady() const {
@@ -293,45 +477,153 @@ void LabelsComponent::render(const RenderData& data,
     if (!_enabled) {
         return;
     }
-    const float scale = static_cast<float>(toMeter(_unit));
-
-    const int renderOption =
-        _faceCamera ? RenderOptionFaceCamera : RenderOptionPositionNormal;
 
-    ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
-    labelInfo.orthoRight = orthoRight;
-    labelInfo.orthoUp = orthoUp;
-    labelInfo.minSize = _minMaxSize.value().x;
-    labelInfo.maxSize = _minMaxSize.value().y;
-    labelInfo.cameraPos = data.camera.positionVec3();
-    labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
-    labelInfo.renderType = renderOption;
-    labelInfo.mvpMatrix = modelViewProjectionMatrix;
-    labelInfo.scale = pow(10.f, _size);
-    labelInfo.enableDepth = true;
-    labelInfo.enableFalseDepth = false;
+    if (_spatialIndexIsDirty || _labelPositions.size() != _labelset.entries.size()) {
+        buildSpatialIndex();
+    }
 
-    const glm::vec4 textColor = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
+    const double scale = std::pow(10.0, static_cast<double>(_size));
+    const double viewportHeight = global::windowDelegate->currentViewportSize().y;
+    const labels::CullingInfo info = labels::cullingInfo(
+        modelViewProjectionMatrix,
+        scale,
+        _font->height(),
+        viewportHeight,
+        _minMaxSize.value().x
+    );
+    labels::selectLabels(
+        _clusterIndex,
+        _labelPositions,
+        _labelExtents,
+        info,
+        _visibleLabels
+    );
 
-    for (const dataloader::Labelset::Entry& e : _labelset.entries) {
-        if (!e.isEnabled) {
+    const double maxSize = _minMaxSize.value().y;
+    _vertexData.clear();
+    for (const uint32_t label : _visibleLabels) {
+        if (!_labelset.entries[label].isEnabled) {
             continue;
         }
 
-        // Transform and scale the labels
-        const glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(e.position, 1.0)
+        // Labels that would be larger than the maximum size are scaled down to it
+        const glm::vec3& p = _labelPositions[label];
+        const double depth =
+            glm::dot(glm::dvec3(info.depthRow), glm::dvec3(p)) + info.depthRow.w;
+        const double pixels = info.pixelsAtUnitDepth / depth;
+        const float s = static_cast<float>(
+            (maxSize > 0.0 && pixels > maxSize) ? scale * maxSize / pixels : scale
         );
-        const glm::vec3 scaledPos = glm::vec3(transformedPos * scale);
-
-        ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
-            *_font,
-            scaledPos,
-            e.text,
-            textColor,
-            labelInfo
+
+        auto addVertex = [this, &p, s](glm::vec2 offset, glm::vec2 texCoords,
+                                       glm::vec2 outlineTexCoords)
+        {
+            _vertexData.insert(
+                _vertexData.end(),
+                {
+                    p.x, p.y, p.z,
+                    offset.x * s, offset.y * s,
+                    texCoords.x, texCoords.y,
+                    outlineTexCoords.x, outlineTexCoords.y
+                }
+            );
+        };
+
+        const TextLayout& layout = _textLayouts[_labelTextLayouts[label]];
+        for (uint32_t i = layout.firstQuad; i < layout.firstQuad + layout.nQuads; i++) {
+            const GlyphQuad& q = _glyphQuads[i];
+            addVertex(q.topLeft, q.texCoordsTopLeft, q.outlineTexCoordsTopLeft);
+            addVertex(
+                glm::vec2(q.topLeft.x, q.bottomRight.y),
+                glm::vec2(q.texCoordsTopLeft.x, q.texCoordsBottomRight.y),
+                glm::vec2(q.outlineTexCoordsTopLeft.x, q.outlineTexCoordsBottomRight.y)
+            );
+            addVertex(
+                q.bottomRight,
+                q.texCoordsBottomRight,
+                q.outlineTexCoordsBottomRight
+            );
+            addVertex(
+                glm::vec2(q.bottomRight.x, q.topLeft.y),
+                glm::vec2(q.texCoordsBottomRight.x, q.texCoordsTopLeft.y),
+                glm::vec2(q.outlineTexCoordsBottomRight.x, q.outlineTexCoordsTopLeft.y)
+            );
+        }
+    }
+
+    if (_vertexData.empty()) {
+        return;
+    }
+
+    if (!SharedRenderData.program) {
+        initializeSharedRenderData();
+    }
+
+    glBindVertexArray(SharedRenderData.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, SharedRenderData.vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _vertexData.size() * sizeof(float),
+        _vertexData.data(),
+        GL_STREAM_DRAW
+    );
+
+    // The index buffer only depends on the number of quads and is grown when needed
+    const GLsizei nQuads =
+        static_cast<GLsizei>(_vertexData.size() / (4 * FloatsPerVertex));
+    if (nQuads > SharedRenderData.nQuadsInIndexBuffer) {
+        const GLsizei capacity =
+            std::max(nQuads, 2 * SharedRenderData.nQuadsInIndexBuffer);
+        std::vector<GLuint> indices;
+        indices.reserve(6 * static_cast<size_t>(capacity));
+        for (GLuint i = 0; i < static_cast<GLuint>(capacity); i++) {
+            const GLuint v = 4 * i;
+            indices.insert(indices.end(), { v, v + 1, v + 2, v, v + 2, v + 3 });
+        }
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            indices.size() * sizeof(GLuint),
+            indices.data(),
+            GL_STATIC_DRAW
         );
+        SharedRenderData.nQuadsInIndexBuffer = capacity;
     }
+
+    const int renderOption =
+        _faceCamera ? RenderOptionFaceCamera : RenderOptionPositionNormal;
+    const glm::vec4 textColor = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
+
+    ghoul::opengl::ProgramObject* program = SharedRenderData.program;
+    program->activate();
+    program->setUniform("modelViewProjection", modelViewProjectionMatrix);
+    program->setUniform("renderType", renderOption);
+    program->setUniform("orthoRight", orthoRight);
+    program->setUniform("orthoUp", orthoUp);
+    program->setUniform("cameraPosition", data.camera.positionVec3());
+    program->setUniform(
+        "cameraLookUp",
+        glm::vec3(data.camera.lookUpVectorWorldSpace())
+    );
+    program->setUniform("color", textColor);
+    program->setUniform("outlineColor", glm::vec4(glm::vec3(0.f), textColor.a));
+    program->setUniform("hasOutline", _font->hasOutline());
+
+    ghoul::opengl::TextureUnit atlasUnit;
+    atlasUnit.activate();
+    _font->atlas().texture().bind();
+    program->setUniform("tex", atlasUnit);
+
+    glEnablei(GL_BLEND, 0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(false);
+
+    glDrawElements(GL_TRIANGLES, 6 * nQuads, GL_UNSIGNED_INT, nullptr);
+
+    glBindVertexArray(0);
+    program->deactivate();
+
+    global::renderEngine->openglStateCache().resetBlendState();
+    global::renderEngine->openglStateCache().resetDepthState();
 }
 
 } // namespace openspace
@@ -32,6 +32,7 @@
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -92,4 +93,14 @@ void Rotation::update(const UpdateData& data) {
     _needsUpdate = false;
 }
 
+void Rotation::matrices(std::span<const double> times,
+                        std::span<glm::dmat3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    for (size_t i = 0; i < times.size(); i++) {
+        result[i] = matrix({ {}, Time(times[i]), Time(0.0) });
+    }
+}
+
 } // namespace openspace
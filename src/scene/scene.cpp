@@ -185,6 +185,9 @@ void Scene::unregisterNode(SceneGraphNode* node) {
     }
     removePropertySubOwner(node);
     _dirtyNodeRegistry = true;
+    // Clear the hierarchy right away to not keep a dangling pointer to the node
+    _bvh.clear();
+    _dirtyBvh = true;
 }
 
 void Scene::markNodeRegistryDirty() {
@@ -196,6 +199,7 @@ void Scene::updateNodeRegistry() {
 
     sortTopologically();
     _dirtyNodeRegistry = false;
+    _dirtyBvh = true;
 }
 
 void Scene::sortTopologically() {
@@ -307,6 +311,14 @@ void Scene::update(const UpdateData& data) {
             LERRORC(e.component, e.what());
         }
     }
+
+    if (_dirtyBvh) {
+        _bvh.build(_topologicallySortedNodes);
+        _dirtyBvh = false;
+    }
+    else {
+        _bvh.refit();
+    }
 }
 
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
@@ -366,6 +378,10 @@ const std::vector<SceneGraphNode*>& Scene::allSceneGraphNodes() const {
     return _topologicallySortedNodes;
 }
 
+const SceneBvh& Scene::boundingVolumeHierarchy() const {
+    return _bvh;
+}
+
 SceneGraphNode* Scene::loadNode(const ghoul::Dictionary& nodeDictionary) {
     ZoneScoped;
 
@@ -0,0 +1,423 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scene/scenebvh.h>
+
+#include <openspace/scene/scenegraphnode.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Maximum number of scene graph nodes that are stored in a single leaf
+    constexpr uint32_t MaxLeafSize = 4;
+
+    // If the summed surface area of all bounding boxes grows beyond this factor compared
+    // to the freshly built hierarchy, it is rebuilt instead of refit
+    constexpr double RebuildSurfaceAreaFactor = 2.0;
+
+    double surfaceArea(const glm::dvec3& min, const glm::dvec3& max) {
+        const glm::dvec3 d = max - min;
+        return 2.0 * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Returns the squared distance between the point p and the axis-aligned box
+    double distanceSquared(const glm::dvec3& p, const glm::dvec3& min,
+                           const glm::dvec3& max)
+    {
+        const glm::dvec3 d = glm::max(glm::max(min - p, p - max), glm::dvec3(0.0));
+        return glm::dot(d, d);
+    }
+
+    // Returns the squared distance between the point p and the segment from p1 to p2
+    double distanceSquared(const glm::dvec3& p, const glm::dvec3& p1,
+                           const glm::dvec3& dir, double dirLength2)
+    {
+        double t = 0.0;
+        if (dirLength2 > 0.0) {
+            t = std::clamp(glm::dot(p - p1, dir) / dirLength2, 0.0, 1.0);
+        }
+        const glm::dvec3 closest = p1 + t * dir;
+        const glm::dvec3 d = p - closest;
+        return glm::dot(d, d);
+    }
+
+    // Slab test for the intersection between the ray segment `origin + t * dir` with
+    // t in [tMin, tMax] and the axis-aligned box. On success, tMin is set to the entry
+    // parameter
+    bool intersectBox(const glm::dvec3& origin, const glm::dvec3& dir,
+                      const glm::dvec3& min, const glm::dvec3& max, double& tMin,
+                      double tMax)
+    {
+        for (int i = 0; i < 3; i++) {
+            if (dir[i] == 0.0) {
+                if (origin[i] < min[i] || origin[i] > max[i]) {
+                    return false;
+                }
+                continue;
+            }
+
+            const double invDir = 1.0 / dir[i];
+            double t0 = (min[i] - origin[i]) * invDir;
+            double t1 = (max[i] - origin[i]) * invDir;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+namespace openspace {
+
+void SceneBvh::build(const std::vector<SceneGraphNode*>& nodes) {
+    ZoneScoped;
+
+    _sceneNodes = nodes;
+    _leaves.clear();
+    _leaves.reserve(nodes.size());
+    for (SceneGraphNode* node : nodes) {
+        Leaf leaf;
+        leaf.node = node;
+        updateLeaf(leaf);
+        _leaves.push_back(leaf);
+    }
+
+    _nodes.clear();
+    if (_leaves.empty()) {
+        _builtSurfaceArea = 0.0;
+        return;
+    }
+
+    // A binary tree with at least one leaf per node has less than 2n nodes
+    _nodes.reserve(2 * (_leaves.size() / MaxLeafSize + 1));
+    buildRecursive(0, static_cast<uint32_t>(_leaves.size()));
+    _builtSurfaceArea = totalSurfaceArea();
+}
+
+uint32_t SceneBvh::buildRecursive(uint32_t begin, uint32_t end) {
+    const uint32_t index = static_cast<uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+
+    if (end - begin <= MaxLeafSize) {
+        _nodes[index].firstLeaf = begin;
+        _nodes[index].nLeaves = end - begin;
+        fitNode(_nodes[index]);
+        return index;
+    }
+
+    // Split at the median along the longest axis of the box spanned by the centers
+    glm::dvec3 min = _leaves[begin].center;
+    glm::dvec3 max = _leaves[begin].center;
+    for (uint32_t i = begin + 1; i < end; i++) {
+        min = glm::min(min, _leaves[i].center);
+        max = glm::max(max, _leaves[i].center);
+    }
+    const glm::dvec3 extent = max - min;
+    int axis = 0;
+    if (extent.y > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(
+        _leaves.begin() + begin,
+        _leaves.begin() + mid,
+        _leaves.begin() + end,
+        [axis](const Leaf& lhs, const Leaf& rhs) {
+            return lhs.center[axis] < rhs.center[axis];
+        }
+    );
+
+    buildRecursive(begin, mid);
+    const uint32_t second = buildRecursive(mid, end);
+    // The vector might have been reallocated in the recursive calls
+    _nodes[index].secondChild = second;
+    fitNode(_nodes[index]);
+    return index;
+}
+
+void SceneBvh::refit() {
+    ZoneScoped;
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    for (Leaf& leaf : _leaves) {
+        updateLeaf(leaf);
+    }
+
+    // Children are always stored after their parents, so iterating backwards guarantees
+    // that the children are updated before the nodes that contain them
+    for (auto it = _nodes.rbegin(); it != _nodes.rend(); it++) {
+        fitNode(*it);
+    }
+
+    const double area = totalSurfaceArea();
+    if (area > RebuildSurfaceAreaFactor * _builtSurfaceArea) {
+        const std::vector<SceneGraphNode*> nodes = std::move(_sceneNodes);
+        build(nodes);
+    }
+}
+
+void SceneBvh::clear() {
+    _leaves.clear();
+    _nodes.clear();
+    _sceneNodes.clear();
+    _builtSurfaceArea = 0.0;
+}
+
+bool SceneBvh::isEmpty() const {
+    return _leaves.empty();
+}
+
+void SceneBvh::updateLeaf(Leaf& leaf) const {
+    ghoul_assert(leaf.node, "No scene graph node");
+
+    leaf.center = leaf.node->worldPosition();
+    leaf.radius = std::max(leaf.node->boundingSphere(), 0.0);
+    leaf.scale = glm::compMax(glm::abs(leaf.node->worldScale()));
+}
+
+void SceneBvh::fitNode(Node& node) const {
+    if (node.nLeaves > 0) {
+        const Leaf& first = _leaves[node.firstLeaf];
+        node.min = first.center;
+        node.max = first.center;
+        node.maxRadius = first.radius * first.scale;
+        node.maxScale = first.scale;
+        for (uint32_t i = node.firstLeaf + 1; i < node.firstLeaf + node.nLeaves; i++) {
+            const Leaf& leaf = _leaves[i];
+            node.min = glm::min(node.min, leaf.center);
+            node.max = glm::max(node.max, leaf.center);
+            node.maxRadius = std::max(node.maxRadius, leaf.radius * leaf.scale);
+            node.maxScale = std::max(node.maxScale, leaf.scale);
+        }
+    }
+    else {
+        // The first child is located directly after its parent
+        const Node& first = *(&node + 1);
+        const Node& second = _nodes[node.secondChild];
+        node.min = glm::min(first.min, second.min);
+        node.max = glm::max(first.max, second.max);
+        node.maxRadius = std::max(first.maxRadius, second.maxRadius);
+        node.maxScale = std::max(first.maxScale, second.maxScale);
+    }
+}
+
+double SceneBvh::totalSurfaceArea() const {
+    double area = 0.0;
+    for (const Node& node : _nodes) {
+        const glm::dvec3 r = glm::dvec3(node.maxRadius);
+        area += surfaceArea(node.min - r, node.max + r);
+    }
+    return area;
+}
+
+void SceneBvh::querySegment(const glm::dvec3& p1, const glm::dvec3& p2,
+                            double radiusScale, double minRadius,
+                            std::vector<SceneGraphNode*>& result) const
+{
+    ZoneScoped;
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    const glm::dvec3 dir = p2 - p1;
+    const double dirLength2 = glm::dot(dir, dir);
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+
+        const double r = radiusScale *
+            std::max(node.maxRadius, minRadius * node.maxScale);
+        double tMin = 0.0;
+        const glm::dvec3 rv = glm::dvec3(r);
+        if (!intersectBox(p1, dir, node.min - rv, node.max + rv, tMin, 1.0)) {
+            continue;
+        }
+
+        if (node.nLeaves == 0) {
+            stack.push_back(node.secondChild);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.firstLeaf; i < node.firstLeaf + node.nLeaves; i++) {
+            const Leaf& leaf = _leaves[i];
+            const double radius =
+                radiusScale * std::max(leaf.radius, minRadius) * leaf.scale;
+            if (distanceSquared(leaf.center, p1, dir, dirLength2) <= radius * radius) {
+                result.push_back(leaf.node);
+            }
+        }
+    }
+}
+
+SceneGraphNode* SceneBvh::nearestNode(const glm::dvec3& position,
+                                      const NodeFilter& filter) const
+{
+    ZoneScoped;
+
+    if (_nodes.empty()) {
+        return nullptr;
+    }
+
+    SceneGraphNode* best = nullptr;
+    double bestDistance2 = std::numeric_limits<double>::max();
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+
+        if (distanceSquared(position, node.min, node.max) >= bestDistance2) {
+            continue;
+        }
+
+        if (node.nLeaves == 0) {
+            // Visit the closer child first to tighten the bound as early as possible
+            const uint32_t first = index + 1;
+            const uint32_t second = node.secondChild;
+            const double d1 =
+                distanceSquared(position, _nodes[first].min, _nodes[first].max);
+            const double d2 =
+                distanceSquared(position, _nodes[second].min, _nodes[second].max);
+            if (d1 < d2) {
+                stack.push_back(second);
+                stack.push_back(first);
+            }
+            else {
+                stack.push_back(first);
+                stack.push_back(second);
+            }
+            continue;
+        }
+
+        for (uint32_t i = node.firstLeaf; i < node.firstLeaf + node.nLeaves; i++) {
+            const Leaf& leaf = _leaves[i];
+            const glm::dvec3 d = leaf.center - position;
+            const double distance2 = glm::dot(d, d);
+            if (distance2 < bestDistance2 && (!filter || filter(leaf.node))) {
+                best = leaf.node;
+                bestDistance2 = distance2;
+            }
+        }
+    }
+
+    return best;
+}
+
+SceneGraphNode* SceneBvh::intersectRay(const glm::dvec3& origin,
+                                       const glm::dvec3& direction,
+                                       const NodeFilter& filter, double* distance) const
+{
+    ZoneScoped;
+
+    if (_nodes.empty()) {
+        return nullptr;
+    }
+
+    SceneGraphNode* best = nullptr;
+    double bestT = std::numeric_limits<double>::max();
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+
+        double tMin = 0.0;
+        const glm::dvec3 r = glm::dvec3(node.maxRadius);
+        if (!intersectBox(origin, direction, node.min - r, node.max + r, tMin, bestT)) {
+            continue;
+        }
+
+        if (node.nLeaves == 0) {
+            stack.push_back(node.secondChild);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.firstLeaf; i < node.firstLeaf + node.nLeaves; i++) {
+            const Leaf& leaf = _leaves[i];
+            const double radius = leaf.radius * leaf.scale;
+            if (radius <= 0.0) {
+                continue;
+            }
+
+            // Solve |origin + t * direction - center|^2 = radius^2 for the closest t
+            const glm::dvec3 oc = origin - leaf.center;
+            const double b = glm::dot(oc, direction);
+            const double c = glm::dot(oc, oc) - radius * radius;
+            const double discriminant = b * b - c;
+            if (discriminant < 0.0) {
+                continue;
+            }
+            const double sqrtDiscriminant = std::sqrt(discriminant);
+            double t = -b - sqrtDiscriminant;
+            if (t < 0.0) {
+                // The origin is inside the sphere
+                t = -b + sqrtDiscriminant;
+                if (t < 0.0) {
+                    continue;
+                }
+                t = 0.0;
+            }
+
+            if (t < bestT && (!filter || filter(leaf.node))) {
+                best = leaf.node;
+                bestT = t;
+            }
+        }
+    }
+
+    if (best && distance) {
+        *distance = bestT;
+    }
+    return best;
+}
+
+} // namespace openspace
@@ -30,6 +30,7 @@
 #include <openspace/util/memorymanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -91,6 +92,16 @@ glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
 
+void Translation::positions(std::span<const double> times,
+                            std::span<glm::dvec3> result) const
+{
+    ghoul_assert(times.size() == result.size(), "Times and result must have same size");
+
+    for (size_t i = 0; i < times.size(); i++) {
+        result[i] = position({ {}, Time(times[i]), Time(0.0) });
+    }
+}
+
 void Translation::notifyObservers() const {
     if (_onParameterChangeCallback) {
         _onParameterChangeCallback();
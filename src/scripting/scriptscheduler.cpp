@@ -77,6 +77,20 @@ namespace {
     };
 
 #include "scriptscheduler_codegen.cpp"
+
+    using ScheduledScript = openspace::scripting::ScriptScheduler::ScheduledScript;
+
+    bool compareScriptTimes(const ScheduledScript& lhs, const ScheduledScript& rhs) {
+        return lhs.time < rhs.time;
+    }
+
+    std::string combinedScript(const std::string& universalScript,
+                               const std::string& specificScript)
+    {
+        return universalScript.empty() ?
+            specificScript :
+            universalScript + "; " + specificScript;
+    }
 } // namespace
 
 namespace openspace::scripting {
@@ -113,28 +127,72 @@ void ScriptScheduler::loadScripts(std::vector<ScheduledScript> scheduledScripts)
     std::stable_sort(
         scheduledScripts.begin(),
         scheduledScripts.end(),
-        [](const ScheduledScript& lhs, const ScheduledScript& rhs) {
-            return lhs.time < rhs.time;
-        }
+        &compareScriptTimes
     );
 
-    for (ScheduledScript& script : scheduledScripts) {
-        _scripts.push_back(std::move(script));
+    // Merge the new scripts with the existing ones. Existing scripts come first for the
+    // same time, which keeps the order in which the scripts were loaded. The backward
+    // scripts are collected in time order and reversed afterwards
+    const size_t nScripts = _scripts.size() + scheduledScripts.size();
+    std::vector<ScheduledScript> scripts;
+    scripts.reserve(nScripts);
+    std::vector<std::string> forwardScripts;
+    forwardScripts.reserve(nScripts);
+    std::vector<std::string> backwardScripts;
+    backwardScripts.reserve(nScripts);
+
+    size_t iExisting = 0;
+    size_t iNew = 0;
+    while (iExisting < _scripts.size() || iNew < scheduledScripts.size()) {
+        const bool takeNew = iExisting == _scripts.size() ||
+            (iNew < scheduledScripts.size() &&
+             scheduledScripts[iNew].time < _scripts[iExisting].time);
+
+        if (takeNew) {
+            ScheduledScript& script = scheduledScripts[iNew];
+            forwardScripts.push_back(
+                combinedScript(script.universalScript, script.forwardScript)
+            );
+            backwardScripts.push_back(
+                combinedScript(script.universalScript, script.backwardScript)
+            );
+            scripts.push_back(std::move(script));
+            iNew++;
+        }
+        else {
+            const size_t iBackward = _scripts.size() - 1 - iExisting;
+            forwardScripts.push_back(std::move(_forwardScripts[iExisting]));
+            backwardScripts.push_back(std::move(_backwardScripts[iBackward]));
+            scripts.push_back(std::move(_scripts[iExisting]));
+            iExisting++;
+        }
     }
+    std::reverse(backwardScripts.begin(), backwardScripts.end());
 
-    // Re-sort so it is always in sorted order in regards to time
-    std::stable_sort(
+    _scripts = std::move(scripts);
+    _forwardScripts = std::move(forwardScripts);
+    _backwardScripts = std::move(backwardScripts);
+
+    // Ensure _currentIndex is accurate after new scripts was added
+    updateIndices();
+}
+
+void ScriptScheduler::updateIndices() {
+    _groups.clear();
+    for (size_t i = 0; i < _scripts.size(); i++) {
+        _groups[_scripts[i].group].push_back(i);
+    }
+
+    // All scripts up to and including the current time have been passed
+    const auto it = std::upper_bound(
         _scripts.begin(),
         _scripts.end(),
-        [](const ScheduledScript& lhs, const ScheduledScript& rhs) {
-            return lhs.time < rhs.time;
+        _currentTime,
+        [](const double value, const ScheduledScript& item) {
+            return value < item.time;
         }
     );
-
-    // Ensure _currentIndex and _currentTime is accurate after new scripts was added
-    const double lastTime = _currentTime;
-    rewind();
-    progressTo(lastTime);
+    _currentIndex = static_cast<int>(std::distance(_scripts.begin(), it));
 }
 
 void ScriptScheduler::rewind() {
@@ -144,32 +202,65 @@ void ScriptScheduler::rewind() {
 
 void ScriptScheduler::clearSchedule(std::optional<int> group) {
     if (group.has_value()) {
-        for (auto it = _scripts.begin(); it < _scripts.end();) {
-            if (it->group == *group) {
-                it = _scripts.erase(it);
+        const auto it = _groups.find(*group);
+        if (it == _groups.end()) {
+            return;
+        }
+
+        // Compact all three lists in a single pass, skipping the scripts in the group
+        const std::vector<size_t>& removed = it->second;
+        const size_t nScripts = _scripts.size();
+        size_t iRemoved = 0;
+        size_t iTarget = 0;
+        for (size_t i = 0; i < nScripts; i++) {
+            if (iRemoved < removed.size() && removed[iRemoved] == i) {
+                iRemoved++;
+                continue;
             }
-            else {
-                it++;
+            if (iTarget != i) {
+                _scripts[iTarget] = std::move(_scripts[i]);
+                _forwardScripts[iTarget] = std::move(_forwardScripts[i]);
             }
+            iTarget++;
         }
+        _scripts.resize(iTarget);
+        _forwardScripts.resize(iTarget);
+
+        // The backward scripts are stored in reverse, so the removed indices are
+        // mirrored and visited in the reverse order
+        iTarget = 0;
+        size_t iRemovedBackward = removed.size();
+        for (size_t i = 0; i < nScripts; i++) {
+            const bool isRemoved = iRemovedBackward > 0 &&
+                nScripts - 1 - removed[iRemovedBackward - 1] == i;
+            if (isRemoved) {
+                iRemovedBackward--;
+                continue;
+            }
+            if (iTarget != i) {
+                _backwardScripts[iTarget] = std::move(_backwardScripts[i]);
+            }
+            iTarget++;
+        }
+        _backwardScripts.resize(iTarget);
 
-        // Ensure _currentIndex and _currentTime is accurate after scripts was removed
-        const double lastTime = _currentTime;
-        rewind();
-        progressTo(lastTime);
+        // Ensure _currentIndex is accurate after scripts was removed
+        updateIndices();
     }
     else {
         rewind();
         _scripts.clear();
+        _forwardScripts.clear();
+        _backwardScripts.clear();
+        _groups.clear();
     }
 }
 
-std::vector<std::string> ScriptScheduler::progressTo(double newTime) {
-    std::vector<std::string> result;
+std::span<const std::string> ScriptScheduler::progressTo(double newTime) {
     if (!_enabled || newTime == _currentTime || _scripts.empty()) {
         // Update the new time
         _currentTime = newTime;
-        return result;
+        return {};
     }
 
     if (newTime > _currentTime) {
@@ -192,18 +283,8 @@ std::vector<std::string> ScriptScheduler::progressTo(double newTime) {
         // Update the new time
         _currentTime = newTime;
 
-        // Construct result
-        for (auto iter = _scripts.begin() + prevIndex;
-            iter < (_scripts.begin() + _currentIndex);
-            iter++)
-        {
-            std::string script = iter->universalScript.empty() ?
-                iter->forwardScript :
-                iter->universalScript + "; " + iter->forwardScript;
-            result.push_back(std::move(script));
-        }
-
-        return result;
+        // The forward scripts are stored in time order
+        return std::span<const std::string>(_forwardScripts.data() + prevIndex, n);
     }
     else {
         // Moving backward in time; the need to find the lowest entry that is still bigger
@@ -225,22 +306,10 @@ std::vector<std::string> ScriptScheduler::progressTo(double newTime) {
         // Update the new time
         _currentTime = newTime;
 
-        // Construct result
-        const size_t startOffset = prevIndex == 0 ? prevIndex : prevIndex - 1;
-        auto start = _scripts.begin() + startOffset;
-        auto end = it;
-        for (auto iter = start; iter != _scripts.end() && iter >= end; --iter) {
-            std::string script = iter->universalScript.empty() ?
-                iter->backwardScript :
-                iter->universalScript + "; " + iter->backwardScript;
-            result.push_back(std::move(script));
-
-            if (iter == _scripts.begin()) {
-                break;
-            }
-        }
-
-        return result;
+        // The backward scripts are stored in reverse time order, so the scripts that we
+        // passed over, starting with the latest one, are a contiguous range as well
+        const size_t start = _scripts.size() - prevIndex;
+        return std::span<const std::string>(_backwardScripts.data() + start, n);
     }
 }
 
@@ -250,7 +319,7 @@ double ScriptScheduler::currentTime() const {
 
 void ScriptScheduler::setCurrentTime(double time) {
     // Ensure _currentIndex and _currentTime is accurate after time jump
-    const std::vector<std::string> scheduledScripts = progressTo(time);
+    const std::span<const std::string> scheduledScripts = progressTo(time);
 
     if (_shouldRunAllTimeJump) {
         // Queue all scripts for the time jump
@@ -263,10 +332,16 @@ void ScriptScheduler::setCurrentTime(double time) {
 std::vector<ScriptScheduler::ScheduledScript> ScriptScheduler::allScripts(
                                                            std::optional<int> group) const
 {
+    if (!group.has_value()) {
+        return _scripts;
+    }
+
     std::vector<ScheduledScript> result;
-    for (const ScheduledScript& script : _scripts) {
-        if (!group.has_value() || script.group == *group) {
-            result.push_back(script);
+    const auto it = _groups.find(*group);
+    if (it != _groups.end()) {
+        result.reserve(it->second.size());
+        for (size_t index : it->second) {
+            result.push_back(_scripts[index]);
         }
     }
     return result;
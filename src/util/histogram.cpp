@@ -27,6 +27,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <cmath>
+#include <utility>
 
 namespace {
     constexpr std::string_view _loggerCat = "Histogram";
@@ -48,10 +49,32 @@ Histogram::Histogram(float minValue, float maxValue, int numBins, float* data)
     }
 }
 
+Histogram::Histogram(Histogram&& other) noexcept
+    : _numBins(other._numBins)
+    , _minValue(other._minValue)
+    , _maxValue(other._maxValue)
+    , _data(std::exchange(other._data, nullptr))
+    , _equalizer(std::move(other._equalizer))
+    , _numValues(other._numValues)
+{}
+
 Histogram::~Histogram() {
     delete[] _data;
 }
 
+Histogram& Histogram::operator=(Histogram&& other) noexcept {
+    if (this != &other) {
+        delete[] _data;
+        _numBins = other._numBins;
+        _minValue = other._minValue;
+        _maxValue = other._maxValue;
+        _data = std::exchange(other._data, nullptr);
+        _equalizer = std::move(other._equalizer);
+        _numValues = other._numValues;
+    }
+    return *this;
+}
+
 int Histogram::numBins() const {
     return _numBins;
 }
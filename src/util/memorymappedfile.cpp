@@ -0,0 +1,213 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <utility>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^ WIN32 / !WIN32 vvv
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& file) {
+#ifdef WIN32
+    HANDLE f = CreateFileW(
+        file.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (f == INVALID_HANDLE_VALUE) {
+        throw ghoul::RuntimeError(std::format("Error opening file '{}'", file));
+    }
+    _file = f;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size)) {
+        unmap();
+        throw ghoul::RuntimeError(std::format("Error reading size of file '{}'", file));
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) {
+        // Empty files cannot be mapped, but they are still valid files
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        unmap();
+        throw ghoul::RuntimeError(std::format("Error mapping file '{}'", file));
+    }
+    _mapping = mapping;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        unmap();
+        throw ghoul::RuntimeError(std::format("Error mapping file '{}'", file));
+    }
+    _data = reinterpret_cast<const char*>(data);
+#else // ^^^ WIN32 / !WIN32 vvv
+    const int fd = open(file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw ghoul::RuntimeError(std::format("Error opening file '{}'", file));
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        close(fd);
+        throw ghoul::RuntimeError(std::format("Error reading size of file '{}'", file));
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size == 0) {
+        // Empty files cannot be mapped, but they are still valid files
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file, so we can close it right away
+    close(fd);
+    if (data == MAP_FAILED) {
+        _size = 0;
+        throw ghoul::RuntimeError(std::format("Error mapping file '{}'", file));
+    }
+    _data = reinterpret_cast<const char*>(data);
+#endif // WIN32
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    unmap();
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr))
+    , _size(std::exchange(other._size, 0))
+#ifdef WIN32
+    , _file(std::exchange(other._file, nullptr))
+    , _mapping(std::exchange(other._mapping, nullptr))
+#endif // WIN32
+{}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#ifdef WIN32
+        _file = std::exchange(other._file, nullptr);
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif // WIN32
+    }
+    return *this;
+}
+
+const char* MemoryMappedFile::data() const {
+    return _data;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+std::string_view MemoryMappedFile::view() const {
+    return _data ? std::string_view(_data, _size) : std::string_view();
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    size = std::min(size, _size - offset);
+
+#ifdef WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = {
+        .VirtualAddress = const_cast<char*>(_data + offset),
+        .NumberOfBytes = size
+    };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else // ^^^ WIN32 / !WIN32 vvv
+    // madvise requires the start of the range to be aligned to a page boundary
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset - offset % pageSize;
+    madvise(const_cast<char*>(_data + begin), size + offset - begin, MADV_WILLNEED);
+#endif // WIN32
+}
+
+void MemoryMappedFile::release(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    size = std::min(size, _size - offset);
+
+#ifdef WIN32
+    // Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(const_cast<char*>(_data + offset), size);
+#else // ^^^ WIN32 / !WIN32 vvv
+    // Only release the pages that are entirely inside the range, as the neighboring
+    // data might still be in use
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+    const size_t end = (offset + size) / pageSize * pageSize;
+    if (begin < end) {
+        madvise(const_cast<char*>(_data + begin), end - begin, MADV_DONTNEED);
+    }
+#endif // WIN32
+}
+
+void MemoryMappedFile::unmap() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping) {
+        CloseHandle(_mapping);
+    }
+    if (_file) {
+        CloseHandle(_file);
+    }
+    _file = nullptr;
+    _mapping = nullptr;
+#else // ^^^ WIN32 / !WIN32 vvv
+    if (_data) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif // WIN32
+    _data = nullptr;
+    _size = 0;
+}
+
+} // namespace openspace
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/parallelfor.h>
+
+#include <openspace/util/threadpool.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // The calling thread always takes part in the work, so one thread fewer than the
+    // hardware supports is enough to keep all cores busy
+    size_t nHelperThreads() {
+        static const size_t N = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        return N;
+    }
+
+    openspace::ThreadPool& helperPool() {
+        static openspace::ThreadPool Pool = openspace::ThreadPool(nHelperThreads());
+        return Pool;
+    }
+
+    // Shared between the calling thread and the helper tasks. The helper tasks own a
+    // reference as they might only start running after the call has already returned
+    struct State {
+        std::atomic<size_t> nextRange = 0;
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t nFinishedRanges = 0;
+        std::exception_ptr exception;
+        size_t exceptionRange = 0;
+    };
+
+    // `func` is passed as a pointer since it is only valid while a range is unclaimed
+    void processRanges(State& state, size_t n, size_t nRanges,
+                       const std::function<void(size_t, size_t, size_t)>* func)
+    {
+        while (true) {
+            const size_t range = state.nextRange.fetch_add(1);
+            if (range >= nRanges) {
+                // Once all ranges are claimed, `func` might no longer exist, so we must
+                // not touch it anymore
+                return;
+            }
+
+            std::exception_ptr exception;
+            try {
+                (*func)(range, n * range / nRanges, n * (range + 1) / nRanges);
+            }
+            catch (...) {
+                exception = std::current_exception();
+            }
+
+            const std::lock_guard lock(state.mutex);
+            if (exception && (!state.exception || range < state.exceptionRange)) {
+                state.exception = exception;
+                state.exceptionRange = range;
+            }
+            state.nFinishedRanges++;
+            if (state.nFinishedRanges == nRanges) {
+                state.finished.notify_all();
+            }
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+size_t parallelRangeCount(size_t n, size_t minItemsPerRange) {
+    const size_t nRanges = n / std::max(minItemsPerRange, size_t(1));
+    return std::clamp(nRanges, size_t(1), nHelperThreads() + 1);
+}
+
+void parallelForRanges(size_t n, size_t nRanges,
+                       const std::function<void(size_t, size_t, size_t)>& func)
+{
+    if (n == 0) {
+        return;
+    }
+    ghoul_assert(nRanges > 0, "nRanges must be positive");
+    nRanges = std::min(nRanges, n);
+
+    auto state = std::make_shared<State>();
+    const size_t nHelpers = std::min(nRanges - 1, nHelperThreads());
+    for (size_t i = 0; i < nHelpers; i++) {
+        helperPool().enqueue([state, n, nRanges, f = &func]() {
+            processRanges(*state, n, nRanges, f);
+        });
+    }
+
+    processRanges(*state, n, nRanges, &func);
+
+    std::unique_lock lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->nFinishedRanges == nRanges; });
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+} // namespace openspace
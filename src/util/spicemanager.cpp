@@ -62,6 +62,37 @@ namespace {
             default:                            throw ghoul::MissingCaseException();
         }
     }
+
+    // The SPK coverage of a single body. Consecutive queries are usually close in time,
+    // so the interval that contained the last query is checked first
+    struct SpkCoverage {
+        bool contains(double et) {
+            if (isAlwaysCovered) {
+                return true;
+            }
+            if (!intervals) {
+                return false;
+            }
+
+            const std::vector<std::pair<double, double>>& iv = *intervals;
+            if (lastInterval < iv.size() &&
+                iv[lastInterval].first < et && iv[lastInterval].second > et)
+            {
+                return true;
+            }
+            for (size_t i = 0; i < iv.size(); i++) {
+                if (iv[i].first < et && iv[i].second > et) {
+                    lastInterval = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool isAlwaysCovered = false;
+        const std::vector<std::pair<double, double>>* intervals = nullptr;
+        size_t lastInterval = 0;
+    };
 } // namespace
 
 #include "spicemanager_lua.inl"
@@ -727,6 +758,70 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     );
 }
 
+void SpiceManager::targetPositions(const std::string& target,
+                                   const std::string& observer,
+                                   const std::string& referenceFrame,
+                                   AberrationCorrection aberrationCorrection,
+                                   std::span<const double> ephemerisTimes,
+                                   std::span<glm::dvec3> positions) const
+{
+    ghoul_assert(!target.empty(), "Target is not empty");
+    ghoul_assert(!observer.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
+    ghoul_assert(
+        ephemerisTimes.size() == positions.size(),
+        "Times and positions must have the same size"
+    );
+
+    auto coverage = [this](const std::string& body) {
+        SpkCoverage c;
+        const int id = naifId(body);
+        // SOLAR SYSTEM BARYCENTER special case, implicitly included by Spice
+        c.isAlwaysCovered = (id == 0);
+        const auto it = _spkIntervals.find(id);
+        if (it != _spkIntervals.end()) {
+            c.intervals = &it->second;
+        }
+        return c;
+    };
+    SpkCoverage targetCoverage = coverage(target);
+    SpkCoverage observerCoverage = coverage(observer);
+
+    for (size_t i = 0; i < ephemerisTimes.size(); i++) {
+        const double et = ephemerisTimes[i];
+        // Only the common case of both bodies being covered is handled directly, all
+        // other cases are forwarded to the single time version that deals with missing
+        // coverage and the error reporting
+        if (targetCoverage.contains(et) && observerCoverage.contains(et)) {
+            double lightTime = 0.0;
+            spkpos_c(
+                target.c_str(),
+                et,
+                referenceFrame.c_str(),
+                aberrationCorrection,
+                observer.c_str(),
+                glm::value_ptr(positions[i]),
+                &lightTime
+            );
+            if (failed_c()) {
+                throwSpiceError(std::format(
+                    "Error getting position from '{}' to '{}' in frame '{}' at time '{}'",
+                    target, observer, referenceFrame, et
+                ));
+            }
+        }
+        else {
+            positions[i] = targetPosition(
+                target,
+                observer,
+                referenceFrame,
+                aberrationCorrection,
+                et
+            );
+        }
+    }
+}
+
 glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
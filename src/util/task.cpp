@@ -27,8 +27,10 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/factorymanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/templatefactory.h>
+#include <optional>
 
 namespace {
 
@@ -45,12 +47,35 @@ namespace {
         // valid Tasks that are available for creation (see the FactoryDocumentation for a
         // list of possible Tasks), which depends on the configration of the application
         std::string type [[codegen::annotation("A valid Task created by a factory")]];
+
+        // The name of this task, which other tasks can refer to in their Dependencies
+        std::optional<std::string> name;
+
+        // The files that are read by this task. A task that reads a file that is listed
+        // in the Outputs of another task is performed after that task
+        std::optional<std::vector<std::string>> inputs;
+
+        // The files that are written by this task. If all of these files exist and none
+        // of the Inputs is newer than them, the task is skipped
+        std::optional<std::vector<std::string>> outputs;
+
+        // The Names of other tasks that have to be finished before this task is
+        // performed
+        std::optional<std::vector<std::string>> dependencies;
     };
 #include "task_codegen.cpp"
 } // namespace
 
 namespace openspace {
 
+const Task::Scheduling& Task::scheduling() const {
+    return _scheduling;
+}
+
+void Task::setScheduling(Scheduling scheduling) {
+    _scheduling = std::move(scheduling);
+}
+
 documentation::Documentation Task::documentation() {
     return codegen::doc<Parameters>("core_task");
 }
@@ -60,6 +85,18 @@ std::unique_ptr<Task> Task::createFromDictionary(const ghoul::Dictionary& dictio
 
     ghoul::TemplateFactory<Task>* factory = FactoryManager::ref().factory<Task>();
     Task* task = factory->create(p.type, dictionary);
+    if (task) {
+        Scheduling scheduling;
+        scheduling.name = p.name.value_or("");
+        for (const std::string& input : p.inputs.value_or(std::vector<std::string>())) {
+            scheduling.inputs.push_back(absPath(input));
+        }
+        for (const std::string& output : p.outputs.value_or(std::vector<std::string>())) {
+            scheduling.outputs.push_back(absPath(output));
+        }
+        scheduling.dependencies = p.dependencies.value_or(std::vector<std::string>());
+        task->setScheduling(std::move(scheduling));
+    }
     return std::unique_ptr<Task>(task);
 }
 
@@ -0,0 +1,317 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/taskscheduler.h>
+
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace {
+    constexpr std::string_view _loggerCat = "TaskScheduler";
+
+    enum class State {
+        Performed,
+        Skipped,
+        Failed
+    };
+
+    std::string taskName(const openspace::Task& task, size_t index) {
+        const std::string& name = task.scheduling().name;
+        return name.empty() ? std::format("#{}", index + 1) : std::format("'{}'", name);
+    }
+} // namespace
+
+namespace openspace {
+
+TaskScheduler::TaskScheduler(std::vector<std::unique_ptr<Task>> tasks)
+    : _tasks(std::move(tasks))
+{
+    // The TaskLoader leaves an empty entry for every task that could not be created
+    std::erase(_tasks, nullptr);
+
+    const size_t n = _tasks.size();
+    std::map<std::string, size_t> names;
+    std::map<std::filesystem::path, size_t> producers;
+    for (size_t i = 0; i < n; i++) {
+        const Task::Scheduling& s = _tasks[i]->scheduling();
+        if (!s.name.empty() && !names.emplace(s.name, i).second) {
+            throw ghoul::RuntimeError(std::format(
+                "Multiple tasks are called '{}'", s.name
+            ));
+        }
+        for (const std::filesystem::path& output : s.outputs) {
+            if (!producers.emplace(output.lexically_normal(), i).second) {
+                throw ghoul::RuntimeError(std::format(
+                    "Multiple tasks write to '{}'", output
+                ));
+            }
+        }
+    }
+
+    std::vector<std::set<size_t>> dependencies(n);
+    for (size_t i = 0; i < n; i++) {
+        const Task::Scheduling& s = _tasks[i]->scheduling();
+        for (const std::string& dependency : s.dependencies) {
+            const auto it = names.find(dependency);
+            if (it == names.end()) {
+                throw ghoul::RuntimeError(std::format(
+                    "Task {} depends on unknown task '{}'",
+                    taskName(*_tasks[i], i), dependency
+                ));
+            }
+            dependencies[i].insert(it->second);
+        }
+        for (const std::filesystem::path& input : s.inputs) {
+            const auto it = producers.find(input.lexically_normal());
+            if (it != producers.end()) {
+                dependencies[i].insert(it->second);
+            }
+        }
+        if (dependencies[i].contains(i)) {
+            throw ghoul::RuntimeError(std::format(
+                "Task {} depends on itself", taskName(*_tasks[i], i)
+            ));
+        }
+    }
+
+    _dependents.resize(n);
+    _nDependencies.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        _nDependencies[i] = dependencies[i].size();
+        for (const size_t dependency : dependencies[i]) {
+            _dependents[dependency].push_back(i);
+        }
+    }
+
+    // Make sure that every task can be reached without passing through a cycle
+    std::vector<size_t> remaining = _nDependencies;
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < n; i++) {
+        if (remaining[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    size_t nReachable = 0;
+    while (!ready.empty()) {
+        const size_t i = ready.back();
+        ready.pop_back();
+        nReachable++;
+        for (const size_t dependent : _dependents[i]) {
+            if (--remaining[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (nReachable != n) {
+        for (size_t i = 0; i < n; i++) {
+            if (remaining[i] > 0) {
+                throw ghoul::RuntimeError(std::format(
+                    "The dependencies of task {} form a cycle", taskName(*_tasks[i], i)
+                ));
+            }
+        }
+    }
+}
+
+TaskScheduler::Result TaskScheduler::run(unsigned int nWorkers,
+                                         const Task::ProgressCallback& onProgress)
+{
+    ghoul_assert(nWorkers > 0, "Must have at least one worker");
+
+    const size_t n = _tasks.size();
+    Result result;
+    if (n == 0) {
+        return result;
+    }
+
+    std::mutex mutex;
+    std::condition_variable finishedTask;
+
+    // All of the following is guarded by the mutex
+    std::vector<size_t> remaining = _nDependencies;
+    std::vector<bool> dependencyPerformed = std::vector<bool>(n, false);
+    std::vector<bool> dependencyFailed = std::vector<bool>(n, false);
+    std::vector<float> progress = std::vector<float>(n, 0.f);
+    // Tasks whose dependencies are all finished, ordered by their position in the list
+    std::set<size_t> ready;
+    for (size_t i = 0; i < n; i++) {
+        if (remaining[i] == 0) {
+            ready.insert(i);
+        }
+    }
+    size_t nStarted = 0;
+    size_t nFinished = 0;
+
+    auto reportProgress = [&]() {
+        if (onProgress) {
+            float sum = 0.f;
+            for (const float p : progress) {
+                sum += p;
+            }
+            onProgress(sum / static_cast<float>(n));
+        }
+    };
+
+    auto finish = [&](size_t i, State state) {
+        switch (state) {
+            case State::Performed:
+                result.nPerformed++;
+                break;
+            case State::Skipped:
+                result.nSkipped++;
+                break;
+            case State::Failed:
+                result.nFailed++;
+                break;
+        }
+
+        for (const size_t dependent : _dependents[i]) {
+            if (state == State::Performed) {
+                dependencyPerformed[dependent] = true;
+            }
+            else if (state == State::Failed) {
+                dependencyFailed[dependent] = true;
+            }
+            if (--remaining[dependent] == 0) {
+                ready.insert(dependent);
+            }
+        }
+
+        progress[i] = 1.f;
+        nFinished++;
+        reportProgress();
+        finishedTask.notify_all();
+    };
+
+    auto work = [&]() {
+        std::unique_lock lock = std::unique_lock(mutex);
+        while (true) {
+            finishedTask.wait(lock, [&]() { return !ready.empty() || nFinished == n; });
+            if (nFinished == n) {
+                return;
+            }
+
+            const size_t i = *ready.begin();
+            ready.erase(ready.begin());
+            Task& task = *_tasks[i];
+
+            if (dependencyFailed[i]) {
+                LERROR(std::format(
+                    "Not performing task {} as one of its dependencies failed",
+                    taskName(task, i)
+                ));
+                finish(i, State::Failed);
+                continue;
+            }
+            if (!dependencyPerformed[i] && isUpToDate(task)) {
+                LINFO(std::format(
+                    "Skipping task {} as its outputs are up to date", taskName(task, i)
+                ));
+                finish(i, State::Skipped);
+                continue;
+            }
+
+            nStarted++;
+            LINFO(std::format(
+                "Performing task {} out of {}: {}", nStarted, n, task.description()
+            ));
+            lock.unlock();
+
+            State state = State::Performed;
+            try {
+                task.perform([&, i](float p) {
+                    const std::lock_guard guard = std::lock_guard(mutex);
+                    progress[i] = std::clamp(p, 0.f, 1.f);
+                    reportProgress();
+                });
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+                state = State::Failed;
+            }
+            catch (const std::exception& e) {
+                LERROR(e.what());
+                state = State::Failed;
+            }
+            if (state == State::Failed) {
+                LERROR(std::format("Task {} failed", taskName(task, i)));
+            }
+
+            lock.lock();
+            finish(i, state);
+        }
+    };
+
+    const size_t nThreads = std::min<size_t>(nWorkers, n);
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (size_t i = 1; i < nThreads; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return result;
+}
+
+bool TaskScheduler::isUpToDate(const Task& task) {
+    const Task::Scheduling& s = task.scheduling();
+    if (s.outputs.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::file_time_type oldestOutput = std::filesystem::file_time_type::max();
+    for (const std::filesystem::path& output : s.outputs) {
+        const std::filesystem::file_time_type time =
+            std::filesystem::last_write_time(output, ec);
+        if (ec) {
+            // The output does not exist yet
+            return false;
+        }
+        oldestOutput = std::min(oldestOutput, time);
+    }
+
+    for (const std::filesystem::path& input : s.inputs) {
+        const std::filesystem::file_time_type time =
+            std::filesystem::last_write_time(input, ec);
+        if (ec || time > oldestOutput) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace openspace
@@ -232,14 +232,13 @@ void TimeManager::preSynchronization(double dt) {
 }
 
 TimeManager::TimeKeyframeData TimeManager::interpolate(double applicationTime) {
-    const std::deque<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
+    const std::vector<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
 
-    auto firstFutureKeyframe = std::lower_bound(
-        keyframes.begin(),
-        keyframes.end(),
-        applicationTime,
-        &compareKeyframeTimeWithTime
-    );
+    const Keyframe<TimeKeyframeData>* firstFuture =
+        _timeline.firstKeyframeAfter(applicationTime, true);
+    auto firstFutureKeyframe = firstFuture ?
+        keyframes.begin() + std::distance(keyframes.data(), firstFuture) :
+        keyframes.end();
 
     const bool hasFutureKeyframes = firstFutureKeyframe != keyframes.end();
     const bool hasPastKeyframes = firstFutureKeyframe != keyframes.begin();
@@ -314,18 +313,16 @@ void TimeManager::progressTime(double dt) {
     }
 
     const double now = currentApplicationTimeForInterpolation();
-    const std::deque<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
-
-    const std::function<bool(const KeyframeBase&, double)> comparisonFunc =
-        (isPlayingBackSessionRecording()) ?
-        &compareKeyframeTimeWithTime_playbackWithFrames : &compareKeyframeTimeWithTime;
-
-    auto firstFutureKeyframe = std::lower_bound(
-        keyframes.begin(),
-        keyframes.end(),
-        now,
-        comparisonFunc
-    );
+    const std::vector<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
+
+    // When playing back a session recording, keyframes at the current time are
+    // considered to be in the past (see compareKeyframeTimeWithTime_playbackWithFrames)
+    const bool includeCurrent = !isPlayingBackSessionRecording();
+    const Keyframe<TimeKeyframeData>* firstFuture =
+        _timeline.firstKeyframeAfter(now, includeCurrent);
+    auto firstFutureKeyframe = firstFuture ?
+        keyframes.begin() + std::distance(keyframes.data(), firstFuture) :
+        keyframes.end();
 
     const bool hasFutureKeyframes = firstFutureKeyframe != keyframes.end();
     const bool hasPastKeyframes = firstFutureKeyframe != keyframes.begin();
@@ -427,6 +424,15 @@ void TimeManager::addKeyframe(double timestamp, TimeKeyframeData time) {
     _timelineChanged = true;
 }
 
+void TimeManager::addKeyframes(std::vector<std::pair<double, TimeKeyframeData>> keyframes)
+{
+    if (keyframes.empty()) {
+        return;
+    }
+    _timeline.addKeyframes(std::move(keyframes));
+    _timelineChanged = true;
+}
+
 void TimeManager::removeKeyframesAfter(double timestamp, bool inclusive) {
     const size_t nKeyframes = _timeline.nKeyframes();
     _timeline.removeKeyframesAfter(timestamp, inclusive);
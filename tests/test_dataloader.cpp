@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/data/dataloader.h>
+#include <filesystem>
+#include <vector>
+
+TEST_CASE("DataLoader: Cached File Reader", "[dataloader]") {
+    using namespace openspace::dataloader;
+
+    Dataset dataset;
+    dataset.variables = { { 0, "a" }, { 1, "b" } };
+    dataset.textures = { { 0, "texture.png" } };
+    dataset.textureDataIndex = 1;
+    dataset.maxPositionComponent = 99.f;
+    constexpr int NEntries = 100;
+    for (int i = 0; i < NEntries; i++) {
+        Dataset::Entry e;
+        e.position = glm::vec3(i, 2.f * i, 3.f * i);
+        e.data = { static_cast<float>(i), -static_cast<float>(i) };
+        if (i % 3 == 0) {
+            e.comment = "comment";
+        }
+        dataset.entries.push_back(std::move(e));
+    }
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader_cache.bin";
+    data::saveCachedFile(dataset, file);
+
+    {
+        // The reader keeps the file mapped, so it has to be closed before the removal
+        const data::CachedFileReader reader = data::CachedFileReader(file);
+        CHECK(reader.nEntries() == NEntries);
+
+        const Dataset& header = reader.header();
+        REQUIRE(header.variables.size() == 2);
+        CHECK(header.variables[1].name == "b");
+        REQUIRE(header.textures.size() == 1);
+        CHECK(header.textures[0].file == "texture.png");
+        CHECK(header.textureDataIndex == 1);
+        CHECK(header.orientationDataIndex == -1);
+        CHECK(header.maxPositionComponent == 99.f);
+        CHECK(header.entries.empty());
+
+        const std::vector<Dataset::Entry> entries = reader.readEntries(40, 20);
+        REQUIRE(entries.size() == 20);
+        for (int i = 0; i < 20; i++) {
+            const Dataset::Entry& expected = dataset.entries[40 + i];
+            CHECK(entries[i].position == expected.position);
+            CHECK(entries[i].data == expected.data);
+            CHECK(!entries[i].comment.has_value());
+        }
+    }
+
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,388 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/format.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/kepler.h>
+#include <modules/space/translation/keplertranslation.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+TEST_CASE("KeplerTranslation: Batch Positions", "[keplertranslation]") {
+    using namespace openspace;
+
+    // Eccentricities for each of the solver regimes
+    const std::vector<double> eccentricities = { 0.0, 0.1, 0.5, 0.95 };
+    for (const double eccentricity : eccentricities) {
+        KeplerTranslation translation;
+        translation.setKeplerElements(
+            eccentricity,
+            7000.0,
+            51.6,
+            120.0,
+            45.0,
+            10.0,
+            5400.0,
+            1000.0
+        );
+
+        std::vector<double> times;
+        for (int i = 0; i < 100; i++) {
+            times.push_back(1000.0 + 97.3 * i);
+        }
+        std::vector<glm::dvec3> positions(times.size());
+        translation.positions(times, positions);
+
+        for (size_t i = 0; i < times.size(); i++) {
+            const glm::dvec3 p = translation.position({ {}, Time(times[i]), Time(0.0) });
+            CHECK(positions[i].x == Catch::Approx(p.x).margin(1e-6));
+            CHECK(positions[i].y == Catch::Approx(p.y).margin(1e-6));
+            CHECK(positions[i].z == Catch::Approx(p.z).margin(1e-6));
+        }
+    }
+}
+
+namespace {
+    std::vector<openspace::kepler::Parameters> testOrbits(int n) {
+        std::vector<openspace::kepler::Parameters> result;
+        for (int i = 0; i < n; i++) {
+            openspace::kepler::Parameters p;
+            // Cycle through all of the solver regimes
+            p.eccentricity = std::vector<double>{ 0.0, 0.1, 0.5, 0.95 }[i % 4];
+            p.semiMajorAxis = 7000.0 + 10.0 * i;
+            p.inclination = std::fmod(13.0 * i, 180.0);
+            p.ascendingNode = std::fmod(29.0 * i, 360.0);
+            p.argumentOfPeriapsis = std::fmod(47.0 * i, 360.0);
+            p.meanAnomaly = std::fmod(71.0 * i, 360.0);
+            p.epoch = 1000.0 * i;
+            p.period = 5400.0 + i;
+            result.push_back(p);
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("KeplerTranslation: Orbit Positions", "[keplertranslation]") {
+    using namespace openspace;
+
+    const std::vector<kepler::Parameters> parameters = testOrbits(16);
+    const kepler::OrbitElements elements = kepler::OrbitElements(parameters);
+    REQUIRE(elements.size() == parameters.size());
+
+    // More points than a single block of the solver
+    constexpr int NPoints = 150;
+    std::vector<glm::dvec3> positions(NPoints);
+    KeplerTranslation translation;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        const kepler::Parameters& p = parameters[i];
+        translation.setKeplerElements(
+            p.eccentricity,
+            p.semiMajorAxis,
+            p.inclination,
+            p.ascendingNode,
+            p.argumentOfPeriapsis,
+            p.meanAnomaly,
+            p.period,
+            p.epoch
+        );
+        kepler::orbitPositions(elements, i, positions);
+
+        for (int j = 0; j < NPoints; j++) {
+            const double t = p.epoch + p.period * j / (NPoints - 1);
+            const glm::dvec3 ref = translation.position({ {}, Time(t), Time(0.0) });
+            // The reference subtracts the epoch from the absolute time again, so we can
+            // only expect agreement up to the precision of that time
+            CHECK(positions[j].x == Catch::Approx(ref.x).margin(1e-3));
+            CHECK(positions[j].y == Catch::Approx(ref.y).margin(1e-3));
+            CHECK(positions[j].z == Catch::Approx(ref.z).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("KeplerTranslation: Orbit Positions At Times", "[keplertranslation]") {
+    using namespace openspace;
+
+    const std::vector<kepler::Parameters> parameters = testOrbits(16);
+    const kepler::OrbitElements elements = kepler::OrbitElements(parameters);
+
+    constexpr int NPoints = 150;
+    constexpr double StartTime = 6.2e8;
+    constexpr double TimeStep = 97.5;
+    std::vector<glm::dvec3> positions(NPoints);
+    KeplerTranslation translation;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        const kepler::Parameters& p = parameters[i];
+        translation.setKeplerElements(
+            p.eccentricity,
+            p.semiMajorAxis,
+            p.inclination,
+            p.ascendingNode,
+            p.argumentOfPeriapsis,
+            p.meanAnomaly,
+            p.period,
+            p.epoch
+        );
+        kepler::orbitPositions(elements, i, StartTime, TimeStep, positions);
+
+        for (int j = 0; j < NPoints; j++) {
+            const double t = StartTime + j * TimeStep;
+            const glm::dvec3 ref = translation.position({ {}, Time(t), Time(0.0) });
+            CHECK(positions[j].x == Catch::Approx(ref.x).margin(1e-3));
+            CHECK(positions[j].y == Catch::Approx(ref.y).margin(1e-3));
+            CHECK(positions[j].z == Catch::Approx(ref.z).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("KeplerTranslation: Read TLE File", "[keplertranslation]") {
+    using namespace openspace;
+
+    constexpr std::string_view FirstLine =
+        "1 25544U 98067A   20001.50000000  .00001000  00000-0  10000-4 0  9991";
+    constexpr std::string_view SecondLine =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.49140000    10";
+
+    // Enough records for the file to be split across multiple threads
+    constexpr int NRecords = 5000;
+    const std::filesystem::path path = std::filesystem::temp_directory_path();
+    const std::filesystem::path file = path / "test_keplertranslation_read.tle";
+    {
+        std::ofstream f(file);
+        for (int i = 0; i < NRecords; i++) {
+            f << "SATELLITE " << i << "\r\n" << FirstLine << "\r\n" << SecondLine << '\n';
+        }
+    }
+
+    const std::vector<kepler::Parameters> params = kepler::readTleFile(file);
+    REQUIRE(params.size() == NRecords);
+    for (int i = 0; i < NRecords; i++) {
+        const kepler::Parameters& p = params[i];
+        CHECK(p.name == std::format("SATELLITE {}", i));
+        CHECK(p.id == "1998-67A");
+        CHECK(p.inclination == Catch::Approx(51.6416));
+        CHECK(p.ascendingNode == Catch::Approx(247.4627));
+        CHECK(p.eccentricity == Catch::Approx(0.0006703));
+        CHECK(p.argumentOfPeriapsis == Catch::Approx(130.536));
+        CHECK(p.meanAnomaly == Catch::Approx(325.0288));
+        CHECK(p.period == Catch::Approx(86400.0 / 15.4914));
+        CHECK(p.epoch == params.front().epoch);
+    }
+
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("KeplerTranslation: Read OMM File", "[keplertranslation]") {
+    using namespace openspace;
+
+    // Enough records for the file to be split across multiple threads
+    constexpr int NRecords = 2000;
+    const std::filesystem::path path = std::filesystem::temp_directory_path();
+    const std::filesystem::path file = path / "test_keplertranslation_read.omm";
+    {
+        std::ofstream f(file);
+        for (int i = 0; i < NRecords; i++) {
+            f << "CCSDS_OMM_VERS = 2.0\n"
+              << "OBJECT_NAME = SATELLITE " << i << "\r\n"
+              << "OBJECT_ID = 1998-067A\n"
+              << "EPOCH = 2020-01-01T12:00:00.000000\n"
+              << "MEAN_MOTION = 15.4914\n"
+              << "ECCENTRICITY = .0006703\n"
+              << "INCLINATION = 51.6416\n"
+              << "RA_OF_ASC_NODE = 247.4627\n"
+              << "ARG_OF_PERICENTER = 130.5360\n"
+              << "MEAN_ANOMALY = 325.0288\n"
+              << '\n';
+        }
+    }
+
+    const std::vector<kepler::Parameters> params = kepler::readOmmFile(file);
+    REQUIRE(params.size() == NRecords);
+    for (int i = 0; i < NRecords; i++) {
+        const kepler::Parameters& p = params[i];
+        CHECK(p.name == std::format("SATELLITE {}", i));
+        CHECK(p.id == "1998-067A");
+        CHECK(p.inclination == Catch::Approx(51.6416));
+        CHECK(p.ascendingNode == Catch::Approx(247.4627));
+        CHECK(p.eccentricity == Catch::Approx(0.0006703));
+        CHECK(p.argumentOfPeriapsis == Catch::Approx(130.536));
+        CHECK(p.meanAnomaly == Catch::Approx(325.0288));
+        CHECK(p.period == Catch::Approx(86400.0 / 15.4914));
+        CHECK(p.epoch == params.front().epoch);
+    }
+
+    std::filesystem::remove(file);
+}
+
+namespace {
+    // Writes a JPL SBDB file with `nRecords` records that only differ in their names
+    void writeSbdbFile(const std::filesystem::path& file, int nRecords) {
+        std::ofstream f(file);
+        f << "full_name,epoch_cal,e,a,i,om,w,ma,per\n";
+        for (int i = 0; i < nRecords; i++) {
+            f << "  ASTEROID " << i
+              << ",2020-01-01.5,0.0785,2.7658,10.588,-80.0,73.638,352.23,1681.6\n";
+        }
+    }
+
+    void checkSbdbParameters(const std::vector<openspace::kepler::Parameters>& params,
+                             int nRecords)
+    {
+        REQUIRE(params.size() == static_cast<size_t>(nRecords));
+        for (int i = 0; i < nRecords; i++) {
+            const openspace::kepler::Parameters& p = params[i];
+            CHECK(p.name == std::format("ASTEROID {}", i));
+            CHECK(p.id.empty());
+            CHECK(p.eccentricity == Catch::Approx(0.0785));
+            CHECK(p.semiMajorAxis == Catch::Approx(2.7658 * 1.496e8));
+            CHECK(p.inclination == Catch::Approx(10.588));
+            CHECK(p.ascendingNode == Catch::Approx(280.0));
+            CHECK(p.argumentOfPeriapsis == Catch::Approx(73.638));
+            CHECK(p.meanAnomaly == Catch::Approx(352.23));
+            CHECK(p.period == Catch::Approx(1681.6 * 86400.0));
+            CHECK(p.epoch == params.front().epoch);
+        }
+    }
+} // namespace
+
+TEST_CASE("KeplerTranslation: Read SBDB File", "[keplertranslation]") {
+    using namespace openspace;
+
+    constexpr int NRecords = 2000;
+    const std::filesystem::path path = std::filesystem::temp_directory_path();
+    const std::filesystem::path file = path / "test_keplertranslation_read.csv";
+    writeSbdbFile(file, NRecords);
+
+    checkSbdbParameters(kepler::readSbdbFile(file), NRecords);
+
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("KeplerTranslation: Cache Round Trip", "[keplertranslation]") {
+    using namespace openspace;
+
+    constexpr int NRecords = 2000;
+    const std::filesystem::path path = std::filesystem::temp_directory_path();
+    const std::filesystem::path file = path / "test_keplertranslation_cache.csv";
+    writeSbdbFile(file, NRecords);
+    const std::filesystem::path cache = FileSys.cacheManager()->cachedFilename(file);
+    std::filesystem::remove(cache);
+
+    // The first read parses the file and creates the cache, the second loads the cache
+    const std::vector<kepler::Parameters> parsed =
+        kepler::readFile(file, kepler::Format::SBDB);
+    checkSbdbParameters(parsed, NRecords);
+    REQUIRE(std::filesystem::is_regular_file(cache));
+
+    const std::vector<kepler::Parameters> cached =
+        kepler::readFile(file, kepler::Format::SBDB);
+    REQUIRE(cached.size() == parsed.size());
+    for (size_t i = 0; i < parsed.size(); i++) {
+        CHECK(cached[i].name == parsed[i].name);
+        CHECK(cached[i].id == parsed[i].id);
+        CHECK(cached[i].inclination == parsed[i].inclination);
+        CHECK(cached[i].semiMajorAxis == parsed[i].semiMajorAxis);
+        CHECK(cached[i].ascendingNode == parsed[i].ascendingNode);
+        CHECK(cached[i].eccentricity == parsed[i].eccentricity);
+        CHECK(cached[i].argumentOfPeriapsis == parsed[i].argumentOfPeriapsis);
+        CHECK(cached[i].meanAnomaly == parsed[i].meanAnomaly);
+        CHECK(cached[i].epoch == parsed[i].epoch);
+        CHECK(cached[i].period == parsed[i].period);
+    }
+
+    // A header whose record count makes the computed file size wrap around to the actual
+    // size must be rejected, after which the original file is parsed again
+    {
+        std::ofstream f(cache, std::ofstream::binary | std::ofstream::trunc);
+        const int8_t version = 2;
+        const std::array<uint8_t, 7> padding = {};
+        const uint64_t nRecords = uint64_t(1) << 60;
+        const uint64_t stringsSize = 0;
+        f.write(reinterpret_cast<const char*>(&version), sizeof(int8_t));
+        f.write(reinterpret_cast<const char*>(padding.data()), padding.size());
+        f.write(reinterpret_cast<const char*>(&nRecords), sizeof(uint64_t));
+        f.write(reinterpret_cast<const char*>(&stringsSize), sizeof(uint64_t));
+    }
+    checkSbdbParameters(kepler::readFile(file, kepler::Format::SBDB), NRecords);
+
+    std::filesystem::remove(cache);
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("KeplerTranslation: Benchmark", "[keplertranslation][.benchmark]") {
+    using namespace openspace;
+
+    const std::vector<kepler::Parameters> parameters = testOrbits(1000);
+    constexpr int NPoints = 40;
+    std::vector<glm::dvec3> positions(NPoints);
+
+    BENCHMARK("KeplerTranslation") {
+        KeplerTranslation translation;
+        double sum = 0.0;
+        for (const kepler::Parameters& p : parameters) {
+            translation.setKeplerElements(
+                p.eccentricity,
+                p.semiMajorAxis,
+                p.inclination,
+                p.ascendingNode,
+                p.argumentOfPeriapsis,
+                p.meanAnomaly,
+                p.period,
+                p.epoch
+            );
+            for (int j = 0; j < NPoints; j++) {
+                const double t = p.epoch + p.period * j / (NPoints - 1);
+                sum += translation.position({ {}, Time(t), Time(0.0) }).x;
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("OrbitElements") {
+        const kepler::OrbitElements elements = kepler::OrbitElements(parameters);
+        double sum = 0.0;
+        for (size_t i = 0; i < elements.size(); i++) {
+            kepler::orbitPositions(elements, i, positions);
+            sum += positions.front().x;
+        }
+        return sum;
+    };
+}
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/rendering/labelclusters.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+    struct Labels {
+        std::vector<glm::vec3> positions;
+        std::vector<float> extents;
+    };
+
+    // A uniformly distributed cube of labels with extents that correspond to texts
+    // between a single character and a few words
+    Labels createLabels(size_t nLabels) {
+        std::mt19937 random = std::mt19937(1337);
+        std::uniform_real_distribution<float> position(-5000.f, 5000.f);
+        std::uniform_real_distribution<float> extent(10.f, 400.f);
+
+        Labels catalog;
+        catalog.positions.reserve(nLabels);
+        catalog.extents.reserve(nLabels);
+        for (size_t i = 0; i < nLabels; i++) {
+            catalog.positions.emplace_back(
+                position(random),
+                position(random),
+                position(random)
+            );
+            catalog.extents.push_back(extent(random));
+        }
+        return catalog;
+    }
+
+    // A modelViewProjection matrix for a camera at the provided position that looks
+    // along the negative z axis with a field of view of 90 degrees
+    glm::dmat4 modelViewProjection(const glm::dvec3& cameraPosition) {
+        const glm::dmat4 projection = glm::dmat4(
+            1.0, 0.0, 0.0, 0.0,
+            0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, 0.0, -1.0,
+            0.0, 0.0, 0.0, 0.0
+        );
+        glm::dmat4 view = glm::dmat4(1.0);
+        view[3] = glm::dvec4(-cameraPosition, 1.0);
+        return projection * view;
+    }
+} // namespace
+
+TEST_CASE("LabelClusters: Index", "[labelclusters]") {
+    using namespace openspace;
+
+    const Labels catalog = createLabels(10000);
+    const labels::ClusterIndex index =
+        labels::buildClusterIndex(catalog.positions, catalog.extents, 64);
+
+    // Every label has to be part of exactly one cluster
+    REQUIRE(index.order.size() == catalog.positions.size());
+    std::vector<uint32_t> order = index.order;
+    std::sort(order.begin(), order.end());
+    for (size_t i = 0; i < order.size(); i++) {
+        REQUIRE(order[i] == i);
+    }
+
+    uint32_t next = 0;
+    for (const labels::ClusterIndex::Cluster& cluster : index.clusters) {
+        CHECK(cluster.first == next);
+        CHECK(cluster.count > 0);
+        CHECK(cluster.count <= 64);
+        next = cluster.first + cluster.count;
+
+        for (uint32_t i = cluster.first; i < cluster.first + cluster.count; i++) {
+            const uint32_t label = index.order[i];
+            const glm::dvec3 p = glm::dvec3(catalog.positions[label]);
+            CHECK(glm::distance(cluster.center, p) <= cluster.radius);
+            CHECK(catalog.extents[label] <= cluster.maxExtent);
+        }
+    }
+    CHECK(next == catalog.positions.size());
+}
+
+TEST_CASE("LabelClusters: Selection", "[labelclusters]") {
+    using namespace openspace;
+
+    const Labels catalog = createLabels(50000);
+    const labels::ClusterIndex index =
+        labels::buildClusterIndex(catalog.positions, catalog.extents);
+
+    constexpr double LineHeight = 60.0;
+    constexpr double ViewportHeight = 1080.0;
+    const std::vector<glm::dvec3> cameraPositions = {
+        glm::dvec3(0.0),
+        glm::dvec3(1500.0, -2000.0, 4000.0),
+        glm::dvec3(-8000.0, 0.0, 0.0),
+        glm::dvec3(0.0, 0.0, 9000.0)
+    };
+    const std::vector<double> scales = { 1.0, 5.0 };
+    const std::vector<double> minSizes = { 0.0, 8.0, 50.0 };
+
+    size_t nVisible = 0;
+    size_t nCulled = 0;
+    std::vector<uint32_t> selected;
+    for (const glm::dvec3& camera : cameraPositions) {
+        for (double scale : scales) {
+            for (double minSize : minSizes) {
+                const labels::CullingInfo info = labels::cullingInfo(
+                    modelViewProjection(camera),
+                    scale,
+                    LineHeight,
+                    ViewportHeight,
+                    minSize
+                );
+                labels::selectLabels(
+                    index,
+                    catalog.positions,
+                    catalog.extents,
+                    info,
+                    selected
+                );
+                std::sort(selected.begin(), selected.end());
+
+                // Brute force: A label is visible if it is in front of the camera, if
+                // its line height is at least the minimum size in pixels, and if the
+                // sphere of its extent intersects any of the side planes of the frustum
+                std::vector<uint32_t> visible;
+                for (uint32_t i = 0; i < catalog.positions.size(); i++) {
+                    const glm::dvec3 p = glm::dvec3(catalog.positions[i]) - camera;
+                    const double depth = -p.z;
+                    const double slack = catalog.extents[i] * scale * std::sqrt(2.0);
+                    const bool isInFrustum =
+                        depth > 0.0 &&
+                        depth + p.x >= -slack && depth - p.x >= -slack &&
+                        depth + p.y >= -slack && depth - p.y >= -slack;
+                    const double pixels =
+                        LineHeight * scale * ViewportHeight / (2.0 * depth);
+                    if (isInFrustum && pixels >= minSize) {
+                        visible.push_back(i);
+                    }
+                }
+
+                CHECK(selected == visible);
+                nVisible += visible.size();
+                nCulled += catalog.positions.size() - visible.size();
+            }
+        }
+    }
+    CHECK(nVisible > 0);
+    CHECK(nCulled > 0);
+}
+
+TEST_CASE("LabelClusters: Benchmark", "[labelclusters][.benchmark]") {
+    using namespace openspace;
+
+    const Labels catalog = createLabels(1000000);
+    const labels::ClusterIndex index =
+        labels::buildClusterIndex(catalog.positions, catalog.extents);
+    const labels::CullingInfo info = labels::cullingInfo(
+        modelViewProjection(glm::dvec3(0.0)),
+        0.1,
+        60.0,
+        1080.0,
+        8.0
+    );
+
+    std::vector<uint32_t> selected;
+    BENCHMARK("Selection") {
+        labels::selectLabels(index, catalog.positions, catalog.extents, info, selected);
+        return selected.size();
+    };
+}
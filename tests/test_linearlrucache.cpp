@@ -0,0 +1,88 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/volume/linearlrucache.h>
+#include <memory>
+
+using openspace::volume::LinearLruCache;
+
+TEST_CASE("LinearLruCache: Set and Get", "[linearlrucache]") {
+    LinearLruCache<int> cache(2, 4);
+    CHECK_FALSE(cache.has(0));
+    cache.set(0, 10);
+    cache.set(3, 13);
+    CHECK(cache.has(0));
+    CHECK(cache.has(3));
+    CHECK_FALSE(cache.has(1));
+    CHECK(cache.get(0) == 10);
+    CHECK(cache.get(3) == 13);
+    CHECK(cache.size() == 2);
+}
+
+TEST_CASE("LinearLruCache: Evicts Least Recently Used", "[linearlrucache]") {
+    LinearLruCache<int> cache(2, 4);
+    cache.set(0, 10);
+    cache.set(1, 11);
+    cache.set(2, 12);
+    CHECK_FALSE(cache.has(0));
+    CHECK(cache.has(1));
+    CHECK(cache.has(2));
+
+    // Using a key makes it the most recently used one
+    CHECK(cache.use(1) == 11);
+    cache.set(3, 13);
+    CHECK(cache.has(1));
+    CHECK_FALSE(cache.has(2));
+    CHECK(cache.has(3));
+
+    // Setting a cached key replaces the value and makes it the most recently used one
+    cache.set(1, 21);
+    cache.set(0, 20);
+    CHECK(cache.get(1) == 21);
+    CHECK_FALSE(cache.has(3));
+    CHECK(cache.size() == 2);
+}
+
+TEST_CASE("LinearLruCache: Evict Releases Value", "[linearlrucache]") {
+    LinearLruCache<std::shared_ptr<int>> cache(3, 3);
+    std::shared_ptr<int> value = std::make_shared<int>(5);
+    cache.set(0, value);
+    cache.set(1, std::make_shared<int>(6));
+    CHECK(value.use_count() == 2);
+
+    cache.evict();
+    CHECK_FALSE(cache.has(0));
+    CHECK(value.use_count() == 1);
+    CHECK(cache.size() == 1);
+
+    cache.evict();
+    CHECK(cache.size() == 0);
+
+    // The cache is fully usable again after being emptied
+    cache.set(2, value);
+    CHECK(cache.has(2));
+    CHECK(*cache.use(2) == 5);
+}
@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/parallelfor.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace openspace;
+
+TEST_CASE("ParallelFor: Range Count", "[parallelfor]") {
+    const size_t maxRanges = parallelRangeCount(std::numeric_limits<size_t>::max(), 1);
+    CHECK(maxRanges >= 1);
+
+    CHECK(parallelRangeCount(0, 16) == 1);
+    CHECK(parallelRangeCount(15, 16) == 1);
+    CHECK(parallelRangeCount(32, 16) == std::min<size_t>(2, maxRanges));
+    CHECK(parallelRangeCount(100, 0) == std::min<size_t>(100, maxRanges));
+}
+
+TEST_CASE("ParallelFor: Ranges Cover Items", "[parallelfor]") {
+    constexpr size_t N = 1001;
+    constexpr size_t NRanges = 37;
+
+    std::vector<int> visits(N, 0);
+    std::vector<std::pair<size_t, size_t>> ranges(NRanges, { N, N });
+    parallelForRanges(N, NRanges, [&](size_t range, size_t begin, size_t end) {
+        ranges[range] = { begin, end };
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+    for (size_t r = 0; r < NRanges; r++) {
+        CHECK(ranges[r].first == N * r / NRanges);
+        CHECK(ranges[r].second == N * (r + 1) / NRanges);
+    }
+}
+
+TEST_CASE("ParallelFor: Empty And Small", "[parallelfor]") {
+    bool wasCalled = false;
+    parallelForRanges(0, 4, [&](size_t, size_t, size_t) { wasCalled = true; });
+    CHECK_FALSE(wasCalled);
+
+    // More ranges than items are reduced to one range per item
+    std::vector<size_t> rangeSizes(3, 0);
+    std::atomic<size_t> nCalls = 0;
+    parallelForRanges(3, 10, [&](size_t range, size_t begin, size_t end) {
+        REQUIRE(range < 3);
+        rangeSizes[range] = end - begin;
+        nCalls++;
+    });
+    CHECK(nCalls == 3);
+    CHECK(rangeSizes == std::vector<size_t>{ 1, 1, 1 });
+}
+
+TEST_CASE("ParallelFor: Items", "[parallelfor]") {
+    constexpr size_t N = 100000;
+    std::vector<size_t> values(N, 0);
+    parallelFor(N, 128, [&values](size_t i) { values[i] = i * i; });
+
+    for (size_t i = 0; i < N; i++) {
+        REQUIRE(values[i] == i * i);
+    }
+}
+
+TEST_CASE("ParallelFor: Nested", "[parallelfor]") {
+    // Nested calls must not deadlock even if all helper threads are busy with the outer
+    // loop, since each caller takes part in the work of its own loop
+    constexpr size_t N = 64;
+    std::vector<size_t> sums(N, 0);
+    parallelFor(N, 1, [&sums](size_t i) {
+        std::vector<size_t> values(1000);
+        parallelFor(values.size(), 1, [&values, i](size_t j) { values[j] = i + j; });
+        sums[i] = std::accumulate(values.begin(), values.end(), size_t(0));
+    });
+
+    for (size_t i = 0; i < N; i++) {
+        CHECK(sums[i] == 1000 * i + 999 * 1000 / 2);
+    }
+}
+
+TEST_CASE("ParallelFor: Exceptions", "[parallelfor]") {
+    constexpr size_t NRanges = 16;
+    std::atomic<size_t> nProcessed = 0;
+    bool hasThrown = false;
+    try {
+        parallelForRanges(NRanges, NRanges, [&](size_t range, size_t, size_t) {
+            nProcessed++;
+            if (range == 5 || range == 11) {
+                throw std::runtime_error(std::to_string(range));
+            }
+        });
+    }
+    catch (const std::runtime_error& e) {
+        hasThrown = true;
+        // The exception of the lowest range is rethrown
+        CHECK(std::string(e.what()) == "5");
+    }
+    CHECK(hasThrown);
+    // All other ranges are still processed
+    CHECK(nProcessed == NRanges);
+}
@@ -24,13 +24,21 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/voxelevaluation.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timeline.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/exception.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 TEST_CASE("RawVolumeIO: TinyInputOutput", "[rawvolumeio]") {
     using namespace openspace::volume;
@@ -82,3 +90,190 @@ TEST_CASE("RawVolumeIO: BasicInputOutput", "[rawvolumeio]") {
         CHECK(v == value(x));
     });
 }
+
+TEST_CASE("RawVolumeIO: RandomAccess", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims = glm::uvec3(5, 7, 9);
+    auto value = [dims](const glm::uvec3& v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    RawVolume<float> vol(dims);
+    vol.forEachVoxel(
+        [&vol, &value](const glm::uvec3& x, float) { vol.set(x, value(x)); }
+    );
+
+    const std::filesystem::path volumePath = absPath("${TESTDIR}/randomvolume.rawvolume");
+    RawVolumeWriter<float> writer(volumePath);
+    writer.write(vol);
+
+    RawVolumeReader<float> reader(volumePath, dims);
+    CHECK(reader.get(glm::uvec3(3, 4, 5)) == value(glm::uvec3(3, 4, 5)));
+
+    const std::unique_ptr<RawVolume<float>> inverted = reader.read(true);
+    CHECK(inverted->get(glm::uvec3(1, 2, 0)) == value(glm::uvec3(1, 2, 8)));
+
+    const std::unique_ptr<RawVolume<float>> box = reader.readBox(
+        glm::uvec3(1, 2, 3),
+        glm::uvec3(4, 5, 6),
+        glm::uvec3(2, 2, 3)
+    );
+    REQUIRE(box->dimensions() == glm::uvec3(2, 3, 2));
+    box->forEachVoxel([&value](const glm::uvec3& x, float v) {
+        CHECK(v == value(glm::uvec3(1, 2, 3) + x * glm::uvec3(2, 2, 3)));
+    });
+
+    const std::unique_ptr<RawVolume<float>> slice = reader.readSlice(4);
+    REQUIRE(slice->dimensions() == glm::uvec3(5, 7, 1));
+    CHECK(slice->get(glm::uvec3(2, 3, 0)) == value(glm::uvec3(2, 3, 4)));
+
+    const std::unique_ptr<RawVolume<float>> downsampled =
+        reader.readDownsampled(glm::uvec3(2));
+    REQUIRE(downsampled->dimensions() == glm::uvec3(3, 4, 5));
+    CHECK(downsampled->get(glm::uvec3(2, 3, 4)) == value(glm::uvec3(4, 6, 8)));
+
+    const std::unique_ptr<MappedRawVolume<float>> mapped = reader.map();
+    for (size_t i = 0; i < mapped->nCells(); i++) {
+        CHECK(mapped->get(i) == value(mapped->indexToCoords(i)));
+    }
+
+    CHECK_THROWS(reader.readBox(glm::uvec3(4, 0, 0), glm::uvec3(2, 1, 1)));
+    CHECK_THROWS(RawVolumeReader<float>(volumePath, glm::uvec3(10)).map());
+
+    // The first random access of a new reader can happen on multiple threads at once
+    const RawVolumeReader<float> sharedReader(volumePath, dims);
+    std::vector<std::thread> threads;
+    std::vector<int> nMismatches(4, 0);
+    for (size_t t = 0; t < nMismatches.size(); t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < mapped->nCells(); i++) {
+                if (sharedReader.get(i) != value(mapped->indexToCoords(i))) {
+                    nMismatches[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(nMismatches == std::vector<int>(nMismatches.size(), 0));
+}
+
+TEST_CASE("RawVolumeIO: Streaming Write", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims = glm::uvec3(3, 4, 5);
+    std::vector<float> values(60);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<float>(i);
+    }
+    const std::span<const float> v = values;
+
+    const std::filesystem::path volumePath = absPath("${TESTDIR}/streamvolume.rawvolume");
+    RawVolumeWriter<float> writer(volumePath);
+    writer.begin(dims);
+    writer.append(v.subspan(0, 7));
+    writer.append(v.subspan(7));
+    writer.finish();
+
+    RawVolumeReader<float> reader(volumePath, dims);
+    const std::unique_ptr<RawVolume<float>> volume = reader.read();
+    for (size_t i = 0; i < values.size(); i++) {
+        CHECK(volume->data()[i] == values[i]);
+    }
+
+    writer.begin(dims);
+    CHECK_THROWS_AS(writer.append(std::vector<float>(61)), ghoul::RuntimeError);
+    writer.append(v.subspan(0, 59));
+    CHECK_THROWS_AS(writer.finish(), ghoul::RuntimeError);
+}
+
+TEST_CASE("RawVolumeIO: Evaluate Voxels", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    // Large enough to be split into multiple batches
+    const glm::uvec3 dims = glm::uvec3(101, 103, 107);
+    auto value = [dims](const glm::uvec3& v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    struct State {
+        std::atomic_bool isInUse = false;
+    };
+    using StatePtr = std::unique_ptr<State>;
+
+    for (const unsigned int nThreads : { 0u, 1u, 3u }) {
+        size_t nStates = 0;
+        auto createState = [&nStates]() {
+            nStates++;
+            return std::make_unique<State>();
+        };
+        // A state must never be used by two threads at the same time
+        std::atomic_bool wasStateShared = false;
+        auto evaluate = [&](StatePtr& state, const glm::uvec3& cell) {
+            if (state->isInUse.exchange(true)) {
+                wasStateShared = true;
+            }
+            const float v = value(cell);
+            state->isInUse = false;
+            return v;
+        };
+
+        const std::filesystem::path volumePath =
+            absPath("${TESTDIR}/evaluatedvolume.rawvolume");
+        RawVolumeWriter<float> writer(volumePath);
+        writer.begin(dims);
+        size_t nextVoxel = 0;
+        float lastProgress = 0.f;
+        evaluateVoxels<float, StatePtr>(
+            dims,
+            createState,
+            evaluate,
+            [&](size_t first, std::span<const float> values) {
+                // The batches have to arrive in file order
+                CHECK(first == nextVoxel);
+                nextVoxel += values.size();
+                writer.append(values);
+            },
+            [&lastProgress](float progress) {
+                CHECK(progress >= lastProgress);
+                lastProgress = progress;
+            },
+            nThreads
+        );
+        writer.finish();
+        CHECK(lastProgress == 1.f);
+        CHECK(nStates > 0);
+        if (nThreads > 0) {
+            CHECK(nStates == nThreads);
+        }
+        CHECK_FALSE(wasStateShared);
+
+        RawVolumeReader<float> reader(volumePath, dims);
+        const std::unique_ptr<RawVolume<float>> volume = reader.read();
+        size_t nMismatches = 0;
+        volume->forEachVoxel([&](const glm::uvec3& x, float v) {
+            if (v != value(x)) {
+                nMismatches++;
+            }
+        });
+        CHECK(nMismatches == 0);
+    }
+
+    // Errors in the evaluation are passed on to the caller
+    CHECK_THROWS_AS(
+        (evaluateVoxels<float, int>(
+            dims,
+            []() { return 0; },
+            [](int&, const glm::uvec3& cell) {
+                if (cell == glm::uvec3(50, 60, 70)) {
+                    throw std::runtime_error("Evaluation failed");
+                }
+                return 0.f;
+            },
+            [](size_t, std::span<const float>) {}
+        )),
+        std::runtime_error
+    );
+}
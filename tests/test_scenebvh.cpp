@@ -0,0 +1,328 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/scene/scenebvh.h>
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    // A handful of nodes at random positions with random bounding spheres. The number of
+    // nodes is big enough to result in a hierarchy with multiple levels
+    struct TestScene {
+        explicit TestScene(size_t nNodes) {
+            std::mt19937 random(1337);
+            std::uniform_real_distribution<double> position(-100.0, 100.0);
+            std::uniform_real_distribution<double> radius(0.5, 10.0);
+            std::uniform_real_distribution<double> scale(0.5, 2.0);
+
+            for (size_t i = 0; i < nNodes; i++) {
+                ghoul::Dictionary translation;
+                translation.setValue("Type", std::string("StaticTranslation"));
+                translation.setValue(
+                    "Position",
+                    glm::dvec3(position(random), position(random), position(random))
+                );
+                ghoul::Dictionary scaling;
+                scaling.setValue("Type", std::string("StaticScale"));
+                scaling.setValue("Scale", scale(random));
+                ghoul::Dictionary transform;
+                transform.setValue("Translation", translation);
+                transform.setValue("Scale", scaling);
+
+                ghoul::Dictionary dictionary;
+                dictionary.setValue("Identifier", "BvhNode" + std::to_string(i));
+                dictionary.setValue("BoundingSphere", radius(random));
+                dictionary.setValue("Transform", transform);
+
+                ghoul::mm_unique_ptr<SceneGraphNode> node =
+                    SceneGraphNode::createFromDictionary(dictionary);
+                node->initialize();
+                pointers.push_back(node.get());
+                nodes.push_back(std::move(node));
+            }
+            update();
+        }
+
+        ~TestScene() {
+            for (ghoul::mm_unique_ptr<SceneGraphNode>& node : nodes) {
+                node->deinitialize();
+            }
+        }
+
+        void update() {
+            const UpdateData data = { TransformData(), Time(0.0), Time(0.0) };
+            for (SceneGraphNode* node : pointers) {
+                node->update(data);
+            }
+        }
+
+        void move(size_t index, const glm::dvec3& position) {
+            properties::Property* p = pointers[index]->property("Translation.Position");
+            REQUIRE(p);
+            p->set(position);
+        }
+
+        std::vector<ghoul::mm_unique_ptr<SceneGraphNode>> nodes;
+        std::vector<SceneGraphNode*> pointers;
+    };
+
+    // The world space radius of a node in the same way as it is used by the hierarchy
+    double worldRadius(const SceneGraphNode* node, double minRadius = 0.0) {
+        return std::max(std::max(node->boundingSphere(), 0.0), minRadius) *
+            glm::compMax(glm::abs(node->worldScale()));
+    }
+
+    std::vector<SceneGraphNode*> bruteForceSegment(const std::vector<SceneGraphNode*>& n,
+                                                   const glm::dvec3& p1,
+                                                   const glm::dvec3& p2,
+                                                   double radiusScale, double minRadius)
+    {
+        std::vector<SceneGraphNode*> result;
+        const glm::dvec3 dir = p2 - p1;
+        const double length2 = glm::dot(dir, dir);
+        for (SceneGraphNode* node : n) {
+            const glm::dvec3 position = node->worldPosition();
+            const double t = length2 > 0.0 ?
+                std::clamp(glm::dot(position - p1, dir) / length2, 0.0, 1.0) :
+                0.0;
+            const double distance = glm::distance(position, p1 + t * dir);
+            if (distance <= radiusScale * worldRadius(node, minRadius)) {
+                result.push_back(node);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    SceneGraphNode* bruteForceNearest(const std::vector<SceneGraphNode*>& n,
+                                      const glm::dvec3& position,
+                                      const SceneBvh::NodeFilter& filter)
+    {
+        SceneGraphNode* best = nullptr;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (SceneGraphNode* node : n) {
+            const double distance = glm::distance(node->worldPosition(), position);
+            if (distance < bestDistance && (!filter || filter(node))) {
+                best = node;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    SceneGraphNode* bruteForceRay(const std::vector<SceneGraphNode*>& n,
+                                  const glm::dvec3& origin, const glm::dvec3& direction,
+                                  double& bestT)
+    {
+        SceneGraphNode* best = nullptr;
+        bestT = std::numeric_limits<double>::max();
+        for (SceneGraphNode* node : n) {
+            const double radius = worldRadius(node);
+            const glm::dvec3 oc = origin - node->worldPosition();
+            const double b = glm::dot(oc, direction);
+            const double c = glm::dot(oc, oc) - radius * radius;
+            const double discriminant = b * b - c;
+            if (discriminant < 0.0) {
+                continue;
+            }
+            double t = -b - std::sqrt(discriminant);
+            if (t < 0.0) {
+                if (-b + std::sqrt(discriminant) < 0.0) {
+                    continue;
+                }
+                t = 0.0;
+            }
+            if (t < bestT) {
+                best = node;
+                bestT = t;
+            }
+        }
+        return best;
+    }
+
+    std::vector<SceneGraphNode*> querySegment(const SceneBvh& bvh, const glm::dvec3& p1,
+                                              const glm::dvec3& p2, double radiusScale,
+                                              double minRadius)
+    {
+        std::vector<SceneGraphNode*> result;
+        bvh.querySegment(p1, p2, radiusScale, minRadius, result);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<glm::dvec3> testPoints() {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<double> position(-150.0, 150.0);
+        std::vector<glm::dvec3> points;
+        for (int i = 0; i < 64; i++) {
+            points.emplace_back(position(random), position(random), position(random));
+        }
+        return points;
+    }
+} // namespace
+
+TEST_CASE("SceneBvh: Empty", "[scenebvh]") {
+    SceneBvh bvh;
+    bvh.build({});
+    CHECK(bvh.isEmpty());
+    CHECK(bvh.nearestNode(glm::dvec3(0.0)) == nullptr);
+    CHECK(bvh.intersectRay(glm::dvec3(0.0), glm::dvec3(1.0, 0.0, 0.0)) == nullptr);
+
+    std::vector<SceneGraphNode*> result;
+    bvh.querySegment(glm::dvec3(0.0), glm::dvec3(1.0), 1.0, 0.0, result);
+    CHECK(result.empty());
+}
+
+TEST_CASE("SceneBvh: Query Segment", "[scenebvh]") {
+    TestScene scene(40);
+    SceneBvh bvh;
+    bvh.build(scene.pointers);
+    REQUIRE_FALSE(bvh.isEmpty());
+
+    const std::vector<glm::dvec3> points = testPoints();
+    for (size_t i = 0; i + 1 < points.size(); i += 2) {
+        const glm::dvec3& p1 = points[i];
+        const glm::dvec3& p2 = points[i + 1];
+        CHECK(
+            querySegment(bvh, p1, p2, 1.0, 0.0) ==
+            bruteForceSegment(scene.pointers, p1, p2, 1.0, 0.0)
+        );
+        CHECK(
+            querySegment(bvh, p1, p2, 2.5, 8.0) ==
+            bruteForceSegment(scene.pointers, p1, p2, 2.5, 8.0)
+        );
+
+        // A segment with the same start and end point is a point query
+        CHECK(
+            querySegment(bvh, p1, p1, 3.0, 0.0) ==
+            bruteForceSegment(scene.pointers, p1, p1, 3.0, 0.0)
+        );
+    }
+}
+
+TEST_CASE("SceneBvh: Nearest Node", "[scenebvh]") {
+    TestScene scene(40);
+    SceneBvh bvh;
+    bvh.build(scene.pointers);
+
+    // Only accept every third node to check that the filter is respected
+    const SceneBvh::NodeFilter filter = [&scene](const SceneGraphNode* node) {
+        const auto it = std::find(scene.pointers.begin(), scene.pointers.end(), node);
+        return std::distance(scene.pointers.begin(), it) % 3 == 0;
+    };
+
+    for (const glm::dvec3& p : testPoints()) {
+        CHECK(bvh.nearestNode(p) == bruteForceNearest(scene.pointers, p, nullptr));
+        CHECK(bvh.nearestNode(p, filter) == bruteForceNearest(scene.pointers, p, filter));
+    }
+
+    const SceneBvh::NodeFilter rejectAll = [](const SceneGraphNode*) { return false; };
+    CHECK(bvh.nearestNode(glm::dvec3(0.0), rejectAll) == nullptr);
+}
+
+TEST_CASE("SceneBvh: Intersect Ray", "[scenebvh]") {
+    TestScene scene(40);
+    SceneBvh bvh;
+    bvh.build(scene.pointers);
+
+    const std::vector<glm::dvec3> points = testPoints();
+    int nHits = 0;
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        const glm::dvec3 origin = points[i];
+        // Aim close to another point so that a decent number of rays hit something
+        const glm::dvec3 direction = glm::normalize(
+            scene.pointers[i % scene.pointers.size()]->worldPosition() - origin
+        );
+
+        double expectedT = 0.0;
+        SceneGraphNode* expected =
+            bruteForceRay(scene.pointers, origin, direction, expectedT);
+        double t = -1.0;
+        SceneGraphNode* hit = bvh.intersectRay(origin, direction, nullptr, &t);
+        CHECK(hit == expected);
+        if (expected) {
+            CHECK(std::abs(t - expectedT) < 1e-9);
+            nHits++;
+        }
+    }
+    CHECK(nHits > 0);
+
+    // A ray pointing away from all nodes
+    CHECK(
+        bvh.intersectRay(glm::dvec3(0.0, 0.0, 1e6), glm::dvec3(0.0, 0.0, 1.0)) == nullptr
+    );
+}
+
+TEST_CASE("SceneBvh: Refit Matches Rebuild", "[scenebvh]") {
+    TestScene scene(40);
+    SceneBvh refitted;
+    refitted.build(scene.pointers);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> offset(-5.0, 5.0);
+    std::uniform_real_distribution<double> position(-1000.0, 1000.0);
+    for (int step = 0; step < 4; step++) {
+        // Small movements are handled by refitting, the large ones in the last step
+        // degrade the hierarchy far enough to trigger a rebuild
+        for (size_t i = 0; i < scene.pointers.size(); i++) {
+            const glm::dvec3 p = scene.pointers[i]->worldPosition();
+            if (step < 3) {
+                scene.move(i, p + glm::dvec3(offset(random), offset(random), 0.0));
+            }
+            else {
+                scene.move(i, glm::dvec3(position(random), position(random), 0.0));
+            }
+        }
+        scene.update();
+        refitted.refit();
+
+        SceneBvh rebuilt;
+        rebuilt.build(scene.pointers);
+
+        for (const glm::dvec3& p : testPoints()) {
+            CHECK(refitted.nearestNode(p) == rebuilt.nearestNode(p));
+            CHECK(
+                refitted.nearestNode(p) == bruteForceNearest(scene.pointers, p, nullptr)
+            );
+
+            const glm::dvec3 p2 = p + glm::dvec3(50.0, -20.0, 10.0);
+            const std::vector<SceneGraphNode*> expected =
+                bruteForceSegment(scene.pointers, p, p2, 1.5, 2.0);
+            CHECK(querySegment(refitted, p, p2, 1.5, 2.0) == expected);
+            CHECK(querySegment(rebuilt, p, p2, 1.5, 2.0) == expected);
+        }
+    }
+}
@@ -22,6 +22,7 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <openspace/scripting/scriptscheduler.h>
@@ -30,6 +31,8 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/dictionary.h>
 #include <limits>
+#include <span>
+#include <string>
 
 TEST_CASE("ScriptScheduler: Simple Forward", "[scriptscheduler]") {
     using namespace openspace;
@@ -51,7 +54,8 @@ TEST_CASE("ScriptScheduler: Simple Forward", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 03"));
@@ -86,7 +90,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Single Jump", "[scriptscheduler]")
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -126,7 +131,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Ordering", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
@@ -157,7 +163,8 @@ TEST_CASE("ScriptScheduler: Simple Backward", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 05"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
@@ -193,7 +200,8 @@ TEST_CASE("ScriptScheduler: Multiple Backward Single Jump", "[scriptscheduler]")
     scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -233,7 +241,8 @@ TEST_CASE("ScriptScheduler: Multiple Backward Ordering", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 01"));
@@ -258,14 +267,14 @@ TEST_CASE("ScriptScheduler: Empty", "[scriptscheduler]") {
     // First test if a new ScriptScheduler will return an empty list
     for (const double t : TestTimes) {
         ScriptScheduler scheduler;
-        const std::vector<std::string> res = scheduler.progressTo(t);
+        const std::span<const std::string> res = scheduler.progressTo(t);
         CHECK(res.empty());
     }
 
     // Then test the same thing but keeping the same ScriptScheduler
     ScriptScheduler scheduler;
     for (const double t : TestTimes) {
-        const std::vector<std::string> res = scheduler.progressTo(t);
+        const std::span<const std::string> res = scheduler.progressTo(t);
         CHECK(res.empty());
     }
 
@@ -298,7 +307,8 @@ TEST_CASE("ScriptScheduler: Forward Backwards", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
 
@@ -342,7 +352,8 @@ TEST_CASE("ScriptScheduler: Rewind", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 07"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     REQUIRE(res.size() == 2);
 
     scheduler.rewind();
@@ -433,7 +444,7 @@ TEST_CASE("ScriptScheduler: Jump Equal", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::span<const std::string> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 11:00:00"));
     CHECK(res.empty());
 
@@ -470,7 +481,7 @@ TEST_CASE("ScriptScheduler: Same Time", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::span<const std::string> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 12:00:00"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
@@ -500,7 +511,7 @@ TEST_CASE("ScriptScheduler: Multi Inner Jump", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::span<const std::string> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 10:00:00"));
     CHECK(res.empty());
 
@@ -543,7 +554,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -580,7 +592,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Ordering Multiple Load" "[scriptsch
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
@@ -616,7 +629,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -656,7 +670,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 01"));
@@ -689,7 +704,8 @@ TEST_CASE("ScriptScheduler: Forward Backwards Multiple Load", "[scriptscheduler]
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
 
@@ -729,7 +745,8 @@ TEST_CASE("ScriptScheduler: Rewind Multiple Load", "[scriptscheduler]") {
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 07"));
+    std::span<const std::string> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     REQUIRE(res.size() == 2);
 
     scheduler.rewind();
@@ -811,3 +828,122 @@ TEST_CASE("ScriptScheduler: All Scripts Mixed Load", "[scriptscheduler]") {
 
     SpiceManager::deinitialize();
 }
+
+TEST_CASE("ScriptScheduler: Universal Script", "[scriptscheduler]") {
+    using namespace openspace;
+    using namespace openspace::scripting;
+
+    std::vector<ScriptScheduler::ScheduledScript> scripts;
+    {
+        ScriptScheduler::ScheduledScript script1;
+        script1.time = 10.0;
+        script1.universalScript = "UniversalScript1";
+        script1.forwardScript = "ForwardScript1";
+        script1.backwardScript = "BackwardScript1";
+        scripts.push_back(script1);
+    }
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(0.0);
+    scheduler.loadScripts(scripts);
+
+    std::span<const std::string> res = scheduler.progressTo(20.0);
+    REQUIRE(res.size() == 1);
+    CHECK(res[0] == "UniversalScript1; ForwardScript1");
+
+    res = scheduler.progressTo(0.0);
+    REQUIRE(res.size() == 1);
+    CHECK(res[0] == "UniversalScript1; BackwardScript1");
+}
+
+TEST_CASE("ScriptScheduler: Groups", "[scriptscheduler]") {
+    using namespace openspace;
+    using namespace openspace::scripting;
+
+    std::vector<ScriptScheduler::ScheduledScript> scripts;
+    for (int i = 0; i < 6; i++) {
+        ScriptScheduler::ScheduledScript script;
+        script.time = static_cast<double>(i);
+        script.forwardScript = "ForwardScript" + std::to_string(i);
+        script.backwardScript = "BackwardScript" + std::to_string(i);
+        script.group = i % 2;
+        scripts.push_back(script);
+    }
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(-1.0);
+    scheduler.loadScripts(scripts);
+
+    CHECK(scheduler.allScripts().size() == 6);
+    CHECK(scheduler.allScripts(0).size() == 3);
+    CHECK(scheduler.allScripts(1).size() == 3);
+    CHECK(scheduler.allScripts(2).empty());
+
+    std::span<const std::string> res = scheduler.progressTo(2.5);
+    REQUIRE(res.size() == 3);
+    CHECK(res[2] == "ForwardScript2");
+
+    scheduler.clearSchedule(0);
+    CHECK(scheduler.allScripts().size() == 3);
+    CHECK(scheduler.allScripts(0).empty());
+
+    res = scheduler.progressTo(10.0);
+    REQUIRE(res.size() == 2);
+    CHECK(res[0] == "ForwardScript3");
+    CHECK(res[1] == "ForwardScript5");
+
+    res = scheduler.progressTo(-1.0);
+    REQUIRE(res.size() == 3);
+    CHECK(res[0] == "BackwardScript5");
+    CHECK(res[1] == "BackwardScript3");
+    CHECK(res[2] == "BackwardScript1");
+
+    scheduler.clearSchedule();
+    CHECK(scheduler.allScripts().empty());
+    CHECK(scheduler.progressTo(10.0).empty());
+}
+
+TEST_CASE("ScriptScheduler: Benchmark", "[scriptscheduler][.benchmark]") {
+    using namespace openspace;
+    using namespace openspace::scripting;
+
+    constexpr int NScripts = 10000;
+
+    std::vector<ScriptScheduler::ScheduledScript> scripts;
+    scripts.reserve(NScripts);
+    for (int i = 0; i < NScripts; i++) {
+        ScriptScheduler::ScheduledScript script;
+        script.time = static_cast<double>(i);
+        script.forwardScript = "ForwardScript" + std::to_string(i);
+        script.backwardScript = "BackwardScript" + std::to_string(i);
+        script.group = i % 10;
+        scripts.push_back(std::move(script));
+    }
+
+    BENCHMARK("Load scripts") {
+        ScriptScheduler scheduler;
+        scheduler.loadScripts(scripts);
+        return scheduler.allScripts().size();
+    };
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(-1.0);
+    scheduler.loadScripts(scripts);
+
+    BENCHMARK("Progress in small steps") {
+        size_t n = 0;
+        for (int i = 0; i < NScripts; i++) {
+            n += scheduler.progressTo(static_cast<double>(i) + 0.5).size();
+        }
+        for (int i = NScripts - 1; i >= 0; i--) {
+            n += scheduler.progressTo(static_cast<double>(i) - 0.5).size();
+        }
+        return n;
+    };
+
+    BENCHMARK("Jump over entire schedule") {
+        size_t n = scheduler.progressTo(static_cast<double>(NScripts)).size();
+        n += scheduler.progressTo(-1.0).size();
+        return n;
+    };
+}
@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/glm.h>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/starhierarchy.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+namespace {
+    struct Catalog {
+        std::vector<glm::vec3> positions;
+        std::vector<float> absoluteMagnitudes;
+    };
+
+    // A uniformly distributed cube of stars with a range of magnitudes that is similar
+    // to the ones found in the HYG catalog
+    Catalog createCatalog(size_t nStars) {
+        std::mt19937 random = std::mt19937(1337);
+        std::uniform_real_distribution<float> position(-500.f, 500.f);
+        std::uniform_real_distribution<float> magnitude(-5.f, 15.f);
+
+        Catalog catalog;
+        catalog.positions.reserve(nStars);
+        catalog.absoluteMagnitudes.reserve(nStars);
+        for (size_t i = 0; i < nStars; i++) {
+            catalog.positions.emplace_back(
+                position(random),
+                position(random),
+                position(random)
+            );
+            catalog.absoluteMagnitudes.push_back(magnitude(random));
+        }
+        return catalog;
+    }
+
+    // A view-projection matrix for a camera at the origin that looks along the negative
+    // z axis with a field of view of 90 degrees
+    glm::dmat4 viewProjection() {
+        return glm::dmat4(
+            1.0, 0.0, 0.0, 0.0,
+            0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, 0.0, -1.0,
+            0.0, 0.0, 0.0, 0.0
+        );
+    }
+} // namespace
+
+TEST_CASE("StarHierarchy: Selection", "[starhierarchy]") {
+    using namespace openspace;
+
+    const Catalog catalog = createCatalog(100000);
+    const stars::Hierarchy hierarchy = stars::buildHierarchy(
+        catalog.positions,
+        catalog.absoluteMagnitudes,
+        256
+    );
+    REQUIRE(hierarchy.order.size() == catalog.positions.size());
+
+    constexpr float MagnitudeLimit = 6.f;
+    std::vector<stars::Range> ranges;
+    stars::selectStars(
+        hierarchy,
+        glm::dvec3(0.0),
+        stars::frustumPlanes(viewProjection()),
+        MagnitudeLimit,
+        ranges
+    );
+
+    std::vector<bool> isSelected = std::vector<bool>(catalog.positions.size(), false);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (i > 0) {
+            // Ranges must be sorted and must not overlap or touch
+            CHECK(ranges[i].first > ranges[i - 1].first + ranges[i - 1].count);
+        }
+        for (uint32_t j = ranges[i].first; j < ranges[i].first + ranges[i].count; j++) {
+            isSelected[hierarchy.order[j]] = true;
+        }
+    }
+
+    // The selection is conservative, so every star that is visible has to be selected
+    size_t nVisible = 0;
+    size_t nMissing = 0;
+    for (size_t i = 0; i < catalog.positions.size(); i++) {
+        const glm::vec3 p = catalog.positions[i];
+        const bool isInFrustum = -p.z >= std::abs(p.x) && -p.z >= std::abs(p.y);
+        const double distance = glm::length(glm::dvec3(p));
+        const double apparentMagnitude =
+            catalog.absoluteMagnitudes[i] + 5.0 * std::log10(distance) - 5.0;
+        if (isInFrustum && apparentMagnitude <= MagnitudeLimit) {
+            nVisible++;
+            if (!isSelected[i]) {
+                nMissing++;
+            }
+        }
+    }
+    CHECK(nVisible > 0);
+    CHECK(nMissing == 0);
+}
+
+TEST_CASE("StarHierarchy: Benchmark", "[starhierarchy][.benchmark]") {
+    using namespace openspace;
+
+    const Catalog catalog = createCatalog(2000000);
+    const stars::Hierarchy hierarchy = stars::buildHierarchy(
+        catalog.positions,
+        catalog.absoluteMagnitudes
+    );
+    const std::array<glm::dvec4, 4> planes = stars::frustumPlanes(viewProjection());
+
+    std::vector<stars::Range> ranges;
+    BENCHMARK("Selection") {
+        stars::selectStars(hierarchy, glm::dvec3(0.0), planes, 6.f, ranges);
+        return ranges.size();
+    };
+}
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,186 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/misc/exception.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace {
+    // A task that writes its outputs and records the order in which tasks were performed
+    class TestTask : public openspace::Task {
+    public:
+        TestTask(std::vector<std::string>& order, std::mutex& mutex, Scheduling s)
+            : _order(order)
+            , _mutex(mutex)
+        {
+            setScheduling(std::move(s));
+        }
+
+        void perform(const ProgressCallback& onProgress) override {
+            onProgress(0.5f);
+            for (const std::filesystem::path& output : scheduling().outputs) {
+                std::ofstream(output) << scheduling().name;
+            }
+            const std::lock_guard guard = std::lock_guard(_mutex);
+            _order.push_back(scheduling().name);
+        }
+
+        std::string description() override {
+            return scheduling().name;
+        }
+
+    private:
+        std::vector<std::string>& _order;
+        std::mutex& _mutex;
+    };
+
+    struct TaskList {
+        void add(openspace::Task::Scheduling s) {
+            tasks.push_back(std::make_unique<TestTask>(order, mutex, std::move(s)));
+        }
+
+        std::vector<std::unique_ptr<openspace::Task>> tasks;
+        std::vector<std::string> order;
+        std::mutex mutex;
+    };
+} // namespace
+
+TEST_CASE("TaskScheduler: Dependencies", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskList list;
+    list.add({ .name = "a", .dependencies = { "b" } });
+    list.add({ .name = "b" });
+    list.add({ .name = "c" });
+
+    TaskScheduler scheduler = TaskScheduler(std::move(list.tasks));
+    float progress = 0.f;
+    const TaskScheduler::Result res = scheduler.run(1, [&](float p) { progress = p; });
+    CHECK(res.nPerformed == 3);
+    CHECK(res.nSkipped == 0);
+    CHECK(res.nFailed == 0);
+    CHECK(progress == 1.f);
+    CHECK(list.order == std::vector<std::string>{ "b", "a", "c" });
+}
+
+TEST_CASE("TaskScheduler: Concurrent", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskList list;
+    for (int i = 0; i < 16; i++) {
+        list.add({ .name = std::to_string(i) });
+    }
+    list.add({ .name = "last", .dependencies = { "0", "7", "15" } });
+
+    TaskScheduler scheduler = TaskScheduler(std::move(list.tasks));
+    const TaskScheduler::Result res = scheduler.run(4);
+    CHECK(res.nPerformed == 17);
+    REQUIRE(list.order.size() == 17);
+    CHECK(list.order.back() == "last");
+}
+
+TEST_CASE("TaskScheduler: Invalid Dependencies", "[taskscheduler]") {
+    using namespace openspace;
+
+    {
+        TaskList list;
+        list.add({ .name = "a", .dependencies = { "b" } });
+        list.add({ .name = "b", .dependencies = { "a" } });
+        CHECK_THROWS_AS(TaskScheduler(std::move(list.tasks)), ghoul::RuntimeError);
+    }
+    {
+        TaskList list;
+        list.add({ .name = "a", .dependencies = { "unknown" } });
+        CHECK_THROWS_AS(TaskScheduler(std::move(list.tasks)), ghoul::RuntimeError);
+    }
+    {
+        TaskList list;
+        list.add({ .name = "a" });
+        list.add({ .name = "a" });
+        CHECK_THROWS_AS(TaskScheduler(std::move(list.tasks)), ghoul::RuntimeError);
+    }
+}
+
+TEST_CASE("TaskScheduler: Skip Up-To-Date", "[taskscheduler]") {
+    using namespace openspace;
+    namespace fs = std::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / "openspace-test-taskscheduler";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    std::ofstream(dir / "input.txt") << "input";
+    // Make sure that the outputs are strictly newer than the input regardless of the
+    // timestamp resolution of the file system
+    fs::last_write_time(
+        dir / "input.txt",
+        fs::last_write_time(dir / "input.txt") - std::chrono::hours(1)
+    );
+
+    // The second task reads the output of the first one, so it has to run after it
+    auto run = [&dir]() {
+        TaskList list;
+        list.add({
+            .name = "second",
+            .inputs = { dir / "intermediate.txt" },
+            .outputs = { dir / "output.txt" }
+        });
+        list.add({
+            .name = "first",
+            .inputs = { dir / "input.txt" },
+            .outputs = { dir / "intermediate.txt" }
+        });
+        TaskScheduler scheduler = TaskScheduler(std::move(list.tasks));
+        const TaskScheduler::Result res = scheduler.run(2);
+        return std::pair(res, list.order);
+    };
+
+    {
+        const auto [res, order] = run();
+        CHECK(res.nPerformed == 2);
+        CHECK(order == std::vector<std::string>{ "first", "second" });
+    }
+    {
+        const auto [res, order] = run();
+        CHECK(res.nSkipped == 2);
+        CHECK(order.empty());
+    }
+
+    std::ofstream(dir / "input.txt") << "changed";
+    fs::last_write_time(
+        dir / "input.txt",
+        fs::last_write_time(dir / "intermediate.txt") + std::chrono::hours(1)
+    );
+    {
+        const auto [res, order] = run();
+        CHECK(res.nPerformed == 2);
+        CHECK(order == std::vector<std::string>{ "first", "second" });
+    }
+
+    fs::remove_all(dir);
+}
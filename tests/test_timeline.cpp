@@ -22,11 +22,14 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <openspace/util/timeline.h>
 #include <openspace/util/time.h>
+#include <utility>
+#include <vector>
 
 TEST_CASE("TimeLine: Add and Count Keyframes", "[timeline]") {
     openspace::Timeline<openspace::Time> timeline;
@@ -95,3 +98,111 @@ TEST_CASE("TimeLine: Remove Keyframes In Range", "[timeline]") {
     timeline.removeKeyframesBetween(-1.0, 4.0);
     CHECK(timeline.nKeyframes() == 0);
 }
+
+TEST_CASE("TimeLine: Query Keyframes Sequentially", "[timeline]") {
+    openspace::Timeline<float> timeline;
+    for (int i = 0; i < 100; i++) {
+        timeline.addKeyframe(static_cast<double>(i), static_cast<float>(i));
+    }
+
+    // Forwards in small steps, as during playback
+    for (int i = 0; i < 990; i++) {
+        const double t = i * 0.1;
+        const openspace::Keyframe<float>* prev = timeline.lastKeyframeBefore(t, true);
+        const openspace::Keyframe<float>* next = timeline.firstKeyframeAfter(t);
+        REQUIRE(prev);
+        REQUIRE(next);
+        CHECK(prev->timestamp <= t);
+        CHECK(next->timestamp > t);
+        CHECK(next->timestamp - prev->timestamp == Catch::Approx(1.0));
+    }
+
+    // Backwards
+    for (int i = 989; i >= 0; i--) {
+        const double t = i * 0.1;
+        const openspace::Keyframe<float>* prev = timeline.lastKeyframeBefore(t, true);
+        REQUIRE(prev);
+        CHECK(prev->timestamp <= t);
+        CHECK(t - prev->timestamp < 1.0);
+    }
+
+    // Jumps
+    CHECK(timeline.firstKeyframeAfter(95.0, true)->data == Catch::Approx(95.f));
+    CHECK(timeline.firstKeyframeAfter(3.0, true)->data == Catch::Approx(3.f));
+    CHECK(timeline.firstKeyframeAfter(99.0) == nullptr);
+    CHECK(timeline.lastKeyframeBefore(0.0) == nullptr);
+    CHECK(timeline.firstKeyframeAfter(-10.0)->data == Catch::Approx(0.f));
+    CHECK(timeline.lastKeyframeBefore(1000.0)->data == Catch::Approx(99.f));
+}
+
+TEST_CASE("TimeLine: Add Keyframe Batch", "[timeline]") {
+    openspace::Timeline<float> timeline;
+    timeline.addKeyframe(1.0, 1.f);
+    timeline.addKeyframe(3.0, 3.f);
+
+    // Interleaved with the existing keyframes
+    timeline.addKeyframes({ { 0.0, 0.f }, { 2.0, 2.f }, { 4.0, 4.f } });
+    REQUIRE(timeline.nKeyframes() == 5);
+    for (size_t i = 0; i < timeline.nKeyframes(); i++) {
+        CHECK(timeline.keyframes()[i].data == Catch::Approx(static_cast<float>(i)));
+    }
+
+    // Appended after the existing keyframes, unsorted
+    timeline.addKeyframes({ { 6.0, 6.f }, { 5.0, 5.f } });
+    REQUIRE(timeline.nKeyframes() == 7);
+    for (size_t i = 0; i < timeline.nKeyframes(); i++) {
+        CHECK(timeline.keyframes()[i].data == Catch::Approx(static_cast<float>(i)));
+    }
+
+    // Keyframes with the same timestamp are placed after the existing ones
+    timeline.addKeyframes({ { 3.0, 10.f } });
+    REQUIRE(timeline.nKeyframes() == 8);
+    CHECK(timeline.keyframes()[3].data == Catch::Approx(3.f));
+    CHECK(timeline.keyframes()[4].data == Catch::Approx(10.f));
+}
+
+TEST_CASE("TimeLine: Benchmark", "[timeline][.benchmark]") {
+    constexpr int NKeyframes = 100000;
+
+    std::vector<std::pair<double, float>> batch;
+    batch.reserve(NKeyframes);
+    for (int i = 0; i < NKeyframes; i++) {
+        batch.emplace_back(static_cast<double>(i), static_cast<float>(i));
+    }
+
+    BENCHMARK("Add keyframes individually") {
+        openspace::Timeline<float> timeline;
+        for (const std::pair<double, float>& kf : batch) {
+            timeline.addKeyframe(kf.first, kf.second);
+        }
+        return timeline.nKeyframes();
+    };
+
+    BENCHMARK("Add keyframe batch") {
+        openspace::Timeline<float> timeline;
+        timeline.addKeyframes(batch);
+        return timeline.nKeyframes();
+    };
+
+    openspace::Timeline<float> timeline;
+    timeline.addKeyframes(batch);
+
+    BENCHMARK("Sequential lookup") {
+        float sum = 0.f;
+        for (int i = 0; i < NKeyframes; i++) {
+            const double t = static_cast<double>(i) + 0.5;
+            sum += timeline.lastKeyframeBefore(t)->data;
+        }
+        return sum;
+    };
+
+    BENCHMARK("Random lookup") {
+        float sum = 0.f;
+        for (int i = 0; i < NKeyframes; i++) {
+            // Spread the lookups over the entire timeline
+            const double t = static_cast<double>((i * 7919) % NKeyframes) + 0.5;
+            sum += timeline.lastKeyframeBefore(t)->data;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,432 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/multiresvolume/rendering/errorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/util/histogram.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    constexpr int NumBins = 50;
+
+    // Writes a TSP file with 4 timesteps of 4x4x4 bricks that each have 4x4x4 voxels,
+    // which results in 3 BST levels and 3 octree levels
+    std::filesystem::path createTspFile(const std::string& name) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+
+        const TSP::Header header = { 0, 4, 4, 4, 4, 4, 4, 4, 4 };
+        constexpr unsigned int NumBricks = 73 * 7;
+        constexpr unsigned int NumBrickValues = 6 * 6 * 6;
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(TSP::Header));
+        // Values that are irregular enough to not cancel out in any of the errors
+        for (unsigned int i = 0; i < NumBricks * NumBrickValues; i++) {
+            const float value = static_cast<float>((i * 7919) % 1009) / 1009.f;
+            file.write(reinterpret_cast<const char*>(&value), sizeof(float));
+        }
+        return path;
+    }
+
+    // The breadth-first traversal that TSP::coveredLeafBricks used to perform
+    std::vector<unsigned int> coveredLeafBricksBfs(const TSP& tsp, unsigned int brick) {
+        std::vector<unsigned int> result;
+        std::queue<unsigned int> queue;
+        queue.push(brick);
+        while (!queue.empty()) {
+            const unsigned int node = queue.front();
+            queue.pop();
+            if (tsp.isOctreeLeaf(node)) {
+                result.push_back(node);
+            }
+            else {
+                for (unsigned int i = 0; i < 8; i++) {
+                    queue.push(tsp.firstOctreeChild(node) + i);
+                }
+            }
+        }
+        return result;
+    }
+
+    // The breadth-first traversal that TSP::coveredBSTLeafBricks used to perform
+    std::vector<unsigned int> coveredBstLeafBricksBfs(const TSP& tsp, unsigned int brick)
+    {
+        std::vector<unsigned int> result;
+        std::queue<unsigned int> queue;
+        queue.push(brick);
+        while (!queue.empty()) {
+            const unsigned int node = queue.front();
+            queue.pop();
+            if (tsp.isBstLeaf(node)) {
+                result.push_back(node);
+            }
+            else {
+                queue.push(tsp.bstLeft(node));
+                queue.push(tsp.bstRight(node));
+            }
+        }
+        return result;
+    }
+
+    unsigned int linearCoords(const TSP& tsp, const glm::ivec3& coords) {
+        const unsigned int dim = tsp.paddedBrickDim();
+        return coords.z * dim * dim + coords.y * dim + coords.x;
+    }
+
+    float interpolate(const TSP& tsp, const glm::vec3& p, const float* voxels) {
+        const glm::ivec3 low = glm::ivec3(p);
+        const glm::ivec3 high = glm::ivec3(glm::ceil(p));
+        const glm::vec3 t = 1.f - (p - glm::vec3(low));
+
+        auto v = [&](int x, int y) {
+            const float lowZ = voxels[linearCoords(tsp, glm::ivec3(x, y, low.z))];
+            const float highZ = voxels[linearCoords(tsp, glm::ivec3(x, y, high.z))];
+            return t.z * lowZ + (1.f - t.z) * highZ;
+        };
+        const float v00 = v(low.x, low.y);
+        const float v01 = v(low.x, high.y);
+        const float v10 = v(high.x, low.y);
+        const float v11 = v(high.x, high.y);
+        const float v0 = t.y * v00 + (1.f - t.y) * v01;
+        const float v1 = t.y * v10 + (1.f - t.y) * v11;
+        return t.x * v0 + (1.f - t.x) * v1;
+    }
+
+    // The serial leaf-by-leaf spatial error calculation
+    std::vector<float> serialSpatialErrors(const TSP& tsp) {
+        const unsigned int numBrickVals =
+            tsp.paddedBrickDim() * tsp.paddedBrickDim() * tsp.paddedBrickDim();
+
+        std::vector<float> errors(tsp.numTotalNodes());
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            const float* values = tsp.brickValues(brick);
+            const double average = std::accumulate(
+                values,
+                values + numBrickVals,
+                0.0,
+                [](double a, float b) { return a + static_cast<double>(b); }
+            );
+            const float brickAvg =
+                static_cast<float>(average / static_cast<double>(numBrickVals));
+
+            const std::vector<unsigned int> leaves = coveredLeafBricksBfs(tsp, brick);
+            float stdDev = -0.1f;
+            if (leaves.size() > 1) {
+                stdDev = 0.f;
+                for (const unsigned int leaf : leaves) {
+                    const float* leafValues = tsp.brickValues(leaf);
+                    for (unsigned int v = 0; v < numBrickVals; v++) {
+                        stdDev += pow(leafValues[v] - brickAvg, 2.f);
+                    }
+                }
+                stdDev /= static_cast<float>(leaves.size() * numBrickVals);
+                stdDev = sqrt(stdDev);
+            }
+            errors[brick] = stdDev > 0.f ? pow(stdDev, 0.5f) : stdDev;
+        }
+        return errors;
+    }
+
+    // The serial voxel-by-voxel temporal error calculation
+    std::vector<float> serialTemporalErrors(const TSP& tsp) {
+        const unsigned int numBrickVals =
+            tsp.paddedBrickDim() * tsp.paddedBrickDim() * tsp.paddedBrickDim();
+
+        std::vector<float> errors(tsp.numTotalNodes());
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            const float* averages = tsp.brickValues(brick);
+            const std::vector<unsigned int> leaves = coveredBstLeafBricksBfs(tsp, brick);
+            float error = -0.1f;
+            if (leaves.size() > 1) {
+                error = 0.f;
+                for (unsigned int voxel = 0; voxel < numBrickVals; voxel++) {
+                    float stdDev = 0.f;
+                    for (const unsigned int leaf : leaves) {
+                        const float sample = tsp.brickValues(leaf)[voxel];
+                        stdDev += pow(sample - averages[voxel], 2.f);
+                    }
+                    stdDev /= static_cast<float>(leaves.size());
+                    stdDev = sqrt(stdDev);
+                    error += stdDev;
+                }
+                error /= static_cast<float>(numBrickVals);
+            }
+            errors[brick] = error > 0.f ? pow(error, 0.25f) : error;
+        }
+        return errors;
+    }
+
+    // The serial histogram construction that visits every leaf and adds its errors to
+    // all of its BST and octree ancestors, keyed by the brick index of the ancestor
+    std::map<unsigned int, Histogram> serialErrorHistograms(const TSP& tsp) {
+        const int brickDim = static_cast<int>(tsp.brickDim());
+        const unsigned int padding = (tsp.paddedBrickDim() - tsp.brickDim()) / 2;
+        const unsigned int numOtNodes = tsp.numOTNodes();
+        const unsigned int numBstNodes = tsp.numBSTNodes();
+
+        std::map<unsigned int, Histogram> histograms;
+        for (unsigned int bstLeaf = numBstNodes / 2; bstLeaf < numBstNodes; bstLeaf++) {
+            for (unsigned int otLeaf = 0; otLeaf < numOtNodes; otLeaf++) {
+                if (!tsp.isOctreeLeaf(otLeaf)) {
+                    continue;
+                }
+                const float* leafValues = tsp.brickValues(bstLeaf * numOtNodes + otLeaf);
+
+                int bstNode = static_cast<int>(bstLeaf);
+                while (bstNode >= 0) {
+                    glm::vec3 leafOffset = glm::vec3(0.f);
+                    int octreeLevel = 0;
+                    int octreeNode = static_cast<int>(otLeaf);
+                    while (octreeNode >= 0) {
+                        const unsigned int ancestor = bstNode * numOtNodes + octreeNode;
+                        if (bstNode != static_cast<int>(bstLeaf) ||
+                            octreeNode != static_cast<int>(otLeaf))
+                        {
+                            Histogram& histogram = histograms.try_emplace(
+                                ancestor, 0.f, 1.f, NumBins
+                            ).first->second;
+                            const float* ancestorValues = tsp.brickValues(ancestor);
+
+                            const float invScale =
+                                1.f / static_cast<float>(std::pow(2.f, octreeLevel));
+                            const glm::vec3 ancestorOffset =
+                                leafOffset * invScale + glm::vec3(padding - 0.5f);
+                            for (int z = 0; z < brickDim; z++) {
+                                for (int y = 0; y < brickDim; y++) {
+                                    for (int x = 0; x < brickDim; x++) {
+                                        const glm::vec3 xyz = glm::vec3(x, y, z);
+                                        const float leafValue = leafValues[linearCoords(
+                                            tsp,
+                                            glm::ivec3(xyz + glm::vec3(padding))
+                                        )];
+                                        const float ancestorValue = interpolate(
+                                            tsp,
+                                            ancestorOffset +
+                                                (xyz + glm::vec3(0.5)) * invScale,
+                                            ancestorValues
+                                        );
+                                        histogram.addRectangle(
+                                            leafValue,
+                                            ancestorValue,
+                                            std::abs(leafValue - ancestorValue)
+                                        );
+                                    }
+                                }
+                            }
+                        }
+
+                        if (octreeNode == 0) {
+                            break;
+                        }
+                        const int child = (octreeNode - 1) % 8;
+                        const int childSize = (1 << octreeLevel) * brickDim;
+                        leafOffset += glm::vec3(
+                            child % 2,
+                            (child / 2) % 2,
+                            child / 4
+                        ) * static_cast<float>(childSize);
+                        octreeNode = (octreeNode - 1) / 8;
+                        octreeLevel++;
+                    }
+
+                    bstNode = bstNode == 0 ? -1 : (bstNode - 1) / 2;
+                }
+            }
+        }
+        return histograms;
+    }
+
+    bool isEqual(const Histogram& lhs, const Histogram& rhs) {
+        return lhs.numBins() == rhs.numBins() &&
+            std::equal(lhs.data(), lhs.data() + lhs.numBins(), rhs.data());
+    }
+} // namespace
+
+TEST_CASE("TSP: Covered Leaf Bricks", "[tsp]") {
+    const std::filesystem::path path = createTspFile("test_tsp_covered.tsp");
+    {
+        TSP tsp = TSP(path);
+        REQUIRE(tsp.readHeader());
+        REQUIRE(tsp.construct());
+        REQUIRE(tsp.numTotalNodes() == 73 * 7);
+
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            const std::vector<unsigned int> leaves = coveredLeafBricksBfs(tsp, brick);
+            const TSP::BrickRange range = tsp.coveredLeafBricks(brick);
+            REQUIRE(range.count == leaves.size());
+            for (unsigned int i = 0; i < range.count; i++) {
+                CHECK(range[i] == leaves[i]);
+            }
+
+            const std::vector<unsigned int> bstLeaves =
+                coveredBstLeafBricksBfs(tsp, brick);
+            const TSP::BrickRange bstRange = tsp.coveredBSTLeafBricks(brick);
+            REQUIRE(bstRange.count == bstLeaves.size());
+            for (unsigned int i = 0; i < bstRange.count; i++) {
+                CHECK(bstRange[i] == bstLeaves[i]);
+            }
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TSP: Parallel Errors", "[tsp]") {
+    const std::filesystem::path path = createTspFile("test_tsp_errors.tsp");
+    {
+        TSP tsp = TSP(path);
+        REQUIRE(tsp.readHeader());
+        REQUIRE(tsp.construct());
+        REQUIRE(tsp.calculateSpatialError());
+        REQUIRE(tsp.calculateTemporalError());
+
+        // The parallel passes accumulate in the same order as the serial ones, so the
+        // results have to be identical rather than just close
+        const std::vector<float> spatial = serialSpatialErrors(tsp);
+        const std::vector<float> temporal = serialTemporalErrors(tsp);
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            CHECK(tsp.spatialError(brick) == spatial[brick]);
+            CHECK(tsp.temporalError(brick) == temporal[brick]);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TSP: Parallel Error Histograms", "[tsp]") {
+    const std::filesystem::path path = createTspFile("test_tsp_histograms.tsp");
+    {
+        TSP tsp = TSP(path);
+        REQUIRE(tsp.readHeader());
+        REQUIRE(tsp.construct());
+
+        ErrorHistogramManager manager = ErrorHistogramManager(&tsp);
+        REQUIRE(manager.buildHistograms(NumBins));
+
+        const std::map<unsigned int, Histogram> histograms = serialErrorHistograms(tsp);
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            const Histogram* histogram = manager.histogram(brick);
+            const auto it = histograms.find(brick);
+            REQUIRE((histogram != nullptr) == (it != histograms.end()));
+            if (histogram) {
+                CHECK(isEqual(*histogram, it->second));
+            }
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TSP: Parallel Local Error Histograms", "[tsp]") {
+    const std::filesystem::path path = createTspFile("test_tsp_localhistograms.tsp");
+    {
+        TSP tsp = TSP(path);
+        REQUIRE(tsp.readHeader());
+        REQUIRE(tsp.construct());
+
+        LocalErrorHistogramManager manager = LocalErrorHistogramManager(&tsp);
+        REQUIRE(manager.buildHistograms(NumBins));
+
+        const int brickDim = static_cast<int>(tsp.brickDim());
+        const int padding = static_cast<int>(tsp.paddedBrickDim() - tsp.brickDim()) / 2;
+        for (unsigned int brick = 0; brick < tsp.numTotalNodes(); brick++) {
+            const Histogram* spatial = manager.spatialHistogram(brick);
+            const Histogram* temporal = manager.temporalHistogram(brick);
+            if (!spatial) {
+                CHECK((tsp.isOctreeLeaf(brick) && tsp.isBstLeaf(brick)));
+                continue;
+            }
+            REQUIRE(temporal);
+            const float* parentValues = tsp.brickValues(brick);
+
+            Histogram expectedSpatial = Histogram(0.f, 1.f, NumBins);
+            for (int child = 0; child < 8 && !tsp.isOctreeLeaf(brick); child++) {
+                const float* childValues =
+                    tsp.brickValues(tsp.firstOctreeChild(brick) + child);
+                const glm::vec3 offset =
+                    glm::vec3(child % 2, (child / 2) % 2, child / 4) * (brickDim / 2.f);
+                for (int z = 0; z < brickDim; z++) {
+                    for (int y = 0; y < brickDim; y++) {
+                        for (int x = 0; x < brickDim; x++) {
+                            const float childValue = childValues[linearCoords(
+                                tsp,
+                                glm::ivec3(x, y, z) + glm::ivec3(padding)
+                            )];
+                            const float parentValue = interpolate(
+                                tsp,
+                                offset + glm::vec3(x + 0.5f, y + 0.5f, z + 0.5f) * 0.5f,
+                                parentValues
+                            );
+                            expectedSpatial.addRectangle(
+                                childValue,
+                                parentValue,
+                                std::abs(childValue - parentValue) / 8.f
+                            );
+                        }
+                    }
+                }
+            }
+            CHECK(isEqual(*spatial, expectedSpatial));
+
+            Histogram expectedTemporal = Histogram(0.f, 1.f, NumBins);
+            if (!tsp.isBstLeaf(brick)) {
+                for (unsigned int child : { tsp.bstLeft(brick), tsp.bstRight(brick) }) {
+                    const float* childValues = tsp.brickValues(child);
+                    for (int z = 0; z < brickDim; z++) {
+                        for (int y = 0; y < brickDim; y++) {
+                            for (int x = 0; x < brickDim; x++) {
+                                const unsigned int i = linearCoords(
+                                    tsp,
+                                    glm::ivec3(x, y, z) + glm::ivec3(padding)
+                                );
+                                expectedTemporal.addRectangle(
+                                    childValues[i],
+                                    parentValues[i],
+                                    std::abs(childValues[i] - parentValues[i]) / 2.f
+                                );
+                            }
+                        }
+                    }
+                }
+            }
+            CHECK(isEqual(*temporal, expectedTemporal));
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+#endif // OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED